@@ -0,0 +1,535 @@
+#include "Map.h"
+#include "Physics.h"
+#include "Player.h"
+#include "PlayerSlots.h"
+#include "Projectiles.h"
+#include "Random.h"
+#include "Renderer.h"
+#include "SkillOrb.h"
+#include "Terrain.h"
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Microbenchmarks of the hot terrain, physics and rendering kernels on the shipped maps.
+//
+//   BallyBench [--filter text] [--map name] [--samples N] [--sample-ms ms] [--json file]
+//              [--baseline file] [--list]
+//
+// Run it from the repository root: maps/ and fonts/ are looked up there, like the game does.
+// Each benchmark is calibrated to fill --sample-ms, then timed --samples times; the median
+// is reported as ns/op and ops/s. --json writes the results (one benchmark per line) and
+// --baseline reads such a file back to print the speedup of every benchmark against it.
+
+namespace {
+
+constexpr int DEFAULT_SAMPLES = 5;
+constexpr int DEFAULT_SAMPLE_MS = 100;
+constexpr Uint64 MAX_OPERATIONS = 1ull << 32;
+constexpr int QUERY_COUNT = 4096; // Precomputed inputs per benchmark, cycled through (power of two)
+constexpr Uint64 QUERY_SEED = 0xBA11B3C4;
+
+constexpr float PLAYER_RADIUS = 20.0f;      // Every player starts at this size
+constexpr float CRATER_RADIUS = 30.0f;      // Plain projectile explosion
+constexpr int SPAWN_SEARCH_RANGE = 100;     // As Match::FindSpawnPosition
+constexpr float SPAWN_PADDING = 100.0f;
+constexpr float PARKING_CLEARANCE = 60.0f;  // Parked projectiles and orbs keep this far from everything
+
+const char* const TEXT_BENCHMARKS[] = { "Renderer::DrawText short", "Renderer::DrawText line" };
+
+// Results of the timed loops are stored here so the compiler can't drop the work
+volatile Uint64 s_sink = 0;
+
+struct Benchmark {
+    std::string name;
+    std::string map;                      // Empty = does not depend on the map
+    std::function<void()> setup;          // Untimed, before every run (optional)
+    std::function<void(Uint64)> run;      // Timed: perform this many operations
+};
+
+struct BenchResult {
+    std::string name;
+    std::string map;
+    Uint64 operations;   // Per sample
+    double nsPerOp;      // Median sample
+    double nsPerOpMin;   // Fastest sample
+    double opsPerSecond;
+};
+
+struct PointQuery {
+    int x;
+    int y;
+};
+
+struct LoadedMap {
+    std::string name;
+    std::unique_ptr<Terrain> terrain;
+};
+
+// Everything CheckCollisions touches. Players are spawned the way Match does it, projectiles
+// and orbs are parked in open air away from everything, so every step does the same work.
+struct PhysicsScene {
+    Terrain terrain;
+    Physics physics;
+    std::vector<std::unique_ptr<Player>> players;
+    SkillOrbPool skillOrbs;
+};
+
+void PrintUsage() {
+    std::cout << "Usage: BallyBench [--filter text] [--map name] [--samples N] [--sample-ms ms] [--json file]"
+              << " [--baseline file] [--list]" << std::endl;
+}
+
+double RunNanoseconds(const Benchmark& benchmark, Uint64 operations) {
+    if (benchmark.setup) benchmark.setup();
+    auto start = std::chrono::steady_clock::now();
+    benchmark.run(operations);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+BenchResult Measure(const Benchmark& benchmark, int samples, int sampleMs) {
+    // Grow the operation count until one run fills a sample
+    double targetNs = sampleMs * 1e6;
+    Uint64 operations = 1;
+    double ns = RunNanoseconds(benchmark, operations);
+    while (ns < targetNs && operations < MAX_OPERATIONS) {
+        double grow = ns > 0.0 ? targetNs / ns * 1.2 : 100.0;
+        grow = std::max(2.0, std::min(grow, 100.0));
+        operations = std::min(MAX_OPERATIONS, static_cast<Uint64>(operations * grow));
+        ns = RunNanoseconds(benchmark, operations);
+    }
+
+    std::vector<double> nsPerOp;
+    for (int i = 0; i < samples; ++i) {
+        nsPerOp.push_back(RunNanoseconds(benchmark, operations) / operations);
+    }
+    std::sort(nsPerOp.begin(), nsPerOp.end());
+
+    BenchResult result;
+    result.name = benchmark.name;
+    result.map = benchmark.map;
+    result.operations = operations;
+    result.nsPerOp = nsPerOp[nsPerOp.size() / 2];
+    result.nsPerOpMin = nsPerOp.front();
+    result.opsPerSecond = result.nsPerOp > 0.0 ? 1e9 / result.nsPerOp : 0.0;
+    return result;
+}
+
+std::string ResultKey(const std::string& name, const std::string& map) {
+    return map.empty() ? name : name + " @ " + map;
+}
+
+std::string JsonEscape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+bool WriteJson(const std::string& path, const std::vector<BenchResult>& results, int samples, int sampleMs) {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Failed to write benchmark results: " << path << std::endl;
+        return false;
+    }
+
+    file << std::setprecision(6);
+    file << "{\"samples\": " << samples << ", \"sample_ms\": " << sampleMs << ", \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& result = results[i];
+        file << "{\"name\": \"" << JsonEscape(result.name) << "\", \"map\": \"" << JsonEscape(result.map)
+             << "\", \"operations\": " << result.operations << ", \"ns_per_op\": " << result.nsPerOp
+             << ", \"ns_per_op_min\": " << result.nsPerOpMin << ", \"ops_per_second\": " << result.opsPerSecond
+             << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    file << "]}\n";
+    std::cout << "Benchmark results written to " << path << std::endl;
+    return true;
+}
+
+// Value of "key": in one line of our own JSON output
+std::string ReadJsonField(const std::string& line, const std::string& key) {
+    std::string pattern = "\"" + key + "\": ";
+    size_t start = line.find(pattern);
+    if (start == std::string::npos) return "";
+    start += pattern.size();
+    if (line[start] == '"') {
+        std::string value;
+        for (size_t i = start + 1; i < line.size() && line[i] != '"'; ++i) {
+            if (line[i] == '\\' && i + 1 < line.size()) ++i;
+            value += line[i];
+        }
+        return value;
+    }
+    size_t end = line.find_first_of(",}", start);
+    return line.substr(start, end - start);
+}
+
+// ns/op by ResultKey from a file written by --json
+bool ReadBaseline(const std::string& path, std::map<std::string, double>& baseline) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Failed to read baseline: " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::string name = ReadJsonField(line, "name");
+        std::string nsPerOp = ReadJsonField(line, "ns_per_op");
+        if (name.empty() || nsPerOp.empty()) continue;
+        baseline[ResultKey(name, ReadJsonField(line, "map"))] = std::atof(nsPerOp.c_str());
+    }
+    return true;
+}
+
+std::vector<PointQuery> MakePointQueries(const Terrain& terrain, Uint64 stream) {
+    RandomStream random = RandomStream(QUERY_SEED).Split(stream);
+    std::vector<PointQuery> queries(QUERY_COUNT);
+    for (PointQuery& query : queries) {
+        query.x = random.RangeInt(0, terrain.GetWidth() - 1);
+        query.y = random.RangeInt(0, terrain.GetHeight() - 1);
+    }
+    return queries;
+}
+
+std::vector<LoadedMap> LoadMaps(const std::string& onlyMap) {
+    // Sorted so every run lists the maps in the same order
+    std::vector<MapInfo> available = Map::ScanAvailableMaps("maps");
+    std::sort(available.begin(), available.end(),
+              [](const MapInfo& a, const MapInfo& b) { return a.name < b.name; });
+
+    std::vector<LoadedMap> maps;
+    for (const MapInfo& info : available) {
+        if (!onlyMap.empty() && info.name != onlyMap) continue;
+
+        LoadedMap loaded;
+        loaded.name = info.name;
+        loaded.terrain = std::make_unique<Terrain>();
+        if (!loaded.terrain->LoadFromImage(info.terrainPath)) {
+            std::cerr << "Skipping map " << info.name << ": terrain failed to load" << std::endl;
+            continue;
+        }
+        // Matches build the mask once per map before sharing it
+        loaded.terrain->BuildFreeSpaceMask(SkillOrb::DEFAULT_RADIUS);
+        maps.push_back(std::move(loaded));
+    }
+    return maps;
+}
+
+bool IsClearOf(const Vector2& position, const std::vector<Vector2>& taken) {
+    for (const Vector2& other : taken) {
+        if ((other - position).Length() < PARKING_CLEARANCE) return false;
+    }
+    return true;
+}
+
+// A free-space cell centre that is clear of everything placed so far (false if none was found)
+bool FindParkingSpot(const Terrain& terrain, RandomStream& random, std::vector<Vector2>& taken, Vector2& outPosition) {
+    if (terrain.GetFreeCellCount() == 0) return false;
+    for (int attempt = 0; attempt < 1000; ++attempt) {
+        Vector2 cellMin, cellMax;
+        terrain.GetFreeCellBounds(random.RangeInt(0, terrain.GetFreeCellCount() - 1), cellMin, cellMax);
+        Vector2 position = (cellMin + cellMax) * 0.5f;
+        if (terrain.IsCircleSolid(position, PARKING_CLEARANCE * 0.5f) || !IsClearOf(position, taken)) continue;
+        taken.push_back(position);
+        outPosition = position;
+        return true;
+    }
+    return false;
+}
+
+void BuildPhysicsScene(PhysicsScene& scene, const Terrain& map, int playerCount, int projectileCount, int orbCount) {
+    scene.terrain.ShareFrom(map);
+    scene.physics.ClearProjectiles();
+    scene.physics.SetTerrain(&scene.terrain);
+    scene.players.clear();
+    scene.skillOrbs.Clear();
+
+    std::vector<Vector2> taken;
+    float width = static_cast<float>(map.GetWidth());
+    float spacing = playerCount > 1 ? (width - SPAWN_PADDING * 2.0f) / (playerCount - 1) : 0.0f;
+    for (int i = 0; i < playerCount; ++i) {
+        int targetX = static_cast<int>(SPAWN_PADDING + spacing * i);
+        int spawnX = targetX, spawnY = map.GetHeight() / 2;
+        map.FindValidSpawnPosition(targetX, SPAWN_SEARCH_RANGE, PLAYER_RADIUS, spawnX, spawnY);
+
+        Vector2 position(static_cast<float>(spawnX), spawnY - PLAYER_RADIUS - 3.0f);
+        scene.players.push_back(std::make_unique<Player>(i, position, PlayerSlots::GetColor(i)));
+        taken.push_back(position);
+    }
+
+    RandomStream random = RandomStream(QUERY_SEED).Split(playerCount);
+    Vector2 position;
+    for (int i = 0; i < projectileCount && FindParkingSpot(scene.terrain, random, taken, position); ++i) {
+        scene.physics.AddProjectile(Projectile(position, Vector2(300.0f, -300.0f),
+            ProjectileType::NORMAL, i % std::max(playerCount, 1)));
+    }
+    for (int i = 0; i < orbCount && !scene.skillOrbs.IsFull() && FindParkingSpot(scene.terrain, random, taken, position); ++i) {
+        SkillType skill = static_cast<SkillType>(i % static_cast<int>(SkillType::COUNT));
+        scene.skillOrbs.Spawn()->Respawn(position, skill, 0);
+    }
+}
+
+void AddTerrainBenchmarks(std::vector<Benchmark>& benchmarks, const LoadedMap& map) {
+    const Terrain* terrain = map.terrain.get();
+
+    auto points = std::make_shared<std::vector<PointQuery>>(MakePointQueries(*terrain, 0));
+    benchmarks.push_back({ "Terrain::IsPixelSolid", map.name, nullptr, [terrain, points](Uint64 operations) {
+        Uint64 solid = 0;
+        for (Uint64 i = 0; i < operations; ++i) {
+            const PointQuery& query = (*points)[i & (QUERY_COUNT - 1)];
+            solid += terrain->IsPixelSolid(query.x, query.y);
+        }
+        s_sink = solid;
+    } });
+
+    auto centers = std::make_shared<std::vector<PointQuery>>(MakePointQueries(*terrain, 1));
+    benchmarks.push_back({ "Terrain::IsCircleSolid r20", map.name, nullptr, [terrain, centers](Uint64 operations) {
+        Uint64 solid = 0;
+        for (Uint64 i = 0; i < operations; ++i) {
+            const PointQuery& query = (*centers)[i & (QUERY_COUNT - 1)];
+            solid += terrain->IsCircleSolid(Vector2(static_cast<float>(query.x), static_cast<float>(query.y)),
+                                            PLAYER_RADIUS);
+        }
+        s_sink = solid;
+    } });
+
+    // Cuts into a private copy of the map; the copy is made fresh (untimed) for every run
+    auto craters = std::make_shared<std::vector<PointQuery>>(MakePointQueries(*terrain, 2));
+    auto edited = std::make_shared<Terrain>();
+    benchmarks.push_back({ "Terrain::DestroyCircle r30", map.name,
+        [terrain, edited]() {
+            edited->ShareFrom(*terrain);
+            edited->DestroyCircle(Vector2(-100.0f, -100.0f), 1.0f); // Take the copy now
+        },
+        [edited, craters](Uint64 operations) {
+            for (Uint64 i = 0; i < operations; ++i) {
+                const PointQuery& query = (*craters)[i & (QUERY_COUNT - 1)];
+                edited->DestroyCircle(Vector2(static_cast<float>(query.x), static_cast<float>(query.y)), CRATER_RADIUS);
+            }
+            s_sink = edited->GetCraterLog().size();
+        } });
+
+    auto columns = std::make_shared<std::vector<PointQuery>>(MakePointQueries(*terrain, 3));
+    benchmarks.push_back({ "Terrain::FindTopSolidPixel", map.name, nullptr, [terrain, columns](Uint64 operations) {
+        Uint64 sum = 0;
+        for (Uint64 i = 0; i < operations; ++i) {
+            sum += terrain->FindTopSolidPixel((*columns)[i & (QUERY_COUNT - 1)].x, 0);
+        }
+        s_sink = sum;
+    } });
+
+    auto targets = std::make_shared<std::vector<PointQuery>>(MakePointQueries(*terrain, 4));
+    benchmarks.push_back({ "Terrain::FindValidSpawnPosition", map.name, nullptr, [terrain, targets](Uint64 operations) {
+        Uint64 sum = 0;
+        for (Uint64 i = 0; i < operations; ++i) {
+            int spawnX = 0, spawnY = 0;
+            if (terrain->FindValidSpawnPosition((*targets)[i & (QUERY_COUNT - 1)].x, SPAWN_SEARCH_RANGE,
+                                                PLAYER_RADIUS, spawnX, spawnY)) {
+                sum += spawnX + spawnY;
+            }
+        }
+        s_sink = sum;
+    } });
+}
+
+void AddPhysicsBenchmarks(std::vector<Benchmark>& benchmarks, const LoadedMap& map) {
+    struct Load { int players, projectiles, orbs; };
+    const Load loads[] = { { 4, 1, 4 }, { 8, 8, 8 }, { 32, 32, 16 } };
+
+    for (const Load& load : loads) {
+        std::ostringstream name;
+        name << "Physics::CheckCollisions " << load.players << "p " << load.projectiles << "proj " << load.orbs << "orb";
+
+        // One simulation step as Match::Update runs it, minus projectile flight (parked
+        // projectiles are still swept against every orb, player and the terrain)
+        const Terrain* terrain = map.terrain.get();
+        auto scene = std::make_shared<PhysicsScene>();
+        benchmarks.push_back({ name.str(), map.name,
+            [scene, terrain, load]() {
+                BuildPhysicsScene(*scene, *terrain, load.players, load.projectiles, load.orbs);
+            },
+            [scene](Uint64 operations) {
+                for (Uint64 i = 0; i < operations; ++i) {
+                    scene->physics.CheckCollisions(scene->players, scene->skillOrbs);
+                    for (auto& player : scene->players) {
+                        player->Update(1.0f / 60.0f);
+                    }
+                }
+                s_sink = scene->physics.GetProjectiles().size();
+            } });
+    }
+}
+
+void AddTrajectoryBenchmark(std::vector<Benchmark>& benchmarks) {
+    // Aim previews across the whole angle and power range
+    auto shots = std::make_shared<std::vector<Vector2>>();
+    RandomStream random = RandomStream(QUERY_SEED).Split(5);
+    for (int i = 0; i < QUERY_COUNT; ++i) {
+        shots->push_back(Vector2(random.Range(-900.0f, 900.0f), random.Range(-1200.0f, 0.0f)));
+    }
+
+    benchmarks.push_back({ "ProjectileUtils::SimulateTrajectory", "", nullptr, [shots](Uint64 operations) {
+        Uint64 points = 0;
+        for (Uint64 i = 0; i < operations; ++i) {
+            points += ProjectileUtils::SimulateTrajectory(Vector2(600.0f, 400.0f), (*shots)[i & (QUERY_COUNT - 1)]).size();
+        }
+        s_sink = points;
+    } });
+}
+
+void AddTextBenchmarks(std::vector<Benchmark>& benchmarks, Renderer* renderer) {
+    const Color white(255, 255, 255, 255);
+    auto setup = [renderer]() {
+        renderer->EndFrame();
+        renderer->BeginFrame();
+    };
+
+    benchmarks.push_back({ TEXT_BENCHMARKS[0], "", setup, [renderer, white](Uint64 operations) {
+        for (Uint64 i = 0; i < operations; ++i) {
+            renderer->DrawText(Vector2(20.0f, 20.0f), "HP 100", white);
+        }
+    } });
+    benchmarks.push_back({ TEXT_BENCHMARKS[1], "", setup, [renderer, white](Uint64 operations) {
+        for (Uint64 i = 0; i < operations; ++i) {
+            renderer->DrawText(Vector2(20.0f, 60.0f), "Player 3's turn - 12s left - Split Throw ready", white);
+        }
+    } });
+}
+
+bool Matches(const std::string& filter, const Benchmark& benchmark) {
+    return filter.empty() || ResultKey(benchmark.name, benchmark.map).find(filter) != std::string::npos;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string filter;
+    std::string onlyMap;
+    std::string jsonPath;
+    std::string baselinePath;
+    int samples = DEFAULT_SAMPLES;
+    int sampleMs = DEFAULT_SAMPLE_MS;
+    bool listOnly = false;
+
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--filter") == 0 && hasValue) {
+            filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--map") == 0 && hasValue) {
+            onlyMap = argv[++i];
+        } else if (std::strcmp(argv[i], "--samples") == 0 && hasValue) {
+            samples = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--sample-ms") == 0 && hasValue) {
+            sampleMs = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--json") == 0 && hasValue) {
+            jsonPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--baseline") == 0 && hasValue) {
+            baselinePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--list") == 0) {
+            listOnly = true;
+        } else {
+            PrintUsage();
+            return -1;
+        }
+    }
+
+    std::map<std::string, double> baseline;
+    if (!baselinePath.empty() && !ReadBaseline(baselinePath, baseline)) {
+        return 1;
+    }
+
+    std::vector<LoadedMap> maps = LoadMaps(onlyMap);
+    if (maps.empty()) {
+        std::cerr << "No maps loaded (run from the repository root, or check --map)" << std::endl;
+        return 1;
+    }
+
+    std::vector<Benchmark> benchmarks;
+    for (const LoadedMap& map : maps) {
+        AddTerrainBenchmarks(benchmarks, map);
+        AddPhysicsBenchmarks(benchmarks, map);
+    }
+    AddTrajectoryBenchmark(benchmarks);
+
+    // Text needs a real renderer: a hidden window, or the offscreen driver on headless machines
+    SDL_Window* window = nullptr;
+    std::unique_ptr<Renderer> renderer;
+    bool wantsText = false;
+    for (const char* name : TEXT_BENCHMARKS) {
+        wantsText = wantsText || Matches(filter, Benchmark{ name, "", nullptr, nullptr });
+    }
+    if (wantsText) {
+        bool video = SDL_Init(SDL_INIT_VIDEO);
+        if (!video) {
+            SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+            video = SDL_Init(SDL_INIT_VIDEO);
+        }
+        window = video ? SDL_CreateWindow("Bally benchmarks", 1200, 800, SDL_WINDOW_HIDDEN) : nullptr;
+        if (window) {
+            renderer = std::make_unique<Renderer>(window);
+            if (renderer->Initialize() && renderer->GetFont()) {
+                renderer->BeginFrame();
+                AddTextBenchmarks(benchmarks, renderer.get());
+            } else {
+                renderer.reset();
+            }
+        }
+        if (!renderer) {
+            std::cerr << "Skipping text benchmarks: no renderer or font (" << SDL_GetError() << ")" << std::endl;
+        }
+    }
+
+    std::vector<BenchResult> results;
+    std::cout << std::left << std::setw(48) << "benchmark" << std::setw(18) << "map" << std::right
+              << std::setw(12) << "ns/op" << std::setw(16) << "ops/s" << std::setw(12) << "ops"
+              << (baseline.empty() ? "" : "  vs baseline") << std::endl;
+    for (const Benchmark& benchmark : benchmarks) {
+        if (!Matches(filter, benchmark)) continue;
+        if (listOnly) {
+            std::cout << ResultKey(benchmark.name, benchmark.map) << std::endl;
+            continue;
+        }
+
+        BenchResult result = Measure(benchmark, samples, sampleMs);
+        results.push_back(result);
+
+        std::cout << std::left << std::setw(48) << result.name << std::setw(18) << (result.map.empty() ? "-" : result.map)
+                  << std::right << std::fixed << std::setprecision(1) << std::setw(12) << result.nsPerOp
+                  << std::setprecision(0) << std::setw(16) << result.opsPerSecond << std::setw(12) << result.operations;
+        if (!baseline.empty()) {
+            auto previous = baseline.find(ResultKey(result.name, result.map));
+            if (previous != baseline.end() && result.nsPerOp > 0.0) {
+                std::cout << "  " << std::setprecision(2) << previous->second / result.nsPerOp << "x";
+            } else {
+                std::cout << "  -";
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    renderer.reset();
+    if (window) {
+        SDL_DestroyWindow(window);
+    }
+    SDL_Quit();
+
+    if (!jsonPath.empty() && !listOnly && !WriteJson(jsonPath, results, samples, sampleMs)) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include "LiveMetrics.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Reads the live metrics a game or server publishes with --metrics and prints them.
+//
+//   BallyMetrics [--name name] [--watch ms] [--prometheus]
+//
+// --watch keeps printing one line per sample; --prometheus prints the text exposition
+// format for scrapers (for example the node exporter's textfile collector).
+
+static void PrintUsage() {
+    std::cout << "Usage: BallyMetrics [--name name] [--watch ms] [--prometheus]" << std::endl;
+}
+
+static void PrintReport(const LiveMetrics& metrics, Uint32 processId) {
+    std::cout << std::fixed << std::setprecision(2)
+              << "process         " << processId << std::endl
+              << "samples         " << metrics.publishCount << std::endl
+              << "frame ms        " << metrics.frameMs << " (avg " << metrics.frameMsAverage << ")" << std::endl
+              << "steps/s         " << metrics.stepsPerSecond << " (" << metrics.stepsTotal << " total)" << std::endl
+              << "craters/s       " << metrics.cratersPerSecond << " (" << metrics.cratersTotal << " total)" << std::endl
+              << "players         " << metrics.playersAlive << " alive of " << metrics.players << std::endl
+              << "projectiles     " << metrics.projectiles << std::endl
+              << "skill orbs      " << metrics.skillOrbs << std::endl
+              << "matches         " << metrics.matchesRunning << " running, " << metrics.matchesFinished << " finished" << std::endl
+              << "memory          " << metrics.residentBytes / (1024.0 * 1024.0) << " MB" << std::endl;
+}
+
+static void PrintLine(const LiveMetrics& metrics) {
+    std::cout << std::fixed << std::setprecision(2)
+              << "frame " << metrics.frameMs << " ms avg " << metrics.frameMsAverage
+              << " | " << metrics.stepsPerSecond << " steps/s | " << metrics.cratersPerSecond << " craters/s"
+              << " | players " << metrics.playersAlive << "/" << metrics.players
+              << " | projectiles " << metrics.projectiles << " | orbs " << metrics.skillOrbs
+              << " | matches " << metrics.matchesRunning << "/" << metrics.matchesFinished
+              << " | " << metrics.residentBytes / (1024.0 * 1024.0) << " MB" << std::endl;
+}
+
+static void PrintPrometheus(const LiveMetrics& metrics, Uint32 processId) {
+    std::string labels = "{pid=\"" + std::to_string(processId) + "\"}";
+    auto gauge = [&labels](const char* name, const char* help, double value) {
+        std::cout << "# HELP bally_" << name << " " << help << "\n"
+                  << "# TYPE bally_" << name << " gauge\n"
+                  << "bally_" << name << labels << " " << value << "\n";
+    };
+    auto counter = [&labels](const char* name, const char* help, Uint64 value) {
+        std::cout << "# HELP bally_" << name << " " << help << "\n"
+                  << "# TYPE bally_" << name << " counter\n"
+                  << "bally_" << name << labels << " " << value << "\n";
+    };
+
+    gauge("frame_ms", "Work time of the last frame", metrics.frameMs);
+    gauge("frame_ms_average", "Average frame work time over the last second", metrics.frameMsAverage);
+    gauge("steps_per_second", "Simulation steps per second", metrics.stepsPerSecond);
+    gauge("craters_per_second", "Terrain edits per second", metrics.cratersPerSecond);
+    counter("steps_total", "Simulation steps since startup", metrics.stepsTotal);
+    counter("craters_total", "Terrain edits since startup", metrics.cratersTotal);
+    gauge("players", "Players in running matches", metrics.players);
+    gauge("players_alive", "Players still alive", metrics.playersAlive);
+    gauge("projectiles", "Projectiles in flight", metrics.projectiles);
+    gauge("skill_orbs", "Skill orbs on the map", metrics.skillOrbs);
+    gauge("matches_running", "Matches being played", metrics.matchesRunning);
+    counter("matches_finished", "Matches finished since startup", metrics.matchesFinished);
+    gauge("resident_bytes", "Process memory in RAM", static_cast<double>(metrics.residentBytes));
+    std::cout << std::flush;
+}
+
+int main(int argc, char* argv[]) {
+    std::string name = LiveMetricsPublisher::DEFAULT_NAME;
+    int watchMs = 0;
+    bool prometheus = false;
+
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--name") == 0 && hasValue) {
+            name = argv[++i];
+        } else if (std::strcmp(argv[i], "--watch") == 0 && hasValue) {
+            watchMs = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--prometheus") == 0) {
+            prometheus = true;
+        } else {
+            PrintUsage();
+            return -1;
+        }
+    }
+
+    LiveMetricsReader reader;
+    if (!reader.Open(name)) {
+        std::cerr << "No metrics published under '" << name << "' (start the game or server with --metrics)" << std::endl;
+        return 1;
+    }
+
+    LiveMetrics metrics;
+    Uint32 processId = 0;
+    if (watchMs <= 0) {
+        if (!reader.Read(metrics, processId)) {
+            std::cerr << "Metrics segment '" << name << "' is unreadable or from another version" << std::endl;
+            return 1;
+        }
+        if (prometheus) {
+            PrintPrometheus(metrics, processId);
+        } else {
+            PrintReport(metrics, processId);
+        }
+        return 0;
+    }
+
+    // Watch until the publisher goes away
+    for (;;) {
+        if (!reader.Read(metrics, processId)) {
+            std::cerr << "Metrics segment '" << name << "' closed" << std::endl;
+            return 0;
+        }
+        if (prometheus) {
+            PrintPrometheus(metrics, processId);
+        } else {
+            PrintLine(metrics);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(watchMs));
+    }
+}
@@ -0,0 +1,36 @@
+#include "LoopbackNetwork.h"
+#include <algorithm>
+
+LoopbackNetwork::LoopbackNetwork(const LinkConditions& conditions, unsigned int seed)
+    : m_conditions(conditions), m_random(seed), m_timeMs(0.0), m_packetsSent(0), m_packetsDropped(0) {
+    for (int i = 0; i < 2; ++i) {
+        m_endpoints[i].m_network = this;
+        m_endpoints[i].m_index = i;
+    }
+}
+
+void LoopbackNetwork::Send(int from, const std::vector<Uint8>& packet) {
+    m_packetsSent++;
+    if (m_random.NextFloat() < m_conditions.lossRate) {
+        m_packetsDropped++;
+        return;
+    }
+
+    InFlight inFlight;
+    inFlight.deliverTimeMs = m_timeMs + m_conditions.latencyMs +
+        m_random.Range(-static_cast<float>(m_conditions.jitterMs), static_cast<float>(m_conditions.jitterMs));
+    inFlight.data = packet;
+    m_inFlight[1 - from].push_back(std::move(inFlight));
+}
+
+bool LoopbackNetwork::Receive(int to, std::vector<Uint8>& packet) {
+    // Earliest packet that is due (jitter can overtake older packets)
+    std::vector<InFlight>& queue = m_inFlight[to];
+    auto next = std::min_element(queue.begin(), queue.end(),
+        [](const InFlight& a, const InFlight& b) { return a.deliverTimeMs < b.deliverTimeMs; });
+    if (next == queue.end() || next->deliverTimeMs > m_timeMs) return false;
+
+    packet.swap(next->data);
+    queue.erase(next);
+    return true;
+}
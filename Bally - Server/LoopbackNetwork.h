@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include "NetTransport.h"
+#include "Random.h"
+
+struct LinkConditions {
+    double latencyMs;  // One way
+    double jitterMs;   // +- uniform on top of the latency (reorders packets)
+    double lossRate;   // 0..1, per packet
+
+    LinkConditions() : latencyMs(50.0), jitterMs(0.0), lossRate(0.0) {}
+};
+
+// Two in-process endpoints joined by a simulated link on a virtual clock, for testing
+// netplay without sockets. Every packet is delayed, jittered or dropped with a seeded
+// stream, so a run is reproducible.
+class LoopbackNetwork {
+public:
+    LoopbackNetwork(const LinkConditions& conditions, unsigned int seed);
+
+    NetTransport& GetEndpoint(int index) { return m_endpoints[index]; }
+
+    // Move the clock forward; packets due by then become receivable
+    void AdvanceTime(double ms) { m_timeMs += ms; }
+
+    int GetPacketsSent() const { return m_packetsSent; }
+    int GetPacketsDropped() const { return m_packetsDropped; }
+
+private:
+    struct InFlight {
+        double deliverTimeMs;
+        std::vector<Uint8> data;
+    };
+
+    class Endpoint : public NetTransport {
+    public:
+        Endpoint() : m_network(nullptr), m_index(0) {}
+
+        void Send(const std::vector<Uint8>& packet) override { m_network->Send(m_index, packet); }
+        bool Receive(std::vector<Uint8>& packet) override { return m_network->Receive(m_index, packet); }
+
+        LoopbackNetwork* m_network;
+        int m_index;
+    };
+
+    void Send(int from, const std::vector<Uint8>& packet);
+    bool Receive(int to, std::vector<Uint8>& packet);
+
+    LinkConditions m_conditions;
+    RandomStream m_random;
+    double m_timeMs;
+    Endpoint m_endpoints[2];
+    std::vector<InFlight> m_inFlight[2]; // Packets on their way to each endpoint
+    int m_packetsSent;
+    int m_packetsDropped;
+};
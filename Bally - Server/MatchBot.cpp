@@ -0,0 +1,102 @@
+#include "MatchBot.h"
+#include <algorithm>
+#include <cmath>
+
+MatchBot::MatchBot(unsigned int seed)
+    : m_random(RandomStream(seed).Split(0)), m_plannedTurn(-1), m_targetPower(0.0f), m_facingRight(true) {
+}
+
+MatchInput MatchBot::Think(const Match& match) {
+    MatchInput input;
+    if (!match.IsStarted() || match.IsEnded()) return input;
+
+    const auto& players = match.GetPlayers();
+    int index = match.GetCurrentPlayerIndex();
+    if (index < 0 || index >= static_cast<int>(players.size())) return input;
+
+    const Player& self = *players[index];
+    if (!self.IsAlive() || self.GetState() != PlayerState::AIMING) return input;
+
+    // New turn: pick a target and a power
+    if (m_plannedTurn != match.GetTurnCounter()) {
+        const Player* target = FindTarget(match, self);
+        if (!target) return input;
+
+        m_plannedTurn = match.GetTurnCounter();
+        m_facingRight = target->GetPosition().x >= self.GetPosition().x;
+
+        float power = PlanPower(*match.GetTerrain(), self, *target, m_facingRight) + m_random.Range(-AIM_ERROR, AIM_ERROR);
+        m_targetPower = std::max(POWER_STEP, std::min(power, 100.0f));
+    }
+
+    // Turn around first (a single tap only changes facing)
+    if (self.IsFacingRight() != m_facingRight) {
+        input.SetPressed(m_facingRight ? InputManager::PlayerInput::MOVE_RIGHT
+                                       : InputManager::PlayerInput::MOVE_LEFT, true);
+        return input;
+    }
+
+    // Hold power until it reaches the plan; releasing throws
+    input.SetPressed(InputManager::PlayerInput::ADJUST_POWER, self.GetPower() < m_targetPower);
+    return input;
+}
+
+const Player* MatchBot::FindTarget(const Match& match, const Player& self) const {
+    bool teams = match.GetConfig().gameMode == GameMode::TEAM_2V2;
+    const Player* best = nullptr;
+    float bestDistanceSq = 0.0f;
+
+    for (const auto& player : match.GetPlayers()) {
+        if (player.get() == &self || !player->IsAlive()) continue;
+        if (teams && player->GetTeam() == self.GetTeam()) continue;
+
+        float distanceSq = (player->GetPosition() - self.GetPosition()).LengthSquared();
+        if (!best || distanceSq < bestDistanceSq) {
+            best = player.get();
+            bestDistanceSq = distanceSq;
+        }
+    }
+    return best;
+}
+
+float MatchBot::PlanPower(const Terrain& terrain, const Player& self, const Player& target, bool facingRight) const {
+    // Same launch as Match::ThrowProjectile at the turn's starting angle
+    const float radians = self.GetAngle() * (3.14159265358979323846f / 180.0f);
+    Vector2 direction(std::cos(radians), std::sin(radians));
+    if (!facingRight) {
+        direction.x = -direction.x;
+    }
+
+    float bestPower = 50.0f;
+    float bestDistanceSq = -1.0f;
+    const int maxSteps = static_cast<int>(MAX_FLIGHT_TIME / Match::STEP_DURATION);
+
+    for (float power = POWER_STEP; power <= 100.0f; power += POWER_STEP) {
+        Projectile projectile(self.GetPosition(), direction * (power / 100.0f * 1800.0f),
+            ProjectileType::NORMAL, self.GetId());
+
+        // Closest approach before the shot lands or leaves the map
+        float closestSq = (self.GetPosition() - target.GetPosition()).LengthSquared();
+        for (int step = 0; step < maxSteps; ++step) {
+            projectile.Update(Match::STEP_DURATION);
+            const Vector2& position = projectile.GetPosition();
+            closestSq = std::min(closestSq, (position - target.GetPosition()).LengthSquared());
+
+            if (!projectile.IsActive() || position.y > terrain.GetHeight() ||
+                position.x < 0.0f || position.x > terrain.GetWidth()) {
+                break;
+            }
+            // Skip the first steps while the projectile is still inside the thrower
+            if (step > 3 && terrain.IsCircleSolid(position, projectile.GetRadius())) {
+                break;
+            }
+        }
+
+        if (bestDistanceSq < 0.0f || closestSq < bestDistanceSq) {
+            bestDistanceSq = closestSq;
+            bestPower = power;
+        }
+    }
+
+    return bestPower;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Match.h"
+#include "Random.h"
+
+// Plays every player of a headless match.
+// At the start of each turn it faces the nearest enemy, forward-simulates a normal
+// projectile over a range of powers against the terrain, then charges the power bar
+// to the best one (plus some aim error) and releases.
+class MatchBot {
+public:
+    explicit MatchBot(unsigned int seed);
+
+    // Input for the active player for the next step
+    MatchInput Think(const Match& match);
+
+private:
+    const Player* FindTarget(const Match& match, const Player& self) const;
+    float PlanPower(const Terrain& terrain, const Player& self, const Player& target, bool facingRight) const;
+
+    RandomStream m_random; // Aim error
+    int m_plannedTurn;    // Turn counter the current plan belongs to (-1 = none)
+    float m_targetPower;
+    bool m_facingRight;
+
+    static constexpr float AIM_ERROR = 8.0f;       // +- power
+    static constexpr float POWER_STEP = 2.0f;
+    static constexpr float MAX_FLIGHT_TIME = 6.0f; // Seconds simulated per candidate shot
+};
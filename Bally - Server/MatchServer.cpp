@@ -0,0 +1,87 @@
+#include "MatchServer.h"
+#include "MatchBot.h"
+#include "JobSystem.h"
+#include "Replay.h"
+#include <chrono>
+
+MatchServer::MatchServer(JobSystem& jobSystem, const Terrain& mapTerrain, const MatchConfig& config)
+    : m_jobSystem(jobSystem), m_mapTerrain(mapTerrain), m_config(config), m_maxSteps(DEFAULT_MAX_STEPS),
+      m_stepsPlayed(0), m_matchesRunning(0), m_matchesFinished(0) {
+}
+
+void MatchServer::Run(int matchCount, unsigned int baseSeed) {
+    // One match per batch; workers steal whole matches from each other
+    m_jobSystem.ParallelFor(matchCount, 1, [this, baseSeed](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            MatchResult result = PlayMatch(i, baseSeed + static_cast<unsigned int>(i));
+            if (m_onResult) {
+                m_onResult(result);
+            }
+        }
+    });
+}
+
+MatchResult MatchServer::PlayMatch(int matchIndex, unsigned int seed) const {
+    auto startTime = std::chrono::steady_clock::now();
+
+    MatchResult result;
+    result.matchIndex = matchIndex;
+    result.seed = seed;
+    result.winnerId = -1;
+    result.finished = false;
+    result.steps = 0;
+    result.turns = 0;
+    result.damageDealt = 0.0f;
+    result.explosions = 0;
+    result.orbsCollected = 0;
+
+    m_matchesRunning.fetch_add(1, std::memory_order_relaxed);
+
+    // Headless and serial inside the match: no renderer, no job system
+    Match match;
+    match.SetSeed(seed);
+    EventBus events;
+    EventReader statsEvents(events);
+    match.SetEventBus(&events);
+    if (match.Initialize(m_mapTerrain, m_config)) {
+        MatchBot bot(seed);
+        ReplayRecorder recorder;
+        if (!m_replayFolder.empty()) {
+            recorder.Begin(match, m_mapFolder);
+        }
+
+        while (!match.IsEnded() && match.GetStepCount() < m_maxSteps) {
+            MatchInput input = bot.Think(match);
+            recorder.RecordStep(input);
+            match.Step(input);
+            recorder.RecordStateHash(match);
+            if (match.GetStepCount() % STEP_COUNT_BATCH == 0) {
+                m_stepsPlayed.fetch_add(STEP_COUNT_BATCH, std::memory_order_relaxed);
+            }
+
+            GameEvent event;
+            while (statsEvents.Next(event)) {
+                if (event.type == GameEventType::DAMAGE) result.damageDealt += event.amount;
+                else if (event.type == GameEventType::EXPLOSION) result.explosions++;
+                else if (event.type == GameEventType::ORB_COLLECTED) result.orbsCollected++;
+            }
+        }
+
+        if (recorder.IsRecording()) {
+            recorder.End(match.GetWinnerId());
+            recorder.GetData().SaveToFile(m_replayFolder + "/match_" + std::to_string(matchIndex) + ".bin");
+        }
+
+        result.finished = match.IsEnded();
+        result.winnerId = match.GetWinnerId();
+        result.steps = match.GetStepCount();
+        result.turns = match.GetTurnCounter();
+        m_stepsPlayed.fetch_add(result.steps % STEP_COUNT_BATCH, std::memory_order_relaxed);
+    }
+
+    m_matchesRunning.fetch_sub(1, std::memory_order_relaxed);
+    m_matchesFinished.fetch_add(1, std::memory_order_relaxed);
+
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
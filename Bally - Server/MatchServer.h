@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include "Match.h"
+
+class JobSystem;
+
+struct MatchResult {
+    int matchIndex;
+    unsigned int seed;
+    int winnerId;      // Same encoding as Match::GetWinnerId()
+    bool finished;     // false = hit the step limit (draw)
+    int steps;
+    int turns;
+    double wallSeconds;
+    float damageDealt;  // Stats gathered from the match's gameplay events
+    int explosions;
+    int orbsCollected;
+};
+
+// Runs many independent bot matches on the job system.
+// Every match is one job: it shares the map terrain copy-on-write, steps to the end on
+// its worker and reports its result. Matches never touch each other's state, so the
+// throughput grows with the number of workers.
+class MatchServer {
+public:
+    MatchServer(JobSystem& jobSystem, const Terrain& mapTerrain, const MatchConfig& config);
+
+    void SetMaxSteps(int maxSteps) { m_maxSteps = maxSteps; }
+    // Write a replay of every match to replayFolder (mapFolder is stored in the replays)
+    void SetRecording(const std::string& replayFolder, const std::string& mapFolder) {
+        m_replayFolder = replayFolder;
+        m_mapFolder = mapFolder;
+    }
+    // Called from worker threads as each match finishes (serialize your output)
+    void SetOnResult(std::function<void(const MatchResult&)> callback) { m_onResult = callback; }
+
+    // Play matchCount matches (seed = baseSeed + index) and block until all are done
+    void Run(int matchCount, unsigned int baseSeed);
+
+    // Progress, safe to poll from any thread while Run is going
+    Uint64 GetStepsPlayed() const { return m_stepsPlayed.load(std::memory_order_relaxed); }
+    int GetMatchesRunning() const { return m_matchesRunning.load(std::memory_order_relaxed); }
+    int GetMatchesFinished() const { return m_matchesFinished.load(std::memory_order_relaxed); }
+
+    static constexpr int DEFAULT_MAX_STEPS = 60 * 60 * 15; // 15 simulated minutes
+    static constexpr int STEP_COUNT_BATCH = 256; // Steps a match plays before adding them to the total
+
+private:
+    MatchResult PlayMatch(int matchIndex, unsigned int seed) const;
+
+    JobSystem& m_jobSystem;
+    const Terrain& m_mapTerrain;
+    MatchConfig m_config;
+    int m_maxSteps;
+    std::string m_replayFolder; // Empty = no recording
+    std::string m_mapFolder;
+    std::function<void(const MatchResult&)> m_onResult;
+
+    mutable std::atomic<Uint64> m_stepsPlayed;
+    mutable std::atomic<int> m_matchesRunning;
+    mutable std::atomic<int> m_matchesFinished;
+};
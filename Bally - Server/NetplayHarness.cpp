@@ -0,0 +1,125 @@
+#include "NetplayHarness.h"
+#include "MatchBot.h"
+#include "RollbackSession.h"
+#include <algorithm>
+#include <iostream>
+
+NetplayHarness::NetplayHarness(const Terrain& mapTerrain, const MatchConfig& config, const LinkConditions& conditions)
+    : m_mapTerrain(mapTerrain), m_config(config), m_conditions(conditions),
+      m_inputDelay(NetplaySetup::DEFAULT_INPUT_DELAY), m_maxFrames(60 * 60 * 15), m_injectDesyncFrame(-1) {
+}
+
+NetplayHarnessResult NetplayHarness::PlayMatch(unsigned int seed) const {
+    LoopbackNetwork network(m_conditions, seed);
+    RollbackSession host(network.GetEndpoint(0), true);
+    RollbackSession guest(network.GetEndpoint(1), false);
+
+    NetplaySetup setup;
+    setup.seed = seed;
+    setup.config = m_config;
+    setup.inputDelay = m_inputDelay;
+    host.SetSetup(setup);
+
+    // The host starts right away; the guest once the setup has reached it
+    Match hostMatch;
+    hostMatch.SetSeed(seed);
+    hostMatch.Initialize(m_mapTerrain, m_config);
+    host.Start(hostMatch);
+    Match guestMatch;
+    bool guestStarted = false;
+
+    // Each peer has its own bot; only the inputs for its own players are used
+    MatchBot hostBot(seed * 2 + 1);
+    MatchBot guestBot(seed * 2 + 2);
+
+    std::vector<MatchInput> confirmedInputs;
+    host.SetOnFrameConfirmed([&confirmedInputs](const MatchInput& input, Uint64) { confirmedInputs.push_back(input); });
+
+    NetplayHarnessResult result;
+    result.desyncFrame = -1;
+    auto onDesync = [&result](int frame, const std::string& difference, const StateHashDetail&) {
+        if (result.desyncFrame < 0 || frame < result.desyncFrame) {
+            result.desyncFrame = frame;
+            result.desyncDifference = difference;
+        }
+    };
+    host.SetOnDesync(onDesync);
+    guest.SetOnDesync(onDesync);
+    bool injected = false;
+
+    // Play until both peers saw the end (or the frame limit), then bring both to the same
+    // frame and wait for every input there to be confirmed
+    const double frameMs = Match::STEP_DURATION * 1000.0;
+    int endFrame = -1;
+    for (int tick = 0; tick < m_maxFrames * 2; ++tick) {
+        network.AdvanceTime(frameMs);
+        host.Poll();
+        guest.Poll();
+
+        if (!guestStarted && guest.GetStatus() == RollbackSession::Status::RUNNING) {
+            guestMatch.SetSeed(guest.GetSetup().seed);
+            guestMatch.Initialize(m_mapTerrain, guest.GetSetup().config);
+            guest.Start(guestMatch);
+            guestStarted = true;
+        }
+
+        if (endFrame < 0 && guestStarted) {
+            bool ended = hostMatch.IsEnded() && guestMatch.IsEnded();
+            bool limit = host.GetFrame() >= m_maxFrames || guest.GetFrame() >= m_maxFrames;
+            if (ended || limit) {
+                endFrame = std::max(host.GetFrame(), guest.GetFrame());
+            }
+        }
+        if (endFrame >= 0 && host.GetFrame() == endFrame && guest.GetFrame() == endFrame &&
+            host.IsConfirmed() && guest.IsConfirmed()) {
+            break;
+        }
+
+        if (endFrame < 0 || host.GetFrame() < endFrame) {
+            host.AdvanceFrame(hostBot.Think(hostMatch).buttons);
+        }
+        if (guestStarted && (endFrame < 0 || guest.GetFrame() < endFrame)) {
+            guest.AdvanceFrame(guestBot.Think(guestMatch).buttons);
+        }
+
+        // Only once nothing before this frame can be rolled back, so the change sticks
+        if (!injected && guestStarted && m_injectDesyncFrame >= 0 && guest.GetFrame() >= m_injectDesyncFrame &&
+            guest.IsConfirmed()) {
+            Player* player = guestMatch.GetPlayers()[0].get();
+            Player::SavedState state = player->SaveState();
+            state.position.x += 0.5f;
+            player->LoadState(state);
+            injected = true;
+        }
+    }
+
+    // Both peers, and a plain run of the confirmed inputs, must end in the same state
+    Match offlineMatch;
+    offlineMatch.SetSeed(seed);
+    offlineMatch.Initialize(m_mapTerrain, m_config);
+    for (const MatchInput& input : confirmedInputs) {
+        offlineMatch.Step(input);
+    }
+
+    std::vector<Uint8> hostSnapshot;
+    std::vector<Uint8> guestSnapshot;
+    std::vector<Uint8> offlineSnapshot;
+    hostMatch.SaveSnapshot(hostSnapshot);
+    guestMatch.SaveSnapshot(guestSnapshot);
+    offlineMatch.SaveSnapshot(offlineSnapshot);
+
+    result.inSync = endFrame >= 0 && static_cast<int>(confirmedInputs.size()) == endFrame &&
+        hostSnapshot == guestSnapshot && hostSnapshot == offlineSnapshot;
+    result.frames = host.GetFrame();
+
+    const RollbackStats& hostStats = host.GetStats();
+    const RollbackStats& guestStats = guest.GetStats();
+    result.rollbacks = hostStats.rollbacks + guestStats.rollbacks;
+    result.resimulatedFrames = hostStats.resimulatedFrames + guestStats.resimulatedFrames;
+    result.maxRollbackDepth = std::max(hostStats.maxRollbackDepth, guestStats.maxRollbackDepth);
+    result.resimulationMs = hostStats.resimulationMs + guestStats.resimulationMs;
+    result.maxResimulationMs = std::max(hostStats.maxResimulationMs, guestStats.maxResimulationMs);
+    result.stallFrames = hostStats.stallFrames + guestStats.stallFrames;
+    result.hashesCompared = hostStats.hashesCompared + guestStats.hashesCompared;
+    return result;
+}
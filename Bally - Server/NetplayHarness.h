@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include "LoopbackNetwork.h"
+#include "Match.h"
+
+struct NetplayHarnessResult {
+    bool inSync;       // Both peers and an offline re-run of the confirmed inputs ended identical
+    int frames;
+    int rollbacks;
+    int resimulatedFrames;
+    int maxRollbackDepth;
+    double resimulationMs;
+    double maxResimulationMs;
+    int stallFrames;
+    int hashesCompared;            // Confirmed frames whose state hashes the peers compared
+    int desyncFrame;               // First frame a peer reported as diverged (-1 = none)
+    std::string desyncDifference;  // What diverged there, as the peer reported it
+};
+
+// Plays bot matches between a host and a guest rollback session over a loopback link
+// with latency, jitter and loss, on a virtual 60 Hz clock. Reports how deep and how
+// expensive the rollbacks were and checks that the peers never desynchronized.
+// A desync can be injected to check that the state hashes catch and name it.
+class NetplayHarness {
+public:
+    NetplayHarness(const Terrain& mapTerrain, const MatchConfig& config, const LinkConditions& conditions);
+
+    void SetInputDelay(int frames) { m_inputDelay = frames; }
+    void SetMaxFrames(int frames) { m_maxFrames = frames; }
+    // Nudge the guest's first player once it reaches this frame (-1 = never)
+    void SetInjectDesyncFrame(int frame) { m_injectDesyncFrame = frame; }
+
+    NetplayHarnessResult PlayMatch(unsigned int seed) const;
+
+private:
+    const Terrain& m_mapTerrain;
+    MatchConfig m_config;
+    LinkConditions m_conditions;
+    int m_inputDelay;
+    int m_maxFrames;
+    int m_injectDesyncFrame;
+};
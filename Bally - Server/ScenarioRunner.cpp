@@ -0,0 +1,324 @@
+#include "ScenarioRunner.h"
+#include "MatchBot.h"
+#include "MatchServer.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+constexpr Uint64 SCRIPT_STREAM = 1; // Child of the scenario seed that draws the skill mixes
+
+template<typename T>
+double Percentile(std::vector<T> values, double fraction) {
+    if (values.empty()) return 0.0;
+    size_t index = std::min(values.size() - 1, static_cast<size_t>(fraction * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+// Distinct skills by weight (the same skill twice would toggle itself off again)
+void ArmShot(Player& player, const Scenario& scenario, RandomStream& script) {
+    player.GetInventory().clear();
+    player.ClearSelectedSkills();
+    if (script.RangeInt(1, 100) > scenario.skillShotPercent) return;
+
+    int weights[static_cast<int>(SkillType::COUNT)];
+    std::copy(std::begin(scenario.skillWeights), std::end(scenario.skillWeights), weights);
+    int count = script.RangeInt(1, std::max(1, scenario.maxSkillsPerShot));
+    for (int i = 0; i < count && !player.IsInventoryFull(); ++i) {
+        int total = 0;
+        for (int weight : weights) total += weight;
+        if (total <= 0) break;
+
+        int pick = script.RangeInt(0, total - 1);
+        int skill = 0;
+        while (pick >= weights[skill]) {
+            pick -= weights[skill];
+            skill++;
+        }
+        weights[skill] = 0;
+        player.AddSkillToInventory(skill);
+    }
+
+    // Same as pressing every slot; teleport and heal drop the other skills
+    for (int slot = 0; slot < static_cast<int>(player.GetInventory().size()); ++slot) {
+        player.ToggleSkillSelection(slot);
+    }
+}
+
+// Every pass of one scenario; its result takes the medians
+struct PassFigures {
+    std::vector<double> seconds;
+    std::vector<double> stepsPerSecond;
+    std::vector<double> stepP50Us;
+    std::vector<double> stepP99Us;
+    std::vector<double> craterUs;
+};
+
+// Value of "key": in one line of a results file
+std::string ReadField(const std::string& line, const std::string& key) {
+    std::string pattern = "\"" + key + "\": ";
+    size_t start = line.find(pattern);
+    if (start == std::string::npos) return "";
+    start += pattern.size();
+    if (line[start] == '"') {
+        size_t end = line.find('"', start + 1);
+        return line.substr(start + 1, end - start - 1);
+    }
+    size_t end = line.find_first_of(",}", start);
+    return line.substr(start, end - start);
+}
+
+}
+
+ScenarioRunner::ScenarioRunner() : m_repeats(DEFAULT_REPEATS), m_maxSteps(MatchServer::DEFAULT_MAX_STEPS) {
+}
+
+double ScenarioRunner::GetPeakMemoryMB() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize / (1024.0 * 1024.0);
+    }
+    return 0.0;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.0;
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024.0 * 1024.0); // Bytes
+#else
+    return usage.ru_maxrss / 1024.0;            // Kilobytes
+#endif
+#endif
+}
+
+const std::vector<Scenario>& ScenarioRunner::GetScenarios() {
+    // Weights: split, enhanced damage, enhanced explosive, teleport, heal
+    static const std::vector<Scenario> scenarios = {
+        { "duel", 2, GameMode::FREE_FOR_ALL, 60, 0, 0, { 1, 1, 1, 1, 1 }, 101 },
+        { "ffa4-split-explosive", 4, GameMode::FREE_FOR_ALL, 200, 80, 3, { 4, 1, 4, 1, 1 }, 202 },
+        { "teams8-mixed", 8, GameMode::TEAM_2V2, 120, 50, 2, { 1, 1, 1, 1, 1 }, 303 },
+        { "crowd32-split", 32, GameMode::FREE_FOR_ALL, 100, 60, 2, { 6, 1, 2, 0, 1 }, 404 },
+    };
+    return scenarios;
+}
+
+void ScenarioRunner::PlayPass(const Scenario& scenario, const Terrain& mapTerrain, int shotBudget, Pass& pass) const {
+    pass.matches = 0;
+    pass.shots = 0;
+    pass.steps = 0;
+    pass.seconds = 0.0;
+    pass.stepUs.clear();
+
+    MatchConfig config;
+    config.numPlayers = scenario.players;
+    config.gameMode = scenario.mode;
+    config.skipImpactDelay = true; // Nobody watches the camera
+
+    RandomStream script = RandomStream(scenario.seed).Split(SCRIPT_STREAM);
+    Uint64 cratersBefore = Terrain::GetCratersCutTotal();
+    Uint64 craterNanosecondsBefore = Terrain::GetCraterNanosecondsTotal();
+    Uint64 stepNanoseconds = 0;
+    const Uint64 minNanoseconds = static_cast<Uint64>(MIN_TIMED_SECONDS * 1e9);
+
+    bool budgetSpent = false;
+    while (!budgetSpent) {
+        unsigned int seed = scenario.seed + static_cast<unsigned int>(pass.matches);
+        Match match;
+        match.SetSeed(seed);
+        if (!match.Initialize(mapTerrain, config)) break;
+        pass.matches++;
+
+        MatchBot bot(seed);
+        int armedTurn = -1;
+        int shotsBefore = pass.shots;
+        while (!match.IsEnded() && match.GetStepCount() < m_maxSteps) {
+            // Script the shot at the start of each turn; only the match steps are timed
+            Player& player = *match.GetPlayers()[match.GetCurrentPlayerIndex()];
+            if (match.GetTurnCounter() != armedTurn && player.IsAlive() && player.GetState() == PlayerState::AIMING) {
+                if (shotBudget > 0 ? pass.shots == shotBudget
+                                   : pass.shots >= scenario.shots && stepNanoseconds >= minNanoseconds) {
+                    budgetSpent = true;
+                    break;
+                }
+                armedTurn = match.GetTurnCounter();
+                ArmShot(player, scenario, script);
+                pass.shots++;
+            }
+
+            MatchInput input = bot.Think(match);
+            Uint64 start = Profiler::Now();
+            match.Step(input);
+            Uint64 elapsed = Profiler::Now() - start;
+            stepNanoseconds += elapsed;
+            pass.stepUs.push_back(elapsed / 1000.0f);
+        }
+        pass.steps += match.GetStepCount();
+
+        // A map where no turn ever starts would never spend the budget
+        if (pass.shots == shotsBefore) break;
+    }
+
+    pass.seconds = stepNanoseconds / 1e9;
+    pass.craters = Terrain::GetCratersCutTotal() - cratersBefore;
+    pass.craterNanoseconds = Terrain::GetCraterNanosecondsTotal() - craterNanosecondsBefore;
+}
+
+std::vector<ScenarioResult> ScenarioRunner::Run(const std::vector<Scenario>& scenarios, const std::vector<int>& shots,
+                                                const std::string& mapName, const Terrain& mapTerrain) const {
+    std::vector<ScenarioResult> results(scenarios.size());
+    std::vector<PassFigures> figures(scenarios.size());
+    Pass pass;
+    for (int repeat = 0; repeat < std::max(1, m_repeats); ++repeat) {
+        for (size_t i = 0; i < scenarios.size(); ++i) {
+            // The first pass fixes the workload (unless given), the others replay it
+            ScenarioResult& result = results[i];
+            int budget = repeat > 0 ? result.shots : i < shots.size() ? shots[i] : 0;
+            PlayPass(scenarios[i], mapTerrain, budget, pass);
+            if (repeat == 0) {
+                result.scenario = scenarios[i].name;
+                result.map = mapName;
+                result.matches = pass.matches;
+                result.shots = pass.shots;
+                result.steps = pass.steps;
+                result.craters = pass.craters;
+            }
+
+            PassFigures& passFigures = figures[i];
+            passFigures.seconds.push_back(pass.seconds);
+            passFigures.stepsPerSecond.push_back(pass.seconds > 0.0 ? pass.steps / pass.seconds : 0.0);
+            passFigures.stepP50Us.push_back(Percentile(pass.stepUs, 0.50));
+            passFigures.stepP99Us.push_back(Percentile(pass.stepUs, 0.99));
+            passFigures.craterUs.push_back(pass.craters > 0 ? pass.craterNanoseconds / 1000.0 / pass.craters : 0.0);
+        }
+    }
+
+    for (size_t i = 0; i < scenarios.size(); ++i) {
+        results[i].seconds = Percentile(figures[i].seconds, 0.5);
+        results[i].stepsPerSecond = Percentile(figures[i].stepsPerSecond, 0.5);
+        results[i].stepP50Us = Percentile(figures[i].stepP50Us, 0.5);
+        results[i].stepP99Us = Percentile(figures[i].stepP99Us, 0.5);
+        results[i].craterUs = Percentile(figures[i].craterUs, 0.5);
+    }
+    return results;
+}
+
+bool ScenarioRunner::SaveResults(const std::string& path, const std::vector<ScenarioResult>& results, double peakMemoryMB) {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Failed to write scenario results: " << path << std::endl;
+        return false;
+    }
+
+    file << std::setprecision(8);
+    for (const ScenarioResult& result : results) {
+        file << "{\"scenario\": \"" << result.scenario << "\", \"map\": \"" << result.map
+             << "\", \"matches\": " << result.matches << ", \"shots\": " << result.shots
+             << ", \"steps\": " << result.steps << ", \"craters\": " << result.craters
+             << ", \"seconds\": " << result.seconds << ", \"steps_per_second\": " << result.stepsPerSecond
+             << ", \"step_p50_us\": " << result.stepP50Us << ", \"step_p99_us\": " << result.stepP99Us
+             << ", \"crater_us\": " << result.craterUs << "}\n";
+    }
+    file << "{\"peak_memory_mb\": " << peakMemoryMB << "}\n";
+    std::cout << "Scenario results written to " << path << std::endl;
+    return true;
+}
+
+bool ScenarioRunner::LoadResults(const std::string& path, std::vector<ScenarioResult>& results, double& peakMemoryMB) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Failed to read scenario results: " << path << std::endl;
+        return false;
+    }
+
+    peakMemoryMB = 0.0;
+    std::string line;
+    while (std::getline(file, line)) {
+        ScenarioResult result;
+        result.scenario = ReadField(line, "scenario");
+        if (result.scenario.empty()) {
+            std::string peak = ReadField(line, "peak_memory_mb");
+            if (!peak.empty()) peakMemoryMB = std::atof(peak.c_str());
+            continue;
+        }
+        result.map = ReadField(line, "map");
+        result.matches = std::atoi(ReadField(line, "matches").c_str());
+        result.shots = std::atoi(ReadField(line, "shots").c_str());
+        result.steps = std::strtoull(ReadField(line, "steps").c_str(), nullptr, 10);
+        result.craters = std::strtoull(ReadField(line, "craters").c_str(), nullptr, 10);
+        result.seconds = std::atof(ReadField(line, "seconds").c_str());
+        result.stepsPerSecond = std::atof(ReadField(line, "steps_per_second").c_str());
+        result.stepP50Us = std::atof(ReadField(line, "step_p50_us").c_str());
+        result.stepP99Us = std::atof(ReadField(line, "step_p99_us").c_str());
+        result.craterUs = std::atof(ReadField(line, "crater_us").c_str());
+        results.push_back(result);
+    }
+    return true;
+}
+
+int ScenarioRunner::CompareToBaseline(const std::vector<ScenarioResult>& results, double peakMemoryMB,
+                                      const std::vector<ScenarioResult>& baseline, double baselinePeakMemoryMB,
+                                      double thresholdPercent) {
+    int regressions = 0;
+    int matched = 0;
+    for (const ScenarioResult& result : results) {
+        std::string label = result.scenario + " on " + result.map;
+        auto previous = std::find_if(baseline.begin(), baseline.end(), [&result](const ScenarioResult& entry) {
+            return entry.scenario == result.scenario && entry.map == result.map;
+        });
+        if (previous == baseline.end()) {
+            std::cout << "  " << label << ": not in the baseline" << std::endl;
+            continue;
+        }
+        matched++;
+        if (previous->shots != result.shots || previous->steps != result.steps || previous->craters != result.craters) {
+            std::cout << "  " << label << ": workload changed (" << result.shots << " shots, " << result.steps
+                      << " steps, " << result.craters << " craters; baseline " << previous->shots << ", "
+                      << previous->steps << ", " << previous->craters << "), the gameplay differs from the baseline build"
+                      << std::endl;
+        }
+
+        auto check = [&](const char* figure, double now, double before, bool higherIsBetter, bool gated) {
+            if (before <= 0.0) return;
+            double change = (now - before) / before * 100.0;
+            double worse = higherIsBetter ? -change : change;
+            if (worse > thresholdPercent) {
+                std::cout << (gated ? "  REGRESSION " : "  (not gated) ") << label << ": " << figure << " " << now
+                          << " (baseline " << before << ", " << worse << "% worse)" << std::endl;
+                if (gated) regressions++;
+            }
+        };
+        check("steps/s", result.stepsPerSecond, previous->stepsPerSecond, true, true);
+        check("p50 step us", result.stepP50Us, previous->stepP50Us, false, true);
+        check("p99 step us", result.stepP99Us, previous->stepP99Us, false, false);
+        check("crater us", result.craterUs, previous->craterUs, false, false);
+    }
+
+    // The process peak covers everything run before, so it only compares like with like
+    if (baselinePeakMemoryMB <= 0.0) return regressions;
+    if (matched != static_cast<int>(results.size()) || matched != static_cast<int>(baseline.size())) {
+        std::cout << "  peak memory not compared: the run covers other scenarios or maps than the baseline" << std::endl;
+        return regressions;
+    }
+    double worse = (peakMemoryMB - baselinePeakMemoryMB) / baselinePeakMemoryMB * 100.0;
+    if (worse > thresholdPercent) {
+        std::cout << "  REGRESSION peak memory MB " << peakMemoryMB << " (baseline " << baselinePeakMemoryMB
+                  << ", " << worse << "% worse)" << std::endl;
+        regressions++;
+    }
+    return regressions;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "Match.h"
+
+// One scripted workload: bot matches on a map with a fixed seed, one after another, shot
+// after shot. At the start of every turn the script hands the active player the skills of
+// its next shot, drawn from skillWeights (indexed by SkillType).
+struct Scenario {
+    std::string name;
+    int players;
+    GameMode mode;
+    int shots;                // Minimum per map; more are played until the steps fill MIN_TIMED_SECONDS
+    int skillShotPercent;     // Shots that carry any skill
+    int maxSkillsPerShot;
+    int skillWeights[static_cast<int>(SkillType::COUNT)];
+    unsigned int seed;
+};
+
+struct ScenarioResult {
+    std::string scenario;
+    std::string map;
+    int matches;
+    int shots;
+    Uint64 steps;
+    Uint64 craters;
+    double seconds;        // Timings are medians over the repeats
+    double stepsPerSecond;
+    double stepP50Us;
+    double stepP99Us;
+    double craterUs;       // Average terrain edit
+};
+
+// Plays scenarios headless on a single thread and measures them. Without a shot count the
+// first pass of a scenario keeps shooting until Match::Step has run for MIN_TIMED_SECONDS,
+// which fixes it; every repeat replays exactly that workload. Shots follow one seeded
+// script, so a run given the baseline's shot counts plays the same games, and results are
+// comparable between builds and machines of the same kind; CompareToBaseline turns that
+// into a pass/fail gate.
+class ScenarioRunner {
+public:
+    ScenarioRunner();
+
+    void SetRepeats(int repeats) { m_repeats = repeats; }
+    void SetMaxSteps(int steps) { m_maxSteps = steps; }
+
+    // Plays the scenarios on one map, each with its entry of shots (missing or 0 = sized by
+    // MIN_TIMED_SECONDS). Every repeat plays each scenario once and the results are medians,
+    // so a slow spell of the machine costs one pass of each scenario instead of all of one.
+    std::vector<ScenarioResult> Run(const std::vector<Scenario>& scenarios, const std::vector<int>& shots,
+                                    const std::string& mapName, const Terrain& mapTerrain) const;
+
+    static const std::vector<Scenario>& GetScenarios();
+
+    // Process high-water mark, which can't be reset: it covers everything run so far, so it
+    // is reported once per run rather than per scenario
+    static double GetPeakMemoryMB();
+
+    // Results files hold one JSON object per line, then the run's peak memory
+    static bool SaveResults(const std::string& path, const std::vector<ScenarioResult>& results, double peakMemoryMB);
+    static bool LoadResults(const std::string& path, std::vector<ScenarioResult>& results, double& peakMemoryMB);
+
+    // Prints every gated figure (steps/s, p50 step) that got worse than the baseline by more
+    // than thresholdPercent and returns how many did. p99 and crater cost hang on a handful
+    // of samples, so they are printed when worse but never counted. Peak memory is only
+    // compared when the run covers exactly the scenarios and maps of the baseline.
+    static int CompareToBaseline(const std::vector<ScenarioResult>& results, double peakMemoryMB,
+                                 const std::vector<ScenarioResult>& baseline, double baselinePeakMemoryMB,
+                                 double thresholdPercent);
+
+    static constexpr int DEFAULT_REPEATS = 5;
+    static constexpr double DEFAULT_THRESHOLD_PERCENT = 15.0;
+    static constexpr double MIN_TIMED_SECONDS = 1.0; // Match::Step time per pass
+
+private:
+    int m_repeats;
+    int m_maxSteps;
+
+    struct Pass {
+        int matches = 0;
+        int shots = 0;
+        Uint64 steps = 0;
+        Uint64 craters = 0;
+        Uint64 craterNanoseconds = 0;
+        double seconds = 0.0;
+        std::vector<float> stepUs;
+    };
+    // shotBudget 0 sizes the pass by MIN_TIMED_SECONDS instead
+    void PlayPass(const Scenario& scenario, const Terrain& mapTerrain, int shotBudget, Pass& pass) const;
+};
@@ -0,0 +1,708 @@
+#include "MatchServer.h"
+#include "JobSystem.h"
+#include "LiveMetrics.h"
+#include "MatchBot.h"
+#include "MatchSnapshot.h"
+#include "NetplayHarness.h"
+#include "Profiler.h"
+#include "ReplayPlayer.h"
+#include "RollbackSession.h"
+#include "ScenarioRunner.h"
+#include "SpectatorClient.h"
+#include "SpectatorServer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+// Headless tournament server: plays bot matches on every core and prints one line per
+// finished match, then a throughput summary. Can also play a replay back headless, or
+// play bot matches over a simulated network to measure rollback netplay, or stream bot
+// matches to spectators, or run the scripted performance scenarios.
+//
+//   BallyServer [--matches N] [--players N] [--mode ffa|teams] [--map folder]
+//               [--seed N] [--workers N] [--max-steps N] [--record folder] [--turbo] [--trace file]
+//               [--metrics [name]]
+//
+// --turbo ends each turn as soon as the shot lands instead of pausing for a camera
+// nobody watches (the flag is recorded in replays and sent to netplay guests).
+// --trace writes a Chrome trace (chrome://tracing, ui.perfetto.dev) of the whole run.
+// --metrics publishes live progress to shared memory for BallyMetrics.
+//   BallyServer --replay file [--dump-step N dumpfile]
+//   BallyServer --compare-dumps dumpfile dumpfile
+//   BallyServer --netplay-test [--rtt ms] [--jitter ms] [--loss percent] [--delay frames]
+//               [--inject-desync frame] [--matches N] [--players N] [--mode ffa|teams] [--map folder] [--seed N]
+//   BallyServer --spectate port [--matches N] [--players N] [--mode ffa|teams] [--map folder] [--seed N]
+//   BallyServer --spectate-test viewers [--port N] [--players N] [--mode ffa|teams] [--map folder] [--seed N]
+//   BallyServer --scenarios [name] [--map folder] [--repeats N] [--baseline file] [--save-baseline file]
+//               [--threshold percent]
+//
+// --scenarios plays every scenario (or the named one) on every map in maps/ (or just --map)
+// and exits with an error when a figure is worse than --baseline by more than --threshold.
+
+static constexpr int METRICS_INTERVAL_MS = 100;
+
+static void PrintUsage() {
+    std::cout << "Usage: BallyServer [--matches N] [--players 2-32] [--mode ffa|teams] [--map folder]"
+              << " [--seed N] [--workers N] [--max-steps N] [--record folder] [--turbo] [--trace file]"
+              << " [--metrics [name]]" << std::endl;
+    std::cout << "       BallyServer --replay file [--dump-step N dumpfile]" << std::endl;
+    std::cout << "       BallyServer --compare-dumps dumpfile dumpfile" << std::endl;
+    std::cout << "       BallyServer --netplay-test [--rtt ms] [--jitter ms] [--loss percent] [--delay frames]"
+              << " [--inject-desync frame] [--matches N] [--players 2-32] [--mode ffa|teams] [--map folder] [--seed N]" << std::endl;
+    std::cout << "       BallyServer --spectate port [--matches N] [--players 2-32] [--mode ffa|teams] [--map folder]"
+              << " [--seed N]" << std::endl;
+    std::cout << "       BallyServer --spectate-test viewers [--port N] [--players 2-32] [--mode ffa|teams]"
+              << " [--map folder] [--seed N]" << std::endl;
+    std::cout << "       BallyServer --scenarios [name] [--map folder] [--repeats N] [--baseline file]"
+              << " [--save-baseline file] [--threshold percent]" << std::endl;
+}
+
+static bool LoadMapTerrain(Terrain& terrain, std::string& mapFolder) {
+    if (!mapFolder.empty() && terrain.LoadFromImage(mapFolder + "/terrain.png")) {
+        return true;
+    }
+    if (!mapFolder.empty()) {
+        std::cerr << "Failed to load map " << mapFolder << ", using default terrain" << std::endl;
+        mapFolder.clear();
+    }
+    terrain.CreateDefaultTerrain(1200, 800);
+    return false;
+}
+
+// Write the state hashes, terrain chunks included, after a replay step; dumps of the
+// same step from two machines or builds show where they diverged
+static bool DumpReplayStep(ReplayPlayer& player, int step, const std::string& path) {
+    player.SeekToStep(step);
+    StateHashDetail detail;
+    player.GetMatch().ComputeStateHash(detail, true);
+    if (!detail.WriteDump(path, "Replay state after step " + std::to_string(player.GetStep()))) {
+        return false;
+    }
+    std::cout << "State dump of step " << player.GetStep() << " saved: " << path << std::endl;
+    return true;
+}
+
+static int CompareDumps(const std::string& firstPath, const std::string& secondPath) {
+    StateHashDetail first;
+    StateHashDetail second;
+    if (!first.ReadDump(firstPath) || !second.ReadDump(secondPath)) {
+        return -1;
+    }
+    if (first.step != second.step) {
+        std::cout << "Warning: dumps are of different steps (" << first.step << " and " << second.step << ")" << std::endl;
+    }
+
+    std::string difference = StateHashDetail::FirstDifference(first, second);
+    if (difference.empty()) {
+        std::cout << "States are identical" << std::endl;
+        return 0;
+    }
+    std::cout << "States differ, first in " << difference << std::endl;
+    return -1;
+}
+
+// Play a replay to the end as fast as possible, checking its state hashes, then time
+// seeking to every turn
+static int PlayReplay(const std::string& path, int dumpStep, const std::string& dumpPath) {
+    ReplayData replay;
+    if (!replay.LoadFromFile(path)) {
+        return -1;
+    }
+
+    std::string mapFolder = replay.mapFolder;
+    Terrain mapTerrain;
+    LoadMapTerrain(mapTerrain, mapFolder);
+    mapTerrain.BuildFreeSpaceMask(SkillOrb::DEFAULT_RADIUS);
+
+    ReplayPlayer player;
+    if (!player.Load(replay, mapTerrain)) {
+        return -1;
+    }
+    if (dumpStep >= 0) {
+        return DumpReplayStep(player, dumpStep, dumpPath) ? 0 : -1;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    player.RunToEnd();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    double simulated = player.GetStep() * Match::STEP_DURATION;
+
+    const Match& match = player.GetMatch();
+    int winnerId = match.GetWinnerId();
+    int finalStep = player.GetStep();
+    std::cout << "Replay " << path << ": " << player.GetStep() << " steps, " << match.GetTurnCounter() + 1
+              << " turns, winner " << match.GetWinnerId() << " (recorded " << replay.winnerId << ")" << std::endl;
+    std::cout << "Played " << simulated << "s of match in " << seconds << "s ("
+              << (seconds > 0.0 ? simulated / seconds : 0.0) << "x real time), "
+              << player.GetKeyframeCount() << " keyframes" << std::endl;
+
+    std::cout << "State hashes: " << player.GetCheckedHashCount() << " of " << replay.stateHashes.size()
+              << " checkpoints verified in " << player.GetHashMs() << "ms ("
+              << (seconds > 0.0 ? player.GetHashMs() / (seconds * 10.0) : 0.0) << "% of playback)" << std::endl;
+    if (player.GetMismatchStep() >= 0) {
+        std::string dump = path + ".step" + std::to_string(player.GetMismatchStep()) + ".txt";
+        std::cerr << "State differs from the recording after step " << player.GetMismatchStep()
+                  << "; compare " << dump << " with a dump from the recording machine (--dump-step)" << std::endl;
+        DumpReplayStep(player, player.GetMismatchStep(), dump);
+        return -1;
+    }
+
+    // Seek backwards through every turn (worst case for a scrubbing viewer)
+    double worstMs = 0.0;
+    double totalMs = 0.0;
+    int turns = match.GetTurnCounter() + 1;
+    for (int turn = turns - 1; turn >= 0; --turn) {
+        auto seekStart = std::chrono::steady_clock::now();
+        player.SeekToTurn(turn);
+        player.SeekToStep(player.GetStep() + ReplayPlayer::KEYFRAME_INTERVAL - 1); // Mid-turn
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - seekStart).count();
+        worstMs = std::max(worstMs, ms);
+        totalMs += ms;
+    }
+    std::cout << "Seek: " << (turns > 0 ? totalMs / turns : 0.0) << "ms average, " << worstMs << "ms worst" << std::endl;
+
+    // Playing on after all that seeking must end exactly like the recording
+    player.RunToEnd();
+    if (winnerId != replay.winnerId || match.GetWinnerId() != winnerId || player.GetStep() != finalStep) {
+        std::cerr << "Replay diverged from the recorded result!" << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
+// Bot matches between two rollback sessions over a simulated link, one after another
+// With an injected desync every match must report it instead
+static int RunNetplayTest(const Terrain& mapTerrain, const MatchConfig& config, const LinkConditions& conditions,
+    int inputDelay, int matchCount, unsigned int baseSeed, int maxSteps, int injectDesyncFrame) {
+    std::cout << "Netplay test: " << matchCount << " matches, RTT " << conditions.latencyMs * 2.0 << "ms +-"
+              << conditions.jitterMs << "ms, " << conditions.lossRate * 100.0 << "% loss, input delay "
+              << inputDelay << " frames" << std::endl;
+
+    NetplayHarness harness(mapTerrain, config, conditions);
+    harness.SetInputDelay(inputDelay);
+    harness.SetMaxFrames(maxSteps);
+    harness.SetInjectDesyncFrame(injectDesyncFrame);
+
+    int desyncs = 0;
+    int detected = 0;
+    long long hashesCompared = 0;
+    long long frames = 0;
+    long long rollbacks = 0;
+    long long resimulatedFrames = 0;
+    long long stallFrames = 0;
+    int maxDepth = 0;
+    double resimulationMs = 0.0;
+    double maxResimulationMs = 0.0;
+    for (int i = 0; i < matchCount; ++i) {
+        unsigned int seed = baseSeed + static_cast<unsigned int>(i);
+        NetplayHarnessResult result = harness.PlayMatch(seed);
+
+        std::cout << "match " << i << " seed " << seed << (result.inSync ? " in sync" : " DESYNC")
+                  << " frames " << result.frames << " rollbacks " << result.rollbacks
+                  << " max depth " << result.maxRollbackDepth << " stalls " << result.stallFrames
+                  << " resim " << result.resimulationMs << "ms" << std::endl;
+        if (result.desyncFrame >= 0) {
+            std::cout << "  desync reported at frame " << result.desyncFrame << ": " << result.desyncDifference
+                      << " differs" << std::endl;
+        }
+
+        desyncs += result.inSync ? 0 : 1;
+        detected += result.desyncFrame >= 0 ? 1 : 0;
+        hashesCompared += result.hashesCompared;
+        frames += result.frames;
+        rollbacks += result.rollbacks;
+        resimulatedFrames += result.resimulatedFrames;
+        stallFrames += result.stallFrames;
+        maxDepth = std::max(maxDepth, result.maxRollbackDepth);
+        resimulationMs += result.resimulationMs;
+        maxResimulationMs = std::max(maxResimulationMs, result.maxResimulationMs);
+    }
+
+    // Both peers count: per peer-frame figures
+    double peerFrames = static_cast<double>(std::max(1LL, frames * 2));
+    std::cout << "Rollbacks: " << rollbacks << " (" << rollbacks * 1000.0 / peerFrames << " per 1000 frames), average depth "
+              << (rollbacks > 0 ? static_cast<double>(resimulatedFrames) / rollbacks : 0.0) << ", max depth " << maxDepth
+              << std::endl;
+    std::cout << "Re-simulation: " << (rollbacks > 0 ? resimulationMs / rollbacks : 0.0) << "ms average, "
+              << maxResimulationMs << "ms worst, " << resimulationMs * 1000.0 / peerFrames << "us per frame overall" << std::endl;
+    std::cout << "Stalls: " << stallFrames << " frames (" << stallFrames * 100.0 / peerFrames << "%), desyncs: "
+              << desyncs << std::endl;
+    std::cout << "State hashes: " << hashesCompared << " compared, " << detected << " desyncs reported" << std::endl;
+    if (injectDesyncFrame >= 0) {
+        return detected == matchCount ? 0 : -1;
+    }
+    return desyncs == 0 && detected == 0 ? 0 : -1;
+}
+
+// Every viewer is a socket; the default descriptor limit is often 1024
+static void RaiseSocketLimit(int viewerCount) {
+#ifndef _WIN32
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        rlim_t wanted = static_cast<rlim_t>(viewerCount) * 2 + 64;
+        if (limit.rlim_cur < wanted) {
+            limit.rlim_cur = std::min(wanted, limit.rlim_max);
+            setrlimit(RLIMIT_NOFILE, &limit);
+        }
+    }
+#endif
+}
+
+// Play bot matches in real time and stream them to whoever connects
+static int RunSpectateServer(const Terrain& mapTerrain, const MatchConfig& config, Uint16 port, int matchCount,
+    unsigned int baseSeed, int maxSteps) {
+    RaiseSocketLimit(SpectatorServer::MAX_VIEWERS);
+    SpectatorServer server;
+    if (!server.Listen(port)) {
+        return -1;
+    }
+    std::cout << "Streaming " << matchCount << " bot matches to spectators on port " << port << std::endl;
+
+    const auto tickDuration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(Match::STEP_DURATION));
+    auto nextTick = std::chrono::steady_clock::now();
+    for (int i = 0; i < matchCount; ++i) {
+        unsigned int seed = baseSeed + static_cast<unsigned int>(i);
+        Match match;
+        match.SetSeed(seed);
+        match.Initialize(mapTerrain, config);
+        MatchBot bot(seed);
+
+        // Keep showing the result for a few seconds before the next match
+        int endTicks = 0;
+        while (endTicks < 180) {
+            if (match.IsEnded() || match.GetStepCount() >= maxSteps) {
+                endTicks++;
+            } else {
+                match.Step(bot.Think(match));
+            }
+            server.Broadcast(match);
+
+            nextTick += tickDuration;
+            std::this_thread::sleep_until(nextTick);
+        }
+
+        const SpectatorServerStats& stats = server.GetStats();
+        std::cout << "match " << i << " seed " << seed << " winner " << match.GetWinnerId() << ", "
+                  << server.GetViewerCount() << " viewers, " << stats.bytesSent / 1024 << " KB sent" << std::endl;
+    }
+    return 0;
+}
+
+// One bot match streamed to many local stand-in viewers, timing the server side of every tick
+static int RunSpectateTest(const Terrain& mapTerrain, const MatchConfig& config, int viewerCount, Uint16 port,
+    unsigned int seed, int maxSteps) {
+    RaiseSocketLimit(viewerCount);
+    SpectatorServer server;
+    if (!server.Listen(port)) {
+        return -1;
+    }
+
+    Match match;
+    match.SetSeed(seed);
+    match.Initialize(mapTerrain, config);
+    MatchBot bot(seed);
+
+    // Every Nth viewer decodes the stream and is checked against the server's view
+    const int decodeEvery = 50;
+    std::vector<std::unique_ptr<SpectatorClient>> viewers;
+    for (int i = 0; i < viewerCount; ++i) {
+        std::unique_ptr<SpectatorClient> viewer = std::make_unique<SpectatorClient>();
+        if (!viewer->Connect("127.0.0.1", port)) {
+            std::cerr << "Viewer " << i << " could not connect" << std::endl;
+            return -1;
+        }
+        viewer->SetDecoding(i % decodeEvery == 0);
+        viewers.push_back(std::move(viewer));
+
+        // Accept in batches so the listen backlog never overflows
+        if (i % 64 == 63) {
+            server.Broadcast(match);
+        }
+    }
+    server.Broadcast(match);
+    std::cout << "Spectate test: " << server.GetViewerCount() << " of " << viewerCount << " viewers connected" << std::endl;
+
+    SpectatorServerStats joinStats = server.GetStats();
+    int lostViewers = 0;
+    auto pollViewers = [&]() {
+        for (auto& viewer : viewers) {
+            if (viewer && !viewer->Poll()) {
+                viewer.reset();
+                lostViewers++;
+            }
+        }
+    };
+    pollViewers();
+
+    // The match itself; client reads are not part of the server's tick
+    const double tickBudgetMs = Match::STEP_DURATION * 1000.0;
+    double maxDeltaMs = 0.0;
+    long long maxDeltaBytes = 0;
+    int ticks = 0;
+    int ticksOverBudget = 0;
+    while (!match.IsEnded() && match.GetStepCount() < maxSteps) {
+        match.Step(bot.Think(match));
+
+        long long deltaBytesBefore = server.GetStats().deltaBytes;
+        auto tickStart = std::chrono::steady_clock::now();
+        server.Broadcast(match);
+        double tickMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tickStart).count();
+        maxDeltaMs = std::max(maxDeltaMs, tickMs);
+        ticksOverBudget += (tickMs > tickBudgetMs) ? 1 : 0;
+        maxDeltaBytes = std::max(maxDeltaBytes, server.GetStats().deltaBytes - deltaBytesBefore);
+        ticks++;
+
+        pollViewers();
+    }
+
+    // Let the last frames drain
+    for (int i = 0; i < 30; ++i) {
+        server.Broadcast(match);
+        pollViewers();
+    }
+
+    // Decoding viewers must hold exactly the server's view, and the view must match the
+    // simulation up to the stream's resolution
+    std::vector<Uint8> serverView;
+    MatchSnapshot::Write(server.GetEncoder().GetView(), serverView);
+    int decoding = 0;
+    int inSync = 0;
+    for (const auto& viewer : viewers) {
+        if (!viewer || !viewer->IsDecoding()) continue;
+        decoding++;
+        std::vector<Uint8> viewerView;
+        MatchSnapshot::Write(viewer->GetDecoder().GetView(), viewerView);
+        inSync += (viewerView == serverView) ? 1 : 0;
+    }
+
+    MatchState actual;
+    match.SaveState(actual);
+    const MatchState& view = server.GetEncoder().GetView();
+    float maxError = 0.0f;
+    bool viewMatches = actual.players.size() == view.players.size() && actual.craters.size() == view.craters.size() &&
+        actual.projectiles.size() == view.projectiles.size() && actual.turnCounter == view.turnCounter &&
+        actual.winnerId == view.winnerId;
+    for (size_t i = 0; viewMatches && i < actual.players.size(); ++i) {
+        maxError = std::max(maxError, std::fabs(actual.players[i].position.x - view.players[i].position.x));
+        maxError = std::max(maxError, std::fabs(actual.players[i].position.y - view.players[i].position.y));
+        viewMatches = actual.players[i].health == view.players[i].health;
+    }
+    viewMatches = viewMatches && maxError <= 0.5f / SpectatorEncoder::POSITION_SCALE;
+
+    const SpectatorServerStats& stats = server.GetStats();
+    double serverMs = stats.encodeMs + stats.sendMs - joinStats.encodeMs - joinStats.sendMs;
+    long long deltaBytes = stats.deltaBytes - joinStats.deltaBytes;
+    std::cout << "Broadcast " << ticks << " ticks: " << (ticks > 0 ? serverMs / ticks : 0.0) << "ms average ("
+              << (ticks > 0 ? serverMs / ticks * 100.0 / tickBudgetMs : 0.0) << "% of a tick), " << maxDeltaMs
+              << "ms worst, " << ticksOverBudget << " over budget; encode " << (stats.ticks > 0 ? stats.encodeMs * 1000.0 / stats.ticks : 0.0)
+              << "us per tick" << std::endl;
+    std::cout << "Stream: delta " << (ticks > 0 ? static_cast<double>(deltaBytes) / ticks : 0.0) << " bytes average, "
+              << maxDeltaBytes << " worst, keyframe " << (stats.keyframes > 0 ? stats.keyframeBytes / stats.keyframes : 0)
+              << " bytes, " << stats.bytesSent / (1024 * 1024) << " MB sent to all viewers" << std::endl;
+    std::cout << "Viewers: " << server.GetViewerCount() << " connected, " << lostViewers << " lost, "
+              << stats.resyncs << " resyncs; " << inSync << " of " << decoding << " decoding viewers in sync, view "
+              << (viewMatches ? "matches" : "DIFFERS FROM") << " the match (max position error " << maxError << "px)"
+              << std::endl;
+
+    bool passed = lostViewers == 0 && inSync == decoding && viewMatches;
+    return passed ? 0 : -1;
+}
+
+// Scripted scenarios on every map, one at a time on this thread; optionally saved as the
+// next baseline and gated against the previous one
+static int RunScenarios(const std::string& onlyScenario, const std::string& mapFolder, int repeats, int maxSteps,
+    const std::string& baselinePath, const std::string& savePath, double thresholdPercent) {
+    std::vector<ScenarioResult> baseline;
+    double baselinePeakMemoryMB = 0.0;
+    if (!baselinePath.empty() && !ScenarioRunner::LoadResults(baselinePath, baseline, baselinePeakMemoryMB)) {
+        return -1;
+    }
+
+    std::vector<std::string> mapFolders;
+    if (!mapFolder.empty()) {
+        mapFolders.push_back(mapFolder);
+    } else {
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator("maps", error)) {
+            if (std::filesystem::exists(entry.path() / "terrain.png")) {
+                mapFolders.push_back(entry.path().string());
+            }
+        }
+        std::sort(mapFolders.begin(), mapFolders.end());
+    }
+    if (mapFolders.empty()) {
+        std::cerr << "No maps found (run from the repository root or pass --map)" << std::endl;
+        return -1;
+    }
+
+    ScenarioRunner runner;
+    runner.SetRepeats(repeats);
+    runner.SetMaxSteps(maxSteps);
+
+    std::vector<ScenarioResult> results;
+    for (const std::string& folder : mapFolders) {
+        Terrain mapTerrain;
+        if (!mapTerrain.LoadFromImage(folder + "/terrain.png")) {
+            std::cerr << "Failed to load map " << folder << std::endl;
+            return -1;
+        }
+        mapTerrain.BuildFreeSpaceMask(SkillOrb::DEFAULT_RADIUS);
+        std::string mapName = std::filesystem::path(folder).filename().string();
+
+        // Against a baseline, replay its shot counts so both sides time the same games
+        std::vector<Scenario> scenarios;
+        std::vector<int> shots;
+        for (const Scenario& scenario : ScenarioRunner::GetScenarios()) {
+            if (!onlyScenario.empty() && scenario.name != onlyScenario) continue;
+
+            auto previous = std::find_if(baseline.begin(), baseline.end(), [&](const ScenarioResult& entry) {
+                return entry.scenario == scenario.name && entry.map == mapName;
+            });
+            scenarios.push_back(scenario);
+            shots.push_back(previous != baseline.end() ? previous->shots : 0);
+        }
+
+        for (const ScenarioResult& result : runner.Run(scenarios, shots, mapName, mapTerrain)) {
+            std::cout << result.scenario << " on " << mapName << ": " << result.matches << " matches, " << result.shots
+                      << " shots, " << result.steps << " steps, " << static_cast<int>(result.stepsPerSecond)
+                      << " steps/s, step p50 " << result.stepP50Us << "us p99 " << result.stepP99Us << "us, "
+                      << result.craters << " craters at " << result.craterUs << "us" << std::endl;
+            results.push_back(result);
+        }
+    }
+    if (results.empty()) {
+        std::cerr << "No scenario named " << onlyScenario << std::endl;
+        return -1;
+    }
+    double peakMemoryMB = ScenarioRunner::GetPeakMemoryMB();
+    std::cout << "Peak memory of the run: " << peakMemoryMB << " MB" << std::endl;
+
+    if (!savePath.empty() && !ScenarioRunner::SaveResults(savePath, results, peakMemoryMB)) {
+        return -1;
+    }
+    if (baselinePath.empty()) {
+        return 0;
+    }
+
+    std::cout << "Against " << baselinePath << " (threshold " << thresholdPercent << "%):" << std::endl;
+    int regressions = ScenarioRunner::CompareToBaseline(results, peakMemoryMB, baseline, baselinePeakMemoryMB, thresholdPercent);
+    std::cout << (regressions == 0 ? "No regressions" : std::to_string(regressions) + " regressions") << std::endl;
+    return regressions == 0 ? 0 : -1;
+}
+
+int main(int argc, char* argv[]) {
+    int matchCount = 100;
+    int workerCount = 0; // One per hardware thread
+    int maxSteps = MatchServer::DEFAULT_MAX_STEPS;
+    unsigned int baseSeed = 1;
+    std::string mapFolder;
+    std::string recordFolder;
+    std::string tracePath;
+    std::string metricsName;
+    MatchConfig config;
+    bool netplayTest = false;
+    LinkConditions conditions;
+    int inputDelay = NetplaySetup::DEFAULT_INPUT_DELAY;
+    int spectatePort = 0;
+    int spectateTestViewers = 0;
+    int port = 40300;
+    int injectDesyncFrame = -1;
+    std::string replayPath;
+    int dumpStep = -1;
+    std::string dumpPath;
+    bool scenarios = false;
+    std::string scenarioName;
+    int repeats = ScenarioRunner::DEFAULT_REPEATS;
+    std::string baselinePath;
+    std::string saveBaselinePath;
+    double thresholdPercent = ScenarioRunner::DEFAULT_THRESHOLD_PERCENT;
+
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--matches") == 0 && hasValue) {
+            matchCount = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--players") == 0 && hasValue) {
+            config.numPlayers = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--mode") == 0 && hasValue) {
+            std::string mode = argv[++i];
+            config.gameMode = (mode == "teams") ? GameMode::TEAM_2V2 : GameMode::FREE_FOR_ALL;
+        } else if (std::strcmp(argv[i], "--map") == 0 && hasValue) {
+            mapFolder = argv[++i];
+        } else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+            baseSeed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--workers") == 0 && hasValue) {
+            workerCount = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-steps") == 0 && hasValue) {
+            maxSteps = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--record") == 0 && hasValue) {
+            recordFolder = argv[++i];
+        } else if (std::strcmp(argv[i], "--metrics") == 0) {
+            metricsName = hasValue && argv[i + 1][0] != '-' ? argv[++i] : LiveMetricsPublisher::DEFAULT_NAME;
+        } else if (std::strcmp(argv[i], "--trace") == 0 && hasValue) {
+            tracePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--replay") == 0 && hasValue) {
+            replayPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--dump-step") == 0 && i + 2 < argc) {
+            dumpStep = std::atoi(argv[++i]);
+            dumpPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--compare-dumps") == 0 && i + 2 < argc) {
+            return CompareDumps(argv[i + 1], argv[i + 2]);
+        } else if (std::strcmp(argv[i], "--inject-desync") == 0 && hasValue) {
+            injectDesyncFrame = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--netplay-test") == 0) {
+            netplayTest = true;
+        } else if (std::strcmp(argv[i], "--rtt") == 0 && hasValue) {
+            conditions.latencyMs = std::atof(argv[++i]) / 2.0;
+        } else if (std::strcmp(argv[i], "--jitter") == 0 && hasValue) {
+            conditions.jitterMs = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--loss") == 0 && hasValue) {
+            conditions.lossRate = std::atof(argv[++i]) / 100.0;
+        } else if (std::strcmp(argv[i], "--delay") == 0 && hasValue) {
+            inputDelay = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--spectate") == 0 && hasValue) {
+            spectatePort = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--spectate-test") == 0 && hasValue) {
+            spectateTestViewers = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--turbo") == 0) {
+            config.skipImpactDelay = true;
+        } else if (std::strcmp(argv[i], "--port") == 0 && hasValue) {
+            port = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--scenarios") == 0) {
+            scenarios = true;
+            if (hasValue && argv[i + 1][0] != '-') scenarioName = argv[++i];
+        } else if (std::strcmp(argv[i], "--repeats") == 0 && hasValue) {
+            repeats = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--baseline") == 0 && hasValue) {
+            baselinePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--save-baseline") == 0 && hasValue) {
+            saveBaselinePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--threshold") == 0 && hasValue) {
+            thresholdPercent = std::atof(argv[++i]);
+        } else {
+            PrintUsage();
+            return -1;
+        }
+    }
+
+    if (!replayPath.empty()) {
+        return PlayReplay(replayPath, dumpStep, dumpPath);
+    }
+    if (scenarios) {
+        return RunScenarios(scenarioName, mapFolder, repeats, maxSteps, baselinePath, saveBaselinePath, thresholdPercent);
+    }
+
+    // Teams alternate by slot, so they need an even player count
+    if (config.gameMode == GameMode::TEAM_2V2 && config.numPlayers % 2 != 0) {
+        config.numPlayers++;
+    }
+
+    // Load the map once; every match shares its pixels until it destroys terrain
+    Terrain mapTerrain;
+    LoadMapTerrain(mapTerrain, mapFolder);
+    mapTerrain.BuildFreeSpaceMask(SkillOrb::DEFAULT_RADIUS);
+
+    if (netplayTest) {
+        return RunNetplayTest(mapTerrain, config, conditions, inputDelay, matchCount, baseSeed, maxSteps, injectDesyncFrame);
+    }
+    if (spectatePort > 0) {
+        return RunSpectateServer(mapTerrain, config, static_cast<Uint16>(spectatePort), matchCount, baseSeed, maxSteps);
+    }
+    if (spectateTestViewers > 0) {
+        return RunSpectateTest(mapTerrain, config, spectateTestViewers, static_cast<Uint16>(port), baseSeed, maxSteps);
+    }
+
+    Profiler::SetThreadName("Server main");
+    if (!tracePath.empty() && !Profiler::StartTrace(tracePath)) {
+        return -1;
+    }
+
+    JobSystem jobSystem;
+    if (!jobSystem.Initialize(workerCount)) {
+        std::cerr << "Failed to start job system!" << std::endl;
+        Profiler::StopTrace();
+        return -1;
+    }
+
+    std::cout << "Bally match server: " << matchCount << " matches, " << config.numPlayers << " players, "
+              << (jobSystem.GetWorkerCount() + 1) << " threads" << std::endl;
+
+    MatchServer server(jobSystem, mapTerrain, config);
+    server.SetMaxSteps(maxSteps);
+    if (!recordFolder.empty()) {
+        std::error_code error;
+        std::filesystem::create_directories(recordFolder, error);
+        server.SetRecording(recordFolder, mapFolder);
+    }
+
+    std::mutex outputMutex;
+    long long totalSteps = 0;
+    int draws = 0;
+    server.SetOnResult([&](const MatchResult& result) {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        totalSteps += result.steps;
+
+        std::cout << "match " << result.matchIndex << " seed " << result.seed;
+        if (!result.finished) {
+            draws++;
+            std::cout << " draw";
+        } else if (config.gameMode == GameMode::TEAM_2V2) {
+            std::cout << " winner team " << (result.winnerId == -2 ? 2 : 1);
+        } else if (result.winnerId >= 0) {
+            std::cout << " winner player " << (result.winnerId + 1);
+        } else {
+            std::cout << " no survivors";
+        }
+        std::cout << " turns " << result.turns << " steps " << result.steps << " damage "
+                  << static_cast<int>(result.damageDealt) << " explosions " << result.explosions << " orbs "
+                  << result.orbsCollected << " time " << result.wallSeconds << "s" << std::endl;
+    });
+
+    // Publish progress from a thread of its own; every core is busy playing matches
+    LiveMetricsPublisher metricsPublisher;
+    std::atomic<bool> publishing(false);
+    std::thread metricsThread;
+    if (!metricsName.empty() && metricsPublisher.Open(metricsName)) {
+        publishing = true;
+        metricsThread = std::thread([&]() {
+            while (publishing.load(std::memory_order_relaxed)) {
+                LiveMetrics metrics;
+                metrics.stepsTotal = server.GetStepsPlayed();
+                metrics.cratersTotal = Terrain::GetCratersCutTotal();
+                metrics.matchesRunning = static_cast<Uint32>(server.GetMatchesRunning());
+                metrics.matchesFinished = static_cast<Uint32>(server.GetMatchesFinished());
+                metricsPublisher.Publish(metrics);
+                std::this_thread::sleep_for(std::chrono::milliseconds(METRICS_INTERVAL_MS));
+            }
+        });
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    server.Run(matchCount, baseSeed);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::cout << "Finished " << matchCount << " matches (" << draws << " draws) in " << seconds << "s: "
+              << (seconds > 0.0 ? matchCount / seconds : 0.0) << " matches/s, "
+              << (seconds > 0.0 ? totalSteps / seconds : 0.0) << " steps/s" << std::endl;
+
+    if (metricsThread.joinable()) {
+        publishing = false;
+        metricsThread.join();
+    }
+
+    jobSystem.Shutdown();
+    Profiler::StopTrace();
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "SpectatorClient.h"
+#include "SocketPlatform.h"
+#include <cstring>
+#include <iostream>
+
+SpectatorClient::SpectatorClient()
+    : m_socket(-1), m_bufferUsed(0), m_decoding(false), m_bytesReceived(0), m_framesReceived(0), m_keyframesReceived(0) {
+}
+
+SpectatorClient::~SpectatorClient() {
+    Close();
+}
+
+bool SpectatorClient::Connect(const std::string& host, Uint16 port) {
+    Close();
+    if (!StartSockets()) {
+        std::cerr << "Failed to start Winsock" << std::endl;
+        return false;
+    }
+
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &result) != 0 || !result) {
+        std::cerr << "Failed to resolve " << host << std::endl;
+        StopSockets();
+        return false;
+    }
+
+    SocketHandle handle = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+    bool connected = handle != NO_SOCKET &&
+        connect(handle, result->ai_addr, static_cast<SocketLength>(result->ai_addrlen)) == 0;
+    freeaddrinfo(result);
+    if (!connected) {
+        std::cerr << "Failed to connect to " << host << ":" << port << std::endl;
+        if (handle != NO_SOCKET) CloseSocket(handle);
+        StopSockets();
+        return false;
+    }
+
+    SetNonBlocking(handle);
+    m_socket = static_cast<long long>(handle);
+    return true;
+}
+
+void SpectatorClient::Close() {
+    if (m_socket < 0) return;
+
+    CloseSocket(ToSocket(m_socket));
+    m_socket = -1;
+    m_bufferUsed = 0;
+    StopSockets();
+}
+
+bool SpectatorClient::Poll() {
+    if (m_socket < 0) return false;
+
+    for (;;) {
+        if (m_buffer.size() < m_bufferUsed + READ_SIZE) {
+            m_buffer.resize(m_bufferUsed + READ_SIZE);
+        }
+        int received = static_cast<int>(recv(ToSocket(m_socket),
+            reinterpret_cast<char*>(m_buffer.data() + m_bufferUsed), static_cast<int>(READ_SIZE), 0));
+        if (received == 0) return false;
+        if (received < 0) {
+            if (SocketWouldBlock()) break;
+            return false;
+        }
+        m_bufferUsed += static_cast<size_t>(received);
+        m_bytesReceived += received;
+    }
+
+    // Consume every complete frame; keep the partial one for the next poll
+    size_t offset = 0;
+    size_t frameSize = 0;
+    while (SpectatorDecoder::PeekFrameSize(m_buffer.data() + offset, m_bufferUsed - offset, frameSize)) {
+        if (frameSize < SpectatorDecoder::HEADER_SIZE || frameSize > SpectatorDecoder::MAX_FRAME_SIZE) {
+            return false;
+        }
+        if (m_bufferUsed - offset < frameSize) break;
+
+        const Uint8* frame = m_buffer.data() + offset;
+        if (frame[4] == static_cast<Uint8>(SpectatorFrameType::KEYFRAME)) {
+            m_keyframesReceived++;
+        }
+        if (m_decoding && !m_decoder.ApplyFrame(frame, frameSize)) {
+            return false;
+        }
+        m_framesReceived++;
+        offset += frameSize;
+    }
+
+    if (offset > 0) {
+        std::memmove(m_buffer.data(), m_buffer.data() + offset, m_bufferUsed - offset);
+        m_bufferUsed -= offset;
+    }
+    return true;
+}
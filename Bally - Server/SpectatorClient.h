@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <SDL3/SDL.h>
+#include "SpectatorStream.h"
+
+// Stand-in spectator for load tests: reads the stream and splits it into frames.
+// Decoding is optional so a thousand of them can share one core with the server.
+class SpectatorClient {
+public:
+    SpectatorClient();
+    ~SpectatorClient();
+
+    bool Connect(const std::string& host, Uint16 port);
+    void Close();
+
+    // Read whatever has arrived; false once the connection is gone or the stream is corrupt
+    bool Poll();
+
+    void SetDecoding(bool decoding) { m_decoding = decoding; }
+    bool IsDecoding() const { return m_decoding; }
+    const SpectatorDecoder& GetDecoder() const { return m_decoder; }
+
+    long long GetBytesReceived() const { return m_bytesReceived; }
+    int GetFramesReceived() const { return m_framesReceived; }
+    int GetKeyframesReceived() const { return m_keyframesReceived; }
+
+private:
+    long long m_socket;
+    std::vector<Uint8> m_buffer;
+    size_t m_bufferUsed;
+    SpectatorDecoder m_decoder;
+    bool m_decoding;
+    long long m_bytesReceived;
+    int m_framesReceived;
+    int m_keyframesReceived;
+
+    static constexpr size_t READ_SIZE = 16 * 1024;
+};
@@ -0,0 +1,188 @@
+#include "SpectatorServer.h"
+#include "SocketPlatform.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+SpectatorServer::SpectatorServer() : m_listenSocket(-1) {
+    std::memset(&m_stats, 0, sizeof(m_stats));
+}
+
+SpectatorServer::~SpectatorServer() {
+    Close();
+}
+
+bool SpectatorServer::Listen(Uint16 port) {
+    Close();
+    if (!StartSockets()) {
+        std::cerr << "Failed to start Winsock" << std::endl;
+        return false;
+    }
+
+    SocketHandle handle = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (handle == NO_SOCKET) {
+        std::cerr << "Failed to create TCP socket" << std::endl;
+        StopSockets();
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (bind(handle, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(handle, SOMAXCONN) != 0) {
+        std::cerr << "Failed to listen on TCP port " << port << std::endl;
+        CloseSocket(handle);
+        StopSockets();
+        return false;
+    }
+
+    SetNonBlocking(handle);
+    m_listenSocket = static_cast<long long>(handle);
+    return true;
+}
+
+void SpectatorServer::Close() {
+    if (m_listenSocket < 0) return;
+
+    for (Viewer& viewer : m_viewers) {
+        CloseSocket(ToSocket(viewer.socket));
+    }
+    m_viewers.clear();
+    CloseSocket(ToSocket(m_listenSocket));
+    m_listenSocket = -1;
+    StopSockets();
+}
+
+void SpectatorServer::Broadcast(const Match& match) {
+    if (m_listenSocket < 0) return;
+
+    auto tickStart = std::chrono::steady_clock::now();
+    AcceptViewers();
+
+    // Encode once for everybody
+    match.SaveState(m_state);
+    SharedFrame delta;
+    SharedFrame keyframe;
+    if (m_encoder.EncodeDelta(m_state, m_deltaFrame)) {
+        m_stats.deltaBytes += static_cast<long long>(m_deltaFrame.size());
+        delta = std::make_shared<const std::vector<Uint8>>(m_deltaFrame);
+    }
+    else {
+        // New match or rebuilt terrain: everyone restarts from a keyframe
+        std::vector<Uint8> frame;
+        m_encoder.EncodeKeyframe(m_state, frame);
+        m_stats.keyframes++;
+        m_stats.keyframeBytes += static_cast<long long>(frame.size());
+        keyframe = std::make_shared<const std::vector<Uint8>>(std::move(frame));
+        for (Viewer& viewer : m_viewers) {
+            viewer.needsKeyframe = true;
+        }
+    }
+    auto encodeEnd = std::chrono::steady_clock::now();
+
+    for (Viewer& viewer : m_viewers) {
+        if (viewer.needsKeyframe) {
+            // Joiners and resyncs share one keyframe of the view this delta led to
+            if (!keyframe) {
+                std::vector<Uint8> frame;
+                m_encoder.EncodeViewKeyframe(frame);
+                m_stats.keyframes++;
+                m_stats.keyframeBytes += static_cast<long long>(frame.size());
+                keyframe = std::make_shared<const std::vector<Uint8>>(std::move(frame));
+            }
+            viewer.needsKeyframe = false;
+            Enqueue(viewer, keyframe);
+        }
+        else if (delta) {
+            Enqueue(viewer, delta);
+        }
+        Flush(viewer);
+    }
+    DropClosedViewers();
+
+    auto tickEnd = std::chrono::steady_clock::now();
+    double encodeMs = std::chrono::duration<double, std::milli>(encodeEnd - tickStart).count();
+    double tickMs = std::chrono::duration<double, std::milli>(tickEnd - tickStart).count();
+    m_stats.ticks++;
+    m_stats.encodeMs += encodeMs;
+    m_stats.sendMs += tickMs - encodeMs;
+    m_stats.maxTickMs = std::max(m_stats.maxTickMs, tickMs);
+}
+
+void SpectatorServer::AcceptViewers() {
+    while (static_cast<int>(m_viewers.size()) < MAX_VIEWERS) {
+        SocketHandle handle = accept(ToSocket(m_listenSocket), nullptr, nullptr);
+        if (handle == NO_SOCKET) break;
+
+        SetNonBlocking(handle);
+        int noDelay = 1;
+        setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+
+        Viewer viewer;
+        viewer.socket = static_cast<long long>(handle);
+        viewer.sentOfFront = 0;
+        viewer.queuedBytes = 0;
+        viewer.needsKeyframe = true;
+        viewer.closed = false;
+        m_viewers.push_back(std::move(viewer));
+        m_stats.viewersJoined++;
+    }
+}
+
+void SpectatorServer::Enqueue(Viewer& viewer, const SharedFrame& frame) {
+    if (viewer.queuedBytes + frame->size() > MAX_QUEUED_BYTES) {
+        // Too far behind: finish the frame on the wire, skip the rest, catch up with a keyframe
+        while (viewer.queue.size() > (viewer.sentOfFront > 0 ? 1u : 0u)) {
+            viewer.queue.pop_back();
+        }
+        viewer.queuedBytes = viewer.queue.empty() ? 0 : viewer.queue.front()->size() - viewer.sentOfFront;
+        m_stats.resyncs++;
+
+        bool isKeyframe = (*frame)[4] == static_cast<Uint8>(SpectatorFrameType::KEYFRAME);
+        if (!isKeyframe) {
+            viewer.needsKeyframe = true;
+            return;
+        }
+    }
+
+    viewer.queue.push_back(frame);
+    viewer.queuedBytes += frame->size();
+}
+
+void SpectatorServer::Flush(Viewer& viewer) {
+    while (!viewer.queue.empty()) {
+        const std::vector<Uint8>& frame = *viewer.queue.front();
+        size_t remaining = frame.size() - viewer.sentOfFront;
+        int sent = static_cast<int>(send(ToSocket(viewer.socket),
+            reinterpret_cast<const char*>(frame.data() + viewer.sentOfFront), static_cast<int>(remaining), SEND_FLAGS));
+        if (sent < 0) {
+            if (!SocketWouldBlock()) {
+                viewer.closed = true;
+            }
+            return;
+        }
+
+        m_stats.bytesSent += sent;
+        viewer.queuedBytes -= static_cast<size_t>(sent);
+        viewer.sentOfFront += static_cast<size_t>(sent);
+        if (viewer.sentOfFront < frame.size()) return; // Socket buffer full
+
+        viewer.queue.pop_front();
+        viewer.sentOfFront = 0;
+    }
+}
+
+void SpectatorServer::DropClosedViewers() {
+    auto firstClosed = std::remove_if(m_viewers.begin(), m_viewers.end(), [](const Viewer& viewer) { return viewer.closed; });
+    for (auto it = firstClosed; it != m_viewers.end(); ++it) {
+        CloseSocket(ToSocket(it->socket));
+        m_stats.viewersLeft++;
+    }
+    m_viewers.erase(firstClosed, m_viewers.end());
+}
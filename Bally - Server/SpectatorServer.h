@@ -0,0 +1,70 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+#include <SDL3/SDL.h>
+#include "Match.h"
+#include "SpectatorStream.h"
+
+struct SpectatorServerStats {
+    long long ticks;
+    long long deltaBytes;     // Encoded once per tick, whatever the viewer count
+    long long keyframeBytes;
+    long long keyframes;      // Encoded keyframes (restarts, joins and resyncs share one per tick)
+    long long bytesSent;      // To all viewers together
+    long long resyncs;        // Viewers that fell too far behind and were sent a keyframe
+    long long viewersJoined;
+    long long viewersLeft;
+    double encodeMs;
+    double sendMs;
+    double maxTickMs;
+};
+
+// Streams one match to many spectators over TCP.
+// Each tick the match is encoded once: a delta for every viewer that is in step, and at
+// most one keyframe shared by everyone who joined or fell behind. Viewers only queue
+// references to those buffers, so a viewer costs a send() call, not an encode.
+class SpectatorServer {
+public:
+    SpectatorServer();
+    ~SpectatorServer();
+
+    bool Listen(Uint16 port);
+    void Close();
+
+    // Accept new viewers, encode the match and send to everyone; call once per tick
+    void Broadcast(const Match& match);
+
+    int GetViewerCount() const { return static_cast<int>(m_viewers.size()); }
+    const SpectatorServerStats& GetStats() const { return m_stats; }
+    const SpectatorEncoder& GetEncoder() const { return m_encoder; }
+
+    // A viewer with more than this waiting is dropped to the next keyframe
+    static constexpr size_t MAX_QUEUED_BYTES = 256 * 1024;
+    static constexpr int MAX_VIEWERS = 4096;
+
+private:
+    typedef std::shared_ptr<const std::vector<Uint8>> SharedFrame;
+
+    struct Viewer {
+        long long socket;
+        std::deque<SharedFrame> queue;
+        size_t sentOfFront;   // Bytes of the front frame already sent
+        size_t queuedBytes;
+        bool needsKeyframe;
+        bool closed;
+    };
+
+    void AcceptViewers();
+    void Enqueue(Viewer& viewer, const SharedFrame& frame);
+    void Flush(Viewer& viewer);
+    void DropClosedViewers();
+
+    long long m_listenSocket;
+    std::vector<Viewer> m_viewers;
+    SpectatorEncoder m_encoder;
+    MatchState m_state;
+    std::vector<Uint8> m_deltaFrame;
+    SpectatorServerStats m_stats;
+};
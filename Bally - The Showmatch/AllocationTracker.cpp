@@ -0,0 +1,145 @@
+#include "AllocationTracker.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace {
+
+// Written by the owning thread only (plain load and store, no read-modify-write), read by anyone
+struct alignas(64) ThreadCounters {
+    std::atomic<Uint64> allocations;
+    std::atomic<Uint64> bytes;
+};
+
+ThreadCounters s_threads[AllocationTracker::MAX_THREADS];
+std::atomic<int> s_threadCount(0);
+ThreadCounters s_shared; // Threads beyond MAX_THREADS, updated with fetch_add
+
+// Plain thread_locals: anything with a constructor or destructor could allocate on first use
+thread_local Uint64 t_allocations = 0;
+
+#if BALLY_ALLOCATION_TRACKER
+
+thread_local ThreadCounters* t_counters = nullptr;
+thread_local bool t_shared = false;
+
+void Count(size_t size) {
+    t_allocations++;
+    if (!t_counters) {
+        // Slots are never given back: a finished thread's allocations stay in the totals
+        int index = s_threadCount.fetch_add(1, std::memory_order_relaxed);
+        t_shared = index >= AllocationTracker::MAX_THREADS;
+        t_counters = t_shared ? &s_shared : &s_threads[index];
+    }
+    if (t_shared) {
+        t_counters->allocations.fetch_add(1, std::memory_order_relaxed);
+        t_counters->bytes.fetch_add(size, std::memory_order_relaxed);
+    } else {
+        t_counters->allocations.store(t_counters->allocations.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        t_counters->bytes.store(t_counters->bytes.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+    }
+}
+
+// The nothrow forms return nullptr where the others throw
+void* Allocate(size_t size, bool nothrow) {
+    Count(size);
+    for (;;) {
+        if (void* memory = std::malloc(size == 0 ? 1 : size)) return memory;
+
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            if (nothrow) return nullptr;
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* AllocateAligned(size_t size, std::align_val_t alignment, bool nothrow) {
+    Count(size);
+    size_t align = static_cast<size_t>(alignment);
+    for (;;) {
+#ifdef _WIN32
+        if (void* memory = _aligned_malloc(size == 0 ? 1 : size, align)) return memory;
+#else
+        // aligned_alloc wants a multiple of the alignment
+        size_t rounded = std::max(align, (size + align - 1) / align * align);
+        if (void* memory = std::aligned_alloc(align, rounded)) return memory;
+#endif
+
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            if (nothrow) return nullptr;
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void FreeAligned(void* memory) {
+#ifdef _WIN32
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+#endif
+
+Uint64 Sum(std::atomic<Uint64> ThreadCounters::*field) {
+    Uint64 total = (s_shared.*field).load(std::memory_order_relaxed);
+    int count = std::min(s_threadCount.load(std::memory_order_relaxed), AllocationTracker::MAX_THREADS);
+    for (int i = 0; i < count; ++i) {
+        total += (s_threads[i].*field).load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+}
+
+Uint64 AllocationTracker::GetThreadAllocations() {
+    return t_allocations;
+}
+
+Uint64 AllocationTracker::GetTotalAllocations() {
+    return Sum(&ThreadCounters::allocations);
+}
+
+Uint64 AllocationTracker::GetTotalBytes() {
+    return Sum(&ThreadCounters::bytes);
+}
+
+#if BALLY_ALLOCATION_TRACKER
+
+void* operator new(size_t size) { return Allocate(size, false); }
+void* operator new[](size_t size) { return Allocate(size, false); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return Allocate(size, true); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return Allocate(size, true); }
+void* operator new(size_t size, std::align_val_t alignment) { return AllocateAligned(size, alignment, false); }
+void* operator new[](size_t size, std::align_val_t alignment) { return AllocateAligned(size, alignment, false); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return AllocateAligned(size, alignment, true);
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return AllocateAligned(size, alignment, true);
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { FreeAligned(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { FreeAligned(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { FreeAligned(memory); }
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept { FreeAligned(memory); }
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept { FreeAligned(memory); }
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept { FreeAligned(memory); }
+
+#endif
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+// Build with BALLY_ALLOCATION_TRACKER=0 to leave the global operator new alone
+#ifndef BALLY_ALLOCATION_TRACKER
+#define BALLY_ALLOCATION_TRACKER 1
+#endif
+
+// Counts heap allocations made through the global operator new (every new, make_unique,
+// container growth and std::string past its inline buffer). Each thread bumps counters of
+// its own, so counting costs no locks or shared cache lines. The profiler charges the
+// allocations to zones, and the game's --alloc-check flags gameplay frames that allocate.
+// SDL's own mallocs (surfaces, textures) go around operator new and are not counted.
+class AllocationTracker {
+public:
+    static bool IsEnabled() { return BALLY_ALLOCATION_TRACKER != 0; }
+
+    static Uint64 GetThreadAllocations(); // Calling thread, since it started
+    static Uint64 GetTotalAllocations();  // Every thread, since startup
+    static Uint64 GetTotalBytes();        // Requested, never decreases
+
+    static constexpr int MAX_THREADS = 64; // Later threads share one atomic counter
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <cstring>
+#include <vector>
+
+// Little-endian helpers shared by the compact binary formats (replays, spectator streams).
+// Varints are LEB128; signed values go through ZigZag first.
+
+inline void WriteVarint(std::vector<Uint8>& out, Uint32 value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<Uint8>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<Uint8>(value));
+}
+
+inline void WriteFloat(std::vector<Uint8>& out, float value) {
+    // Raw bits so values come back bit-exact
+    Uint32 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<Uint8>(bits >> (i * 8)));
+    }
+}
+
+// Bounds-checked reader; any read past the end marks the stream as failed
+struct ByteReader {
+    const Uint8* data;
+    size_t size;
+    size_t offset;
+    bool failed;
+
+    explicit ByteReader(const std::vector<Uint8>& bytes)
+        : data(bytes.data()), size(bytes.size()), offset(0), failed(false) {}
+    ByteReader(const Uint8* bytes, size_t count) : data(bytes), size(count), offset(0), failed(false) {}
+
+    Uint8 ReadByte() {
+        if (offset >= size) {
+            failed = true;
+            return 0;
+        }
+        return data[offset++];
+    }
+
+    Uint32 ReadVarint() {
+        Uint32 value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            Uint8 byte = ReadByte();
+            value |= static_cast<Uint32>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        failed = true;
+        return 0;
+    }
+
+    float ReadFloat() {
+        Uint32 bits = 0;
+        for (int i = 0; i < 4; ++i) {
+            bits |= static_cast<Uint32>(ReadByte()) << (i * 8);
+        }
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    bool AtEnd() const { return offset == size; }
+};
+
+inline Uint32 ZigZag(int value) { return (static_cast<Uint32>(value) << 1) ^ static_cast<Uint32>(value >> 31); }
+inline int UnZigZag(Uint32 value) { return static_cast<int>(value >> 1) ^ -static_cast<int>(value & 1); }
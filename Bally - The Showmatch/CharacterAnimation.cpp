@@ -1,7 +1,22 @@
 #include "CharacterAnimation.h"
+#include "Profiler.h"
 #include "Renderer.h"
 #include <SDL3_image/SDL_image.h>
 #include <iostream>
+#include <map>
+
+namespace {
+
+// Sprite sheets already on the GPU, so a big lobby loads each character once instead of
+// once per player. A sheet is destroyed along with the last animation using it.
+struct CachedSheet {
+    std::weak_ptr<SDL_Texture> texture;
+    int width;
+    int height;
+};
+std::map<std::pair<SDL_Renderer*, std::string>, CachedSheet> s_sheetCache;
+
+}
 
 CharacterAnimation::CharacterAnimation(const std::string& characterName)
     : m_characterName(characterName), m_currentAnimation(AnimationType::IDLE),
@@ -9,7 +24,6 @@ CharacterAnimation::CharacterAnimation(const std::string& characterName)
       m_paused(false), m_pauseFrame(-1) {
     // Initialize all animation data
     for (int i = 0; i < 6; i++) {
-        m_animations[i].texture = nullptr;
         m_animations[i].frameCount = 0;
         m_animations[i].frameWidth = 0;
         m_animations[i].frameHeight = 0;
@@ -18,13 +32,7 @@ CharacterAnimation::CharacterAnimation(const std::string& characterName)
 }
 
 CharacterAnimation::~CharacterAnimation() {
-    // Clean up all textures
-    for (int i = 0; i < 6; i++) {
-        if (m_animations[i].texture) {
-            SDL_DestroyTexture(m_animations[i].texture);
-            m_animations[i].texture = nullptr;
-        }
-    }
+    // Textures are released by their shared pointers
 }
 
 bool CharacterAnimation::LoadCharacter(Renderer* renderer) {
@@ -51,28 +59,38 @@ bool CharacterAnimation::LoadCharacter(Renderer* renderer) {
 
 bool CharacterAnimation::LoadSpriteSheet(Renderer* renderer, const std::string& filename,
                                          AnimationData& data, int frameCount) {
-    // Load the image
-    SDL_Surface* surface = IMG_Load(filename.c_str());
-    if (!surface) {
-        std::cerr << "Failed to load sprite sheet: " << filename << " - " << SDL_GetError() << std::endl;
-        return false;
-    }
-
-    // Create texture from surface
-    data.texture = SDL_CreateTextureFromSurface(renderer->GetSDLRenderer(), surface);
+    CachedSheet& cached = s_sheetCache[std::make_pair(renderer->GetSDLRenderer(), filename)];
+    data.texture = cached.texture.lock();
     if (!data.texture) {
-        std::cerr << "Failed to create texture from: " << filename << " - " << SDL_GetError() << std::endl;
+        PROFILE_ZONE("CharacterAnimation::LoadSpriteSheet");
+
+        // Load the image
+        SDL_Surface* surface = IMG_Load(filename.c_str());
+        if (!surface) {
+            std::cerr << "Failed to load sprite sheet: " << filename << " - " << SDL_GetError() << std::endl;
+            return false;
+        }
+
+        // Create texture from surface
+        data.texture.reset(renderer->CreateTextureFromSurface(surface), Renderer::DestroyTexture);
+        if (!data.texture) {
+            std::cerr << "Failed to create texture from: " << filename << " - " << SDL_GetError() << std::endl;
+            SDL_DestroySurface(surface);
+            return false;
+        }
+
+        cached.texture = data.texture;
+        cached.width = surface->w;
+        cached.height = surface->h;
         SDL_DestroySurface(surface);
-        return false;
     }
 
     // Store animation data
     data.frameCount = frameCount;
-    data.frameHeight = surface->h;
-    data.frameWidth = surface->w / frameCount; // Assuming horizontal sprite sheet
+    data.frameHeight = cached.height;
+    data.frameWidth = cached.width / frameCount; // Assuming horizontal sprite sheet
     data.frameDuration = 0.1f; // 100ms per frame
 
-    SDL_DestroySurface(surface);
     return true;
 }
 
@@ -142,8 +160,8 @@ void CharacterAnimation::Draw(Renderer* renderer, const Vector2& position, float
     // Flip sprite based on facing direction
     SDL_FlipMode flip = facingRight ? SDL_FLIP_NONE : SDL_FLIP_HORIZONTAL;
 
-    SDL_RenderTextureRotated(renderer->GetSDLRenderer(), currentAnim.texture,
-                            &srcRect, &destRect, 0.0, nullptr, flip);
+    renderer->DrawTextureRotated(currentAnim.texture.get(),
+                                 &srcRect, &destRect, 0.0, nullptr, flip);
 }
 
 void CharacterAnimation::SetAnimation(AnimationType type) {
@@ -1,5 +1,6 @@
 #pragma once
 #include "Vector2.h"
+#include <memory>
 #include <string>
 #include <SDL3/SDL.h>
 
@@ -36,7 +37,7 @@ public:
 
 private:
     struct AnimationData {
-        SDL_Texture* texture;
+        std::shared_ptr<SDL_Texture> texture; // Shared by every player with this character
         int frameCount;
         int frameWidth;
         int frameHeight;
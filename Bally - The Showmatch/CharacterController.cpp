@@ -0,0 +1,146 @@
+#include "CharacterController.h"
+#include "Terrain.h"
+#include <cmath>
+#include <algorithm>
+
+CharacterController::CharacterController()
+    : m_stepHeight(DEFAULT_STEP_HEIGHT), m_minGroundNormalY(0.0f),
+      m_groundSnapDistance(DEFAULT_GROUND_SNAP_DISTANCE) {
+    SetMaxSlopeAngle(DEFAULT_MAX_SLOPE_ANGLE);
+}
+
+void CharacterController::SetMaxSlopeAngle(float degrees) {
+    m_minGroundNormalY = -std::cos(degrees * 3.14159265f / 180.0f);
+}
+
+bool CharacterController::IsWalkable(const Vector2& normal) const {
+    return normal.y <= m_minGroundNormalY;
+}
+
+bool CharacterController::IsFree(const Terrain& terrain, const Vector2& position, float radius) const {
+    return terrain.DistanceToSolid(position, radius) >= radius;
+}
+
+bool CharacterController::Depenetrate(const Terrain& terrain, Vector2& position, float radius,
+    Vector2& outNormal) const {
+    bool touched = false;
+
+    for (int i = 0; i < MAX_DEPENETRATION_ITERATIONS; ++i) {
+        float distance = terrain.DistanceToSolid(position, radius);
+        if (distance >= radius) break;
+
+        Vector2 normal = terrain.GetSurfaceNormal(position, radius);
+        if (!touched) {
+            outNormal = normal;
+            touched = true;
+        }
+
+        // Walkable ground pushes straight up, so standing on a slope doesn't creep down it.
+        // Steep slopes push sideways only, so they can't be used to climb
+        float depth = radius - distance + 0.01f;
+        if (IsWalkable(normal)) {
+            position.y -= depth / -normal.y;
+        } else if (normal.y < 0.0f && std::abs(normal.x) > 0.0001f) {
+            position.x += normal.x > 0.0f ? depth : -depth;
+        } else {
+            position += normal * depth;
+        }
+    }
+
+    return touched;
+}
+
+ControllerResult CharacterController::Move(const Terrain& terrain, const Vector2& start,
+    const Vector2& displacement, const Vector2& velocity, float radius, bool wasGrounded,
+    ArenaVector<Vector2>* contactPoints) const {
+    ControllerResult result;
+    result.position = start;
+    result.velocity = velocity;
+    result.grounded = false;
+    result.groundNormal = Vector2::Up();
+    result.groundPoint = start;
+
+    Vector2 position = start;
+    bool grounded = wasGrounded;
+    Vector2 normal;
+
+    // Resolve anything the circle already overlaps (terrain destroyed/moved under it)
+    if (Depenetrate(terrain, position, radius, normal) && contactPoints) {
+        contactPoints->push_back(position - normal * radius);
+    }
+
+    // Sub-steps shorter than the radius can't tunnel through terrain
+    float length = displacement.Length();
+    float maxSubstep = std::max(radius * SUBSTEP_RADIUS_FRACTION, length / MAX_SUBSTEPS);
+    int substeps = std::max(1, (int)std::ceil(length / maxSubstep));
+    Vector2 step = displacement / (float)substeps;
+
+    for (int i = 0; i < substeps; ++i) {
+        Vector2 target = position + step;
+        if (!Depenetrate(terrain, target, radius, normal)) {
+            position = target;
+            continue;
+        }
+
+        // Walked into something too steep - try stepping over it
+        if (grounded && !IsWalkable(normal) && step.x != 0.0f) {
+            Vector2 raised = position + Vector2(0.0f, -m_stepHeight);
+            Vector2 raisedTarget = raised + Vector2(step.x, 0.0f);
+            if (IsFree(terrain, raised, radius) && IsFree(terrain, raisedTarget, radius)) {
+                position = raisedTarget;
+                continue;
+            }
+        }
+
+        if (contactPoints) contactPoints->push_back(target - normal * radius);
+        if (IsWalkable(normal)) {
+            grounded = true;
+        }
+
+        // Ground stops the fall without turning it into sideways speed (static friction);
+        // anything steeper removes the velocity along its normal, so players slide off it
+        if (IsWalkable(normal)) {
+            if (result.velocity.y > 0.0f) result.velocity.y = 0.0f;
+        } else {
+            float into = result.velocity.Dot(normal);
+            if (into < 0.0f) {
+                result.velocity -= normal * into;
+            }
+        }
+
+        position = target;
+    }
+
+    // Keep grounded players on the ground when walking down slopes or off small steps
+    bool movingUp = result.velocity.y < 0.0f;
+    if (grounded && !movingUp) {
+        float gap = terrain.DistanceToSolid(position, radius + m_groundSnapDistance) - radius;
+        for (int i = 0; i < MAX_DEPENETRATION_ITERATIONS && gap > CONTACT_OFFSET && gap < m_groundSnapDistance; ++i) {
+            // The Euclidean gap never exceeds the vertical one, so this never overshoots
+            position.y += gap;
+            gap = terrain.DistanceToSolid(position, radius + m_groundSnapDistance) - radius;
+        }
+    }
+
+    // Final ground check
+    grounded = false;
+    float gap = terrain.DistanceToSolid(position, radius + CONTACT_OFFSET) - radius;
+    if (gap < CONTACT_OFFSET) {
+        Vector2 groundNormal = terrain.GetSurfaceNormal(position, radius + CONTACT_OFFSET);
+        if (IsWalkable(groundNormal)) {
+            grounded = true;
+            result.groundNormal = groundNormal;
+            result.groundPoint = position - groundNormal * radius;
+        }
+    }
+
+    // Static friction: speed picked up sliding down a steep slope stops on walkable ground
+    if (grounded) {
+        result.velocity.x = 0.0f;
+        if (result.velocity.y > 0.0f) result.velocity.y = 0.0f;
+    }
+
+    result.position = position;
+    result.grounded = grounded;
+    return result;
+}
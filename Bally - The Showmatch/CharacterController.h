@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Vector2.h"
+#include "FrameArena.h"
+
+class Terrain;
+
+// Outcome of one controller move
+struct ControllerResult {
+    Vector2 position;
+    Vector2 velocity;
+    bool grounded;
+    Vector2 groundNormal;
+    Vector2 groundPoint;              // Contact point under the circle (valid when grounded)
+};
+
+// Kinematic circle controller for players walking on destructible terrain.
+// Movement is swept in sub-steps shorter than the radius and resolved against terrain
+// distance/normal queries: walkable ground holds the circle in place (no sliding while
+// idle), walls up to the step height are climbed, slopes steeper than the slope limit
+// can't be walked up and are slid down, and grounded players are snapped back onto the
+// ground when walking down slopes. The controller keeps no state, so players can be
+// moved in parallel.
+class CharacterController {
+public:
+    CharacterController();
+
+    // Move a circle from start by displacement. wasGrounded is the previous result's grounded flag.
+    // Every terrain contact of the move is appended to contactPoints (debug view, nullptr = skip).
+    ControllerResult Move(const Terrain& terrain, const Vector2& start, const Vector2& displacement,
+        const Vector2& velocity, float radius, bool wasGrounded, ArenaVector<Vector2>* contactPoints = nullptr) const;
+
+    void SetStepHeight(float stepHeight) { m_stepHeight = stepHeight; }
+    void SetMaxSlopeAngle(float degrees);
+    void SetGroundSnapDistance(float distance) { m_groundSnapDistance = distance; }
+
+    float GetStepHeight() const { return m_stepHeight; }
+    float GetGroundSnapDistance() const { return m_groundSnapDistance; }
+
+private:
+    // Push the circle out of the terrain. Returns true if it was touching, with the contact normal.
+    bool Depenetrate(const Terrain& terrain, Vector2& position, float radius, Vector2& outNormal) const;
+    bool IsWalkable(const Vector2& normal) const;
+    bool IsFree(const Terrain& terrain, const Vector2& position, float radius) const;
+
+    float m_stepHeight;
+    float m_minGroundNormalY; // -cos(max slope angle); walkable normals point at least this far up
+    float m_groundSnapDistance;
+
+    static constexpr float DEFAULT_STEP_HEIGHT = 8.0f;
+    static constexpr float DEFAULT_MAX_SLOPE_ANGLE = 60.0f;
+    static constexpr float DEFAULT_GROUND_SNAP_DISTANCE = 10.0f;
+    static constexpr float SUBSTEP_RADIUS_FRACTION = 0.25f; // Longest sub-step relative to radius
+    static constexpr float CONTACT_OFFSET = 1.0f;           // Gap still counted as touching
+    static constexpr int MAX_DEPENETRATION_ITERATIONS = 4;
+    static constexpr int MAX_SUBSTEPS = 32;
+};
@@ -1,30 +1,58 @@
 #include "ExplosionAnimation.h"
+#include "Profiler.h"
 #include "Renderer.h"
 #include <SDL3_image/SDL_image.h>
 #include <iostream>
 #include <string>
 
+ExplosionAnimation::ExplosionAnimation()
+    : m_position(), m_explosionRadius(0.0f), m_type(ExplosionAnimationType::SMALL_EXPLOSION),
+      m_texture(nullptr), m_textureType(ExplosionAnimationType::SMALL_EXPLOSION), m_frameCount(0),
+      m_currentFrame(0), m_animationTimer(0.0f), m_frameDuration(0.08f), m_frameWidth(0), m_frameHeight(0),
+      m_finished(true) {
+}
+
 ExplosionAnimation::ExplosionAnimation(const Vector2& position, float radius, bool isBigExplosion)
-    : m_position(position), m_explosionRadius(radius), 
-      m_type(isBigExplosion ? ExplosionAnimationType::BIG_EXPLOSION : ExplosionAnimationType::SMALL_EXPLOSION),
-      m_texture(nullptr), m_frameCount(isBigExplosion ? 8 : 7), m_currentFrame(0), m_animationTimer(0.0f),
-      m_frameDuration(0.08f), m_frameWidth(0), m_frameHeight(0), m_finished(false) {
+    : ExplosionAnimation() {
+    Restart(position, radius, isBigExplosion ? ExplosionAnimationType::BIG_EXPLOSION : ExplosionAnimationType::SMALL_EXPLOSION);
 }
 
 ExplosionAnimation::ExplosionAnimation(const Vector2& position, float radius, ExplosionAnimationType type)
-    : m_position(position), m_explosionRadius(radius), m_type(type),
-      m_texture(nullptr), m_frameCount(12), m_currentFrame(0), m_animationTimer(0.0f),
-      m_frameDuration(0.08f), m_frameWidth(0), m_frameHeight(0), m_finished(false) {
+    : ExplosionAnimation() {
+    Restart(position, radius, type);
 }
 
 ExplosionAnimation::~ExplosionAnimation() {
+    Unload();
+}
+
+void ExplosionAnimation::Unload() {
     if (m_texture) {
-        SDL_DestroyTexture(m_texture);
+        Renderer::DestroyTexture(m_texture);
         m_texture = nullptr;
     }
 }
 
+void ExplosionAnimation::Restart(const Vector2& position, float radius, ExplosionAnimationType type) {
+    m_position = position;
+    m_explosionRadius = radius;
+    m_type = type;
+    switch (type) {
+        case ExplosionAnimationType::SMALL_EXPLOSION: m_frameCount = 7; break;
+        case ExplosionAnimationType::BIG_EXPLOSION: m_frameCount = 8; break;
+        default: m_frameCount = 12; break;
+    }
+    m_currentFrame = 0;
+    m_animationTimer = 0.0f;
+    m_finished = false;
+}
+
 bool ExplosionAnimation::Load(Renderer* renderer) {
+    if (m_texture) {
+        if (m_textureType == m_type) return true;
+        Unload();
+    }
+
     std::string filename = GetSpriteFilename();
     return LoadSpriteSheet(renderer, filename);
 }
@@ -47,13 +75,15 @@ std::string ExplosionAnimation::GetSpriteFilename() const {
 }
 
 bool ExplosionAnimation::LoadSpriteSheet(Renderer* renderer, const std::string& filename) {
+    PROFILE_ZONE("ExplosionAnimation::LoadSpriteSheet");
+
     SDL_Surface* surface = IMG_Load(filename.c_str());
     if (!surface) {
         std::cerr << "Failed to load explosion sprite: " << filename << " - " << SDL_GetError() << std::endl;
         return false;
     }
 
-    m_texture = SDL_CreateTextureFromSurface(renderer->GetSDLRenderer(), surface);
+    m_texture = renderer->CreateTextureFromSurface(surface);
     if (!m_texture) {
         std::cerr << "Failed to create texture from: " << filename << " - " << SDL_GetError() << std::endl;
         SDL_DestroySurface(surface);
@@ -69,6 +99,7 @@ bool ExplosionAnimation::LoadSpriteSheet(Renderer* renderer, const std::string&
         m_frameWidth = surface->w / m_frameCount;
     }
 
+    m_textureType = m_type;
     SDL_DestroySurface(surface);
     return true;
 }
@@ -124,6 +155,6 @@ void ExplosionAnimation::Draw(Renderer* renderer) {
     }
 
     // Draw the frame
-    SDL_RenderTexture(renderer->GetSDLRenderer(), m_texture, &srcRect, &destRect);
+    renderer->DrawTexture(m_texture, &srcRect, &destRect);
 }
 
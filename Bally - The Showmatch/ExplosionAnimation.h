@@ -15,11 +15,19 @@ enum class ExplosionAnimationType {
 
 class ExplosionAnimation {
 public:
+    ExplosionAnimation(); // Idle until Restart, for pooled slots
     ExplosionAnimation(const Vector2& position, float radius, bool isBigExplosion);
     ExplosionAnimation(const Vector2& position, float radius, ExplosionAnimationType type);
     ~ExplosionAnimation();
 
+    ExplosionAnimation(const ExplosionAnimation&) = delete;
+    ExplosionAnimation& operator=(const ExplosionAnimation&) = delete;
+
+    // Plays again from the first frame; Load keeps the texture if the type is unchanged
+    void Restart(const Vector2& position, float radius, ExplosionAnimationType type);
+
     bool Load(Renderer* renderer);
+    void Unload(); // Frees the texture; Load brings it back
     void Update(float deltaTime);
     void Draw(Renderer* renderer);
 
@@ -32,6 +40,7 @@ private:
     float m_explosionRadius; // The actual explosion radius (used for sizing)
     ExplosionAnimationType m_type;
     SDL_Texture* m_texture;
+    ExplosionAnimationType m_textureType; // What m_texture shows
     int m_frameCount;
     int m_currentFrame;
     float m_animationTimer;
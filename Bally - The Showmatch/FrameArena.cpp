@@ -0,0 +1,102 @@
+#include "FrameArena.h"
+#include <algorithm>
+#include <cstdint>
+
+FrameArena::FrameArena(size_t blockSize) : m_blockSize(blockSize), m_blockCount(0), m_state(0), m_peakUsed(0) {
+    for (Block& block : m_blocks) {
+        block = { nullptr, 0 };
+    }
+}
+
+FrameArena::~FrameArena() {
+    int count = m_blockCount.load(std::memory_order_acquire);
+    for (int i = 0; i < count; ++i) {
+        delete[] m_blocks[i].memory;
+    }
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment) {
+    for (;;) {
+        Uint64 state = m_state.load(std::memory_order_acquire);
+        int index = static_cast<int>(state >> OFFSET_BITS);
+        size_t offset = static_cast<size_t>(state & OFFSET_MASK);
+
+        if (index < m_blockCount.load(std::memory_order_acquire)) {
+            const Block& block = m_blocks[index];
+            uintptr_t base = reinterpret_cast<uintptr_t>(block.memory);
+            uintptr_t aligned = (base + offset + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+            size_t end = static_cast<size_t>(aligned - base) + size;
+            if (end <= block.size) {
+                Uint64 next = (static_cast<Uint64>(index) << OFFSET_BITS) | end;
+                if (m_state.compare_exchange_weak(state, next, std::memory_order_acq_rel)) {
+                    return reinterpret_cast<void*>(aligned);
+                }
+                continue;
+            }
+        }
+
+        // The current block is full (or there is none yet)
+        if (!NextBlock(state, size + alignment)) return nullptr;
+    }
+}
+
+bool FrameArena::NextBlock(Uint64 expectedState, size_t minSize) {
+    std::lock_guard<std::mutex> lock(m_growMutex);
+    if (m_state.load(std::memory_order_acquire) != expectedState) return true; // Someone else moved on
+
+    int count = m_blockCount.load(std::memory_order_relaxed);
+    int index = static_cast<int>(expectedState >> OFFSET_BITS);
+    int next = index < count ? index + 1 : index;
+
+    // Blocks left over from bigger frames are reused, unless too small for this allocation
+    while (next < count && m_blocks[next].size < minSize) {
+        next++;
+    }
+    if (next >= count) {
+        if (count == MAX_BLOCKS) return false;
+        size_t size = std::max(minSize, count > 0 ? m_blocks[count - 1].size * 2 : m_blockSize);
+        m_blocks[count] = { new char[size], size };
+        m_blockCount.store(count + 1, std::memory_order_release);
+        next = count;
+    }
+
+    m_state.store(static_cast<Uint64>(next) << OFFSET_BITS, std::memory_order_release);
+    return true;
+}
+
+void FrameArena::Reset() {
+    m_peakUsed = std::max(m_peakUsed, GetUsed());
+    m_state.store(0, std::memory_order_release);
+}
+
+size_t FrameArena::GetUsed() const {
+    Uint64 state = m_state.load(std::memory_order_acquire);
+    int index = static_cast<int>(state >> OFFSET_BITS);
+    int count = m_blockCount.load(std::memory_order_acquire);
+
+    // Skipped blocks count as used: nothing else can go there until the reset
+    size_t used = static_cast<size_t>(state & OFFSET_MASK);
+    for (int i = 0; i < std::min(index, count); ++i) {
+        used += m_blocks[i].size;
+    }
+    return used;
+}
+
+size_t FrameArena::GetCapacity() const {
+    size_t capacity = 0;
+    int count = m_blockCount.load(std::memory_order_acquire);
+    for (int i = 0; i < count; ++i) {
+        capacity += m_blocks[i].size;
+    }
+    return capacity;
+}
+
+DoubleBufferedArena::DoubleBufferedArena(size_t blockSize)
+    : m_arenas{ FrameArena(blockSize), FrameArena(blockSize) }, m_current(0), m_frame(0) {
+}
+
+void DoubleBufferedArena::EndFrame() {
+    m_current ^= 1;
+    m_arenas[m_current].Reset();
+    m_frame++;
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// Bump allocator for data that only lives until the end of the frame. Allocating moves one
+// atomic offset forward (any thread may allocate at once), freeing does nothing and Reset
+// starts over from the first block. Blocks are kept, so once the arena has seen the
+// biggest frame it never touches the heap again.
+class FrameArena {
+public:
+    explicit FrameArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // nullptr only if every block slot is used up
+    void* Allocate(size_t size, size_t alignment);
+
+    // Everything allocated so far is gone; nothing may allocate at the same time
+    void Reset();
+
+    size_t GetUsed() const;      // Since the last reset
+    size_t GetPeakUsed() const { return m_peakUsed; }
+    size_t GetCapacity() const;  // All blocks
+
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 256 * 1024;
+    static constexpr int MAX_BLOCKS = 32; // Each new block is at least twice the last
+
+private:
+    struct Block {
+        char* memory;
+        size_t size;
+    };
+
+    bool NextBlock(Uint64 expectedState, size_t minSize);
+
+    // Block index in the high bits, offset into the block in the low ones, so both move
+    // together with a single compare-exchange
+    static constexpr int OFFSET_BITS = 48;
+    static constexpr Uint64 OFFSET_MASK = (Uint64(1) << OFFSET_BITS) - 1;
+
+    size_t m_blockSize;
+    Block m_blocks[MAX_BLOCKS];
+    std::atomic<int> m_blockCount;
+    std::atomic<Uint64> m_state;
+    std::mutex m_growMutex; // Only taken when the current block is full
+    size_t m_peakUsed;
+};
+
+// Two arenas used in turns: what a frame allocates stays valid through the next frame too,
+// so data built while updating can still be drawn a frame later. Tag the data with
+// GetFrame() when it is built and check IsLive before reading it again.
+class DoubleBufferedArena {
+public:
+    explicit DoubleBufferedArena(size_t blockSize = FrameArena::DEFAULT_BLOCK_SIZE);
+
+    FrameArena& Current() { return m_arenas[m_current]; }
+    Uint64 GetFrame() const { return m_frame; }
+    bool IsLive(Uint64 frame) const { return m_frame - frame <= 1; }
+
+    // Frees what was allocated two frames ago; nothing may allocate at the same time
+    void EndFrame();
+
+private:
+    FrameArena m_arenas[2];
+    int m_current;
+    Uint64 m_frame;
+};
+
+// STL allocator on a FrameArena. Deallocating is a no-op, so containers using it must not
+// be read after the arena resets (destroying or clearing them is fine). Without an arena
+// it falls back to the general heap, for code that also runs outside the game's frames.
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    ArenaAllocator(FrameArena* arena = nullptr) : m_arena(arena) {}
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.GetArena()) {}
+
+    T* allocate(size_t count) {
+        if (!m_arena) return static_cast<T*>(::operator new(count * sizeof(T)));
+        void* memory = m_arena->Allocate(count * sizeof(T), alignof(T));
+        if (!memory) throw std::bad_alloc();
+        return static_cast<T*>(memory);
+    }
+
+    void deallocate(T* memory, size_t) {
+        if (!m_arena) ::operator delete(memory);
+    }
+
+    FrameArena* GetArena() const { return m_arena; }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return m_arena == other.GetArena(); }
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return m_arena != other.GetArena(); }
+
+private:
+    FrameArena* m_arena;
+};
+
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
@@ -1,16 +1,21 @@
 #include "Game.h"
+#include "Profiler.h"
 #include "InputManager.h"
 #include "Physics.h"
 #include "UI.h"
 #include <iostream>
-#include <random>
 #include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <random>
 
 Game::Game() : m_window(nullptr), m_running(false), m_lastFrameTime(0.0f),
 m_gameState(GameState::MAIN_MENU), m_gameMode(GameMode::FREE_FOR_ALL), m_numPlayers(4),
-m_currentPlayerIndex(0), m_turnTimer(TURN_DURATION), m_turnCounter(0),
-m_gameStarted(false), m_gameEnded(false), m_winnerId(-1), m_waitingForProjectiles(false),
-m_cameraDelayTimer(0.0f), m_cameraDelayActive(false), m_lastDragMousePos(0, 0), m_isDraggingCamera(false) {
+m_stepAccumulator(0.0f), m_messageEvents(m_events), m_effectEvents(m_events),
+m_turbo(false), m_fastForwarding(false), m_fastForwardFrames(0), m_netInputDelay(NetplaySetup::DEFAULT_INPUT_DELAY), m_netGameOverShown(false), m_stepsPlayed(0),
+m_allocationCheck(false), m_steadyFrames(0), m_allocatingFrames(0), m_lastAllocationReport(0),
+m_lastDragMousePos(0, 0), m_isDraggingCamera(false) {
 }
 
 Game::~Game() {
@@ -18,6 +23,8 @@ Game::~Game() {
 }
 
 bool Game::Initialize() {
+    Profiler::SetThreadName("Main thread");
+
     // Initialize SDL
     if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS)) {
         std::cerr << "Failed to initialize SDL: " << SDL_GetError() << std::endl;
@@ -37,11 +44,15 @@ bool Game::Initialize() {
         std::cerr << "Failed to initialize renderer" << std::endl;
         return false;
     }
+    m_renderer->SetFrameArena(&m_frameArena);
+
+    // Start worker threads before any subsystem that submits jobs
+    m_jobSystem = std::make_unique<JobSystem>();
+    m_jobSystem->Initialize();
 
     m_inputManager = std::make_unique<InputManager>();
-    m_physics = std::make_unique<Physics>();
-    m_physics->SetRenderer(m_renderer.get()); // Set renderer for explosion animations
     m_ui = std::make_unique<UI>(m_renderer.get());
+    m_profilerOverlay = std::make_unique<ProfilerOverlay>(m_renderer.get());
     m_menu = std::make_unique<Menu>(m_renderer.get());
     m_camera = std::make_unique<Camera>(1200.0f, 800.0f);
 
@@ -66,117 +77,31 @@ bool Game::Initialize() {
     return true;
 }
 
-void Game::CreatePlayers() {
-    m_players.clear();
-
-    std::vector<Color> playerColors = {
-        Color(255, 100, 100, 255), // Red
-        Color(100, 100, 255, 255), // Blue
-        Color(100, 255, 100, 255), // Green
-        Color(255, 255, 100, 255)  // Yellow
-    };
-
-    // Character names for each player
-    std::string characterNames[] = {
-        "Meep",   // Player 1
-        "Yetty",  // Player 2
-        "Turt",   // Player 3
-        "Meep"    // Player 4 (reuse Meep for now)
-    };
-
-    // Create players based on menu selection
-    int numPlayers = m_numPlayers;
-    
-    // Get actual map dimensions
-    float mapWidth = m_currentMap ? static_cast<float>(m_currentMap->GetWidth()) : 1200.0f;
-    float mapHeight = m_currentMap ? static_cast<float>(m_currentMap->GetHeight()) : 800.0f;
-    
-    // Spread players across the map with padding from edges
-    float padding = 100.0f; // Padding from map edges
-    float spawnAreaWidth = mapWidth - (padding * 2.0f); // Available width for spawning
-    float startX = padding; // Left edge of spawn area
-
-    for (int i = 0; i < numPlayers; ++i) {
-        // Distribute players evenly across the spawn area
-        float spacing = (numPlayers > 1) ? spawnAreaWidth / (numPlayers - 1) : 0.0f;
-        float targetX = startX + spacing * i;
-        
-        // Clamp targetX to map bounds
-        targetX = std::max(padding, std::min(targetX, mapWidth - padding));
-        
-        // Find valid spawn position - search for valid ground near targetX
-        float x = targetX;
-        float startY = mapHeight * 0.75f; // Default fallback (75% down the map)
-        float playerRadius = 20.0f; // Default radius, will be updated with actual radius
-        
-        if (m_currentMap && m_currentMap->GetTerrain()) {
-            int spawnX = 0, spawnY = 0;
-            // Search up to 100 pixels left/right to find valid spawn position
-            if (m_currentMap->GetTerrain()->FindValidSpawnPosition((int)targetX, 100, playerRadius, spawnX, spawnY)) {
-                x = (float)spawnX;
-                startY = (float)spawnY - playerRadius - 3.0f; // 3px offset to ensure above terrain
-            } else {
-                // Fallback: try to find any valid ground
-                int terrainY = m_currentMap->GetTerrain()->FindSolidGroundSurface((int)targetX, 50);
-                if (terrainY >= 0) {
-                    startY = (float)terrainY - playerRadius - 3.0f;
-                }
-            }
-        }
-        
-        Vector2 position(x, startY);
-
-        auto player = std::make_unique<Player>(i, position, playerColors[i], characterNames[i]);
-
-        // Assign teams for team mode
-        if (m_gameMode == GameMode::TEAM_2V2) {
-            // Player 1 & 3 = Team 1 (green), Player 2 & 4 = Team 2 (red)
-            if (i == 0 || i == 2) {
-                player->SetTeam(1); // Team 1
-            } else if (i == 1 || i == 3) {
-                player->SetTeam(2); // Team 2
-            }
-        }
-
-        // Load character animations
-        if (player->GetAnimation()) {
-            player->GetAnimation()->LoadCharacter(m_renderer.get());
-        }
-
-        // Final verification: ensure player is not inside terrain
-        if (m_currentMap && m_currentMap->GetTerrain()) {
-            Vector2 playerPos = player->GetPosition();
-            float actualRadius = player->GetRadius();
-            
-            // Use IsCircleSolid to check if player is inside terrain (more accurate)
-            if (m_currentMap->GetTerrain()->IsCircleSolid(playerPos, actualRadius)) {
-                // Player is inside terrain - find valid position above
-                int terrainY = m_currentMap->GetTerrain()->FindSolidGroundSurface((int)playerPos.x, 50);
-                if (terrainY >= 0) {
-                    playerPos.y = (float)terrainY - actualRadius - 3.0f;
-                    
-                    // Verify this position is valid
-                    if (m_currentMap->GetTerrain()->IsCircleSolid(playerPos, actualRadius)) {
-                        // Still inside, push up until clear
-                        for (int adjustY = terrainY - (int)actualRadius - 3; adjustY >= 0; adjustY -= 1) {
-                            Vector2 testPos(playerPos.x, (float)adjustY);
-                            if (!m_currentMap->GetTerrain()->IsCircleSolid(testPos, actualRadius)) {
-                                playerPos.y = (float)adjustY;
-                                break;
-                            }
-                        }
-                    }
-                }
-            }
-            
-            player->SetPosition(playerPos);
-        }
+bool Game::HostNetplay(Uint16 port, int inputDelay) {
+    m_netTransport = std::make_unique<UdpTransport>();
+    if (!m_netTransport->Listen(port)) {
+        m_netTransport.reset();
+        return false;
+    }
+    m_netSession = std::make_unique<RollbackSession>(*m_netTransport, true);
+    m_netInputDelay = inputDelay;
+    return true;
+}
 
-        m_players.push_back(std::move(player));
+bool Game::JoinNetplay(const std::string& host, Uint16 port) {
+    m_netTransport = std::make_unique<UdpTransport>();
+    if (!m_netTransport->Connect(host, port)) {
+        m_netTransport.reset();
+        return false;
     }
+    m_netSession = std::make_unique<RollbackSession>(*m_netTransport, false);
+    std::cout << "Waiting for the host to start a match" << std::endl;
+    return true;
+}
 
-    // Set up input mappings for different players
-    SetupPlayerInputs();
+void Game::EndNetplay() {
+    m_netSession.reset();
+    m_netTransport.reset();
 }
 
 void Game::SetupPlayerInputs() {
@@ -202,17 +127,41 @@ void Game::Run() {
 
         deltaTime = std::min(deltaTime, 1.0f / 30.0f);
 
+        Uint64 frameStart = Profiler::Now();
+        Profiler::BeginFrame();
+        Uint64 allocationsBefore = AllocationTracker::GetTotalAllocations();
         HandleEvents();
         Update(deltaTime);
-        Render();
+        if (ShouldRender()) {
+            Render();
+        }
+        Uint64 frameAllocations = AllocationTracker::GetTotalAllocations() - allocationsBefore;
+        PROFILE_COUNTER("Heap allocations", frameAllocations);
+        PROFILE_COUNTER("Frame arena KB", (m_frameArena.GetUsed() + m_simulationArena.Current().GetUsed()) / 1024);
+        Profiler::EndFrame();
+        UpdateMetrics((Profiler::Now() - frameStart) / 1000000.0f);
+        CheckFrameAllocations(frameAllocations);
+
+        // This frame's scratch memory is free again; simulation data stays one frame longer
+        m_frameArena.Reset();
+        m_simulationArena.EndFrame();
 
-        SDL_Delay(16);
+        // Fast-forwarding spends the whole frame simulating
+        if (!m_fastForwarding) {
+            SDL_Delay(16);
+        }
     }
 }
 
 void Game::Update(float deltaTime) {
+    PROFILE_ZONE("Game::Update");
+
     m_inputManager->Update();
 
+    if (m_netSession) {
+        UpdateNetplay();
+    }
+
     // Update menu if in menu state
     if (m_gameState == GameState::MAIN_MENU || m_gameState == GameState::GAME_MODE_SELECTION ||
         m_gameState == GameState::PLAYER_COUNT_SELECTION || m_gameState == GameState::MAP_SELECTION ||
@@ -244,23 +193,7 @@ void Game::Update(float deltaTime) {
     }
 
     // Update game systems only when in game
-    if (m_gameState == GameState::IN_GAME) {
-        // Update physics
-        m_physics->Update(deltaTime);
-
-        // Check collisions
-        m_physics->CheckCollisions(m_players, m_skillOrbs);
-
-        // Update players
-        for (auto& player : m_players) {
-            player->Update(deltaTime);
-        }
-
-        // Update skill orbs
-        for (auto& orb : m_skillOrbs) {
-            orb->Update(deltaTime);
-        }
-
+    if (m_gameState == GameState::IN_GAME && m_match) {
         // Check for minimap click or game over button click (left mouse button)
         Vector2 mousePos = m_inputManager->GetMousePosition();
         if (m_inputManager->IsMouseButtonJustPressed(0)) { // Left mouse button
@@ -270,37 +203,18 @@ void Game::Update(float deltaTime) {
                 // Back to menu
                 m_ui->ShowGameOver(-999, m_gameMode); // Clear game over screen (invalid ID)
                 ReturnToMenu();
-                m_gameEnded = false;
                 m_isDraggingCamera = false;
+                return;
             } else if (buttonClick == 2) {
-                // Rematch - reset game and restart on same map
-                m_ui->ShowGameOver(-999, m_gameMode); // Clear game over screen (invalid ID)
+                // Rematch - restart on the same map without reloading it
                 ResetGame();
-                // Don't call StartGame() - it would reload the map
-                // Instead, just start the game with current map
-                m_currentPlayerIndex = 0;
-                m_turnTimer = TURN_DURATION;
-                m_turnCounter = 0;
-                m_gameStarted = false;
-                m_gameEnded = false;
-                m_winnerId = -1;
-                m_waitingForProjectiles = false;
-                m_cameraDelayActive = false;
-                m_cameraDelayTimer = 0.0f;
-                
+
                 // Snap camera to first player
-                if (!m_players.empty()) {
-                    m_camera->SetTarget(m_players[0]->GetPosition());
+                const auto& players = m_match->GetPlayers();
+                if (!players.empty()) {
+                    m_camera->SetTarget(players[0]->GetPosition());
                     m_camera->SnapToTarget();
                 }
-                
-                // Start first player's turn
-                if (!m_players.empty()) {
-                    m_players[0]->StartTurn();
-                }
-                
-                m_ui->ClearMessages();
-                m_ui->ShowMessage("Player 1's turn");
                 m_isDraggingCamera = false;
             } else {
                 // Check if clicking on minimap
@@ -321,6 +235,35 @@ void Game::Update(float deltaTime) {
             }
         }
 
+        // Turbo runs unattended stretches as fast as the frame budget allows; online the
+        // peer sets the pace
+        m_fastForwarding = m_turbo && !m_netSession && IsUnattended();
+        int steps = 0;
+        if (m_fastForwarding) {
+            Uint64 start = SDL_GetPerformanceCounter();
+            Uint64 budget = static_cast<Uint64>(SDL_GetPerformanceFrequency() * TURBO_FRAME_BUDGET_MS / 1000.0);
+            for (; steps < TURBO_MAX_STEPS_PER_FRAME && IsUnattended(); ++steps) {
+                StepMatch();
+                if (SDL_GetPerformanceCounter() - start >= budget) break;
+            }
+            m_stepAccumulator = 0.0f;
+        }
+        else {
+            // Run the simulation in fixed steps, as many as the frame time covers
+            m_stepAccumulator += deltaTime;
+            while (m_stepAccumulator >= Match::STEP_DURATION) {
+                StepMatch();
+                m_stepAccumulator -= Match::STEP_DURATION;
+                steps++;
+            }
+        }
+        HandleGameEvents(deltaTime);
+        m_stepsPlayed += steps;
+
+        PROFILE_COUNTER("Match steps", steps);
+        PROFILE_COUNTER("Skill orbs", m_match->GetSkillOrbs().Size());
+        PROFILE_COUNTER("Explosion animations", m_explosions.Size());
+
         // Check for manual camera controls (WASD and mouse drag)
         Vector2 cameraMovement(0, 0);
         bool manualCameraInput = false;
@@ -373,22 +316,12 @@ void Game::Update(float deltaTime) {
             m_camera->SetManualControl(false);
         }
 
-        // Update camera delay timer if active
-        if (m_cameraDelayActive) {
-            m_cameraDelayTimer -= deltaTime;
-            if (m_cameraDelayTimer <= 0.0f) {
-                m_cameraDelayActive = false;
-                // Force turn to end immediately after camera delay
-                m_turnTimer = 0.0f;
-            }
-        }
-
         // Update camera to follow active player or projectiles (if not in manual mode)
         Vector2 cameraTarget;
         bool hasCameraTarget = false;
 
         // If there are active projectiles, follow them in order
-        const auto& projectiles = m_physics->GetProjectiles();
+        const auto& projectiles = m_match->GetPhysics()->GetProjectiles();
         if (!projectiles.empty()) {
             // For split projectiles (3 projectiles), follow in order: middle (0), bottom (2), upper (1)
             // For other projectiles, just follow the first one
@@ -422,11 +355,12 @@ void Game::Update(float deltaTime) {
             }
         }
 
-        // If no projectiles and camera delay is active, keep camera at last projectile position
+        // If no projectiles and the impact delay is active, keep camera at last projectile position
         // After delay expires, move camera back to current player
-        if (!hasCameraTarget && !m_cameraDelayActive && m_currentPlayerIndex < m_players.size()) {
-            // No projectiles and delay expired - follow the current player
-            cameraTarget = m_players[m_currentPlayerIndex]->GetPosition();
+        const auto& players = m_match->GetPlayers();
+        int currentPlayerIndex = m_match->GetCurrentPlayerIndex();
+        if (!hasCameraTarget && !m_match->IsImpactDelayActive() && currentPlayerIndex < static_cast<int>(players.size())) {
+            cameraTarget = players[currentPlayerIndex]->GetPosition();
             hasCameraTarget = true;
         }
 
@@ -434,449 +368,250 @@ void Game::Update(float deltaTime) {
             m_camera->SetTarget(cameraTarget);
         }
         m_camera->Update(deltaTime);
+        if (m_fastForwarding && !m_camera->IsManualControl()) {
+            m_camera->SnapToTarget(); // No time to pan smoothly
+        }
 
         // Update UI
         m_ui->Update(deltaTime);
-
-        // Process current player input
-        if (m_gameStarted && !m_gameEnded && m_currentPlayerIndex < m_players.size()) {
-            ProcessCurrentPlayerInput();
-
-            // Handle throw action: spawn projectile and advance turn
-            Player* currentPlayer = m_players[m_currentPlayerIndex].get();
-            if (currentPlayer->GetState() == PlayerState::THROWING) {
-                const float radians = currentPlayer->GetAngle() * (3.14159265358979323846f / 180.0f);
-                const float powerRatio = currentPlayer->GetPower() / 100.0f;
-                Vector2 velocity(std::cos(radians), std::sin(radians));
-                if (!currentPlayer->IsFacingRight()) {
-                    velocity.x = -velocity.x;
-                }
-                velocity = velocity * (powerRatio * 1800.0f); // Increased from 1200 to 1800 for faster, smoother projectiles
-
-                Vector2 spawnPos = currentPlayer->GetPosition();
-
-                // Check if player has selected skills
-                const std::vector<int>& selectedSkills = currentPlayer->GetSelectedSkills();
-                if (!selectedSkills.empty()) {
-                    // Create projectile with skills
-                    m_physics->AddProjectileWithSkills(spawnPos, velocity, selectedSkills, currentPlayer->GetId());
-
-                    // Remove used skills from inventory
-                    for (int skillType : selectedSkills) {
-                        auto& inventory = currentPlayer->GetInventory();
-                        auto it = std::find(inventory.begin(), inventory.end(), skillType);
-                        if (it != inventory.end()) {
-                            int slot = static_cast<int>(std::distance(inventory.begin(), it));
-                            currentPlayer->UseInventorySlot(slot);
-                        }
-                    }
-
-                    // Clear selected skills
-                    currentPlayer->ClearSelectedSkills();
-                }
-                else {
-                    // Normal projectile without skills
-                    m_physics->AddProjectile(std::make_unique<Projectile>(spawnPos, velocity, ProjectileType::NORMAL, currentPlayer->GetId()));
-                }
-
-                currentPlayer->SetPower(0.0f);
-                currentPlayer->SetState(PlayerState::IDLE);
-                // Wait for projectiles to land before ending turn
-                m_waitingForProjectiles = true;
-            }
-        }
-
-        // Process turn
-        ProcessTurn();
-
-        // Check win conditions
-        CheckWinConditions();
     }
 }
 
-void Game::ProcessCurrentPlayerInput() {
-    // Safety check
-    if (m_currentPlayerIndex >= m_players.size()) return;
-    
-    Player* currentPlayer = m_players[m_currentPlayerIndex].get();
-    
-    // Only process input for alive players
-    if (!currentPlayer->IsAlive()) return;
-
-    // Check if inventory slots were pressed (toggle skill selection)
-    if (currentPlayer->GetState() == PlayerState::AIMING) {
-        // Check for skill usage (keys 1-4)
-        if (m_inputManager->IsPlayerInputJustPressed(m_currentPlayerIndex, InputManager::PlayerInput::USE_SLOT_1)) {
-            currentPlayer->ToggleSkillSelection(0);
-        }
-        if (m_inputManager->IsPlayerInputJustPressed(m_currentPlayerIndex, InputManager::PlayerInput::USE_SLOT_2)) {
-            currentPlayer->ToggleSkillSelection(1);
-        }
-        if (m_inputManager->IsPlayerInputJustPressed(m_currentPlayerIndex, InputManager::PlayerInput::USE_SLOT_3)) {
-            currentPlayer->ToggleSkillSelection(2);
-        }
-        if (m_inputManager->IsPlayerInputJustPressed(m_currentPlayerIndex, InputManager::PlayerInput::USE_SLOT_4)) {
-            currentPlayer->ToggleSkillSelection(3);
-        }
+void Game::StepMatch() {
+    MatchInput input = BuildMatchInput();
+    if (m_netSession) {
+        // The session schedules the input and steps (or re-steps) the match
+        m_netSession->AdvanceFrame(input.buttons);
+    } else {
+        m_replayRecorder.RecordStep(input);
+        m_match->Step(input);
+        m_replayRecorder.RecordStateHash(*m_match);
     }
+}
 
-    // Check if space key (ADJUST_POWER) was just released to shoot
-    if (currentPlayer->GetState() == PlayerState::AIMING) {
-        bool spaceReleased = m_inputManager->IsPlayerInputJustReleased(
-            m_currentPlayerIndex, InputManager::PlayerInput::ADJUST_POWER);
+bool Game::IsUnattended() const {
+    return m_match && m_match->IsStarted() && !m_match->IsEnded() &&
+        (m_match->IsWaitingForProjectiles() || m_match->IsImpactDelayActive());
+}
 
-        if (spaceReleased && currentPlayer->GetPower() > 0.0f) {
-            // Player released space, trigger shot
-            currentPlayer->SetState(PlayerState::THROWING);
-        }
+bool Game::ShouldRender() {
+    // Nobody is looking at a minimized or covered window
+    SDL_WindowFlags flags = SDL_GetWindowFlags(m_window);
+    if (flags & (SDL_WINDOW_MINIMIZED | SDL_WINDOW_OCCLUDED | SDL_WINDOW_HIDDEN)) {
+        return false;
     }
-
-    // Process continuous input
-    for (int input = 0; input < static_cast<int>(InputManager::PlayerInput::NONE); ++input) {
-        InputManager::PlayerInput playerInput = static_cast<InputManager::PlayerInput>(input);
-        bool pressed = m_inputManager->IsPlayerInputPressed(m_currentPlayerIndex, playerInput);
-        currentPlayer->HandleInput(static_cast<int>(playerInput), pressed);
+    if (!m_fastForwarding) {
+        m_fastForwardFrames = 0;
+        return true;
     }
+    return m_fastForwardFrames++ % TURBO_RENDER_INTERVAL == 0;
 }
 
-void Game::ProcessTurn() {
-    if (!m_gameStarted) {
-        m_gameStarted = true;
-        m_turnTimer = TURN_DURATION;
-        m_turnCounter = 0;
-        // Always start with player 0 (first player)
-        m_currentPlayerIndex = 0;
-        // Find first alive player
-        while (m_currentPlayerIndex < m_players.size() && !m_players[m_currentPlayerIndex]->IsAlive()) {
-            m_currentPlayerIndex++;
-        }
-        if (m_currentPlayerIndex < m_players.size()) {
-            m_players[m_currentPlayerIndex]->StartTurn();
-        }
-        // Don't spawn orbs at game start - wait for [playercount - 1] turns
-        m_ui->ShowMessage("Game Started! Player " + std::to_string(m_currentPlayerIndex + 1) + "'s turn");
-        return;
+MatchInput Game::BuildMatchInput() const {
+    // All players share the same keys, so the active player's mapping is read
+    MatchInput input;
+    int playerIndex = m_match->GetCurrentPlayerIndex();
+    for (int i = 0; i < static_cast<int>(InputManager::PlayerInput::NONE); ++i) {
+        InputManager::PlayerInput playerInput = static_cast<InputManager::PlayerInput>(i);
+        input.SetPressed(playerInput, m_inputManager->IsPlayerInputPressed(playerIndex, playerInput));
     }
+    return input;
+}
 
-    if (m_gameEnded) return;
+void Game::UpdateNetplay() {
+    m_netSession->Poll();
+    RollbackSession::Status status = m_netSession->GetStatus();
 
-    // Check if current player died during their turn - skip immediately
-    if (!m_players[m_currentPlayerIndex]->IsAlive()) {
-        m_players[m_currentPlayerIndex]->EndTurn();
-        m_waitingForProjectiles = false;
+    // Guest: start the host's match as soon as it arrives
+    if (!m_netSession->IsHost() && status == RollbackSession::Status::RUNNING && !m_match) {
+        const NetplaySetup& setup = m_netSession->GetSetup();
+        StartMatch(setup.config, setup.mapFolder, setup.seed);
+        return;
+    }
+    if (!m_match) return;
 
-        // Move to next alive player
-        do {
-            m_currentPlayerIndex = (m_currentPlayerIndex + 1) % m_players.size();
-        } while (!m_players[m_currentPlayerIndex]->IsAlive() && !m_gameEnded);
+    if (status == RollbackSession::Status::DISCONNECTED) {
+        // Carry on as a local match
+        m_ui->ShowMessage("Opponent disconnected");
+        EndNetplay();
+        return;
+    }
 
-        // Start next player's turn
-        m_turnCounter++;
-        m_turnTimer = TURN_DURATION;
-        m_players[m_currentPlayerIndex]->StartTurn();
+    if (m_match->IsEnded() && !m_netGameOverShown && m_netSession->IsConfirmed()) {
+        m_netGameOverShown = true;
+        m_ui->ShowGameOver(m_match->GetWinnerId(), m_gameMode);
+        SaveReplay(m_match->GetWinnerId());
+    }
+}
 
-        // Spawn skill orbs after [playercount - 1] turns, then every [playercount - 1] turns
-        int playerCount = static_cast<int>(m_players.size());
-        int spawnInterval = playerCount - 1;
-        if (spawnInterval > 0 && m_turnCounter >= spawnInterval && (m_turnCounter % spawnInterval == 0)) {
-            SpawnSkillOrbs();
+void Game::HandleGameEvents(float deltaTime) {
+    GameEvent event;
+    while (m_messageEvents.Next(event)) {
+        char text[64];
+        switch (event.type) {
+        case GameEventType::MATCH_STARTED:
+            std::snprintf(text, sizeof(text), "Game Started! Player %d's turn", event.playerId + 1);
+            m_ui->ShowMessage(text);
+            break;
+        case GameEventType::TURN_STARTED:
+            std::snprintf(text, sizeof(text), "Player %d's turn", event.playerId + 1);
+            m_ui->ShowMessage(text);
+            break;
+        case GameEventType::ORBS_SPAWNED:
+            m_ui->ShowMessage("Skill orbs spawned!");
+            break;
+        default:
+            break;
         }
+    }
 
-        // Remove expired skill orbs (older than [playercount - 1] turns)
-        m_skillOrbs.erase(
-            std::remove_if(m_skillOrbs.begin(), m_skillOrbs.end(),
-                [this, playerCount](const std::unique_ptr<SkillOrb>& orb) {
-                    return orb->IsExpired(m_turnCounter, playerCount);
-                }),
-            m_skillOrbs.end()
-        );
+    while (m_effectEvents.Next(event)) {
+        if (event.type != GameEventType::EXPLOSION) continue;
 
-        m_ui->ShowMessage("Player " + std::to_string(m_currentPlayerIndex + 1) + "'s turn");
-        return;
-    }
+        // Purely cosmetic, so an impact past the pool's capacity simply goes unanimated
+        ExplosionAnimation* explosion = m_explosions.Spawn();
+        if (!explosion) continue;
 
-    // If waiting for projectiles, don't count down timer until all projectiles land
-    if (m_waitingForProjectiles) {
-        if (!m_physics->HasActiveProjectiles()) {
-            // All projectiles have landed, start camera delay
-            m_waitingForProjectiles = false;
-            m_cameraDelayActive = true;
-            m_cameraDelayTimer = CAMERA_DELAY_AFTER_IMPACT;
+        auto type = static_cast<ExplosionAnimationType>(event.kind);
+        if (type == ExplosionAnimationType::TELEPORT || type == ExplosionAnimationType::HEAL) {
+            explosion->Restart(event.position, std::max(event.amount, 50.0f), type);
+        } else {
+            explosion->Restart(event.position, event.amount, type == ExplosionAnimationType::BIG_EXPLOSION
+                ? ExplosionAnimationType::BIG_EXPLOSION : ExplosionAnimationType::SMALL_EXPLOSION);
+        }
+        if (!explosion->Load(m_renderer.get())) {
+            m_explosions.Despawn(explosion);
         }
-        return; // Don't decrement timer while waiting
     }
 
-    // If camera delay is active after projectiles landed, don't count down timer
-    if (m_cameraDelayActive) {
-        return; // Delay will force turn end when it expires
+    for (ExplosionAnimation& explosion : m_explosions) {
+        explosion.Update(deltaTime);
     }
+    m_explosions.DespawnIf([](const ExplosionAnimation& e) { return e.IsFinished(); });
+}
 
-    m_turnTimer -= 1.0f / 60.0f;
-
-    if (m_turnTimer <= 0.0f) {
-        // End current player's turn
-        m_players[m_currentPlayerIndex]->EndTurn();
+void Game::SaveReplay(int winnerId) {
+    if (!m_replayRecorder.IsRecording()) return;
+    m_replayRecorder.End(winnerId);
 
-        // Move to next alive player
-        do {
-            m_currentPlayerIndex = (m_currentPlayerIndex + 1) % m_players.size();
-        } while (!m_players[m_currentPlayerIndex]->IsAlive() && !m_gameEnded);
+    const ReplayData& replay = m_replayRecorder.GetData();
+    std::error_code error;
+    std::filesystem::create_directories("replays", error);
+    std::string path = "replays/replay_" + std::to_string(replay.seed) + ".bin";
+    if (replay.SaveToFile(path)) {
+        std::cout << "Replay saved: " << path << std::endl;
+    }
+}
 
-        // Start next player's turn
-        m_turnCounter++;
-        m_turnTimer = TURN_DURATION;
-        m_players[m_currentPlayerIndex]->StartTurn();
+void Game::ToggleTrace() {
+    if (Profiler::IsTracing()) {
+        Profiler::StopTrace();
+        m_ui->ShowMessage("Trace saved");
+        return;
+    }
 
-        // Spawn skill orbs after [playercount - 1] turns, then every [playercount - 1] turns
-        int playerCount = static_cast<int>(m_players.size());
-        int spawnInterval = playerCount - 1;
-        if (spawnInterval > 0 && m_turnCounter >= spawnInterval && (m_turnCounter % spawnInterval == 0)) {
-            SpawnSkillOrbs();
-        }
+    std::error_code error;
+    std::filesystem::create_directories("traces", error);
+    std::string path = "traces/trace_" + std::to_string(static_cast<long long>(std::time(nullptr))) + ".json";
+    m_ui->ShowMessage(Profiler::StartTrace(path) ? "Recording trace (F4 to stop)" : "Failed to start trace");
+}
 
-        // Remove expired skill orbs (older than [playercount - 1] turns)
-        m_skillOrbs.erase(
-            std::remove_if(m_skillOrbs.begin(), m_skillOrbs.end(),
-                [this, playerCount](const std::unique_ptr<SkillOrb>& orb) {
-                    return orb->IsExpired(m_turnCounter, playerCount);
-                }),
-            m_skillOrbs.end()
-        );
+bool Game::PublishMetrics(const std::string& name) {
+    m_metricsPublisher = std::make_unique<LiveMetricsPublisher>();
+    if (!m_metricsPublisher->Open(name)) {
+        m_metricsPublisher.reset();
+        return false;
+    }
+    return true;
+}
 
-        m_ui->ShowMessage("Player " + std::to_string(m_currentPlayerIndex + 1) + "'s turn");
+void Game::EnableAllocationCheck() {
+    if (!AllocationTracker::IsEnabled()) {
+        std::cerr << "Allocation check needs a build with BALLY_ALLOCATION_TRACKER" << std::endl;
+        return;
     }
+    m_allocationCheck = true;
+    std::cout << "Allocation check on: steady gameplay frames must not allocate" << std::endl;
 }
 
-void Game::SpawnSkillOrbs() {
-    // Get actual map dimensions for spawning
-    float mapWidth = m_currentMap ? static_cast<float>(m_currentMap->GetWidth()) : 1200.0f;
-    float mapHeight = m_currentMap ? static_cast<float>(m_currentMap->GetHeight()) : 800.0f;
-    
-    // Spawn within map bounds with padding from edges
-    float padding = 100.0f;
-    float minX = padding;
-    float maxX = mapWidth - padding;
-    
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> xDist(minX, maxX);
-    std::uniform_int_distribution<int> skillDist(0, static_cast<int>(SkillType::COUNT) - 1);
-
-    // Skill orb constants
-    const float orbRadius = 15.0f; // DEFAULT_RADIUS from SkillOrb
-    const float minOrbDistance = orbRadius * 2.5f; // Minimum distance between orbs (2.5x radius)
-    
-    // Spawn mid-air - use height range from 20% to 80% of map height
-    float minY = mapHeight * 0.2f;
-    float maxY = mapHeight * 0.8f;
-    std::uniform_real_distribution<float> yDist(minY, maxY);
-    
-    // Spawn [playercount + 2] skill orbs
-    int playerCount = static_cast<int>(m_players.size());
-    int numOrbs = playerCount + 2;
-    int attemptsPerOrb = 50; // Increased attempts to find non-overlapping positions
-    
-    // Store positions of already placed orbs (including existing ones) to prevent overlap
-    std::vector<Vector2> existingOrbPositions;
-    for (const auto& orb : m_skillOrbs) {
-        if (!orb->IsCollected()) {
-            existingOrbPositions.push_back(orb->GetPosition());
-        }
+void Game::CheckFrameAllocations(Uint64 allocations) {
+    if (!m_allocationCheck) return;
+
+    // Loading, menus, netplay (packets) and trace capture allocate by design
+    bool steady = m_gameState == GameState::IN_GAME && m_match && m_match->IsStarted() && !m_match->IsEnded() &&
+        !m_netSession && !Profiler::IsTracing();
+    if (!steady) {
+        m_steadyFrames = 0;
+        return;
     }
-    
-    for (int i = 0; i < numOrbs; ++i) {
-        Vector2 position;
-        bool foundValidPosition = false;
-        
-        // Try to find a valid position that doesn't overlap
-        for (int attempt = 0; attempt < attemptsPerOrb; ++attempt) {
-            float targetX = xDist(gen);
-            float targetY = yDist(gen);
-            Vector2 testPos(targetX, targetY);
-            
-            // Check if position is inside terrain
-            bool insideTerrain = false;
-            if (m_currentMap && m_currentMap->GetTerrain()) {
-                insideTerrain = m_currentMap->GetTerrain()->IsCircleSolid(testPos, orbRadius);
-            }
-            
-            if (!insideTerrain) {
-                // Check if position overlaps with existing orbs (both old and newly placed)
-                bool overlaps = false;
-                for (const Vector2& existingPos : existingOrbPositions) {
-                    Vector2 distance = testPos - existingPos;
-                    if (distance.Length() < minOrbDistance) {
-                        overlaps = true;
-                        break;
-                    }
-                }
-                
-                if (!overlaps) {
-                    position = testPos;
-                    existingOrbPositions.push_back(position); // Add to list to prevent future overlaps
-                    foundValidPosition = true;
-                    break;
-                }
-            }
-        }
-        
-        // If we couldn't find a valid position, use a fallback (middle of map with offset)
-        if (!foundValidPosition) {
-            float fallbackX = mapWidth * 0.5f + (i * 50.0f);
-            float fallbackY = mapHeight * 0.4f + (i * 30.0f);
-            position = Vector2(fallbackX, fallbackY);
-            existingOrbPositions.push_back(position);
-        }
-        
-        SkillType skillType = static_cast<SkillType>(skillDist(gen));
-        auto orb = std::make_unique<SkillOrb>(position, skillType, m_turnCounter);
-        orb->LoadTexture(m_renderer.get());
-        m_skillOrbs.push_back(std::move(orb));
+    if (m_steadyFrames < STEADY_WARMUP_FRAMES) {
+        m_steadyFrames++;
+        return;
     }
+    if (allocations == 0) return;
 
-    m_ui->ShowMessage("Skill orbs spawned!");
-}
+    // One report a second at most, naming the zones the allocations were made in
+    m_allocatingFrames++;
+    Uint64 now = SDL_GetTicks();
+    if (m_lastAllocationReport != 0 && now - m_lastAllocationReport < ALLOCATION_REPORT_INTERVAL_MS) return;
+    m_lastAllocationReport = now;
 
-void Game::CheckWinConditions() {
-    if (m_gameMode == GameMode::TEAM_2V2) {
-        // Team mode: check if all players of one team are dead
-        bool team1Alive = false;
-        bool team2Alive = false;
-        
-        for (size_t i = 0; i < m_players.size(); ++i) {
-            if (m_players[i]->IsAlive()) {
-                int team = m_players[i]->GetTeam();
-                if (team == 1) {
-                    team1Alive = true;
-                } else if (team == 2) {
-                    team2Alive = true;
-                }
-            }
-        }
-        
-        if (!m_gameEnded) {
-            if (!team1Alive && team2Alive) {
-                // Team 2 wins
-                m_gameEnded = true;
-                m_winnerId = -2; // -2 = Team 2
-                m_ui->ShowGameOver(m_winnerId, m_gameMode);
-            } else if (team1Alive && !team2Alive) {
-                // Team 1 wins
-                m_gameEnded = true;
-                m_winnerId = -1; // -1 = Team 1
-                m_ui->ShowGameOver(m_winnerId, m_gameMode);
-            }
-        }
-    } else {
-        // Free-for-all mode: last player standing wins
-        int alivePlayers = 0;
-        int lastAlivePlayer = -1;
-
-        for (size_t i = 0; i < m_players.size(); ++i) {
-            if (m_players[i]->IsAlive()) {
-                alivePlayers++;
-                lastAlivePlayer = static_cast<int>(i);
-            }
+    std::cout << "Steady frame made " << allocations << " heap allocations (" << m_allocatingFrames
+              << " allocating frames since the last report):";
+    for (int zone = 0; zone < Profiler::GetZoneCount(); ++zone) {
+        int zoneAllocations = Profiler::GetZoneAllocations(zone);
+        if (zoneAllocations > 0) {
+            std::cout << " " << Profiler::GetZoneName(zone) << " " << zoneAllocations;
         }
+    }
+    std::cout << std::endl;
+    m_allocatingFrames = 0;
 
-        if (alivePlayers <= 1 && !m_gameEnded) {
-            m_gameEnded = true;
-            m_winnerId = lastAlivePlayer;
-            m_ui->ShowGameOver(m_winnerId, m_gameMode);
-        }
+    SDL_assert(!"Steady gameplay frame allocated, see the report above");
+}
+
+void Game::UpdateMetrics(float frameMs) {
+    if (!m_metricsPublisher) return;
+
+    LiveMetrics metrics;
+    metrics.frameMs = frameMs;
+    metrics.stepsTotal = m_stepsPlayed;
+    metrics.cratersTotal = Terrain::GetCratersCutTotal();
+    if (m_match) {
+        for (const auto& player : m_match->GetPlayers()) {
+            metrics.players++;
+            if (player->IsAlive()) metrics.playersAlive++;
+        }
+        metrics.projectiles = static_cast<Uint32>(m_match->GetPhysics()->GetProjectiles().size());
+        metrics.skillOrbs = static_cast<Uint32>(m_match->GetSkillOrbs().Size());
+        metrics.matchesRunning = m_match->IsEnded() ? 0 : 1;
     }
+    m_metricsPublisher->Publish(metrics);
 }
 
 void Game::ResetGame() {
-    m_currentPlayerIndex = 0;
-    m_turnTimer = TURN_DURATION;
-    m_turnCounter = 0;
-    m_gameStarted = false;
-    m_gameEnded = false;
-    m_winnerId = -1;
-    m_waitingForProjectiles = false;
-    m_cameraDelayActive = false;
-    m_cameraDelayTimer = 0.0f;
-    m_ui->ShowGameOver(-999, m_gameMode); // Reset game over screen (invalid ID to deactivate)
-
-    // Get actual map dimensions for respawning
-    float mapWidth = m_currentMap ? static_cast<float>(m_currentMap->GetWidth()) : 1200.0f;
-    float mapHeight = m_currentMap ? static_cast<float>(m_currentMap->GetHeight()) : 800.0f;
-    
-    // Spread players across the map with padding from edges
-    float padding = 100.0f;
-    float spawnAreaWidth = mapWidth - (padding * 2.0f);
-    float startX = padding;
-
-    // Reset all players and respawn them across the map
-    for (size_t i = 0; i < m_players.size(); ++i) {
-        m_players[i]->ResetForNewGame();
-        
-        // Calculate target spawn position based on map size
-        float spacing = (m_players.size() > 1) ? spawnAreaWidth / (m_players.size() - 1) : 0.0f;
-        float targetX = startX + spacing * i;
-        
-        // Clamp targetX to map bounds
-        targetX = std::max(padding, std::min(targetX, mapWidth - padding));
-        
-        // Find valid spawn position - search for valid ground near targetX
-        float x = targetX;
-        float startY = mapHeight * 0.75f; // Default fallback
-        float playerRadius = m_players[i]->GetRadius();
-        
-        if (m_currentMap && m_currentMap->GetTerrain()) {
-            int spawnX = 0, spawnY = 0;
-            // Search up to 100 pixels left/right to find valid spawn position
-            if (m_currentMap->GetTerrain()->FindValidSpawnPosition((int)targetX, 100, playerRadius, spawnX, spawnY)) {
-                x = (float)spawnX;
-                startY = (float)spawnY - playerRadius - 3.0f; // 3px offset to ensure above terrain
-            } else {
-                // Fallback: try to find any valid ground
-                int terrainY = m_currentMap->GetTerrain()->FindSolidGroundSurface((int)targetX, 50);
-                if (terrainY >= 0) {
-                    startY = (float)terrainY - playerRadius - 3.0f;
-                }
-            }
-        }
-        
-        // Set player position on terrain
-        Vector2 playerPos(x, startY);
-        m_players[i]->SetPosition(playerPos);
-        
-        // Final verification: ensure player is not inside terrain
-        if (m_currentMap && m_currentMap->GetTerrain()) {
-            // Use IsCircleSolid to check if player is inside terrain (more accurate)
-            if (m_currentMap->GetTerrain()->IsCircleSolid(playerPos, playerRadius)) {
-                // Player is inside terrain - find valid position above
-                int terrainY = m_currentMap->GetTerrain()->FindSolidGroundSurface((int)playerPos.x, 50);
-                if (terrainY >= 0) {
-                    playerPos.y = (float)terrainY - playerRadius - 3.0f;
-                    
-                    // Verify this position is valid
-                    if (m_currentMap->GetTerrain()->IsCircleSolid(playerPos, playerRadius)) {
-                        // Still inside, push up until clear
-                        for (int adjustY = terrainY - (int)playerRadius - 3; adjustY >= 0; adjustY -= 1) {
-                            Vector2 testPos(playerPos.x, (float)adjustY);
-                            if (!m_currentMap->GetTerrain()->IsCircleSolid(testPos, playerRadius)) {
-                                playerPos.y = (float)adjustY;
-                                break;
-                            }
-                        }
-                    }
-                }
-            }
-            
-            m_players[i]->SetPosition(playerPos);
-        }
+    // Both peers would have to agree on the new seed
+    if (m_netSession) {
+        m_ui->ShowMessage("Rematch is not available online");
+        return;
     }
 
-    // Clear projectiles and skill orbs
-    m_skillOrbs.clear();
-
+    m_ui->ShowGameOver(-999, m_gameMode); // Reset game over screen (invalid ID to deactivate)
+    if (m_match) {
+        // New seed for the rematch; the terrain keeps its craters and goes into the replay
+        m_match->SetSeed(std::random_device{}());
+        m_match->Reset();
+        std::string mapFolder = m_replayRecorder.GetData().mapFolder;
+        m_replayRecorder.Begin(*m_match, mapFolder);
+    }
+    m_stepAccumulator = 0.0f;
     m_ui->ClearMessages();
+    m_explosions.Clear();
 }
 
 void Game::HandleEvents() {
+    PROFILE_ZONE("Game::HandleEvents");
+
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
         switch (event.type) {
@@ -895,15 +630,31 @@ void Game::HandleEvents() {
                     m_gameState = GameState::IN_GAME;
                 }
             }
-            else if (event.key.scancode == SDL_SCANCODE_R && m_gameEnded) {
+            else if (event.key.scancode == SDL_SCANCODE_R && m_match && m_match->IsEnded()) {
                 ResetGame();
             }
+            else if (event.key.scancode == SDL_SCANCODE_F3) {
+                m_profilerOverlay->Toggle();
+            }
+            else if (event.key.scancode == SDL_SCANCODE_F4) {
+                ToggleTrace();
+            }
+            else if (event.key.scancode == SDL_SCANCODE_F2 && m_gameState == GameState::IN_GAME) {
+                if (m_netSession) {
+                    m_ui->ShowMessage("Turbo is not available online");
+                } else {
+                    m_turbo = !m_turbo;
+                    m_ui->ShowMessage(m_turbo ? "Turbo on: shots resolve at full speed" : "Turbo off");
+                }
+            }
             break;
         }
     }
 }
 
 void Game::Render() {
+    PROFILE_ZONE("Game::Render");
+
     m_renderer->BeginFrame();
 
     // Check if we're in a menu-only state
@@ -915,35 +666,43 @@ void Game::Render() {
     // Render menu-only states (no game background)
     if (isMenuOnlyState) {
         m_menu->Render();
+        m_profilerOverlay->Render();
         m_renderer->EndFrame();
         return;
     }
 
     // Render game with overlays (settings/pause accessed during gameplay)
-    if (m_gameState == GameState::IN_GAME || m_gameState == GameState::PAUSED ||
-        m_gameState == GameState::SETTINGS || m_gameState == GameState::SOUND_SETTINGS) {
+    if (m_match && (m_gameState == GameState::IN_GAME || m_gameState == GameState::PAUSED ||
+        m_gameState == GameState::SETTINGS || m_gameState == GameState::SOUND_SETTINGS)) {
+        const auto& players = m_match->GetPlayers();
+        int currentPlayerIndex = m_match->GetCurrentPlayerIndex();
 
         // Set camera offset for world-space rendering
         m_renderer->SetCameraOffset(m_camera->GetPosition());
 
         // Draw map background and terrain (always visible during gameplay)
+        // (the match has its own copy of the terrain once it gets destroyed)
         if (m_currentMap) {
             m_currentMap->DrawBackground(m_renderer.get());
-            m_currentMap->DrawTerrain(m_renderer.get());
         }
+        m_match->GetTerrain()->Draw(m_renderer.get());
 
         // Draw skill orbs
-        for (const auto& orb : m_skillOrbs) {
-            orb->Draw(m_renderer.get());
+        for (const SkillOrb& orb : m_match->GetSkillOrbs()) {
+            orb.Draw(m_renderer.get());
         }
 
-        // Draw projectiles
-        m_physics->Draw(m_renderer.get());
+        // Draw projectiles and explosions
+        m_match->GetPhysics()->Draw(m_renderer.get());
+        for (ExplosionAnimation& explosion : m_explosions) {
+            explosion.Draw(m_renderer.get());
+        }
 
         // Draw players (including dead ones to show death animation)
-        for (const auto& player : m_players) {
-            // Skip players that should be removed (death animation finished)
+        for (const auto& player : players) {
+            // Skip players that should be removed (death animation finished) or are off screen
             if (player->ShouldBeRemoved()) continue;
+            if (!m_camera->IsVisible(player->GetPosition(), player->GetRadius() * 3.0f)) continue;
 
             // Draw character animation if available, otherwise draw circle
             if (player->GetAnimation()) {
@@ -960,13 +719,13 @@ void Game::Render() {
         }
 
         // Draw world-space UI elements (angle/power indicators, trajectory)
-        m_ui->RenderWorldSpace(m_players, m_currentPlayerIndex, Vector2(0, 0));
+        m_ui->RenderWorldSpace(players, currentPlayerIndex, Vector2(0, 0), m_camera.get());
 
         // Reset camera offset for screen-space UI rendering
         m_renderer->SetCameraOffset(Vector2(0, 0));
 
         // Draw screen-space UI (HUD, timer, messages, minimap)
-        m_ui->RenderScreenSpace(m_players, m_currentPlayerIndex, m_turnTimer,
+        m_ui->RenderScreenSpace(players, currentPlayerIndex, m_match->GetTurnTimer(),
             m_camera->GetPosition(), m_currentMap->GetWidth(), m_currentMap->GetHeight());
 
         // Draw menu overlay if paused or in settings
@@ -976,25 +735,45 @@ void Game::Render() {
         }
     }
 
+    m_profilerOverlay->Render();
     m_renderer->EndFrame();
 }
 
 void Game::StartGame() {
-    // Clear game over screen when starting new game
-    m_ui->ShowGameOver(-999, m_gameMode); // Invalid ID to clear screen
-    
+    // The guest plays whatever the host starts
+    if (m_netSession && !m_netSession->IsHost()) {
+        std::cout << "Waiting for the host to start a match" << std::endl;
+        return;
+    }
+
     // Get game configuration from menu
-    m_gameMode = m_menu->GetGameMode();
-    m_numPlayers = m_menu->GetPlayerCount();
+    MatchConfig config;
+    config.gameMode = m_menu->GetGameMode();
+    config.numPlayers = m_menu->GetPlayerCount();
 
-    // Load the selected map
+    std::string mapFolder; // Empty = default terrain
     int mapIndex = m_menu->GetSelectedMapIndex();
+    if (mapIndex >= 0 && mapIndex < static_cast<int>(m_availableMaps.size())) {
+        mapFolder = m_availableMaps[mapIndex].folderPath;
+    }
+
+    StartMatch(config, mapFolder, std::random_device{}());
+}
 
+void Game::StartMatch(const MatchConfig& config, const std::string& mapFolder, unsigned int seed) {
+    // Clear game over screen when starting new game
+    m_ui->ShowGameOver(-999, m_gameMode); // Invalid ID to clear screen
+    m_gameMode = config.gameMode;
+    m_numPlayers = config.numPlayers;
+
+    // Load the map
     m_currentMap = std::make_unique<Map>();
+    std::string replayMapFolder; // Empty = default terrain
 
-    if (mapIndex >= 0 && mapIndex < static_cast<int>(m_availableMaps.size())) {
-        // Load selected map
-        if (!m_currentMap->LoadFromFolder(m_availableMaps[mapIndex].folderPath)) {
+    if (!mapFolder.empty()) {
+        if (m_currentMap->LoadFromFolder(mapFolder, m_jobSystem.get())) {
+            replayMapFolder = mapFolder;
+        } else {
             std::cerr << "Failed to load map, using default" << std::endl;
             m_currentMap->GetTerrain()->CreateDefaultTerrain(1200, 800);
         }
@@ -1004,42 +783,88 @@ void Game::StartGame() {
         m_currentMap->GetTerrain()->CreateDefaultTerrain(1200, 800);
     }
 
-    // Set terrain in physics system
-    m_physics->SetTerrain(m_currentMap->GetTerrain());
+    // Free space for skill orbs, shared with the match and kept up to date there
+    m_currentMap->GetTerrain()->BuildFreeSpaceMask(SkillOrb::DEFAULT_RADIUS);
 
     // Configure camera for the map size
     m_camera->SetMapBounds(m_currentMap->GetWidth(), m_currentMap->GetHeight());
 
     // Set game mode in UI
     m_ui->SetGameMode(m_gameMode);
+    m_ui->ClearMessages();
 
-    // Create players based on selection
-    CreatePlayers();
+    // Start the match on the loaded map
+    m_match = std::make_unique<Match>();
+    m_match->SetRenderer(m_renderer.get()); // Sprites and character animations
+    m_match->SetJobSystem(m_jobSystem.get());
+    m_match->SetFrameArena(&m_simulationArena);
+    m_match->SetSeed(seed);
+    m_match->SetEventBus(&m_events);
+    m_messageEvents.SkipToEnd();
+    m_effectEvents.SkipToEnd();
+    m_explosions.Clear();
+    m_match->SetOnMatchEnded([this](int winnerId) {
+        // Online the end can still be rolled back; UpdateNetplay shows it once confirmed
+        if (m_netSession) return;
+        m_ui->ShowGameOver(winnerId, m_gameMode);
+        SaveReplay(winnerId);
+    });
+    m_match->Initialize(*m_currentMap->GetTerrain(), config);
+    m_replayRecorder.Begin(*m_match, replayMapFolder);
+    m_stepAccumulator = 0.0f;
+
+    if (m_netSession) {
+        // Host: the guest starts the same match once this reaches it
+        if (m_netSession->IsHost()) {
+            NetplaySetup setup;
+            setup.seed = seed;
+            setup.config = config;
+            setup.mapFolder = replayMapFolder;
+            setup.inputDelay = m_netInputDelay;
+            m_netSession->SetSetup(setup);
+        }
+        m_netSession->Start(*m_match);
+        m_netSession->SetOnFrameConfirmed([this](const MatchInput& input, Uint64 stateHash) {
+            m_replayRecorder.RecordStep(input);
+            m_replayRecorder.RecordStateHash(stateHash);
+        });
+        m_netSession->SetOnDesync([this](int frame, const std::string& difference, const StateHashDetail& local) {
+            // Keep this side's hashes so both dumps can be compared later
+            std::error_code error;
+            std::filesystem::create_directories("desyncs", error);
+            std::string side = m_netSession->IsHost() ? "host" : "guest";
+            std::string path = "desyncs/desync_" + std::to_string(frame) + "_" + side + ".txt";
+            if (local.WriteDump(path, "Netplay desync, " + side + " side: " + difference + " differs")) {
+                std::cout << "Desync dump saved: " << path << std::endl;
+            }
+            m_ui->ShowMessage(("Desync: " + difference + " differs").c_str());
+        });
+        m_netGameOverShown = false;
+
+        if (m_netSession->GetStatus() == RollbackSession::Status::SYNCHRONIZING) {
+            m_ui->ShowMessage("Waiting for an opponent to join...");
+        }
+    }
+
+    SetupPlayerInputs();
 
     // Snap camera to the first player's position
-    if (!m_players.empty()) {
-        m_camera->SetTarget(m_players[0]->GetPosition());
+    const auto& players = m_match->GetPlayers();
+    if (!players.empty()) {
+        m_camera->SetTarget(players[0]->GetPosition());
         m_camera->SnapToTarget();
     }
 
-    // Reset game state
-    m_currentPlayerIndex = 0;
-    m_turnTimer = TURN_DURATION;
-    m_turnCounter = 0;
-    m_gameStarted = false;
-    m_gameEnded = false;
-    m_winnerId = -1;
-    m_waitingForProjectiles = false;
-
-    // Clear any existing projectiles and skill orbs
-    m_skillOrbs.clear();
-    m_ui->ClearMessages();
-
     // Switch to game state
     m_gameState = GameState::IN_GAME;
 }
 
 void Game::ReturnToMenu() {
+    // Leaving an online match ends the session (the peer sees a disconnect)
+    if (m_netSession) {
+        EndNetplay();
+    }
+
     // Clear game over screen when returning to menu
     m_ui->ShowGameOver(-999, m_gameMode); // Invalid ID to clear screen
     m_gameState = GameState::MAIN_MENU;
@@ -1047,13 +872,18 @@ void Game::ReturnToMenu() {
 }
 
 void Game::Shutdown() {
-    m_players.clear();
-    m_skillOrbs.clear();
+    EndNetplay();
+    // Pooled slots keep their textures while despawned, and those belong to the renderer
+    m_explosions.Clear();
+    m_explosions.ForEachSlot([](ExplosionAnimation& explosion) { explosion.Unload(); });
+    m_match.reset();
     m_ui.reset();
     m_menu.reset();
-    m_physics.reset();
     m_inputManager.reset();
     m_renderer.reset();
+    m_jobSystem.reset(); // Joins worker threads
+    m_metricsPublisher.reset();
+    Profiler::Shutdown();
 
     if (m_window) {
         SDL_DestroyWindow(m_window);
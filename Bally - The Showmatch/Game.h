@@ -6,15 +6,20 @@
 #include "Player.h"
 #include "Renderer.h"
 #include "InputManager.h"
-#include "Physics.h"
 #include "UI.h"
-#include "SkillOrb.h"
 #include "Menu.h"
 #include "Map.h"
 #include "Camera.h"
-
-// Forward declarations
-class Projectile;
+#include "ExplosionAnimation.h"
+#include "ObjectPool.h"
+#include "GameEvents.h"
+#include "JobSystem.h"
+#include "Match.h"
+#include "Replay.h"
+#include "RollbackSession.h"
+#include "UdpTransport.h"
+#include "ProfilerOverlay.h"
+#include "LiveMetrics.h"
 
 class Game {
 public:
@@ -25,20 +30,39 @@ public:
     void Run();
     void Shutdown();
 
+    // Online play against one other instance (call after Initialize).
+    // The host picks the match in the menu as usual; the guest joins whatever the host starts.
+    bool HostNetplay(Uint16 port, int inputDelay);
+    bool JoinNetplay(const std::string& host, Uint16 port);
+
+    // Publish live metrics to shared memory every frame (read them with BallyMetrics)
+    bool PublishMetrics(const std::string& name);
+
+    // Report every steady gameplay frame that allocates on the heap (and assert in debug builds).
+    // Steady: a local match in progress, past a short warmup, with no trace being recorded.
+    void EnableAllocationCheck();
+
 private:
     void Update(float deltaTime);
     void Render();
     void HandleEvents();
 
-    void ProcessTurn();
-    void ProcessCurrentPlayerInput();
-    void SpawnSkillOrbs();
-    void CheckWinConditions();
+    MatchInput BuildMatchInput() const;
+    void SaveReplay(int winnerId);
     void ResetGame();
-    void CreatePlayers();
     void SetupPlayerInputs();
     void StartGame();
+    void StartMatch(const MatchConfig& config, const std::string& mapFolder, unsigned int seed);
+    void UpdateNetplay();
+    void EndNetplay();
     void ReturnToMenu();
+    void ToggleTrace(); // F4: Chrome trace capture to traces/
+    void HandleGameEvents(float deltaTime);
+    void StepMatch();
+    bool IsUnattended() const;  // Nobody controls anything: shot in flight or impact pause
+    bool ShouldRender();
+    void UpdateMetrics(float frameMs);
+    void CheckFrameAllocations(Uint64 allocations);
 
     SDL_Window* m_window;
     bool m_running;
@@ -47,10 +71,16 @@ private:
     // Game systems
     std::unique_ptr<Renderer> m_renderer;
     std::unique_ptr<InputManager> m_inputManager;
-    std::unique_ptr<Physics> m_physics;
     std::unique_ptr<UI> m_ui;
+    std::unique_ptr<ProfilerOverlay> m_profilerOverlay; // F3
     std::unique_ptr<Menu> m_menu;
     std::unique_ptr<Camera> m_camera;
+    std::unique_ptr<JobSystem> m_jobSystem; // Worker threads shared by all subsystems
+
+    // Scratch memory reset at the end of every frame: drawing uses m_frameArena, the match's
+    // debug data is built while updating and drawn later, so it gets one frame more
+    FrameArena m_frameArena;
+    DoubleBufferedArena m_simulationArena;
 
     // Map system
     std::vector<MapInfo> m_availableMaps;
@@ -60,29 +90,44 @@ private:
     GameState m_gameState;
     GameMode m_gameMode;
     int m_numPlayers;
-    std::vector<std::unique_ptr<Player>> m_players;
-    std::vector<std::unique_ptr<SkillOrb>> m_skillOrbs;
-    std::vector<std::unique_ptr<Projectile>> m_projectiles;
-
-    int m_currentPlayerIndex;
-    float m_turnTimer;
-    int m_turnCounter; // Track turn number for skill orb lifetimes
-    static constexpr float TURN_DURATION = 20.0f;
-    bool m_gameStarted;
-    bool m_gameEnded;
-    int m_winnerId;
-    bool m_waitingForProjectiles; // Wait for projectiles to land before ending turn
-
-    // Camera delay after projectile lands
-    float m_cameraDelayTimer;
-    bool m_cameraDelayActive;
-    static constexpr float CAMERA_DELAY_AFTER_IMPACT = 0.5f; // 0.5 seconds delay
+    std::unique_ptr<Match> m_match; // Simulation of the match being played
+    float m_stepAccumulator;        // Frame time not yet simulated in fixed match steps
+    ReplayRecorder m_replayRecorder; // Written to replays/ when the match ends
+
+    // Gameplay events of the current match; UI messages and effects read them after stepping
+    EventBus m_events;
+    EventReader m_messageEvents;
+    EventReader m_effectEvents;
+    static constexpr int MAX_EXPLOSIONS = 64; // Animations playing at once; more go unanimated
+    ObjectPool<ExplosionAnimation, MAX_EXPLOSIONS> m_explosions; // Textures stay with their slots
+
+    // Turbo (F2, offline only): unattended stretches run as many steps as the frame budget
+    // allows and are drawn every few frames
+    bool m_turbo;
+    bool m_fastForwarding;
+    int m_fastForwardFrames;
+    static constexpr double TURBO_FRAME_BUDGET_MS = 12.0;
+    static constexpr int TURBO_MAX_STEPS_PER_FRAME = 1200;
+    static constexpr int TURBO_RENDER_INTERVAL = 4;
+
+    // Netplay (nullptr = local hot-seat)
+    std::unique_ptr<UdpTransport> m_netTransport;
+    std::unique_ptr<RollbackSession> m_netSession;
+    int m_netInputDelay;
+    bool m_netGameOverShown; // The end is only shown once every input up to it is confirmed
+
+    std::unique_ptr<LiveMetricsPublisher> m_metricsPublisher; // nullptr = not publishing
+    Uint64 m_stepsPlayed; // Every match since startup
+
+    // --alloc-check
+    bool m_allocationCheck;
+    int m_steadyFrames;         // In a row, the warmup counts up to STEADY_WARMUP_FRAMES
+    int m_allocatingFrames;     // Since the last report
+    Uint64 m_lastAllocationReport;
+    static constexpr int STEADY_WARMUP_FRAMES = 120; // Lets buffers reach their working size
+    static constexpr Uint64 ALLOCATION_REPORT_INTERVAL_MS = 1000;
 
     // Mouse drag for camera
     Vector2 m_lastDragMousePos;
     bool m_isDraggingCamera;
-
-    // Game constants
-    static constexpr int MAX_PLAYERS = 4;
-    static constexpr int MIN_PLAYERS = 2;
 };
\ No newline at end of file
@@ -0,0 +1,49 @@
+#include "GameEvents.h"
+
+EventBus::EventBus() : m_slots(new Slot[CAPACITY]), m_published(0), m_step(0) {
+    for (Uint64 i = 0; i < CAPACITY; ++i) {
+        m_slots[i].sequence.store(0, std::memory_order_relaxed);
+    }
+}
+
+void EventBus::Publish(GameEvent event) {
+    event.step = m_step;
+
+    Uint64 index = m_published.load(std::memory_order_relaxed);
+    Slot& slot = m_slots[index & (CAPACITY - 1)];
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.event = event;
+    slot.sequence.store(index + 1, std::memory_order_release);
+    m_published.store(index + 1, std::memory_order_release);
+}
+
+EventReader::EventReader(const EventBus& bus) : m_bus(&bus), m_cursor(bus.GetPublishedCount()), m_dropped(0) {
+}
+
+bool EventReader::Next(GameEvent& event) {
+    for (;;) {
+        Uint64 published = m_bus->GetPublishedCount();
+        if (m_cursor >= published) return false;
+
+        // Lapped: everything older than one ring is gone
+        if (published - m_cursor > EventBus::CAPACITY) {
+            m_dropped += published - EventBus::CAPACITY - m_cursor;
+            m_cursor = published - EventBus::CAPACITY;
+        }
+
+        const EventBus::Slot& slot = m_bus->m_slots[m_cursor & (EventBus::CAPACITY - 1)];
+        Uint64 before = slot.sequence.load(std::memory_order_acquire);
+        event = slot.event;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        Uint64 after = slot.sequence.load(std::memory_order_relaxed);
+
+        m_cursor++;
+        if (before == m_cursor && after == m_cursor) return true;
+        m_dropped++; // Rewritten while being read
+    }
+}
+
+void EventReader::SkipToEnd() {
+    m_cursor = m_bus->GetPublishedCount();
+}
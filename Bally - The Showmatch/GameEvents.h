@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <SDL3/SDL.h>
+#include "Vector2.h"
+
+enum class GameEventType : Uint8 {
+    MATCH_STARTED,  // playerId: first player
+    TURN_STARTED,   // playerId: player whose turn it is
+    DAMAGE,         // playerId took amount from sourceId's projectile
+    HEAL,           // playerId healed amount by sourceId's projectile
+    EXPLOSION,      // kind: ExplosionAnimationType, amount: radius
+    ORB_COLLECTED,  // playerId got an orb of kind (SkillType) at position
+    ORBS_SPAWNED,   // amount: number of orbs
+    PLAYER_DIED,    // playerId
+    MATCH_ENDED     // playerId: winner, same encoding as Match::GetWinnerId()
+};
+
+// Something that happened in the simulation, for presentation, audio and stats.
+// Plain data so it can be copied between threads without allocating.
+struct GameEvent {
+    GameEventType type;
+    Uint8 kind;
+    Sint16 playerId;
+    Sint16 sourceId;  // Player that caused it (-1 = nobody)
+    int step;
+    Vector2 position;
+    float amount;
+
+    GameEvent() : type(GameEventType::MATCH_STARTED), kind(0), playerId(-1), sourceId(-1), step(0), amount(0.0f) {}
+    GameEvent(GameEventType type, int playerId) : GameEvent() {
+        this->type = type;
+        this->playerId = static_cast<Sint16>(playerId);
+    }
+};
+
+// Broadcast ring of the last CAPACITY events. One producer (the thread stepping the
+// match) publishes without locking, blocking or allocating; any number of EventReaders
+// drain it on their own schedule, each from its own cursor. A reader that falls more
+// than CAPACITY events behind loses the oldest ones instead of stalling the simulation.
+//
+// Slots are guarded like a seqlock: a slot's sequence is cleared while it is rewritten,
+// so a reader racing the producer sees the mismatch and drops that event.
+class EventBus {
+public:
+    EventBus();
+
+    // Producer only. Stamps the step onto everything published after it.
+    void SetStep(int step) { m_step = step; }
+    void Publish(GameEvent event);
+
+    Uint64 GetPublishedCount() const { return m_published.load(std::memory_order_acquire); }
+
+    static constexpr Uint64 CAPACITY = 1024; // Power of two
+
+private:
+    friend class EventReader;
+
+    struct Slot {
+        std::atomic<Uint64> sequence; // Event index + 1 once written, 0 while rewriting
+        GameEvent event;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    std::atomic<Uint64> m_published;
+    int m_step;
+};
+
+class EventReader {
+public:
+    // Starts after the events already published
+    explicit EventReader(const EventBus& bus);
+
+    // Copy out the next event; false once caught up
+    bool Next(GameEvent& event);
+    // Forget everything published so far
+    void SkipToEnd();
+
+    Uint64 GetDroppedCount() const { return m_dropped; }
+
+private:
+    const EventBus* m_bus;
+    Uint64 m_cursor;
+    Uint64 m_dropped; // Overwritten before this reader got to them
+};
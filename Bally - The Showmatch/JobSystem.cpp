@@ -0,0 +1,346 @@
+#include "JobSystem.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+struct JobHandle::Job {
+    std::function<void()> work;
+    std::atomic<int> pendingDependencies{ 1 }; // Starts at 1 so the job can't run while dependencies are being added
+    std::atomic<bool> finished{ false };
+    std::mutex mutex;
+    std::vector<std::shared_ptr<Job>> dependents; // Jobs waiting for this one
+    std::shared_ptr<Job> nextHelper;              // Chains the helpers of one ParallelFor
+};
+
+namespace {
+    // Which JobSystem (if any) the current thread works for, and its queue index
+    thread_local const JobSystem* t_owner = nullptr;
+    thread_local int t_threadIndex = 0;
+}
+
+bool JobHandle::IsFinished() const {
+    return !m_job || m_job->finished.load(std::memory_order_acquire);
+}
+
+JobSystem::JobSystem() : m_running(false), m_queuedJobs(0), m_nextVictim(0), m_deterministic(false) {
+}
+
+JobSystem::~JobSystem() {
+    Shutdown();
+}
+
+bool JobSystem::Initialize(int workerCount) {
+    if (m_running) return true;
+
+    if (workerCount <= 0) {
+        unsigned hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? static_cast<int>(hardwareThreads) - 1 : 0;
+    }
+
+    m_queues.clear();
+    for (int i = 0; i <= workerCount; ++i) {
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    m_running = true;
+    for (int i = 1; i <= workerCount; ++i) {
+        m_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+    }
+
+    std::cout << "Job system started with " << workerCount << " worker threads" << std::endl;
+    return true;
+}
+
+void JobSystem::Shutdown() {
+    if (!m_running) return;
+
+    m_running = false;
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_sleepCondition.notify_all();
+
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    m_workers.clear();
+
+    // Finish anything still queued so waiters and dependents are not left hanging
+    while (RunOneJob(0)) {
+    }
+    m_queues.clear();
+}
+
+void JobSystem::WorkerQueue::PushBack(std::shared_ptr<JobHandle::Job> job) {
+    if (count == ring.size()) {
+        // Unroll into a ring twice the size
+        std::vector<std::shared_ptr<JobHandle::Job>> larger(std::max<size_t>(16, ring.size() * 2));
+        for (size_t i = 0; i < count; ++i) {
+            larger[i] = std::move(ring[(head + i) % ring.size()]);
+        }
+        ring.swap(larger);
+        head = 0;
+    }
+    ring[(head + count) % ring.size()] = std::move(job);
+    count++;
+}
+
+std::shared_ptr<JobHandle::Job> JobSystem::WorkerQueue::PopBack() {
+    count--;
+    return std::move(ring[(head + count) % ring.size()]);
+}
+
+std::shared_ptr<JobHandle::Job> JobSystem::WorkerQueue::PopFront() {
+    std::shared_ptr<JobHandle::Job> job = std::move(ring[head]);
+    head = (head + 1) % ring.size();
+    count--;
+    return job;
+}
+
+int JobSystem::GetCurrentThreadIndex() const {
+    return t_owner == this ? t_threadIndex : 0;
+}
+
+JobHandle JobSystem::Submit(std::function<void()> job) {
+    return Submit(std::move(job), std::vector<JobHandle>());
+}
+
+JobHandle JobSystem::Submit(std::function<void()> job, const JobHandle& dependency) {
+    return Submit(std::move(job), std::vector<JobHandle>{ dependency });
+}
+
+JobHandle JobSystem::Submit(std::function<void()> job, const std::vector<JobHandle>& dependencies) {
+    auto newJob = std::make_shared<JobHandle::Job>();
+    newJob->work = std::move(job);
+
+    // Deterministic/serial mode: dependencies already ran at their own submit, so run now
+    if (IsDeterministic() || !m_running) {
+        for (const JobHandle& dependency : dependencies) {
+            Wait(dependency);
+        }
+        Execute(newJob);
+        return JobHandle(newJob);
+    }
+
+    for (const JobHandle& dependency : dependencies) {
+        AddDependency(newJob, dependency);
+    }
+
+    // Drop the submission guard - schedules the job if all dependencies are done
+    ReleaseDependency(newJob);
+    return JobHandle(newJob);
+}
+
+void JobSystem::AddDependency(const std::shared_ptr<JobHandle::Job>& job, const JobHandle& dependency) {
+    if (!dependency.m_job) return;
+
+    std::lock_guard<std::mutex> lock(dependency.m_job->mutex);
+    if (dependency.m_job->finished.load(std::memory_order_acquire)) {
+        return;
+    }
+    job->pendingDependencies.fetch_add(1, std::memory_order_relaxed);
+    dependency.m_job->dependents.push_back(job);
+}
+
+void JobSystem::ReleaseDependency(const std::shared_ptr<JobHandle::Job>& job) {
+    if (job->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        Schedule(job);
+    }
+}
+
+void JobSystem::Schedule(const std::shared_ptr<JobHandle::Job>& job) {
+    int queueIndex = GetCurrentThreadIndex();
+    WorkerQueue& queue = *m_queues[queueIndex];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.PushBack(job);
+    }
+    m_queuedJobs.fetch_add(1, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_sleepCondition.notify_one();
+}
+
+std::shared_ptr<JobHandle::Job> JobSystem::TakeJob(int threadIndex) {
+    if (m_queues.empty()) return nullptr;
+
+    // Own queue first (LIFO keeps recently pushed work hot in cache)
+    {
+        WorkerQueue& own = *m_queues[threadIndex];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (own.count > 0) {
+            std::shared_ptr<JobHandle::Job> job = own.PopBack();
+            m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+
+    // Steal the oldest job from another queue
+    const int queueCount = static_cast<int>(m_queues.size());
+    const int start = static_cast<int>(m_nextVictim.fetch_add(1, std::memory_order_relaxed) % queueCount);
+    for (int i = 0; i < queueCount; ++i) {
+        int victim = (start + i) % queueCount;
+        if (victim == threadIndex) continue;
+
+        WorkerQueue& other = *m_queues[victim];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (other.count > 0) {
+            std::shared_ptr<JobHandle::Job> job = other.PopFront();
+            m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+
+    return nullptr;
+}
+
+bool JobSystem::RunOneJob(int threadIndex) {
+    std::shared_ptr<JobHandle::Job> job = TakeJob(threadIndex);
+    if (!job) return false;
+
+    Execute(job);
+    return true;
+}
+
+void JobSystem::Execute(const std::shared_ptr<JobHandle::Job>& job) {
+    if (job->work) {
+        PROFILE_ZONE("JobSystem::Execute");
+
+        job->work();
+        job->work = nullptr; // Release captured state early
+    }
+
+    std::vector<std::shared_ptr<JobHandle::Job>> dependents;
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->finished.store(true, std::memory_order_release);
+        dependents.swap(job->dependents);
+    }
+
+    for (const auto& dependent : dependents) {
+        ReleaseDependency(dependent);
+    }
+}
+
+void JobSystem::WorkerLoop(int threadIndex) {
+    t_owner = this;
+    t_threadIndex = threadIndex;
+    Profiler::SetThreadName(("Job worker " + std::to_string(threadIndex)).c_str());
+
+    while (m_running) {
+        if (RunOneJob(threadIndex)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepCondition.wait(lock, [this]() {
+            return !m_running || m_queuedJobs.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
+
+void JobSystem::Wait(const JobHandle& handle) {
+    if (!handle.m_job) return;
+
+    const int threadIndex = GetCurrentThreadIndex();
+    while (!handle.IsFinished()) {
+        // Help out instead of blocking; yield if the job we wait on runs elsewhere
+        if (!RunOneJob(threadIndex)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::WaitAll(const std::vector<JobHandle>& handles) {
+    for (const JobHandle& handle : handles) {
+        Wait(handle);
+    }
+}
+
+void JobSystem::ParallelFor(int count, int batchSize, const std::function<void(int begin, int end)>& body) {
+    if (count <= 0) return;
+
+    batchSize = std::max(1, batchSize);
+    const int batchCount = (count + batchSize - 1) / batchSize;
+
+    // Serial path: same batch boundaries, executed in index order
+    if (IsDeterministic() || batchCount == 1) {
+        for (int batch = 0; batch < batchCount; ++batch) {
+            int begin = batch * batchSize;
+            body(begin, std::min(begin + batchSize, count));
+        }
+        return;
+    }
+
+    // Helpers and the calling thread claim batches from a shared counter
+    struct Loop {
+        std::atomic<int> nextBatch;
+        const std::function<void(int begin, int end)>* body;
+        int batchCount;
+        int batchSize;
+        int count;
+
+        void RunBatches() {
+            for (;;) {
+                int batch = nextBatch.fetch_add(1, std::memory_order_relaxed);
+                if (batch >= batchCount) break;
+                PROFILE_ZONE("JobSystem::ParallelFor batch");
+
+                int begin = batch * batchSize;
+                (*body)(begin, std::min(begin + batchSize, count));
+            }
+        }
+    };
+    Loop loop;
+    loop.nextBatch.store(0, std::memory_order_relaxed);
+    loop.body = &body;
+    loop.batchCount = batchCount;
+    loop.batchSize = batchSize;
+    loop.count = count;
+
+    // Helper jobs are recycled and capture one pointer (small enough for std::function to
+    // store inline), so a loop allocates nothing once the spare jobs exist
+    const int helperCount = std::min(GetWorkerCount(), batchCount - 1);
+    std::shared_ptr<JobHandle::Job> helpers;
+    for (int i = 0; i < helperCount; ++i) {
+        std::shared_ptr<JobHandle::Job> helper = TakeSpareJob();
+        helper->work = [&loop]() { loop.RunBatches(); };
+        helper->nextHelper = std::move(helpers);
+        helpers = helper;
+        ReleaseDependency(helper);
+    }
+
+    loop.RunBatches();
+    while (helpers) {
+        Wait(JobHandle(helpers));
+        std::shared_ptr<JobHandle::Job> next = std::move(helpers->nextHelper);
+        ReturnSpareJob(std::move(helpers));
+        helpers = std::move(next);
+    }
+}
+
+std::shared_ptr<JobHandle::Job> JobSystem::TakeSpareJob() {
+    {
+        std::lock_guard<std::mutex> lock(m_spareMutex);
+        if (!m_spareJobs.empty()) {
+            std::shared_ptr<JobHandle::Job> job = std::move(m_spareJobs.back());
+            m_spareJobs.pop_back();
+            return job;
+        }
+    }
+    return std::make_shared<JobHandle::Job>();
+}
+
+void JobSystem::ReturnSpareJob(std::shared_ptr<JobHandle::Job> job) {
+    // Finished and never handed out, so nothing else can still add a dependent to it
+    job->finished.store(false, std::memory_order_relaxed);
+    job->pendingDependencies.store(1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(m_spareMutex);
+    m_spareJobs.push_back(std::move(job));
+}
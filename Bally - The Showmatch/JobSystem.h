@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem;
+
+// Handle to a submitted job - used to wait on it or to make other jobs depend on it
+class JobHandle {
+public:
+    JobHandle() = default;
+
+    bool IsValid() const { return m_job != nullptr; }
+    bool IsFinished() const;
+
+private:
+    friend class JobSystem;
+    struct Job;
+    explicit JobHandle(std::shared_ptr<Job> job) : m_job(std::move(job)) {}
+
+    std::shared_ptr<Job> m_job;
+};
+
+// Work-stealing thread pool shared by the engine subsystems.
+// Every worker owns a deque: it pushes/pops its own work at the back and steals from
+// the front of other workers' deques when it runs dry. Threads that wait on a job
+// (including the main thread) help by executing queued jobs instead of blocking.
+class JobSystem {
+public:
+    JobSystem();
+    ~JobSystem();
+
+    // Start the worker threads (0 = one per hardware thread, minus the calling thread)
+    bool Initialize(int workerCount = 0);
+    void Shutdown();
+
+    // Submit a job, optionally after other jobs have finished
+    JobHandle Submit(std::function<void()> job);
+    JobHandle Submit(std::function<void()> job, const JobHandle& dependency);
+    JobHandle Submit(std::function<void()> job, const std::vector<JobHandle>& dependencies);
+
+    // Block until the job is finished, running other jobs in the meantime
+    void Wait(const JobHandle& handle);
+    void WaitAll(const std::vector<JobHandle>& handles);
+
+    // Run body(begin, end) over [0, count) split into batches of batchSize.
+    // Batch boundaries only depend on count and batchSize (never on the worker count),
+    // so callers can write per-batch results and merge them in index order.
+    void ParallelFor(int count, int batchSize, const std::function<void(int begin, int end)>& body);
+
+    // Deterministic mode runs every job inline on the submitting thread in submission order.
+    // Use it for lockstep/replay simulation or when debugging ordering issues.
+    void SetDeterministic(bool deterministic) { m_deterministic = deterministic; }
+    bool IsDeterministic() const { return m_deterministic || m_workers.empty(); }
+
+    int GetWorkerCount() const { return static_cast<int>(m_workers.size()); }
+
+    // Index of the calling thread: 0 for non-worker threads, 1..N for workers.
+    // Sized for per-thread scratch buffers (GetWorkerCount() + 1 slots).
+    int GetCurrentThreadIndex() const;
+
+private:
+    // The owner pushes and pops at the back, thieves take from the front. The ring only ever
+    // grows, so scheduling stops allocating once a queue has held its busiest load.
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<JobHandle::Job>> ring;
+        size_t head = 0;
+        size_t count = 0;
+
+        void PushBack(std::shared_ptr<JobHandle::Job> job);
+        std::shared_ptr<JobHandle::Job> PopBack();
+        std::shared_ptr<JobHandle::Job> PopFront();
+    };
+
+    std::vector<std::thread> m_workers;
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues; // [0] = injection queue for non-worker threads
+    std::atomic<bool> m_running;
+    std::atomic<int> m_queuedJobs;
+    std::atomic<unsigned> m_nextVictim;
+    bool m_deterministic;
+
+    // Sleeping workers wait here when there is nothing to steal
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCondition;
+
+    // Finished ParallelFor helper jobs, handed out again by the next loop
+    std::mutex m_spareMutex;
+    std::vector<std::shared_ptr<JobHandle::Job>> m_spareJobs;
+    std::shared_ptr<JobHandle::Job> TakeSpareJob();
+    void ReturnSpareJob(std::shared_ptr<JobHandle::Job> job);
+
+    void WorkerLoop(int threadIndex);
+    void Schedule(const std::shared_ptr<JobHandle::Job>& job);
+    std::shared_ptr<JobHandle::Job> TakeJob(int threadIndex);
+    bool RunOneJob(int threadIndex);
+    void Execute(const std::shared_ptr<JobHandle::Job>& job);
+    void AddDependency(const std::shared_ptr<JobHandle::Job>& job, const JobHandle& dependency);
+    void ReleaseDependency(const std::shared_ptr<JobHandle::Job>& job);
+};
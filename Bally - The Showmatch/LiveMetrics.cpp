@@ -0,0 +1,230 @@
+#include "LiveMetrics.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+double SteadySeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Uint64 ReadResidentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.WorkingSetSize;
+    }
+    return 0;
+#elif defined(__linux__)
+    // Second field: resident pages
+    std::ifstream statm("/proc/self/statm");
+    Uint64 size = 0, resident = 0;
+    if (statm >> size >> resident) {
+        return resident * static_cast<Uint64>(sysconf(_SC_PAGESIZE));
+    }
+    return 0;
+#else
+    return 0;
+#endif
+}
+
+Uint32 CurrentProcessId() {
+#ifdef _WIN32
+    return static_cast<Uint32>(GetCurrentProcessId());
+#else
+    return static_cast<Uint32>(getpid());
+#endif
+}
+
+// Maps the segment; creates it when writable. Returns nullptr on failure.
+void* MapSegment(const std::string& name, bool writable, void*& handle) {
+    handle = nullptr;
+#ifdef _WIN32
+    std::string path = "Local\\" + name;
+    HANDLE mapping = writable
+        ? CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, sizeof(LiveMetricsBlock), path.c_str())
+        : OpenFileMappingA(FILE_MAP_READ, FALSE, path.c_str());
+    if (!mapping) return nullptr;
+
+    void* view = MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, sizeof(LiveMetricsBlock));
+    if (!view) {
+        CloseHandle(mapping);
+        return nullptr;
+    }
+    handle = mapping;
+    return view;
+#else
+    std::string path = "/" + name;
+    int file = writable ? shm_open(path.c_str(), O_CREAT | O_RDWR, 0644) : shm_open(path.c_str(), O_RDONLY, 0);
+    if (file < 0) return nullptr;
+    if (writable && ftruncate(file, sizeof(LiveMetricsBlock)) != 0) {
+        close(file);
+        return nullptr;
+    }
+
+    void* view = mmap(nullptr, sizeof(LiveMetricsBlock), writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, file, 0);
+    close(file); // The mapping keeps the segment alive
+    return view == MAP_FAILED ? nullptr : view;
+#endif
+}
+
+void UnmapSegment(const void* view, void* handle) {
+#ifdef _WIN32
+    UnmapViewOfFile(view);
+    CloseHandle(static_cast<HANDLE>(handle));
+#else
+    (void)handle;
+    munmap(const_cast<void*>(view), sizeof(LiveMetricsBlock));
+#endif
+}
+
+}
+
+LiveMetricsPublisher::LiveMetricsPublisher()
+    : m_block(nullptr), m_handle(nullptr), m_windowStarted(false), m_windowStart(0.0), m_windowSteps(0),
+      m_windowCraters(0), m_windowFrameMs(0.0), m_windowFrames(0), m_stepsPerSecond(0.0f),
+      m_cratersPerSecond(0.0f), m_frameMsAverage(0.0f), m_residentBytes(0) {
+}
+
+LiveMetricsPublisher::~LiveMetricsPublisher() {
+    Close();
+}
+
+bool LiveMetricsPublisher::Open(const std::string& name) {
+    Close();
+
+    void* view = MapSegment(name, true, m_handle);
+    if (!view) {
+        std::cerr << "Failed to create metrics segment: " << name << std::endl;
+        return false;
+    }
+
+    m_block = static_cast<LiveMetricsBlock*>(view);
+    m_block->magic = 0; // Readers ignore the segment until the header is complete
+    m_block->version = LiveMetricsBlock::VERSION;
+    m_block->processId = CurrentProcessId();
+    m_block->sequence.store(0, std::memory_order_relaxed);
+    m_block->metrics = LiveMetrics();
+    std::atomic_thread_fence(std::memory_order_release);
+    m_block->magic = LiveMetricsBlock::MAGIC;
+
+    m_name = name;
+    m_windowStarted = false;
+    m_windowFrameMs = 0.0;
+    m_windowFrames = 0;
+    m_residentBytes = ReadResidentBytes();
+    std::cout << "Publishing live metrics to shared memory: " << name << std::endl;
+    return true;
+}
+
+void LiveMetricsPublisher::Close() {
+    if (!m_block) return;
+
+    m_block->magic = 0;
+    UnmapSegment(m_block, m_handle);
+#ifndef _WIN32
+    shm_unlink(("/" + m_name).c_str());
+#endif
+    m_block = nullptr;
+    m_handle = nullptr;
+}
+
+void LiveMetricsPublisher::Publish(LiveMetrics metrics) {
+    if (!m_block) return;
+
+    // Rates over a fixed window; memory is sampled once per window since it costs a syscall
+    double now = SteadySeconds();
+    if (!m_windowStarted) {
+        m_windowStarted = true;
+        m_windowStart = now;
+        m_windowSteps = metrics.stepsTotal;
+        m_windowCraters = metrics.cratersTotal;
+    }
+    m_windowFrameMs += metrics.frameMs;
+    m_windowFrames++;
+    double elapsed = now - m_windowStart;
+    if (elapsed >= RATE_WINDOW_SECONDS) {
+        m_stepsPerSecond = static_cast<float>((metrics.stepsTotal - m_windowSteps) / elapsed);
+        m_cratersPerSecond = static_cast<float>((metrics.cratersTotal - m_windowCraters) / elapsed);
+        m_frameMsAverage = static_cast<float>(m_windowFrameMs / m_windowFrames);
+        m_residentBytes = ReadResidentBytes();
+
+        m_windowStart = now;
+        m_windowSteps = metrics.stepsTotal;
+        m_windowCraters = metrics.cratersTotal;
+        m_windowFrameMs = 0.0;
+        m_windowFrames = 0;
+    }
+
+    metrics.publishCount = m_block->metrics.publishCount + 1;
+    metrics.unixTimeMs = static_cast<Uint64>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    metrics.frameMsAverage = m_frameMsAverage;
+    metrics.stepsPerSecond = m_stepsPerSecond;
+    metrics.cratersPerSecond = m_cratersPerSecond;
+    metrics.residentBytes = m_residentBytes;
+
+    // Seqlock write: odd sequence, data, even sequence
+    Uint32 sequence = m_block->sequence.load(std::memory_order_relaxed);
+    m_block->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_block->metrics = metrics;
+    m_block->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+LiveMetricsReader::LiveMetricsReader() : m_block(nullptr), m_handle(nullptr) {
+}
+
+LiveMetricsReader::~LiveMetricsReader() {
+    Close();
+}
+
+bool LiveMetricsReader::Open(const std::string& name) {
+    Close();
+
+    const void* view = MapSegment(name, false, m_handle);
+    if (!view) return false;
+    m_block = static_cast<const LiveMetricsBlock*>(view);
+    return true;
+}
+
+void LiveMetricsReader::Close() {
+    if (!m_block) return;
+    UnmapSegment(m_block, m_handle);
+    m_block = nullptr;
+    m_handle = nullptr;
+}
+
+bool LiveMetricsReader::Read(LiveMetrics& metrics, Uint32& processId) const {
+    if (!m_block) return false;
+    if (m_block->magic != LiveMetricsBlock::MAGIC || m_block->version != LiveMetricsBlock::VERSION) return false;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    processId = m_block->processId;
+
+    for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt) {
+        Uint32 before = m_block->sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        metrics = m_block->metrics;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        Uint32 after = m_block->sequence.load(std::memory_order_relaxed);
+        if (before == after) return true;
+    }
+    return false;
+}
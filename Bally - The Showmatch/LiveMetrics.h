@@ -0,0 +1,90 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <atomic>
+#include <string>
+
+// Numbers a running game or server publishes for outside monitoring (BallyMetrics reads them).
+// Fill in the counts and totals; the publisher works out the rates, memory use and timestamp.
+struct LiveMetrics {
+    Uint64 publishCount = 0;
+    Uint64 unixTimeMs = 0;
+    float frameMs = 0.0f;               // Work time of the last frame (server: 0)
+    float frameMsAverage = 0.0f;        // Over the last rate window
+    float stepsPerSecond = 0.0f;
+    float cratersPerSecond = 0.0f;      // Terrain edits
+    Uint64 stepsTotal = 0;
+    Uint64 cratersTotal = 0;
+    Uint32 players = 0;                 // Game only, like the next three
+    Uint32 playersAlive = 0;
+    Uint32 projectiles = 0;
+    Uint32 skillOrbs = 0;
+    Uint32 matchesRunning = 0;
+    Uint32 matchesFinished = 0;
+    Uint64 residentBytes = 0;           // Process memory in RAM
+};
+
+// Layout of the shared-memory segment. Readers check magic and version before trusting it;
+// bump VERSION whenever LiveMetrics changes.
+struct LiveMetricsBlock {
+    Uint32 magic;
+    Uint32 version;
+    Uint32 processId;
+    std::atomic<Uint32> sequence; // Seqlock: odd while the publisher is writing
+    LiveMetrics metrics;
+
+    static constexpr Uint32 MAGIC = 0x4D4C4142; // "BALM"
+    static constexpr Uint32 VERSION = 1;
+};
+
+// Writes LiveMetrics to a named shared-memory segment (POSIX shm / Windows file mapping).
+// Publishing never blocks: readers retry when they catch an update half-way.
+class LiveMetricsPublisher {
+public:
+    LiveMetricsPublisher();
+    ~LiveMetricsPublisher();
+
+    bool Open(const std::string& name);
+    void Close();
+    bool IsOpen() const { return m_block != nullptr; }
+
+    void Publish(LiveMetrics metrics);
+
+    static constexpr const char* DEFAULT_NAME = "bally_metrics";
+    static constexpr double RATE_WINDOW_SECONDS = 1.0;
+
+private:
+    LiveMetricsBlock* m_block;
+    void* m_handle;
+    std::string m_name;
+
+    // Rate window
+    bool m_windowStarted;
+    double m_windowStart;
+    Uint64 m_windowSteps;
+    Uint64 m_windowCraters;
+    double m_windowFrameMs;
+    int m_windowFrames;
+    float m_stepsPerSecond;
+    float m_cratersPerSecond;
+    float m_frameMsAverage;
+    Uint64 m_residentBytes;
+};
+
+class LiveMetricsReader {
+public:
+    LiveMetricsReader();
+    ~LiveMetricsReader();
+
+    bool Open(const std::string& name);
+    void Close();
+
+    // false if the segment is not a compatible version or stayed mid-update for too long
+    bool Read(LiveMetrics& metrics, Uint32& processId) const;
+
+private:
+    const LiveMetricsBlock* m_block;
+    void* m_handle;
+
+    static constexpr int MAX_READ_ATTEMPTS = 1000;
+};
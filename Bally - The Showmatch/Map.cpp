@@ -1,5 +1,7 @@
 #include "Map.h"
+#include "Profiler.h"
 #include "Renderer.h"
+#include "JobSystem.h"
 #include <iostream>
 #include <filesystem>
 
@@ -15,12 +17,14 @@ Map::~Map() {
         m_backgroundSurface = nullptr;
     }
     if (m_backgroundTexture) {
-        SDL_DestroyTexture(m_backgroundTexture);
+        Renderer::DestroyTexture(m_backgroundTexture);
         m_backgroundTexture = nullptr;
     }
 }
 
-bool Map::LoadFromFolder(const std::string& folderPath) {
+bool Map::LoadFromFolder(const std::string& folderPath, JobSystem* jobSystem) {
+    PROFILE_ZONE("Map::LoadFromFolder");
+
     m_folderPath = folderPath;
 
     // Extract map name from folder path
@@ -33,20 +37,33 @@ bool Map::LoadFromFolder(const std::string& folderPath) {
     std::string terrainPath = folderPath + "/terrain.png";
     std::string backgroundPath = folderPath + "/background.png";
 
+    // Decode the background (optional) on a worker while the terrain loads here
+    JobHandle backgroundJob;
+    if (jobSystem) {
+        backgroundJob = jobSystem->Submit([this, backgroundPath]() { LoadBackground(backgroundPath); });
+    }
+
     // Load terrain (required)
-    if (!m_terrain->LoadFromImage(terrainPath)) {
+    bool terrainLoaded = m_terrain->LoadFromImage(terrainPath);
+
+    if (jobSystem) {
+        jobSystem->Wait(backgroundJob);
+    } else {
+        LoadBackground(backgroundPath);
+    }
+
+    if (!terrainLoaded) {
         std::cerr << "Failed to load terrain for map: " << m_name.c_str() << std::endl;
         return false;
     }
 
-    // Load background (optional)
-    LoadBackground(backgroundPath);
-
     std::cout << "Map loaded successfully: " << m_name.c_str() << std::endl;
     return true;
 }
 
 void Map::LoadBackground(const std::string& backgroundPath) {
+    PROFILE_ZONE("Map::LoadBackground");
+
     // Try to load background image
     SDL_Surface* loadedSurface = IMG_Load(backgroundPath.c_str());
     if (!loadedSurface) {
@@ -72,18 +89,20 @@ void Map::UpdateBackgroundTexture(Renderer* renderer) {
 
     // Destroy old texture
     if (m_backgroundTexture) {
-        SDL_DestroyTexture(m_backgroundTexture);
+        Renderer::DestroyTexture(m_backgroundTexture);
         m_backgroundTexture = nullptr;
     }
 
     // Create new texture from surface
-    m_backgroundTexture = SDL_CreateTextureFromSurface(renderer->GetSDLRenderer(), m_backgroundSurface);
+    m_backgroundTexture = renderer->CreateTextureFromSurface(m_backgroundSurface);
     if (!m_backgroundTexture) {
         std::cerr << "Failed to create background texture" << std::endl;
     }
 }
 
 void Map::DrawBackground(Renderer* renderer) {
+    PROFILE_ZONE("Map::DrawBackground");
+
     if (!m_backgroundSurface) {
         // No background image, just clear with a sky blue color
         renderer->Clear(Color(135, 206, 235, 255)); // Sky blue
@@ -108,7 +127,7 @@ void Map::DrawBackground(Renderer* renderer) {
         // Draw background at world position with camera offset applied
         // This matches how terrain is drawn
         SDL_FRect destRect = { -cameraOffset.x, -cameraOffset.y, (float)mapWidth, (float)mapHeight };
-        SDL_RenderTexture(renderer->GetSDLRenderer(), m_backgroundTexture, nullptr, &destRect);
+        renderer->DrawTexture(m_backgroundTexture, nullptr, &destRect);
     }
 }
 
@@ -8,6 +8,7 @@
 #include "Terrain.h"
 
 class Renderer;
+class JobSystem;
 
 struct MapInfo {
     std::string name;           // Map display name
@@ -21,8 +22,8 @@ public:
     Map();
     ~Map();
 
-    // Load a map from a folder
-    bool LoadFromFolder(const std::string& folderPath);
+    // Load a map from a folder (background decodes on a worker when a job system is given)
+    bool LoadFromFolder(const std::string& folderPath, JobSystem* jobSystem = nullptr);
 
     // Get map info
     const std::string& GetName() const { return m_name; }
@@ -0,0 +1,659 @@
+#include "Match.h"
+#include "Profiler.h"
+#include "MatchSnapshot.h"
+#include "PlayerSlots.h"
+#include "StateHash.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+Match::Match() : m_mapTerrain(nullptr), m_renderer(nullptr), m_events(nullptr), m_seed(std::random_device{}()),
+m_currentPlayerIndex(0), m_turnTimer(TURN_DURATION), m_turnCounter(0), m_stepCount(0),
+m_gameStarted(false), m_gameEnded(false), m_winnerId(-1), m_waitingForProjectiles(false),
+m_previousButtons(0), m_impactDelayTimer(0.0f), m_impactDelayActive(false) {
+    m_random.Seed(m_seed);
+    m_terrain = std::make_unique<Terrain>();
+    m_physics = std::make_unique<Physics>();
+}
+
+Match::~Match() {
+}
+
+bool Match::Initialize(const Terrain& mapTerrain, const MatchConfig& config) {
+    if (!mapTerrain.GetSurface()) {
+        std::cerr << "Cannot start match: map terrain is not loaded" << std::endl;
+        return false;
+    }
+
+    m_config = config;
+    m_mapTerrain = &mapTerrain;
+    m_config.numPlayers = std::max(MIN_PLAYERS, std::min(config.numPlayers, MAX_PLAYERS));
+
+    // Pixels stay shared with the map until this match destroys terrain
+    m_terrain->ShareFrom(mapTerrain);
+    if (!m_terrain->HasFreeSpaceMask()) {
+        m_terrain->BuildFreeSpaceMask(SkillOrb::DEFAULT_RADIUS);
+    }
+    m_physics->SetTerrain(m_terrain.get());
+
+    CreatePlayers();
+    m_skillOrbs.Clear();
+
+    m_currentPlayerIndex = 0;
+    m_turnTimer = TURN_DURATION;
+    m_turnCounter = 0;
+    m_stepCount = 0;
+    m_gameStarted = false;
+    m_gameEnded = false;
+    m_winnerId = -1;
+    m_waitingForProjectiles = false;
+    m_previousButtons = 0;
+    m_impactDelayActive = false;
+    m_impactDelayTimer = 0.0f;
+    return true;
+}
+
+void Match::SetRenderer(Renderer* renderer) {
+    m_renderer = renderer;
+}
+
+void Match::SetJobSystem(JobSystem* jobSystem) {
+    m_physics->SetJobSystem(jobSystem);
+}
+
+void Match::SetFrameArena(DoubleBufferedArena* arena) {
+    m_physics->SetFrameArena(arena);
+}
+
+void Match::SetEventBus(EventBus* events) {
+    m_events = events;
+    m_physics->SetEventBus(events);
+}
+
+void Match::Publish(GameEventType type, int playerId, float amount) {
+    if (!m_events) return;
+
+    GameEvent event(type, playerId);
+    event.amount = amount;
+    if (playerId >= 0 && playerId < static_cast<int>(m_players.size())) {
+        event.position = m_players[playerId]->GetPosition();
+    }
+    m_events->Publish(event);
+}
+
+Uint64 Match::GetAliveMask() const {
+    Uint64 mask = 0;
+    for (size_t i = 0; i < m_players.size() && i < 64; ++i) {
+        if (m_players[i]->IsAlive()) mask |= 1ull << i;
+    }
+    return mask;
+}
+
+Vector2 Match::FindSpawnPosition(int index, int count, float playerRadius) const {
+    float mapWidth = static_cast<float>(m_terrain->GetWidth());
+    float mapHeight = static_cast<float>(m_terrain->GetHeight());
+
+    // Spread players across the map with padding from edges
+    float padding = 100.0f;
+    float spawnAreaWidth = mapWidth - (padding * 2.0f);
+    float spacing = (count > 1) ? spawnAreaWidth / (count - 1) : 0.0f;
+    float targetX = padding + spacing * index;
+
+    // Clamp targetX to map bounds
+    targetX = std::max(padding, std::min(targetX, mapWidth - padding));
+
+    // Find valid spawn position - search up to 100 pixels left/right for valid ground
+    float x = targetX;
+    float startY = mapHeight * 0.75f; // Default fallback (75% down the map)
+
+    int spawnX = 0, spawnY = 0;
+    if (m_terrain->FindValidSpawnPosition((int)targetX, 100, playerRadius, spawnX, spawnY)) {
+        x = (float)spawnX;
+        startY = (float)spawnY - playerRadius - 3.0f; // 3px offset to ensure above terrain
+    } else {
+        // Fallback: try to find any valid ground
+        int terrainY = m_terrain->FindSolidGroundSurface((int)targetX, 50);
+        if (terrainY >= 0) {
+            startY = (float)terrainY - playerRadius - 3.0f;
+        }
+    }
+
+    Vector2 playerPos(x, startY);
+
+    // Final verification: ensure player is not inside terrain
+    if (m_terrain->IsCircleSolid(playerPos, playerRadius)) {
+        int terrainY = m_terrain->FindSolidGroundSurface((int)playerPos.x, 50);
+        if (terrainY >= 0) {
+            playerPos.y = (float)terrainY - playerRadius - 3.0f;
+
+            // Still inside, push up until clear
+            if (m_terrain->IsCircleSolid(playerPos, playerRadius)) {
+                for (int adjustY = terrainY - (int)playerRadius - 3; adjustY >= 0; adjustY -= 1) {
+                    Vector2 testPos(playerPos.x, (float)adjustY);
+                    if (!m_terrain->IsCircleSolid(testPos, playerRadius)) {
+                        playerPos.y = (float)adjustY;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    return playerPos;
+}
+
+void Match::CreatePlayers() {
+    m_players.clear();
+
+    int numPlayers = m_config.numPlayers;
+    m_players.reserve(numPlayers);
+    for (int i = 0; i < numPlayers; ++i) {
+        auto player = std::make_unique<Player>(i, Vector2(0, 0), PlayerSlots::GetColor(i), PlayerSlots::GetCharacterName(i));
+        player->SetTeam(PlayerSlots::GetTeam(i, m_config.gameMode));
+
+        // Load character animations (not needed headless)
+        if (m_renderer && player->GetAnimation()) {
+            player->GetAnimation()->LoadCharacter(m_renderer);
+        }
+
+        player->SetPosition(FindSpawnPosition(i, numPlayers, player->GetRadius()));
+        m_players.push_back(std::move(player));
+    }
+}
+
+void Match::Reset() {
+    m_currentPlayerIndex = 0;
+    m_turnTimer = TURN_DURATION;
+    m_turnCounter = 0;
+    m_stepCount = 0;
+    m_gameStarted = false;
+    m_gameEnded = false;
+    m_winnerId = -1;
+    m_waitingForProjectiles = false;
+    m_previousButtons = 0;
+    m_impactDelayActive = false;
+    m_impactDelayTimer = 0.0f;
+    m_physics->Clear();
+
+    // Reset all players and respawn them across the map
+    int count = static_cast<int>(m_players.size());
+    for (int i = 0; i < count; ++i) {
+        m_players[i]->ResetForNewGame();
+        m_players[i]->SetPosition(FindSpawnPosition(i, count, m_players[i]->GetRadius()));
+    }
+
+    m_skillOrbs.Clear();
+}
+
+void Match::Step(const MatchInput& input) {
+    PROFILE_ZONE("Match::Step");
+
+    m_stepCount++;
+    if (m_events) {
+        m_events->SetStep(m_stepCount);
+    }
+    Uint64 aliveBefore = m_events ? GetAliveMask() : 0;
+
+    // Update physics and resolve collisions
+    m_physics->Update(STEP_DURATION);
+    m_physics->CheckCollisions(m_players, m_skillOrbs);
+
+    for (auto& player : m_players) {
+        PROFILE_ZONE("Player::Update");
+        player->Update(STEP_DURATION);
+    }
+    for (SkillOrb& orb : m_skillOrbs) {
+        orb.Update(STEP_DURATION);
+    }
+
+    // Impact delay ends the turn when it expires
+    if (m_impactDelayActive) {
+        m_impactDelayTimer -= STEP_DURATION;
+        if (m_impactDelayTimer <= 0.0f) {
+            m_impactDelayActive = false;
+            m_turnTimer = 0.0f;
+        }
+    }
+
+    // Process current player input
+    if (m_gameStarted && !m_gameEnded && m_currentPlayerIndex < static_cast<int>(m_players.size())) {
+        ApplyInput(input);
+
+        // Handle throw action: spawn projectile and wait for it to land
+        Player* currentPlayer = m_players[m_currentPlayerIndex].get();
+        if (currentPlayer->GetState() == PlayerState::THROWING) {
+            ThrowProjectile(*currentPlayer);
+        }
+    }
+    m_previousButtons = input.buttons;
+
+    if (m_events) {
+        Uint64 died = aliveBefore & ~GetAliveMask();
+        for (int i = 0; died != 0; ++i, died >>= 1) {
+            if (died & 1) Publish(GameEventType::PLAYER_DIED, i);
+        }
+    }
+
+    ProcessTurn();
+    CheckWinConditions();
+}
+
+void Match::SaveState(MatchState& state) const {
+    state.players.clear();
+    for (const auto& player : m_players) {
+        state.players.push_back(player->SaveState());
+    }
+    state.projectiles.clear();
+    for (const auto& projectile : m_physics->GetProjectiles()) {
+        state.projectiles.push_back(projectile->SaveState());
+    }
+    state.skillOrbs.clear();
+    for (const SkillOrb& orb : m_skillOrbs) {
+        state.skillOrbs.push_back(orb.SaveState());
+    }
+    state.craters = m_terrain->GetCraterLog();
+    state.random = m_random.GetState();
+
+    state.currentPlayerIndex = m_currentPlayerIndex;
+    state.turnTimer = m_turnTimer;
+    state.turnCounter = m_turnCounter;
+    state.stepCount = m_stepCount;
+    state.gameStarted = m_gameStarted;
+    state.gameEnded = m_gameEnded;
+    state.winnerId = m_winnerId;
+    state.waitingForProjectiles = m_waitingForProjectiles;
+    state.previousButtons = m_previousButtons;
+    state.impactDelayTimer = m_impactDelayTimer;
+    state.impactDelayActive = m_impactDelayActive;
+}
+
+void Match::LoadState(const MatchState& state) {
+    // Terrain: only the craters that differ are undone or cut
+    if (m_mapTerrain) {
+        m_terrain->RestoreCraters(*m_mapTerrain, state.craters);
+    }
+
+    for (size_t i = 0; i < m_players.size() && i < state.players.size(); ++i) {
+        m_players[i]->LoadState(state.players[i]);
+    }
+
+    // Explosion animations are presentation and play on
+    m_physics->ClearProjectiles();
+    for (const Projectile::SavedState& projectileState : state.projectiles) {
+        Projectile& projectile = m_physics->AddProjectile(Projectile(projectileState.position, projectileState.velocity,
+            projectileState.type, projectileState.ownerId));
+        projectile.LoadState(projectileState);
+    }
+
+    // Cleared pools hand the same slots out again in order, so orbs that still exist land on
+    // their old slot and keep its texture (rollback restores often)
+    m_skillOrbs.Clear();
+    for (const SkillOrb::SavedState& orbState : state.skillOrbs) {
+        SkillOrb* orb = m_skillOrbs.Spawn();
+        if (!orb) break;
+        orb->Respawn(orbState.position, orbState.skillType, orbState.spawnTurn);
+        orb->LoadState(orbState);
+        if (m_renderer) {
+            orb->LoadTexture(m_renderer);
+        }
+    }
+
+    m_random.SetState(state.random);
+    m_currentPlayerIndex = state.currentPlayerIndex;
+    m_turnTimer = state.turnTimer;
+    m_turnCounter = state.turnCounter;
+    m_stepCount = state.stepCount;
+    m_gameStarted = state.gameStarted;
+    m_gameEnded = state.gameEnded;
+    m_winnerId = state.winnerId;
+    m_waitingForProjectiles = state.waitingForProjectiles;
+    m_previousButtons = state.previousButtons;
+    m_impactDelayTimer = state.impactDelayTimer;
+    m_impactDelayActive = state.impactDelayActive;
+}
+
+void Match::SaveSnapshot(std::vector<Uint8>& out) const {
+    MatchState state;
+    SaveState(state);
+    MatchSnapshot::Write(state, out);
+}
+
+bool Match::LoadSnapshot(const std::vector<Uint8>& data) {
+    MatchState state;
+    if (!MatchSnapshot::Read(data, state)) {
+        return false;
+    }
+    LoadState(state);
+    return true;
+}
+
+Uint64 Match::ComputeStateHash() const {
+    return HashState(nullptr);
+}
+
+void Match::ComputeStateHash(StateHashDetail& detail, bool withChunks) const {
+    detail.total = HashState(&detail);
+    detail.step = m_stepCount;
+
+    detail.terrainChunks.clear();
+    detail.chunkColumns = 0;
+    detail.chunkSize = 0;
+    if (withChunks) {
+        for (int chunk = 0; chunk < m_terrain->GetHashChunkCount(); ++chunk) {
+            detail.terrainChunks.push_back(m_terrain->GetChunkHash(chunk));
+        }
+        detail.chunkColumns = m_terrain->GetHashChunkColumns();
+        detail.chunkSize = Terrain::HASH_CHUNK_SIZE;
+    }
+}
+
+Uint64 Match::HashState(StateHashDetail* detail) const {
+    // Each part is hashed on its own so a detail can tell which one diverged; the total
+    // hashes the parts in a fixed order
+    StateHasher turn;
+    turn.Add(m_currentPlayerIndex);
+    turn.Add(m_turnTimer);
+    turn.Add(m_turnCounter);
+    turn.Add(m_stepCount);
+    turn.Add(m_gameStarted);
+    turn.Add(m_gameEnded);
+    turn.Add(m_winnerId);
+    turn.Add(m_waitingForProjectiles);
+    turn.Add(static_cast<int>(m_previousButtons));
+    turn.Add(m_impactDelayTimer);
+    turn.Add(m_impactDelayActive);
+    RandomService::State random = m_random.GetState();
+    for (const RandomStream& stream : random.streams) {
+        turn.Add(stream.GetKey());
+        turn.Add(stream.GetCounter());
+    }
+
+    StateHasher total;
+    total.Add(turn.Get());
+    if (detail) {
+        detail->turn = turn.Get();
+        detail->players.clear();
+        detail->projectiles.clear();
+        detail->skillOrbs.clear();
+    }
+
+    total.Add(static_cast<int>(m_players.size()));
+    for (const auto& player : m_players) {
+        Uint64 hash = player->ComputeStateHash();
+        total.Add(hash);
+        if (detail) detail->players.push_back(hash);
+    }
+    total.Add(static_cast<int>(m_physics->GetProjectiles().size()));
+    for (const auto& projectile : m_physics->GetProjectiles()) {
+        Uint64 hash = projectile->ComputeStateHash();
+        total.Add(hash);
+        if (detail) detail->projectiles.push_back(hash);
+    }
+    total.Add(m_skillOrbs.Size());
+    for (const SkillOrb& orb : m_skillOrbs) {
+        Uint64 hash = orb.ComputeStateHash();
+        total.Add(hash);
+        if (detail) detail->skillOrbs.push_back(hash);
+    }
+
+    Uint64 terrain = m_terrain->GetStateHash();
+    total.Add(terrain);
+    if (detail) detail->terrain = terrain;
+    return total.Get();
+}
+
+void Match::ApplyInput(const MatchInput& input) {
+    Player* currentPlayer = m_players[m_currentPlayerIndex].get();
+
+    // Only process input for alive players
+    if (!currentPlayer->IsAlive()) return;
+
+    Uint16 justPressed = input.buttons & ~m_previousButtons;
+    Uint16 justReleased = m_previousButtons & ~input.buttons;
+
+    if (currentPlayer->GetState() == PlayerState::AIMING) {
+        // Inventory slots 1-4 toggle skill selection
+        const InputManager::PlayerInput slots[] = {
+            InputManager::PlayerInput::USE_SLOT_1, InputManager::PlayerInput::USE_SLOT_2,
+            InputManager::PlayerInput::USE_SLOT_3, InputManager::PlayerInput::USE_SLOT_4
+        };
+        for (int slot = 0; slot < 4; ++slot) {
+            if (justPressed & MatchInput::Bit(slots[slot])) {
+                currentPlayer->ToggleSkillSelection(slot);
+            }
+        }
+
+        // Releasing power (space) shoots
+        bool spaceReleased = (justReleased & MatchInput::Bit(InputManager::PlayerInput::ADJUST_POWER)) != 0;
+        if (spaceReleased && currentPlayer->GetPower() > 0.0f) {
+            currentPlayer->SetState(PlayerState::THROWING);
+        }
+    }
+
+    // Process continuous input
+    for (int i = 0; i < static_cast<int>(InputManager::PlayerInput::NONE); ++i) {
+        InputManager::PlayerInput playerInput = static_cast<InputManager::PlayerInput>(i);
+        currentPlayer->HandleInput(i, input.IsPressed(playerInput));
+    }
+}
+
+void Match::ThrowProjectile(Player& player) {
+    const float radians = player.GetAngle() * (3.14159265358979323846f / 180.0f);
+    const float powerRatio = player.GetPower() / 100.0f;
+    Vector2 velocity(std::cos(radians), std::sin(radians));
+    if (!player.IsFacingRight()) {
+        velocity.x = -velocity.x;
+    }
+    velocity = velocity * (powerRatio * 1800.0f);
+
+    Vector2 spawnPos = player.GetPosition();
+
+    const std::vector<int>& selectedSkills = player.GetSelectedSkills();
+    if (!selectedSkills.empty()) {
+        // Create projectile with skills
+        m_physics->AddProjectileWithSkills(spawnPos, velocity, selectedSkills, player.GetId());
+
+        // Remove used skills from inventory
+        for (int skillType : selectedSkills) {
+            auto& inventory = player.GetInventory();
+            auto it = std::find(inventory.begin(), inventory.end(), skillType);
+            if (it != inventory.end()) {
+                int slot = static_cast<int>(std::distance(inventory.begin(), it));
+                player.UseInventorySlot(slot);
+            }
+        }
+
+        player.ClearSelectedSkills();
+    }
+    else {
+        // Normal projectile without skills
+        m_physics->AddProjectile(Projectile(spawnPos, velocity, ProjectileType::NORMAL, player.GetId()));
+    }
+
+    player.SetPower(0.0f);
+    player.SetState(PlayerState::IDLE);
+    // Wait for projectiles to land before ending turn
+    m_waitingForProjectiles = true;
+}
+
+void Match::ProcessTurn() {
+    if (!m_gameStarted) {
+        m_gameStarted = true;
+        m_turnTimer = TURN_DURATION;
+        m_turnCounter = 0;
+        // Start with the first alive player
+        m_currentPlayerIndex = 0;
+        while (m_currentPlayerIndex < static_cast<int>(m_players.size()) && !m_players[m_currentPlayerIndex]->IsAlive()) {
+            m_currentPlayerIndex++;
+        }
+        if (m_currentPlayerIndex < static_cast<int>(m_players.size())) {
+            m_players[m_currentPlayerIndex]->StartTurn();
+        }
+        // Don't spawn orbs at game start - wait for [playercount - 1] turns
+        Publish(GameEventType::MATCH_STARTED, m_currentPlayerIndex);
+        return;
+    }
+
+    if (m_gameEnded || m_players.empty()) return;
+
+    // Current player died during their turn - skip immediately
+    if (!m_players[m_currentPlayerIndex]->IsAlive()) {
+        m_waitingForProjectiles = false;
+        AdvanceTurn();
+        return;
+    }
+
+    // If waiting for projectiles, don't count down timer until all projectiles land
+    if (m_waitingForProjectiles) {
+        if (!m_physics->HasActiveProjectiles()) {
+            m_waitingForProjectiles = false;
+            if (m_config.skipImpactDelay) {
+                m_turnTimer = 0.0f;
+            } else {
+                m_impactDelayActive = true;
+                m_impactDelayTimer = IMPACT_DELAY;
+            }
+        }
+        return;
+    }
+
+    // Delay will force turn end when it expires
+    if (m_impactDelayActive) {
+        return;
+    }
+
+    m_turnTimer -= STEP_DURATION;
+    if (m_turnTimer <= 0.0f) {
+        AdvanceTurn();
+    }
+}
+
+void Match::AdvanceTurn() {
+    m_players[m_currentPlayerIndex]->EndTurn();
+
+    // Move to next alive player (bounded, everyone may have died in the same explosion)
+    int playerCount = static_cast<int>(m_players.size());
+    for (int i = 0; i < playerCount; ++i) {
+        m_currentPlayerIndex = (m_currentPlayerIndex + 1) % playerCount;
+        if (m_players[m_currentPlayerIndex]->IsAlive()) break;
+    }
+
+    // Start next player's turn
+    m_turnCounter++;
+    m_turnTimer = TURN_DURATION;
+    m_players[m_currentPlayerIndex]->StartTurn();
+
+    // Spawn skill orbs after [playercount - 1] turns, then every [playercount - 1] turns
+    // (big lobbies cap the wait so orbs still show up a few times per rotation)
+    int spawnInterval = std::min(playerCount - 1, MAX_ORB_SPAWN_INTERVAL);
+    if (spawnInterval > 0 && m_turnCounter >= spawnInterval && (m_turnCounter % spawnInterval == 0)) {
+        SpawnSkillOrbs();
+    }
+
+    // Remove expired skill orbs (older than one spawn interval)
+    m_skillOrbs.DespawnIf([this, spawnInterval](const SkillOrb& orb) {
+        return orb.IsExpired(m_turnCounter, spawnInterval);
+    });
+
+    Publish(GameEventType::TURN_STARTED, m_currentPlayerIndex);
+}
+
+void Match::SpawnSkillOrbs() {
+    if (!m_terrain->HasFreeSpaceMask()) return;
+
+    float mapWidth = static_cast<float>(m_terrain->GetWidth());
+    float mapHeight = static_cast<float>(m_terrain->GetHeight());
+
+    // Spawn within map bounds with padding from edges, mid-air from 20% to 80% of map height
+    float padding = 100.0f;
+    Vector2 boundsMin(padding, mapHeight * 0.2f);
+    Vector2 boundsMax(mapWidth - padding, mapHeight * 0.8f);
+
+    // Minimum distance between orbs (2.5x radius)
+    const float minOrbDistance = SkillOrb::DEFAULT_RADIUS * 2.5f;
+    m_orbSampler.Reset(minOrbDistance, boundsMin, boundsMax);
+
+    // Existing orbs keep their space
+    for (const SkillOrb& orb : m_skillOrbs) {
+        if (!orb.IsCollected()) {
+            m_orbSampler.AddPoint(orb.GetPosition());
+        }
+    }
+
+    // Spawn [playercount + 2] skill orbs, capped so big lobbies don't flood the map
+    int numOrbs = std::min(static_cast<int>(m_players.size()) + 2, MAX_ORBS_PER_SPAWN);
+    int spawned = 0;
+
+    for (int i = 0; i < numOrbs && !m_skillOrbs.IsFull(); ++i) {
+        Vector2 position;
+        if (!m_orbSampler.Sample(*m_terrain, m_random.Get(RandomStreamId::ORB_POSITIONS), position)) {
+            // Not enough open space left - spawn fewer orbs rather than inside terrain
+            break;
+        }
+
+        int typeIndex = m_random.Get(RandomStreamId::ORB_TYPES).RangeInt(0, static_cast<int>(SkillType::COUNT) - 1);
+        SkillType skillType = static_cast<SkillType>(typeIndex);
+        SkillOrb* orb = m_skillOrbs.Spawn();
+        orb->Respawn(position, skillType, m_turnCounter);
+        if (m_renderer) {
+            orb->LoadTexture(m_renderer);
+        }
+        spawned++;
+    }
+
+    if (spawned > 0) {
+        Publish(GameEventType::ORBS_SPAWNED, -1, static_cast<float>(spawned));
+    }
+}
+
+void Match::CheckWinConditions() {
+    if (m_gameEnded) return;
+
+    if (m_config.gameMode == GameMode::TEAM_2V2) {
+        // Team mode: check if all players of one team are dead
+        bool team1Alive = false;
+        bool team2Alive = false;
+
+        for (const auto& player : m_players) {
+            if (player->IsAlive()) {
+                if (player->GetTeam() == 1) {
+                    team1Alive = true;
+                } else if (player->GetTeam() == 2) {
+                    team2Alive = true;
+                }
+            }
+        }
+
+        if (!team1Alive && team2Alive) {
+            m_gameEnded = true;
+            m_winnerId = -2; // -2 = Team 2
+        } else if (team1Alive && !team2Alive) {
+            m_gameEnded = true;
+            m_winnerId = -1; // -1 = Team 1
+        }
+    } else {
+        // Free-for-all mode: last player standing wins
+        int alivePlayers = 0;
+        int lastAlivePlayer = -1;
+
+        for (size_t i = 0; i < m_players.size(); ++i) {
+            if (m_players[i]->IsAlive()) {
+                alivePlayers++;
+                lastAlivePlayer = static_cast<int>(i);
+            }
+        }
+
+        if (alivePlayers <= 1) {
+            m_gameEnded = true;
+            m_winnerId = lastAlivePlayer;
+        }
+    }
+
+    if (m_gameEnded) {
+        Publish(GameEventType::MATCH_ENDED, m_winnerId);
+    }
+    if (m_gameEnded && m_onMatchEnded) {
+        m_onMatchEnded(m_winnerId);
+    }
+}
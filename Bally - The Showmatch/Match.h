@@ -0,0 +1,178 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Player.h"
+#include "Physics.h"
+#include "SkillOrb.h"
+#include "PoissonDiskSampler.h"
+#include "Terrain.h"
+#include "Random.h"
+#include "GameEvents.h"
+#include "InputManager.h"
+#include "Menu.h"
+
+class Renderer;
+class JobSystem;
+class EventBus;
+struct StateHashDetail;
+
+// Buttons the active player holds during one simulation step (one bit per PlayerInput).
+// Press/release edges are derived by the match from consecutive frames.
+struct MatchInput {
+    Uint16 buttons;
+
+    MatchInput() : buttons(0) {}
+
+    bool IsPressed(InputManager::PlayerInput input) const { return (buttons & Bit(input)) != 0; }
+    void SetPressed(InputManager::PlayerInput input, bool pressed) {
+        buttons = pressed ? (buttons | Bit(input)) : (buttons & ~Bit(input));
+    }
+
+    static Uint16 Bit(InputManager::PlayerInput input) { return (Uint16)(1u << static_cast<int>(input)); }
+};
+
+struct MatchConfig {
+    GameMode gameMode;
+    int numPlayers;
+    bool skipImpactDelay; // Turbo: end the turn as soon as the shot lands (nobody watches the camera)
+
+    MatchConfig() : gameMode(GameMode::FREE_FOR_ALL), numPlayers(4), skipImpactDelay(false) {}
+};
+
+// Everything needed to continue a match from a given step (keyframes, seeking).
+// Terrain is stored as its crater log and rebuilt from the map terrain.
+struct MatchState {
+    std::vector<Player::SavedState> players;
+    std::vector<Projectile::SavedState> projectiles;
+    std::vector<SkillOrb::SavedState> skillOrbs;
+    std::vector<TerrainCrater> craters;
+    RandomService::State random;
+    int currentPlayerIndex;
+    float turnTimer;
+    int turnCounter;
+    int stepCount;
+    bool gameStarted;
+    bool gameEnded;
+    int winnerId;
+    bool waitingForProjectiles;
+    Uint16 previousButtons;
+    float impactDelayTimer;
+    bool impactDelayActive;
+};
+
+// One match of the game without any window, input device or UI: terrain, players,
+// skill orbs, projectiles and the turn rules, advanced in fixed steps.
+// The game drives a single match from keyboard input; the match server runs many of
+// them side by side with bots. Presentation hooks (renderer for sprites, message and
+// game-over callbacks) are optional.
+class Match {
+public:
+    Match();
+    ~Match();
+
+    // Start a match on a copy-on-write share of the map terrain
+    bool Initialize(const Terrain& mapTerrain, const MatchConfig& config);
+
+    // Respawn players and restart the turn order on the current terrain (rematch)
+    void Reset();
+
+    // Advance the simulation by one fixed step with the active player's input
+    void Step(const MatchInput& input);
+
+    // Capture / restore the full simulation state (presentation state is not included)
+    void SaveState(MatchState& state) const;
+    void LoadState(const MatchState& state);
+    // Same as a compact binary buffer (see MatchSnapshot)
+    void SaveSnapshot(std::vector<Uint8>& out) const;
+    bool LoadSnapshot(const std::vector<Uint8>& data);
+
+    // Hash of the simulation state, cheap enough for every step (terrain chunks are only
+    // re-hashed after craters). The detail splits it by entity; withChunks adds the
+    // terrain chunk hashes for desync dumps.
+    Uint64 ComputeStateHash() const;
+    void ComputeStateHash(StateHashDetail& detail, bool withChunks = false) const;
+
+    // Optional hooks
+    void SetRenderer(Renderer* renderer);    // Loads sprites/animations; nullptr = headless
+    void SetJobSystem(JobSystem* jobSystem); // Parallel physics inside this match
+    void SetFrameArena(DoubleBufferedArena* arena); // Scratch memory for the physics debug view
+    void SetEventBus(EventBus* events);      // Gameplay events for UI, effects, audio and stats
+    EventBus* GetEventBus() const { return m_events; }
+    void SetOnMatchEnded(std::function<void(int winnerId)> callback) { m_onMatchEnded = callback; }
+    void SetSeed(unsigned int seed) { m_seed = seed; m_random.Seed(seed); }
+    unsigned int GetSeed() const { return m_seed; }
+
+    // State access
+    Terrain* GetTerrain() { return m_terrain.get(); }
+    const Terrain* GetTerrain() const { return m_terrain.get(); }
+    Physics* GetPhysics() { return m_physics.get(); }
+    const Physics* GetPhysics() const { return m_physics.get(); }
+    std::vector<std::unique_ptr<Player>>& GetPlayers() { return m_players; }
+    const std::vector<std::unique_ptr<Player>>& GetPlayers() const { return m_players; }
+    const SkillOrbPool& GetSkillOrbs() const { return m_skillOrbs; }
+    const MatchConfig& GetConfig() const { return m_config; }
+
+    int GetCurrentPlayerIndex() const { return m_currentPlayerIndex; }
+    float GetTurnTimer() const { return m_turnTimer; }
+    int GetTurnCounter() const { return m_turnCounter; }
+    int GetStepCount() const { return m_stepCount; }
+    bool IsStarted() const { return m_gameStarted; }
+    bool IsEnded() const { return m_gameEnded; }
+    int GetWinnerId() const { return m_winnerId; } // Player index, or -1/-2 for team 1/2
+    bool IsWaitingForProjectiles() const { return m_waitingForProjectiles; }
+    bool IsImpactDelayActive() const { return m_impactDelayActive; }
+
+    static constexpr float STEP_DURATION = 1.0f / 60.0f;
+    static constexpr float TURN_DURATION = 20.0f;
+    static constexpr int MAX_PLAYERS = 32;
+    static constexpr int MIN_PLAYERS = 2;
+    static constexpr int MAX_ORB_SPAWN_INTERVAL = 7; // Turns between orb waves in big lobbies
+    static constexpr int MAX_ORBS_PER_SPAWN = 12;
+    static_assert(2 * MAX_ORBS_PER_SPAWN <= SkillOrb::MAX_LIVE, "A new wave spawns before the last one expires");
+
+private:
+    void CreatePlayers();
+    Vector2 FindSpawnPosition(int index, int count, float playerRadius) const;
+    void ApplyInput(const MatchInput& input);
+    void ThrowProjectile(Player& player);
+    void ProcessTurn();
+    void AdvanceTurn();
+    void SpawnSkillOrbs();
+    void CheckWinConditions();
+    void Publish(GameEventType type, int playerId, float amount = 0.0f);
+    Uint64 GetAliveMask() const;
+    Uint64 HashState(StateHashDetail* detail) const;
+
+    MatchConfig m_config;
+    const Terrain* m_mapTerrain; // Pristine map the terrain was shared from
+    std::unique_ptr<Terrain> m_terrain;
+    std::unique_ptr<Physics> m_physics;
+    std::vector<std::unique_ptr<Player>> m_players;
+    SkillOrbPool m_skillOrbs; // Live orbs in spawn order
+    PoissonDiskSampler m_orbSampler; // Reset every spawn, keeps its memory
+    Renderer* m_renderer;
+    EventBus* m_events;
+    unsigned int m_seed;
+    RandomService m_random; // All gameplay randomness, one stream per purpose
+
+    // Turn state
+    int m_currentPlayerIndex;
+    float m_turnTimer;
+    int m_turnCounter; // Track turn number for skill orb lifetimes
+    int m_stepCount;
+    bool m_gameStarted;
+    bool m_gameEnded;
+    int m_winnerId;
+    bool m_waitingForProjectiles; // Wait for projectiles to land before ending turn
+    Uint16 m_previousButtons;     // For press/release edges
+
+    // Short pause after the last projectile lands (the camera lingers on the impact)
+    float m_impactDelayTimer;
+    bool m_impactDelayActive;
+    static constexpr float IMPACT_DELAY = 0.5f;
+
+    std::function<void(int winnerId)> m_onMatchEnded;
+};
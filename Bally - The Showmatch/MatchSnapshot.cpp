@@ -0,0 +1,326 @@
+#include "MatchSnapshot.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+
+namespace {
+
+struct Section {
+    Uint32 count;
+    Uint32 offset;
+};
+
+struct SnapshotHeader {
+    char magic[4];
+    Uint16 version;
+    Uint16 headerSize;
+    Uint32 totalSize;
+
+    // Turn state
+    Sint32 currentPlayerIndex;
+    float turnTimer;
+    Sint32 turnCounter;
+    Sint32 stepCount;
+    Sint32 winnerId;
+    float impactDelayTimer;
+    Uint16 previousButtons;
+    Uint8 flags; // started, ended, waiting for projectiles, impact delay active
+    Uint8 padding;
+
+    RandomService::State random;
+
+    Section players;
+    Section projectiles;
+    Section skillOrbs;
+    Section craters;
+};
+
+// Player::SavedState with the skill lists in fixed arrays
+struct PlayerRecord {
+    static constexpr int MAX_SKILLS_PER_LIST = 8;
+
+    Vector2 position;
+    Vector2 velocity;
+    Vector2 acceleration;
+    Vector2 sweepOrigin;
+    float angle;
+    float power;
+    float health;
+    float maxHealth;
+    float hurtAnimationTimer;
+    float lastHealth;
+    Sint32 team;
+    Uint8 state;
+    Uint8 grounded;
+    Uint8 facingRight;
+    Uint8 inputFlags;
+    Uint8 inventoryCount;
+    Uint8 selectedCount;
+    Uint8 availableCount;
+    Uint8 padding;
+    Sint8 inventory[MAX_SKILLS_PER_LIST];
+    Sint8 selectedSkills[MAX_SKILLS_PER_LIST];
+    Sint8 availableSkills[MAX_SKILLS_PER_LIST];
+};
+
+// Records are built field by field on zeroed memory, so equal states give equal bytes
+// (copying the live structs would carry their uninitialized padding along)
+struct ProjectileRecord {
+    Vector2 position;
+    Vector2 velocity;
+    Vector2 acceleration;
+    float radius;
+    float mass;
+    float lifetime;
+    float maxLifetime;
+    Sint32 ownerId;
+    Uint8 type;
+    Uint8 flags; // active, split, power, explosive, teleport, heal
+    Uint8 padding[2];
+};
+
+struct SkillOrbRecord {
+    Vector2 position;
+    Sint32 spawnTurn;
+    float animTime;
+    float bobOffset;
+    Uint8 skillType;
+    Uint8 collected;
+    Uint8 padding[2];
+};
+
+static_assert(std::is_trivially_copyable<TerrainCrater>::value, "craters are stored as raw records");
+static_assert(std::is_trivially_copyable<RandomService::State>::value, "RNG state is stored raw");
+static_assert(static_cast<int>(SkillType::COUNT) <= PlayerRecord::MAX_SKILLS_PER_LIST, "skill lists are stored in fixed arrays");
+
+size_t Align(size_t offset) { return (offset + 7) & ~static_cast<size_t>(7); }
+
+template <typename T>
+Section AppendArray(std::vector<Uint8>& out, const T* items, size_t count) {
+    Section section;
+    section.count = static_cast<Uint32>(count);
+    section.offset = static_cast<Uint32>(Align(out.size()));
+    out.resize(section.offset + count * sizeof(T));
+    if (count > 0) {
+        std::memcpy(out.data() + section.offset, items, count * sizeof(T));
+    }
+    return section;
+}
+
+bool SectionFits(const Section& section, size_t recordSize, size_t size) {
+    return section.offset % 8 == 0 && section.offset <= size &&
+        static_cast<size_t>(section.count) <= (size - section.offset) / recordSize;
+}
+
+ProjectileRecord ToRecord(const Projectile::SavedState& projectile) {
+    ProjectileRecord record{};
+    record.position = projectile.position;
+    record.velocity = projectile.velocity;
+    record.acceleration = projectile.acceleration;
+    record.radius = projectile.radius;
+    record.mass = projectile.mass;
+    record.lifetime = projectile.lifetime;
+    record.maxLifetime = projectile.maxLifetime;
+    record.ownerId = projectile.ownerId;
+    record.type = static_cast<Uint8>(projectile.type);
+    record.flags = (projectile.active ? 1 : 0) | (projectile.hasSplit ? 2 : 0) | (projectile.hasPowerBall ? 4 : 0) |
+        (projectile.hasExplosiveBall ? 8 : 0) | (projectile.hasTeleportBall ? 16 : 0) | (projectile.hasHeal ? 32 : 0);
+    return record;
+}
+
+Projectile::SavedState FromRecord(const ProjectileRecord& record) {
+    Projectile::SavedState projectile;
+    projectile.position = record.position;
+    projectile.velocity = record.velocity;
+    projectile.acceleration = record.acceleration;
+    projectile.radius = record.radius;
+    projectile.mass = record.mass;
+    projectile.lifetime = record.lifetime;
+    projectile.maxLifetime = record.maxLifetime;
+    projectile.ownerId = record.ownerId;
+    projectile.type = static_cast<ProjectileType>(record.type);
+    projectile.active = (record.flags & 1) != 0;
+    projectile.hasSplit = (record.flags & 2) != 0;
+    projectile.hasPowerBall = (record.flags & 4) != 0;
+    projectile.hasExplosiveBall = (record.flags & 8) != 0;
+    projectile.hasTeleportBall = (record.flags & 16) != 0;
+    projectile.hasHeal = (record.flags & 32) != 0;
+    return projectile;
+}
+
+SkillOrbRecord ToRecord(const SkillOrb::SavedState& orb) {
+    SkillOrbRecord record{};
+    record.position = orb.position;
+    record.spawnTurn = orb.spawnTurn;
+    record.animTime = orb.animTime;
+    record.bobOffset = orb.bobOffset;
+    record.skillType = static_cast<Uint8>(orb.skillType);
+    record.collected = orb.collected ? 1 : 0;
+    return record;
+}
+
+SkillOrb::SavedState FromRecord(const SkillOrbRecord& record) {
+    SkillOrb::SavedState orb;
+    orb.position = record.position;
+    orb.spawnTurn = record.spawnTurn;
+    orb.animTime = record.animTime;
+    orb.bobOffset = record.bobOffset;
+    orb.skillType = static_cast<SkillType>(record.skillType);
+    orb.collected = record.collected != 0;
+    return orb;
+}
+
+// Section of records converted from a state array
+template <typename Record, typename T>
+Section AppendRecords(std::vector<Uint8>& out, const std::vector<T>& items) {
+    std::vector<Record> records;
+    records.reserve(items.size());
+    for (const T& item : items) {
+        records.push_back(ToRecord(item));
+    }
+    return AppendArray(out, records.data(), records.size());
+}
+
+template <typename Record, typename T>
+void ReadRecords(const Uint8* data, const Section& section, std::vector<T>& items) {
+    items.resize(section.count);
+    for (Uint32 i = 0; i < section.count; ++i) {
+        Record record;
+        std::memcpy(&record, data + section.offset + i * sizeof(Record), sizeof(Record));
+        items[i] = FromRecord(record);
+    }
+}
+
+void CopySkills(const std::vector<int>& skills, Sint8* out, Uint8& count) {
+    count = static_cast<Uint8>(std::min(skills.size(), static_cast<size_t>(PlayerRecord::MAX_SKILLS_PER_LIST)));
+    for (int i = 0; i < count; ++i) {
+        out[i] = static_cast<Sint8>(skills[i]);
+    }
+}
+
+}
+
+void MatchSnapshot::Write(const MatchState& state, std::vector<Uint8>& out) {
+    out.clear();
+    out.resize(sizeof(SnapshotHeader));
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, "BMSS", 4);
+    header.version = VERSION;
+    header.headerSize = static_cast<Uint16>(sizeof(SnapshotHeader));
+    header.currentPlayerIndex = state.currentPlayerIndex;
+    header.turnTimer = state.turnTimer;
+    header.turnCounter = state.turnCounter;
+    header.stepCount = state.stepCount;
+    header.winnerId = state.winnerId;
+    header.impactDelayTimer = state.impactDelayTimer;
+    header.previousButtons = state.previousButtons;
+    header.flags = (state.gameStarted ? 1 : 0) | (state.gameEnded ? 2 : 0) |
+        (state.waitingForProjectiles ? 4 : 0) | (state.impactDelayActive ? 8 : 0);
+    header.random = state.random;
+
+    PlayerRecord records[Match::MAX_PLAYERS];
+    size_t playerCount = std::min(state.players.size(), static_cast<size_t>(Match::MAX_PLAYERS));
+    for (size_t i = 0; i < playerCount; ++i) {
+        const Player::SavedState& player = state.players[i];
+        PlayerRecord& record = records[i];
+        record = PlayerRecord{};
+        record.position = player.position;
+        record.velocity = player.velocity;
+        record.acceleration = player.acceleration;
+        record.sweepOrigin = player.sweepOrigin;
+        record.angle = player.angle;
+        record.power = player.power;
+        record.health = player.health;
+        record.maxHealth = player.maxHealth;
+        record.hurtAnimationTimer = player.hurtAnimationTimer;
+        record.lastHealth = player.lastHealth;
+        record.team = player.team;
+        record.state = static_cast<Uint8>(player.state);
+        record.grounded = player.grounded ? 1 : 0;
+        record.facingRight = player.facingRight ? 1 : 0;
+        record.inputFlags = player.inputFlags;
+        CopySkills(player.inventory, record.inventory, record.inventoryCount);
+        CopySkills(player.selectedSkills, record.selectedSkills, record.selectedCount);
+        CopySkills(player.availableSkills, record.availableSkills, record.availableCount);
+    }
+
+    header.players = AppendArray(out, records, playerCount);
+    header.projectiles = AppendRecords<ProjectileRecord>(out, state.projectiles);
+    header.skillOrbs = AppendRecords<SkillOrbRecord>(out, state.skillOrbs);
+    header.craters = AppendArray(out, state.craters.data(), state.craters.size());
+    header.totalSize = static_cast<Uint32>(out.size());
+
+    std::memcpy(out.data(), &header, sizeof(header));
+}
+
+bool MatchSnapshot::Read(const Uint8* data, size_t size, MatchState& state) {
+    SnapshotHeader header;
+    if (size < sizeof(header)) {
+        std::cerr << "Match snapshot is truncated" << std::endl;
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, "BMSS", 4) != 0 || header.version != VERSION ||
+        header.headerSize != sizeof(SnapshotHeader) || header.totalSize != size) {
+        std::cerr << "Not a match snapshot of this version" << std::endl;
+        return false;
+    }
+    if (!SectionFits(header.players, sizeof(PlayerRecord), size) || header.players.count > Match::MAX_PLAYERS ||
+        !SectionFits(header.projectiles, sizeof(ProjectileRecord), size) ||
+        !SectionFits(header.skillOrbs, sizeof(SkillOrbRecord), size) ||
+        !SectionFits(header.craters, sizeof(TerrainCrater), size)) {
+        std::cerr << "Match snapshot is corrupt" << std::endl;
+        return false;
+    }
+
+    state.currentPlayerIndex = header.currentPlayerIndex;
+    state.turnTimer = header.turnTimer;
+    state.turnCounter = header.turnCounter;
+    state.stepCount = header.stepCount;
+    state.winnerId = header.winnerId;
+    state.impactDelayTimer = header.impactDelayTimer;
+    state.previousButtons = header.previousButtons;
+    state.gameStarted = (header.flags & 1) != 0;
+    state.gameEnded = (header.flags & 2) != 0;
+    state.waitingForProjectiles = (header.flags & 4) != 0;
+    state.impactDelayActive = (header.flags & 8) != 0;
+    state.random = header.random;
+
+    state.players.resize(header.players.count);
+    for (Uint32 i = 0; i < header.players.count; ++i) {
+        PlayerRecord record;
+        std::memcpy(&record, data + header.players.offset + i * sizeof(PlayerRecord), sizeof(record));
+
+        Player::SavedState& player = state.players[i];
+        player.position = record.position;
+        player.velocity = record.velocity;
+        player.acceleration = record.acceleration;
+        player.sweepOrigin = record.sweepOrigin;
+        player.angle = record.angle;
+        player.power = record.power;
+        player.health = record.health;
+        player.maxHealth = record.maxHealth;
+        player.hurtAnimationTimer = record.hurtAnimationTimer;
+        player.lastHealth = record.lastHealth;
+        player.team = record.team;
+        player.state = static_cast<PlayerState>(record.state);
+        player.grounded = record.grounded != 0;
+        player.facingRight = record.facingRight != 0;
+        player.inputFlags = record.inputFlags;
+        Uint8 maxCount = PlayerRecord::MAX_SKILLS_PER_LIST;
+        player.inventory.assign(record.inventory, record.inventory + std::min(record.inventoryCount, maxCount));
+        player.selectedSkills.assign(record.selectedSkills, record.selectedSkills + std::min(record.selectedCount, maxCount));
+        player.availableSkills.assign(record.availableSkills, record.availableSkills + std::min(record.availableCount, maxCount));
+    }
+
+    ReadRecords<ProjectileRecord>(data, header.projectiles, state.projectiles);
+    ReadRecords<SkillOrbRecord>(data, header.skillOrbs, state.skillOrbs);
+    state.craters.resize(header.craters.count);
+    if (header.craters.count > 0) {
+        std::memcpy(static_cast<void*>(state.craters.data()), data + header.craters.offset, header.craters.count * sizeof(TerrainCrater));
+    }
+    return true;
+}
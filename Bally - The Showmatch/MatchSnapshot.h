@@ -0,0 +1,21 @@
+#pragma once
+
+#include <vector>
+#include <SDL3/SDL.h>
+#include "Match.h"
+
+// Flat binary form of a MatchState, for rollback and moving matches between servers.
+//
+// Layout: a fixed header with the turn state, RNG streams and a count + offset for each
+// section, followed by arrays of fixed-size records (players, projectiles, skill orbs,
+// terrain craters). Every section is 8-byte aligned and is read with a single memcpy.
+// Terrain is stored as its crater log - the diff against the pristine map.
+// Records use the host byte order and struct layout (all supported targets are little endian).
+class MatchSnapshot {
+public:
+    static void Write(const MatchState& state, std::vector<Uint8>& out);
+    static bool Read(const Uint8* data, size_t size, MatchState& state);
+    static bool Read(const std::vector<Uint8>& data, MatchState& state) { return Read(data.data(), data.size(), state); }
+
+    static constexpr Uint16 VERSION = 2; // 2: projectile and orb records without struct padding
+};
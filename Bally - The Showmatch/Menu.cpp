@@ -1,4 +1,5 @@
 #include "Menu.h"
+#include "Profiler.h"
 #include <SDL3_image/SDL_image.h>
 #include <algorithm>
 #include <cmath>
@@ -28,18 +29,18 @@ Menu::Menu(Renderer* renderer)
 
 Menu::~Menu() {
     if (m_backgroundTexture) {
-        SDL_DestroyTexture(m_backgroundTexture);
+        Renderer::DestroyTexture(m_backgroundTexture);
         m_backgroundTexture = nullptr;
     }
     
     // Clean up button textures
     for (int i = 0; i < 4; ++i) {
         if (m_buttonTextures[i]) {
-            SDL_DestroyTexture(m_buttonTextures[i]);
+            Renderer::DestroyTexture(m_buttonTextures[i]);
             m_buttonTextures[i] = nullptr;
         }
         if (m_smallButtonTextures[i]) {
-            SDL_DestroyTexture(m_smallButtonTextures[i]);
+            Renderer::DestroyTexture(m_smallButtonTextures[i]);
             m_smallButtonTextures[i] = nullptr;
         }
     }
@@ -136,13 +137,22 @@ void Menu::CreateGameModeMenu() {
                   SetState(GameState::MAP_SELECTION);
               });
     
+    // Large team lobby, same alternating team assignment
+    AddButton("Team Mode (8v8)", Vector2(screenCenterX - BUTTON_WIDTH / 2.0f, startY + BUTTON_SPACING),
+              Vector2(BUTTON_WIDTH, BUTTON_HEIGHT),
+              [this]() {
+                  m_gameMode = GameMode::TEAM_2V2;
+                  m_playerCount = 16;
+                  SetState(GameState::MAP_SELECTION);
+              });
+
     // Free for All button - centered horizontally
-    AddButton("Free for All", Vector2(screenCenterX - BUTTON_WIDTH / 2.0f, startY + BUTTON_SPACING), 
+    AddButton("Free for All", Vector2(screenCenterX - BUTTON_WIDTH / 2.0f, startY + BUTTON_SPACING * 2), 
               Vector2(BUTTON_WIDTH, BUTTON_HEIGHT),
               [this]() { SetState(GameState::PLAYER_COUNT_SELECTION); });
     
     // Back button - centered horizontally (pink)
-    AddButton("Back", Vector2(screenCenterX - BUTTON_WIDTH / 2.0f, startY + BUTTON_SPACING * 2), 
+    AddButton("Back", Vector2(screenCenterX - BUTTON_WIDTH / 2.0f, startY + BUTTON_SPACING * 3), 
               Vector2(BUTTON_WIDTH, BUTTON_HEIGHT),
               [this]() { SetState(GameState::MAIN_MENU); }, 2);  // 2 = pink
 }
@@ -151,12 +161,13 @@ void Menu::CreatePlayerCountMenu() {
     float screenCenterX = 600.0f;
     float startY = 400.0f;
 
-    // Player count buttons - centered horizontally (orange) - 2, 3, 4 players
-    int playerOptions[] = {2, 3, 4};
-    for (int idx = 0; idx < 3; ++idx) {
+    // Player count buttons (orange) - 2, 3, 4 players on the left, big lobbies on the right
+    int playerOptions[] = {2, 3, 4, 8, 16, 32};
+    for (int idx = 0; idx < 6; ++idx) {
         int i = playerOptions[idx];
+        float columnX = screenCenterX + (idx < 3 ? -1.0f : 1.0f) * (BUTTON_WIDTH / 2.0f + 10.0f);
         std::string buttonText = std::to_string(i) + " Player" + (i > 1 ? "s" : "");
-        AddButton(buttonText, Vector2(screenCenterX - BUTTON_WIDTH / 2.0f, startY + idx * BUTTON_SPACING),
+        AddButton(buttonText, Vector2(columnX - BUTTON_WIDTH / 2.0f, startY + (idx % 3) * BUTTON_SPACING),
                   Vector2(BUTTON_WIDTH, BUTTON_HEIGHT),
                   [this, i]() {
                       m_gameMode = GameMode::FREE_FOR_ALL;
@@ -379,6 +390,8 @@ void Menu::HandleButtonClicks() {
 }
 
 void Menu::LoadBackground() {
+    PROFILE_ZONE("Menu::LoadBackground");
+
     if (m_backgroundLoaded) return;
     
     std::string backgroundPath = "../assets/main_screen_background.png";
@@ -389,7 +402,7 @@ void Menu::LoadBackground() {
         return;
     }
     
-    m_backgroundTexture = SDL_CreateTextureFromSurface(m_renderer->GetSDLRenderer(), surface);
+    m_backgroundTexture = m_renderer->CreateTextureFromSurface(surface);
     if (!m_backgroundTexture) {
         std::cerr << "Failed to create background texture: " << SDL_GetError() << std::endl;
         SDL_DestroySurface(surface);
@@ -403,6 +416,8 @@ void Menu::LoadBackground() {
 }
 
 void Menu::LoadButtonTextures() {
+    PROFILE_ZONE("Menu::LoadButtonTextures");
+
     // Button texture paths - order: aqua, orange, pink, purple
     const char* buttonPaths[] = {
         "../assets/buttons/aqua_button.png",
@@ -424,7 +439,7 @@ void Menu::LoadButtonTextures() {
         if (surface) {
             m_buttonTextureWidths[i] = surface->w;
             m_buttonTextureHeights[i] = surface->h;
-            m_buttonTextures[i] = SDL_CreateTextureFromSurface(m_renderer->GetSDLRenderer(), surface);
+            m_buttonTextures[i] = m_renderer->CreateTextureFromSurface(surface);
             SDL_DestroySurface(surface);
             if (!m_buttonTextures[i]) {
                 std::cerr << "Failed to create button texture " << i << ": " << SDL_GetError() << std::endl;
@@ -440,7 +455,7 @@ void Menu::LoadButtonTextures() {
         if (surface) {
             m_smallButtonTextureWidths[i] = surface->w;
             m_smallButtonTextureHeights[i] = surface->h;
-            m_smallButtonTextures[i] = SDL_CreateTextureFromSurface(m_renderer->GetSDLRenderer(), surface);
+            m_smallButtonTextures[i] = m_renderer->CreateTextureFromSurface(surface);
             SDL_DestroySurface(surface);
             if (!m_smallButtonTextures[i]) {
                 std::cerr << "Failed to create small button texture " << i << ": " << SDL_GetError() << std::endl;
@@ -455,7 +470,7 @@ void Menu::DrawBackground() {
     // Draw background image if loaded
     if (m_backgroundTexture && m_backgroundLoaded) {
         SDL_FRect destRect = { 0.0f, 0.0f, 1200.0f, 800.0f };
-        SDL_RenderTexture(m_renderer->GetSDLRenderer(), m_backgroundTexture, nullptr, &destRect);
+        m_renderer->DrawTexture(m_backgroundTexture, nullptr, &destRect);
     } else {
         // Fallback: Draw a semi-transparent dark background
         m_renderer->DrawRect(Vector2::Zero(), 1200, 800, Color(0, 0, 0, 180));
@@ -494,11 +509,11 @@ void Menu::DrawButtons() {
                     scaledWidth, 
                     scaledHeight 
                 };
-                SDL_RenderTexture(m_renderer->GetSDLRenderer(), button.texture, nullptr, &destRect);
+                m_renderer->DrawTexture(button.texture, nullptr, &destRect);
             } else {
                 // Fallback: stretch to button size if dimensions unknown
                 SDL_FRect destRect = { button.position.x, button.position.y, button.size.x, button.size.y };
-                SDL_RenderTexture(m_renderer->GetSDLRenderer(), button.texture, nullptr, &destRect);
+                m_renderer->DrawTexture(button.texture, nullptr, &destRect);
             }
         } else {
             // Fallback to gray rectangle if texture not loaded
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <vector>
+#include <SDL3/SDL.h>
+
+// Unreliable datagram link to a single peer. Packets may be lost, duplicated or
+// reordered; the netplay session copes with all of it by resending.
+class NetTransport {
+public:
+    virtual ~NetTransport() {}
+
+    virtual void Send(const std::vector<Uint8>& packet) = 0;
+    // Next received packet, if any (never blocks)
+    virtual bool Receive(std::vector<Uint8>& packet) = 0;
+};
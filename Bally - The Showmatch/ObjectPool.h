@@ -0,0 +1,200 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <array>
+
+// Refers to one spawn of a pooled object. Goes stale (Get returns nullptr) once that object
+// is despawned, even after its slot has been handed out again.
+struct PoolHandle {
+    int index = -1;
+    Uint32 generation = 0;
+
+    bool IsNull() const { return index < 0; }
+};
+
+// Fixed number of objects, all constructed up front and reused. Spawning takes a slot off an
+// intrusive free list and despawning puts it back, both O(1) and without touching the heap.
+// Live slots are linked in spawn order, so iterating visits only live objects, in the same
+// order a vector with push_back and stable erase would have them (simulation depends on it).
+// Despawned objects are not destroyed: whoever spawns one re-initializes it, which lets a
+// slot keep what is expensive to make again, like a texture.
+template<typename T, int CAPACITY>
+class ObjectPool {
+public:
+    ObjectPool() {
+        Clear();
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // Appends a live object at the end of the order. nullptr when every slot is taken.
+    T* Spawn() {
+        if (m_freeHead < 0) return nullptr;
+
+        int index = m_freeHead;
+        Link& link = m_links[index];
+        m_freeHead = link.next;
+
+        link.live = true;
+        link.prev = m_liveTail;
+        link.next = -1;
+        if (m_liveTail >= 0) {
+            m_links[m_liveTail].next = index;
+        } else {
+            m_liveHead = index;
+        }
+        m_liveTail = index;
+        m_size++;
+        return &m_objects[index];
+    }
+
+    void Despawn(const T* object) {
+        int index = IndexOf(object);
+        if (index < 0 || !m_links[index].live) return;
+
+        Link& link = m_links[index];
+        if (link.prev >= 0) {
+            m_links[link.prev].next = link.next;
+        } else {
+            m_liveHead = link.next;
+        }
+        if (link.next >= 0) {
+            m_links[link.next].prev = link.prev;
+        } else {
+            m_liveTail = link.prev;
+        }
+
+        link.live = false;
+        link.generation++;
+        link.prev = -1;
+        link.next = m_freeHead;
+        m_freeHead = index;
+        m_size--;
+    }
+
+    void Despawn(PoolHandle handle) {
+        if (const T* object = Get(handle)) Despawn(object);
+    }
+
+    // Despawns every live object the predicate holds for; the rest keep their order
+    template<typename Predicate>
+    int DespawnIf(Predicate predicate) {
+        int despawned = 0;
+        for (int index = m_liveHead; index >= 0;) {
+            int next = m_links[index].next;
+            if (predicate(static_cast<const T&>(m_objects[index]))) {
+                Despawn(&m_objects[index]);
+                despawned++;
+            }
+            index = next;
+        }
+        return despawned;
+    }
+
+    // Despawns everything. Spawning the same number again hands out the same slots in the same
+    // order, so a rebuilt list lands on the objects (and resources) it had before.
+    void Clear() {
+        m_freeHead = -1;
+        for (int index = CAPACITY - 1; index >= 0; --index) {
+            if (m_links[index].live) continue;
+            m_links[index].next = m_freeHead;
+            m_freeHead = index;
+        }
+        for (int index = m_liveTail; index >= 0;) {
+            Link& link = m_links[index];
+            int prev = link.prev;
+            link.live = false;
+            link.generation++;
+            link.prev = -1;
+            link.next = m_freeHead;
+            m_freeHead = index;
+            index = prev;
+        }
+        m_liveHead = -1;
+        m_liveTail = -1;
+        m_size = 0;
+    }
+
+    // Every slot, despawned ones included, e.g. to release what slots keep before shutdown
+    template<typename Function>
+    void ForEachSlot(Function function) {
+        for (T& object : m_objects) {
+            function(object);
+        }
+    }
+
+    PoolHandle GetHandle(const T* object) const {
+        PoolHandle handle;
+        int index = IndexOf(object);
+        if (index >= 0 && m_links[index].live) {
+            handle.index = index;
+            handle.generation = m_links[index].generation;
+        }
+        return handle;
+    }
+
+    T* Get(PoolHandle handle) {
+        return IsLive(handle) ? &m_objects[handle.index] : nullptr;
+    }
+    const T* Get(PoolHandle handle) const {
+        return IsLive(handle) ? &m_objects[handle.index] : nullptr;
+    }
+
+    int Size() const { return m_size; }
+    bool Empty() const { return m_size == 0; }
+    bool IsFull() const { return m_size == CAPACITY; }
+    static constexpr int Capacity() { return CAPACITY; }
+
+    // Live objects in spawn order. Despawning the current object while iterating is not allowed
+    // (use DespawnIf).
+    template<typename Pool, typename Value>
+    class Iterator {
+    public:
+        Iterator(Pool* pool, int index) : m_pool(pool), m_index(index) {}
+        Value& operator*() const { return m_pool->m_objects[m_index]; }
+        Value* operator->() const { return &m_pool->m_objects[m_index]; }
+        Iterator& operator++() {
+            m_index = m_pool->m_links[m_index].next;
+            return *this;
+        }
+        bool operator==(const Iterator& other) const { return m_index == other.m_index; }
+        bool operator!=(const Iterator& other) const { return m_index != other.m_index; }
+
+    private:
+        Pool* m_pool;
+        int m_index;
+    };
+    using iterator = Iterator<ObjectPool, T>;
+    using const_iterator = Iterator<const ObjectPool, const T>;
+
+    iterator begin() { return iterator(this, m_liveHead); }
+    iterator end() { return iterator(this, -1); }
+    const_iterator begin() const { return const_iterator(this, m_liveHead); }
+    const_iterator end() const { return const_iterator(this, -1); }
+
+private:
+    struct Link {
+        int prev = -1;
+        int next = -1; // Next live slot, or next free slot while despawned
+        Uint32 generation = 0;
+        bool live = false;
+    };
+
+    int IndexOf(const T* object) const {
+        if (object < m_objects.data() || object >= m_objects.data() + CAPACITY) return -1;
+        return static_cast<int>(object - m_objects.data());
+    }
+
+    bool IsLive(PoolHandle handle) const {
+        return handle.index >= 0 && handle.index < CAPACITY && m_links[handle.index].live &&
+            m_links[handle.index].generation == handle.generation;
+    }
+
+    std::array<T, CAPACITY> m_objects;
+    std::array<Link, CAPACITY> m_links;
+    int m_freeHead = -1;
+    int m_liveHead = -1;
+    int m_liveTail = -1;
+    int m_size = 0;
+};
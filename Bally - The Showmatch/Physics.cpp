@@ -1,25 +1,29 @@
 #include "Physics.h"
+#include "Profiler.h"
 #include "Player.h"
 #include "SkillOrb.h"
 #include "Terrain.h"
 #include "UI.h"
 #include "ExplosionAnimation.h"
+#include "GameEvents.h"
+#include "JobSystem.h"
+#include "StateHash.h"
 #include <cmath>
 #include <algorithm>
-
+#include <cstring>
 
 Projectile::Projectile(const Vector2& position, const Vector2& velocity, ProjectileType type, int ownerId)
     : m_position(position), m_velocity(velocity), m_acceleration(Vector2::Zero()), m_radius(DEFAULT_RADIUS),
     m_mass(DEFAULT_MASS), m_type(type), m_ownerId(ownerId), m_active(true),
     m_lifetime(0.0f), m_maxLifetime(MAX_LIFETIME), m_hasSplit(false), m_hasPowerBall(false),
-    m_hasExplosiveBall(false), m_hasTeleportBall(false), m_hasHeal(false) {
+    m_hasExplosiveBall(false), m_hasTeleportBall(false), m_hasHeal(false), m_stateHash(0), m_hashDirty(true) {
 }
 
 Projectile::Projectile(const Vector2& position, const Vector2& velocity, const std::vector<int>& skillTypes, int ownerId)
     : m_position(position), m_velocity(velocity), m_acceleration(Vector2::Zero()), m_radius(DEFAULT_RADIUS),
     m_mass(DEFAULT_MASS), m_type(ProjectileType::NORMAL), m_ownerId(ownerId), m_active(true),
     m_lifetime(0.0f), m_maxLifetime(MAX_LIFETIME), m_hasSplit(false), m_hasPowerBall(false),
-    m_hasExplosiveBall(false), m_hasTeleportBall(false), m_hasHeal(false) {
+    m_hasExplosiveBall(false), m_hasTeleportBall(false), m_hasHeal(false), m_stateHash(0), m_hashDirty(true) {
 
     // Parse skill types and set flags
     for (int skillType : skillTypes) {
@@ -58,9 +62,70 @@ Projectile::Projectile(const Vector2& position, const Vector2& velocity, const s
     }
 }
 
+Projectile::SavedState Projectile::SaveState() const {
+    SavedState state;
+    state.position = m_position;
+    state.velocity = m_velocity;
+    state.acceleration = m_acceleration;
+    state.radius = m_radius;
+    state.mass = m_mass;
+    state.type = m_type;
+    state.ownerId = m_ownerId;
+    state.active = m_active;
+    state.lifetime = m_lifetime;
+    state.maxLifetime = m_maxLifetime;
+    state.hasSplit = m_hasSplit;
+    state.hasPowerBall = m_hasPowerBall;
+    state.hasExplosiveBall = m_hasExplosiveBall;
+    state.hasTeleportBall = m_hasTeleportBall;
+    state.hasHeal = m_hasHeal;
+    return state;
+}
+
+Uint64 Projectile::ComputeStateHash() const {
+    if (!m_hashDirty) return m_stateHash;
+
+    StateHasher hasher;
+    hasher.Add(m_position);
+    hasher.Add(m_velocity);
+    hasher.Add(m_acceleration);
+    hasher.Add(m_radius);
+    hasher.Add(m_mass);
+    hasher.Add(static_cast<int>(m_type));
+    hasher.Add(m_ownerId);
+    hasher.Add(m_active);
+    hasher.Add(m_lifetime);
+    hasher.Add(m_maxLifetime);
+    hasher.Add((m_hasSplit ? 1 : 0) | (m_hasPowerBall ? 2 : 0) | (m_hasExplosiveBall ? 4 : 0) |
+        (m_hasTeleportBall ? 8 : 0) | (m_hasHeal ? 16 : 0));
+    m_stateHash = hasher.Get();
+    m_hashDirty = false;
+    return m_stateHash;
+}
+
+void Projectile::LoadState(const SavedState& state) {
+    m_position = state.position;
+    m_velocity = state.velocity;
+    m_acceleration = state.acceleration;
+    m_radius = state.radius;
+    m_mass = state.mass;
+    m_type = state.type;
+    m_ownerId = state.ownerId;
+    m_active = state.active;
+    m_lifetime = state.lifetime;
+    m_maxLifetime = state.maxLifetime;
+    m_hasSplit = state.hasSplit;
+    m_hasPowerBall = state.hasPowerBall;
+    m_hasExplosiveBall = state.hasExplosiveBall;
+    m_hasTeleportBall = state.hasTeleportBall;
+    m_hasHeal = state.hasHeal;
+    m_hashDirty = true;
+}
+
 void Projectile::Update(float deltaTime) {
     if (!m_active) return;
 
+    m_hashDirty = true;
     m_lifetime += deltaTime;
     if (m_lifetime >= m_maxLifetime) {
         m_active = false;
@@ -208,16 +273,17 @@ bool Projectile::DamagesTerrain() const {
     return true;
 }
 
-Physics::Physics() : m_terrain(nullptr), m_renderer(nullptr), m_platformWidth(PLATFORM_WIDTH), m_platformHeight(PLATFORM_HEIGHT),
-m_platformPosition(200.0f, 650.0f), m_debugDrawContours(false) {
+Physics::Physics() : m_terrain(nullptr), m_events(nullptr), m_jobSystem(nullptr), m_frameArena(nullptr), m_platformWidth(PLATFORM_WIDTH), m_platformHeight(PLATFORM_HEIGHT),
+m_platformPosition(200.0f, 650.0f), m_debugDrawContours(false), m_debugContourFrame(0) {
 }
 
 Physics::~Physics() {
     m_projectiles.clear();
-    m_explosions.clear();
 }
 
 void Physics::Update(float deltaTime) {
+    PROFILE_ZONE("Physics::Update");
+
     // Get map dimensions for bounds checking
     float mapWidth = m_terrain ? static_cast<float>(m_terrain->GetWidth()) : 1200.0f;
     float mapHeight = m_terrain ? static_cast<float>(m_terrain->GetHeight()) : 800.0f;
@@ -234,24 +300,21 @@ void Physics::Update(float deltaTime) {
         }
     }
 
-    // Remove inactive projectiles
-    m_projectiles.erase(
-        std::remove_if(m_projectiles.begin(), m_projectiles.end(),
-            [](const std::unique_ptr<Projectile>& p) { return !p->IsActive(); }),
-        m_projectiles.end()
-    );
+    RetireProjectiles(nullptr);
+}
 
-    // Update explosions
-    for (auto& explosion : m_explosions) {
-        explosion->Update(deltaTime);
+void Physics::RetireProjectiles(Projectile* only) {
+    size_t kept = 0;
+    for (size_t i = 0; i < m_projectiles.size(); ++i) {
+        bool retire = only ? m_projectiles[i].get() == only : !m_projectiles[i]->IsActive();
+        if (!retire) {
+            std::swap(m_projectiles[kept++], m_projectiles[i]);
+        }
     }
-
-    // Remove finished explosions
-    m_explosions.erase(
-        std::remove_if(m_explosions.begin(), m_explosions.end(),
-            [](const std::unique_ptr<ExplosionAnimation>& e) { return e->IsFinished(); }),
-        m_explosions.end()
-    );
+    for (size_t i = kept; i < m_projectiles.size(); ++i) {
+        m_spareProjectiles.push_back(std::move(m_projectiles[i]));
+    }
+    m_projectiles.resize(kept);
 }
 
 void Physics::Draw(class Renderer* renderer) {
@@ -262,15 +325,8 @@ void Physics::Draw(class Renderer* renderer) {
         }
     }
 
-    // Draw all active explosions
-    for (const auto& explosion : m_explosions) {
-        if (!explosion->IsFinished()) {
-            explosion->Draw(renderer);
-        }
-    }
-
-    // Draw debug contour visualization
-    if (m_debugDrawContours) {
+    // Draw debug contour visualization (unless its points went with an arena reset)
+    if (m_debugDrawContours && (!m_frameArena || m_frameArena->IsLive(m_debugContourFrame))) {
         for (const auto& data : m_debugContourData) {
             // Draw sample points (vertical lines from player bottom)
             for (const auto& samplePoint : data.samplePoints) {
@@ -302,8 +358,15 @@ void Physics::Draw(class Renderer* renderer) {
     }
 }
 
-void Physics::AddProjectile(std::unique_ptr<Projectile> projectile) {
-    m_projectiles.push_back(std::move(projectile));
+Projectile& Physics::AddProjectile(const Projectile& projectile) {
+    if (m_spareProjectiles.empty()) {
+        m_projectiles.push_back(std::make_unique<Projectile>(projectile));
+    } else {
+        *m_spareProjectiles.back() = projectile;
+        m_projectiles.push_back(std::move(m_spareProjectiles.back()));
+        m_spareProjectiles.pop_back();
+    }
+    return *m_projectiles.back();
 }
 
 void Physics::AddProjectileWithSkills(const Vector2& position, const Vector2& velocity, const std::vector<int>& skills, int ownerId) {
@@ -326,225 +389,299 @@ void Physics::AddProjectileWithSkills(const Vector2& position, const Vector2& ve
         float speed = velocity.Length();
 
         // Middle projectile
-        m_projectiles.push_back(std::make_unique<Projectile>(position, velocity, skills, ownerId));
+        AddProjectile(Projectile(position, velocity, skills, ownerId));
 
         // Upper projectile (offset upward)
         float upperAngle = baseAngle - radianOffset;
         Vector2 upperVelocity(std::cos(upperAngle) * speed, std::sin(upperAngle) * speed);
-        m_projectiles.push_back(std::make_unique<Projectile>(position, upperVelocity, skills, ownerId));
+        AddProjectile(Projectile(position, upperVelocity, skills, ownerId));
 
         // Lower projectile (offset downward)
         float lowerAngle = baseAngle + radianOffset;
         Vector2 lowerVelocity(std::cos(lowerAngle) * speed, std::sin(lowerAngle) * speed);
-        m_projectiles.push_back(std::make_unique<Projectile>(position, lowerVelocity, skills, ownerId));
+        AddProjectile(Projectile(position, lowerVelocity, skills, ownerId));
     }
     else {
         // Single projectile
-        m_projectiles.push_back(std::make_unique<Projectile>(position, velocity, skills, ownerId));
+        AddProjectile(Projectile(position, velocity, skills, ownerId));
     }
 }
 
 void Physics::RemoveProjectile(Projectile* projectile) {
-    m_projectiles.erase(
-        std::remove_if(m_projectiles.begin(), m_projectiles.end(),
-            [projectile](const std::unique_ptr<Projectile>& p) { return p.get() == projectile; }),
-        m_projectiles.end()
-    );
+    if (projectile) RetireProjectiles(projectile);
+}
+
+void Physics::Clear() {
+    ClearProjectiles();
+}
+
+void Physics::ClearProjectiles() {
+    for (auto& projectile : m_projectiles) {
+        m_spareProjectiles.push_back(std::move(projectile));
+    }
+    m_projectiles.clear();
+    m_debugContourData.clear();
 }
 
 void Physics::CheckCollisions(std::vector<std::unique_ptr<Player>>& players,
-    std::vector<std::unique_ptr<SkillOrb>>& skillOrbs) {
+    SkillOrbPool& skillOrbs) {
+    PROFILE_ZONE("Physics::CheckCollisions");
+
     // Clear debug data from previous frame
     m_debugContourData.clear();
+    m_debugContourFrame = m_frameArena ? m_frameArena->GetFrame() : 0;
 
-    CheckProjectileCollisions(players, skillOrbs);
+    if (!m_projectiles.empty()) {
+        m_bodies.Gather(players);
+        CheckProjectileCollisions(players, skillOrbs);
+    }
 
     if (m_terrain) {
         CheckPlayerTerrainCollisions(players);
     }
 
-    CheckSkillOrbCollisions(players, skillOrbs);
+    // Players have moved since the sweep
+    if (!skillOrbs.Empty()) {
+        m_bodies.Gather(players);
+        CheckSkillOrbCollisions(skillOrbs);
+    }
+}
+
+void Physics::PlayerBodies::Gather(const std::vector<std::unique_ptr<Player>>& players) {
+    position.clear();
+    radius.clear();
+    id.clear();
+    player.clear();
+    for (const auto& entry : players) {
+        if (!entry->IsAlive()) continue;
+        position.push_back(entry->GetPosition());
+        radius.push_back(entry->GetRadius());
+        id.push_back(entry->GetId());
+        player.push_back(entry.get());
+    }
 }
 
 void Physics::CheckProjectileCollisions(std::vector<std::unique_ptr<Player>>& players,
-    std::vector<std::unique_ptr<SkillOrb>>& skillOrbs) {
-    for (auto& projectile : m_projectiles) {
-        if (!projectile->IsActive()) continue;
+    SkillOrbPool& skillOrbs) {
+    // Phase 1: read-only sweep. Every projectile records what it touched into its batch's
+    // event buffer; nothing in the world is modified yet, so batches can run on workers.
+    const int projectileCount = static_cast<int>(m_projectiles.size());
+    const int batchCount = (projectileCount + PROJECTILE_SWEEP_BATCH_SIZE - 1) / PROJECTILE_SWEEP_BATCH_SIZE;
+    if (static_cast<int>(m_sweepBatchBuffers.size()) < batchCount) {
+        m_sweepBatchBuffers.resize(batchCount);
+    }
+    for (auto& buffer : m_sweepBatchBuffers) {
+        buffer.orbPickups.clear();
+        buffer.impacts.clear();
+    }
+
+    auto sweepBatch = [this, &skillOrbs](int begin, int end) {
+        SweepBuffer& buffer = m_sweepBatchBuffers[begin / PROJECTILE_SWEEP_BATCH_SIZE];
+        for (int i = begin; i < end; ++i) {
+            SweepProjectile(i, skillOrbs, buffer);
+        }
+    };
 
-        // Check collision with skill orbs - projectiles collect them for their owner
-        for (auto& orb : skillOrbs) {
-            if (orb->IsCollected() || !orb->IsActive()) continue;
+    if (m_jobSystem) {
+        m_jobSystem->ParallelFor(projectileCount, PROJECTILE_SWEEP_BATCH_SIZE, sweepBatch);
+    } else {
+        for (int begin = 0; begin < projectileCount; begin += PROJECTILE_SWEEP_BATCH_SIZE) {
+            sweepBatch(begin, std::min(begin + PROJECTILE_SWEEP_BATCH_SIZE, projectileCount));
+        }
+    }
 
-            // Check if projectile intersects with skill orb
-            Vector2 distance = orb->GetPosition() - projectile->GetPosition();
-            float distanceLength = distance.Length();
-            float combinedRadius = orb->GetRadius() + projectile->GetRadius();
+    // Merge in projectile order so resolution never depends on thread scheduling
+    m_orbPickups.clear();
+    m_impacts.clear();
+    for (int batch = 0; batch < batchCount; ++batch) {
+        const SweepBuffer& buffer = m_sweepBatchBuffers[batch];
+        m_orbPickups.insert(m_orbPickups.end(), buffer.orbPickups.begin(), buffer.orbPickups.end());
+        m_impacts.insert(m_impacts.end(), buffer.impacts.begin(), buffer.impacts.end());
+    }
 
-            if (distanceLength < combinedRadius) {
-                for (auto& player : players) {
-                    if (player->GetId() == projectile->GetOwnerId()) {
-                        orb->OnCollected(player.get());
-                        break;
-                    }
-                }
-            }
+    // Phase 2: apply everything that happened this step
+    ResolveImpacts(players, skillOrbs);
+}
+
+void Physics::SweepProjectile(int index,
+    const SkillOrbPool& skillOrbs, SweepBuffer& out) const {
+    const Projectile& projectile = *m_projectiles[index];
+    if (!projectile.IsActive()) return;
+
+    // Check collision with skill orbs - projectiles collect them for their owner
+    for (const SkillOrb& orb : skillOrbs) {
+        if (orb.IsCollected() || !orb.IsActive()) continue;
+
+        Vector2 distance = orb.GetPosition() - projectile.GetPosition();
+        float combinedRadius = orb.GetRadius() + projectile.GetRadius();
+        if (distance.Length() < combinedRadius) {
+            out.orbPickups.push_back({ index, skillOrbs.GetHandle(&orb) });
+        }
+    }
+
+    // Terrain hit ends the projectile before it can reach a player
+    if (m_terrain && m_terrain->IsCircleSolid(projectile.GetPosition(), projectile.GetRadius())) {
+        out.impacts.push_back({ index, nullptr, projectile.GetPosition() });
+        return;
+    }
+
+    // Check collision with players (first one hit wins)
+    const int bodyCount = m_bodies.Count();
+    for (int i = 0; i < bodyCount; ++i) {
+        if (m_bodies.id[i] == projectile.GetOwnerId()) continue;
+
+        Vector2 distance = m_bodies.position[i] - projectile.GetPosition();
+        if (distance.Length() < projectile.GetRadius() + m_bodies.radius[i]) {
+            out.impacts.push_back({ index, m_bodies.player[i], projectile.GetPosition() });
+            return;
         }
+    }
+}
 
-        bool hitTerrain = false;
-        if (m_terrain && m_terrain->IsCircleSolid(projectile->GetPosition(), projectile->GetRadius())) {
-            hitTerrain = true;
+void Physics::ResolveImpacts(std::vector<std::unique_ptr<Player>>& players, SkillOrbPool& skillOrbs) {
+    // Orbs touched by projectiles go to the projectile owner
+    for (const OrbPickupEvent& pickup : m_orbPickups) {
+        Player* owner = FindPlayerById(players, m_projectiles[pickup.projectile]->GetOwnerId());
+        SkillOrb* orb = skillOrbs.Get(pickup.orb);
+        if (owner && orb) {
+            CollectOrb(*orb, *owner);
         }
+    }
 
-        if (hitTerrain) {
-            // Handle terrain/platform collision
-            if (projectile->HasHeal()) {
-                // Apply healing to all allies in AOE
-                ApplyHealing(projectile->GetPosition(), projectile->GetExplosionRadius(),
-                    projectile->GetOwnerId(), players);
-                CreateHealAnimation(projectile->GetPosition(), projectile->GetExplosionRadius());
-            }
-            else if (projectile->HasTeleportBall()) {
-                // Teleport the owner to this location (unless it's void)
-                Vector2 teleportPos = projectile->GetPosition();
-                // Make sure teleport position is within map bounds
-                float mapHeight = m_terrain ? static_cast<float>(m_terrain->GetHeight()) : 800.0f;
-                CreateTeleportAnimation(projectile->GetPosition(), std::max(projectile->GetExplosionRadius(), 50.0f));
-                
-                if (teleportPos.y >= 0 && teleportPos.y < mapHeight) {
-                    for (auto& player : players) {
-                        if (player->GetId() == projectile->GetOwnerId()) {
-                            int teleportX = (int)teleportPos.x;
-                            int groundY = m_terrain ? m_terrain->FindTopSolidPixel(teleportX, (int)teleportPos.y) : -1;
-                            
-                            if (groundY >= 0) {
-                                float playerRadius = player->GetRadius();
-                                float buffer = 5.0f;
-                                teleportPos.y = (float)groundY - playerRadius - buffer;
-                            }
-                            else {
-                                // If no ground found, add height to prevent falling through
-                                float playerRadius = player->GetRadius();
-                                teleportPos.y -= playerRadius * 2.0f;
-                            }
-                            
-                            player->SetPosition(teleportPos);
-                            break;
-                        }
+    m_areaDamage.clear();
+    m_pendingCraters.clear();
+    m_pendingAnimations.clear();
+
+    // Direct effects in projectile order; area damage, animations and terrain edits are
+    // gathered so they can be applied once per step below
+    for (const ImpactEvent& impact : m_impacts) {
+        Projectile& projectile = *m_projectiles[impact.projectile];
+        const float effectRadius = projectile.GetExplosionRadius();
+
+        if (projectile.HasHeal()) {
+            // Apply healing to all allies in AOE
+            ApplyHealing(impact.position, effectRadius, projectile.GetOwnerId(), players);
+            QueueAnimation(impact.position, effectRadius, ExplosionAnimationType::HEAL);
+        }
+        else if (projectile.HasTeleportBall()) {
+            QueueAnimation(impact.position, std::max(effectRadius, 50.0f), ExplosionAnimationType::TELEPORT);
+
+            // Teleport the owner to the hit player, or to the impact point (unless it's void)
+            Player* owner = FindPlayerById(players, projectile.GetOwnerId());
+            if (owner) {
+                if (impact.hitPlayer) {
+                    TeleportPlayer(*owner, impact.hitPlayer->GetPosition());
+                }
+                else {
+                    float mapHeight = m_terrain ? static_cast<float>(m_terrain->GetHeight()) : 800.0f;
+                    if (impact.position.y >= 0 && impact.position.y < mapHeight) {
+                        TeleportPlayer(*owner, impact.position);
                     }
                 }
             }
-            else {
-                // Apply explosion effects if not pure teleport
-                if (projectile->GetExplosionRadius() > 0) {
-                    ApplyExplosion(projectile->GetPosition(), projectile->GetExplosionRadius(),
-                        projectile->GetExplosionForce(), players);
-
-                    // Create explosion animation (use big explosion if explosive buff, otherwise small)
-                    bool isBigExplosion = projectile->HasExplosiveBall();
-                    CreateExplosion(projectile->GetPosition(), projectile->GetExplosionRadius(), isBigExplosion);
-
-                    // Destroy terrain only if projectile damages terrain
-                    if (m_terrain && projectile->DamagesTerrain()) {
-                        m_terrain->DestroyCircle(projectile->GetPosition(), projectile->GetExplosionRadius());
-                    }
+        }
+        else {
+            // Direct hit damage (if damage > 0)
+            float damage = projectile.GetDamage();
+            if (impact.hitPlayer && damage > 0) {
+                float healthBefore = impact.hitPlayer->GetHealth();
+                impact.hitPlayer->TakeDamage(damage);
+                if (m_events) {
+                    GameEvent event(GameEventType::DAMAGE, impact.hitPlayer->GetId());
+                    event.sourceId = static_cast<Sint16>(projectile.GetOwnerId());
+                    event.position = impact.position;
+                    event.amount = healthBefore - impact.hitPlayer->GetHealth();
+                    m_events->Publish(event);
                 }
             }
 
-            projectile->SetActive(false);
-            continue;
-        }
+            // Explosion effects (use big explosion if explosive buff, otherwise small)
+            if (effectRadius > 0) {
+                m_areaDamage.push_back({ impact.position, effectRadius, projectile.GetExplosionForce(), projectile.GetOwnerId() });
+                QueueAnimation(impact.position, effectRadius, projectile.HasExplosiveBall() ?
+                    ExplosionAnimationType::BIG_EXPLOSION : ExplosionAnimationType::SMALL_EXPLOSION);
 
-        // Check collision with players
-        for (auto& player : players) {
-            if (!player->IsAlive() || player->GetId() == projectile->GetOwnerId()) continue;
-
-            CollisionInfo playerCollision = CheckCircleCollision(
-                projectile->GetPosition(), projectile->GetRadius(),
-                player->GetPosition(), player->GetRadius()
-            );
-
-            if (playerCollision.hasCollision) {
-                // Handle player collision
-                if (projectile->HasHeal()) {
-                    // Apply healing to all allies in AOE
-                    ApplyHealing(projectile->GetPosition(), projectile->GetExplosionRadius(),
-                        projectile->GetOwnerId(), players);
-                    CreateHealAnimation(projectile->GetPosition(), projectile->GetExplosionRadius());
-                }
-                else if (projectile->HasTeleportBall()) {
-                    CreateTeleportAnimation(projectile->GetPosition(), std::max(projectile->GetExplosionRadius(), 50.0f));
-                    
-                    // Teleport the owner to this location
-                    for (auto& owner : players) {
-                        if (owner->GetId() == projectile->GetOwnerId()) {
-                            Vector2 teleportPos = player->GetPosition();
-                            
-                            // Find ground surface at teleport X position to ensure safe placement
-                            int teleportX = (int)teleportPos.x;
-                            int groundY = m_terrain ? m_terrain->FindTopSolidPixel(teleportX, (int)teleportPos.y) : -1;
-                            
-                            if (groundY >= 0) {
-                                // Place player above ground with player radius + buffer
-                                float playerRadius = owner->GetRadius();
-                                float buffer = 5.0f;
-                                teleportPos.y = (float)groundY - playerRadius - buffer;
-                            }
-                            else {
-                                // If no ground found, add height to prevent falling through
-                                float playerRadius = owner->GetRadius();
-                                teleportPos.y -= playerRadius * 2.0f;
-                            }
-                            
-                            owner->SetPosition(teleportPos);
-                            break;
-                        }
-                    }
+                // Destroy terrain only if projectile damages terrain
+                if (projectile.DamagesTerrain()) {
+                    m_pendingCraters.push_back({ impact.position, effectRadius });
                 }
-                else {
-                    // Damage player (if damage > 0)
-                    float damage = projectile->GetDamage();
-                    if (damage > 0) {
-                        player->TakeDamage(damage);
-                    }
+            }
+        }
 
-                    // Apply explosion effects
-                    if (projectile->GetExplosionRadius() > 0) {
-                        ApplyExplosion(projectile->GetPosition(), projectile->GetExplosionRadius(),
-                            projectile->GetExplosionForce(), players);
+        projectile.SetActive(false);
+    }
 
-                        bool isBigExplosion = projectile->HasExplosiveBall();
-                        CreateExplosion(projectile->GetPosition(), projectile->GetExplosionRadius(), isBigExplosion);
+    ApplyExplosions(m_areaDamage, players);
 
-                        // Destroy terrain only if projectile damages terrain
-                        if (m_terrain && projectile->DamagesTerrain()) {
-                            m_terrain->DestroyCircle(projectile->GetPosition(), projectile->GetExplosionRadius());
-                        }
-                    }
-                }
+    // Presentation turns these into animations and sounds
+    if (m_events) {
+        for (const PendingAnimation& animation : m_pendingAnimations) {
+            GameEvent event;
+            event.type = GameEventType::EXPLOSION;
+            event.kind = static_cast<Uint8>(animation.type);
+            event.position = animation.position;
+            event.amount = animation.radius;
+            m_events->Publish(event);
+        }
+    }
 
-                projectile->SetActive(false);
-                break;
-            }
+    // All craters of this step in one terrain edit (one texture refresh)
+    if (m_terrain && !m_pendingCraters.empty()) {
+        m_terrain->DestroyCircles(m_pendingCraters);
+    }
+}
+
+void Physics::QueueAnimation(const Vector2& position, float radius, ExplosionAnimationType type) {
+    // Several projectiles landing on the same spot (split shots) share one animation
+    for (PendingAnimation& pending : m_pendingAnimations) {
+        if (pending.type != type) continue;
+
+        float mergeDistance = std::max(pending.radius, radius) * 0.5f;
+        if ((pending.position - position).LengthSquared() <= mergeDistance * mergeDistance) {
+            pending.radius = std::max(pending.radius, radius);
+            return;
         }
     }
+    m_pendingAnimations.push_back({ position, radius, type });
 }
 
+void Physics::TeleportPlayer(Player& player, Vector2 teleportPos) {
+    // Find ground surface at teleport X position to ensure safe placement
+    int teleportX = (int)teleportPos.x;
+    int groundY = m_terrain ? m_terrain->FindTopSolidPixel(teleportX, (int)teleportPos.y) : -1;
+
+    if (groundY >= 0) {
+        // Place player above ground with player radius + buffer
+        float buffer = 5.0f;
+        teleportPos.y = (float)groundY - player.GetRadius() - buffer;
+    }
+    else {
+        // If no ground found, add height to prevent falling through
+        teleportPos.y -= player.GetRadius() * 2.0f;
+    }
+
+    player.SetPosition(teleportPos);
+}
 
-void Physics::CheckSkillOrbCollisions(std::vector<std::unique_ptr<Player>>& players,
-    std::vector<std::unique_ptr<SkillOrb>>& skillOrbs) {
-    for (auto& orb : skillOrbs) {
-        if (orb->IsCollected()) continue;
+Player* Physics::FindPlayerById(const std::vector<std::unique_ptr<Player>>& players, int id) {
+    for (const auto& player : players) {
+        if (player->GetId() == id) {
+            return player.get();
+        }
+    }
+    return nullptr;
+}
 
-        for (auto& player : players) {
-            if (!player->IsAlive()) continue;
 
-            CollisionInfo collision = CheckCircleCollision(
-                orb->GetPosition(), orb->GetRadius(),
-                player->GetPosition(), player->GetRadius()
-            );
+void Physics::CheckSkillOrbCollisions(SkillOrbPool& skillOrbs) {
+    const int bodyCount = m_bodies.Count();
+    for (SkillOrb& orb : skillOrbs) {
+        if (orb.IsCollected()) continue;
 
-            if (collision.hasCollision) {
-                orb->OnCollected(player.get());
+        for (int i = 0; i < bodyCount; ++i) {
+            Vector2 distance = m_bodies.position[i] - orb.GetPosition();
+            if (distance.Length() < orb.GetRadius() + m_bodies.radius[i]) {
+                CollectOrb(orb, *m_bodies.player[i]);
                 break;
             }
         }
@@ -577,7 +714,6 @@ CollisionInfo Physics::CheckCircleCollision(const Vector2& pos1, float radius1,
     return info;
 }
 
-
 void Physics::ApplyExplosion(const Vector2& center, float radius, float force,
     std::vector<std::unique_ptr<Player>>& players) {
     for (auto& player : players) {
@@ -593,197 +729,150 @@ void Physics::ApplyExplosion(const Vector2& center, float radius, float force,
     }
 }
 
-bool Physics::IsPointInBounds(const Vector2& point, const Vector2& boundsMin, const Vector2& boundsMax) const {
-    return point.x >= boundsMin.x && point.x <= boundsMax.x &&
-        point.y >= boundsMin.y && point.y <= boundsMax.y;
-}
-
-void Physics::CheckPlayerTerrainCollisions(std::vector<std::unique_ptr<Player>>& players) {
-    if (!m_terrain) return;
+void Physics::ApplyExplosions(const std::vector<AreaDamage>& explosions,
+    std::vector<std::unique_ptr<Player>>& players) {
+    if (explosions.empty()) return;
 
+    // One pass over players: sum the falloff damage of every explosion of this step
     for (auto& player : players) {
         if (!player->IsAlive()) continue;
 
-        Vector2 pos = player->GetPosition();
-        Vector2 velocity = player->GetVelocity();
-        float radius = player->GetRadius();
-
-        // Check if player fell into the void (below map)
-        // Use terrain height if available, otherwise fallback to default
-        float mapHeight = static_cast<float>(m_terrain->GetHeight());
-        float deathThreshold = mapHeight + 50.0f;
-        if (pos.y > deathThreshold) {
-            player->TakeDamage(player->GetMaxHealth());
-            continue;
-        }
+        float totalDamage = 0.0f;
+        const AreaDamage* firstHit = nullptr;
+        for (const AreaDamage& explosion : explosions) {
+            Vector2 distance = player->GetPosition() - explosion.center;
+            float distanceLength = distance.Length();
 
-        // High-accuracy ground following system
-        bool onGround = false;
-        int groundY = -1;
-
-        // Sample many points across player's width for maximum accuracy
-        const int sampleCount = 11; // Increased to 11 for very accurate terrain detection
-        const float sampleWidthMultiplier = 0.8f; // Adjust this to match character sprite width (0.5-1.5)
-        const float maxUpwardSearch = radius * 0.5f; // Only search slightly above player (prevent ceiling detection)
-        int samples[sampleCount];
-        for (int i = 0; i < sampleCount; i++) {
-            float t = (i / (float)(sampleCount - 1)) - 0.5f;
-            int sampleX = (int)(pos.x + t * radius * sampleWidthMultiplier);
-            int startY = (int)(pos.y + radius);
-            int searchStartY = std::max(0, (int)(startY - maxUpwardSearch));
-            samples[i] = m_terrain->FindTopSolidPixel(sampleX, searchStartY);
+            if (distanceLength < explosion.radius && distanceLength > 0) {
+                totalDamage += 30.0f * (1.0f - (distanceLength / explosion.radius));
+                if (!firstHit) firstHit = &explosion;
+            }
         }
 
-        // Find the highest (lowest Y value) ground point that's not too far above player
-        for (int i = 0; i < sampleCount; i++) {
-            if (samples[i] >= 0) {
-                float currentBottom = pos.y + radius;
-                float distanceToSample = samples[i] - currentBottom;
-
-                // Only accept ground that's below or very slightly above player
-                // This prevents snapping to ceiling in C-shaped terrain
-                if (distanceToSample >= -maxUpwardSearch) {
-                    if (groundY < 0 || samples[i] < groundY) {
-                        groundY = samples[i];
-                    }
-                }
+        if (totalDamage > 0.0f) {
+            float healthBefore = player->GetHealth();
+            player->TakeDamage(totalDamage);
+            if (m_events) {
+                GameEvent event(GameEventType::DAMAGE, player->GetId());
+                event.sourceId = static_cast<Sint16>(firstHit->ownerId);
+                event.position = firstHit->center;
+                event.amount = healthBefore - player->GetHealth();
+                m_events->Publish(event);
             }
         }
+    }
+}
 
-        // Store debug visualization data
-        if (m_debugDrawContours) {
-            DebugContourData debugData;
-            debugData.playerPos = pos;
-            debugData.playerRadius = radius;
-            debugData.groundY = groundY;
-
-            // Store sample points and ground points
-            for (int i = 0; i < sampleCount; i++) {
-                float t = (i / (float)(sampleCount - 1)) - 0.5f;
-                int sampleX = (int)(pos.x + t * radius * sampleWidthMultiplier);
-                int startY = (int)(pos.y + radius);
-                debugData.samplePoints.push_back(Vector2((float)sampleX, (float)startY));
-
-                if (samples[i] >= 0) {
-                    debugData.groundPoints.push_back(Vector2((float)sampleX, (float)samples[i]));
-                }
-            }
+bool Physics::IsPointInBounds(const Vector2& point, const Vector2& boundsMin, const Vector2& boundsMax) const {
+    return point.x >= boundsMin.x && point.x <= boundsMax.x &&
+        point.y >= boundsMin.y && point.y <= boundsMax.y;
+}
 
-            m_debugContourData.push_back(debugData);
-        }
+void Physics::CheckPlayerTerrainCollisions(std::vector<std::unique_ptr<Player>>& players) {
+    if (!m_terrain) return;
 
-        // Ground following logic
-        if (groundY >= 0) {
-            float targetY = groundY - radius; // Target position (feet on ground)
-            float currentBottom = pos.y + radius;
-            float distanceToGround = groundY - currentBottom;
-
-            // Case 1: Player is embedded in terrain (negative distance)
-            if (distanceToGround < -2.0f) {
-                // Push player up to surface
-                onGround = true;
-                pos.y = targetY;
-                if (velocity.y > 0) {
-                    velocity.y = 0;
-                }
-            }
-            // Case 2: Player is on or very close to ground - snap for pixel-perfect contour
-            else if (distanceToGround >= -2.0f && distanceToGround <= 3.0f) {
-                onGround = true;
-                pos.y = targetY; // Direct snap - no smoothing for accuracy
-                if (velocity.y > 0) {
-                    velocity.y = 0;
-                }
-            }
-            // Case 3: Player is falling and close to ground - smooth landing
-            else if (velocity.y > 0 && distanceToGround > 3.0f && distanceToGround <= 15.0f) {
-                float smoothFactor = 0.5f;
-                pos.y = pos.y + distanceToGround * smoothFactor;
-
-                // Check if we're now close enough to snap
-                float newDistanceToGround = groundY - (pos.y + radius);
-                if (newDistanceToGround <= 3.0f) {
-                    onGround = true;
-                    pos.y = targetY;
-                    velocity.y = 0;
-                }
-            }
-            // Case 4: Player is far above ground (>15px) - let gravity work, but check collision
-            else if (distanceToGround > 15.0f && velocity.y > 0) {
-            }
-            // Case 5: Player falling and would pass through ground this frame
-            else if (velocity.y > 0 && distanceToGround > 0) {
-                // Check if velocity would make player pass through
-                float nextBottom = currentBottom + velocity.y;
-                if (nextBottom >= groundY) {
-                    // Would pass through - land on ground instead
-                    onGround = true;
-                    pos.y = targetY;
-                    velocity.y = 0;
-                }
-            }
+    // Each player only reads terrain and writes its own position/velocity, so players are
+    // resolved in parallel. Debug data goes to per-batch buffers that are merged in batch
+    // order afterwards, which keeps the output identical to a serial pass.
+    const int playerCount = static_cast<int>(players.size());
+    const int batchCount = (playerCount + PLAYER_COLLISION_BATCH_SIZE - 1) / PLAYER_COLLISION_BATCH_SIZE;
+    if (static_cast<int>(m_debugBatchBuffers.size()) < batchCount) {
+        m_debugBatchBuffers.resize(batchCount);
+    }
+    for (auto& buffer : m_debugBatchBuffers) {
+        buffer.clear();
+    }
+    if (static_cast<int>(m_controllerMemos.size()) < playerCount) {
+        m_controllerMemos.resize(playerCount, ControllerMemo());
+    }
+
+    auto resolveBatch = [this, &players](int begin, int end) {
+        std::vector<DebugContourData>& debugBuffer = m_debugBatchBuffers[begin / PLAYER_COLLISION_BATCH_SIZE];
+        for (int i = begin; i < end; ++i) {
+            ResolvePlayerTerrainCollision(*players[i], m_controllerMemos[i], debugBuffer);
         }
+    };
 
-        // Handle steep slope traversal (Gunny-style climbing)
-        if (onGround && std::abs(velocity.x) > 0.1f) {
-            float lookAheadDist = radius * 2.0f;
-            int checkX = (int)(pos.x + (velocity.x > 0 ? lookAheadDist : -lookAheadDist));
-            int checkStartY = (int)(pos.y + radius);
-            int groundAhead = m_terrain->FindTopSolidPixel(checkX, checkStartY - (int)(radius * 6));
-
-            if (groundAhead >= 0) {
-                float heightDiff = groundAhead - groundY;
-
-                // Allow climbing extremely steep slopes
-                // Further increased to allow near-vertical terrain traversal
-                if (heightDiff < radius * 8.0f && heightDiff > -radius * 4) {
-                    // Smoothly adjust Y to climb slope - faster interpolation for responsive climbing
-                    float targetClimbY = groundAhead - radius;
-                    pos.y += (targetClimbY - pos.y) * 0.3f;
-                }
-                // If slope is too steep, stop horizontal movement
-                // Increased threshold to 7x radius to match climbing capability
-                else if (heightDiff >= radius * 8.0f) {
-                    velocity.x *= 0.5f;
-                }
-            }
+    if (m_jobSystem) {
+        m_jobSystem->ParallelFor(playerCount, PLAYER_COLLISION_BATCH_SIZE, resolveBatch);
+    } else {
+        for (int begin = 0; begin < playerCount; begin += PLAYER_COLLISION_BATCH_SIZE) {
+            resolveBatch(begin, std::min(begin + PLAYER_COLLISION_BATCH_SIZE, playerCount));
         }
+    }
 
-        // Handle collision with terrain when embedded (pushed into walls)
-        bool embedded = false;
-        Vector2 pushOut(0, 0);
-        int embedCount = 0;
-
-        // Check if player center is inside terrain
-        for (int angle = 0; angle < 360; angle += 45) {
-            float rad = angle * 3.14159265f / 180.0f;
-            int checkX = (int)(pos.x + std::cos(rad) * radius * 0.8f);
-            int checkY = (int)(pos.y + std::sin(rad) * radius * 0.8f);
-
-            if (m_terrain->IsPixelSolid(checkX, checkY)) {
-                // Calculate push direction (away from solid)
-                Vector2 pushDir(-std::cos(rad), -std::sin(rad));
-                pushOut = pushOut + pushDir;
-                embedCount++;
-                embedded = true;
-            }
+    // Merge debug data in player order
+    for (int batch = 0; batch < batchCount; ++batch) {
+        for (auto& debugData : m_debugBatchBuffers[batch]) {
+            m_debugContourData.push_back(std::move(debugData));
         }
+    }
+}
 
-        // Apply push out correction if embedded
-        if (embedded && embedCount > 0) {
-            pushOut = pushOut * (1.0f / embedCount);
-            pos = pos + pushOut * 2.0f;
+void Physics::ResolvePlayerTerrainCollision(Player& player, ControllerMemo& memo, std::vector<DebugContourData>& debugOut) {
+    PROFILE_ZONE("Player terrain collision");
 
-            // Reduce velocity when hitting walls
-            if (std::abs(pushOut.x) > 0.1f) {
-                velocity.x *= 0.3f;
-            }
-        }
+    if (!player.IsAlive()) return;
+
+    Vector2 pos = player.GetPosition();
+    Vector2 velocity = player.GetVelocity();
+    float radius = player.GetRadius();
+
+    // Check if player fell into the void (below map)
+    // Use terrain height if available, otherwise fallback to default
+    float mapHeight = static_cast<float>(m_terrain->GetHeight());
+    float deathThreshold = mapHeight + 50.0f;
+    if (pos.y > deathThreshold) {
+        player.TakeDamage(player.GetMaxHealth());
+        return;
+    }
 
-        // Update player position and velocity
-        player->SetPosition(pos);
-        player->SetVelocity(velocity);
+    // Same move on the same terrain as last step: the controller would answer the same
+    // (bitwise compare, so even -0 vs 0 can't sneak a different result past the memo)
+    Vector2 start = player.GetSweepOrigin();
+    Vector2 displacement = pos - start;
+    bool wasGrounded = player.IsGrounded();
+    if (!m_debugDrawContours && memo.terrainRevision == m_terrain->GetRevision() &&
+        SameBits(memo.start, start) && SameBits(memo.displacement, displacement) &&
+        SameBits(memo.velocity, velocity) && std::memcmp(&memo.radius, &radius, sizeof(radius)) == 0 &&
+        memo.wasGrounded == wasGrounded) {
+        player.SetPosition(memo.resultPosition);
+        player.SetVelocity(memo.resultVelocity);
+        player.SetGrounded(memo.resultGrounded);
+        return;
     }
+
+    // Sweep everything the player moved since the last placement (input + gravity)
+    DebugContourData* debugData = nullptr;
+    if (m_debugDrawContours) {
+        debugOut.emplace_back(m_frameArena ? &m_frameArena->Current() : nullptr);
+        debugData = &debugOut.back();
+    }
+    ControllerResult result = m_characterController.Move(*m_terrain, start, displacement, velocity, radius, wasGrounded,
+        debugData ? &debugData->groundPoints : nullptr);
+
+    memo.terrainRevision = m_terrain->GetRevision();
+    memo.start = start;
+    memo.displacement = displacement;
+    memo.velocity = velocity;
+    memo.radius = radius;
+    memo.wasGrounded = wasGrounded;
+    memo.resultPosition = result.position;
+    memo.resultVelocity = result.velocity;
+    memo.resultGrounded = result.grounded;
+
+    // Store debug visualization data
+    if (debugData) {
+        debugData->playerPos = result.position;
+        debugData->playerRadius = radius;
+        debugData->groundY = result.grounded ? (int)result.groundPoint.y : -1;
+        debugData->samplePoints.push_back(Vector2(result.position.x, result.position.y + radius));
+    }
+
+    // Update player position and velocity
+    player.SetPosition(result.position);
+    player.SetVelocity(result.velocity);
+    player.SetGrounded(result.grounded);
 }
 
 CollisionInfo Physics::CheckCircleTerrainCollision(const Vector2& pos, float radius, Terrain* terrain) const {
@@ -815,37 +904,26 @@ void Physics::ApplyHealing(const Vector2& center, float radius, int ownerId,
         if (distanceLength < radius) {
             // Heal for 30% of max health
             float healAmount = player->GetMaxHealth() * 0.3f;
+            float healthBefore = player->GetHealth();
             player->Heal(healAmount);
+            if (m_events) {
+                GameEvent event(GameEventType::HEAL, player->GetId());
+                event.sourceId = static_cast<Sint16>(ownerId);
+                event.position = center;
+                event.amount = player->GetHealth() - healthBefore;
+                m_events->Publish(event);
+            }
         }
     }
 }
 
-void Physics::CreateExplosion(const Vector2& position, float radius, bool isBigExplosion) {
-    if (!m_renderer) return;
-
-    auto explosion = std::make_unique<ExplosionAnimation>(position, radius, isBigExplosion);
-    if (explosion->Load(m_renderer)) {
-        m_explosions.push_back(std::move(explosion));
-    }
-}
-
-void Physics::CreateTeleportAnimation(const Vector2& position, float radius) {
-    if (!m_renderer) return;
-
-    float animRadius = std::max(radius, 50.0f);
-    auto animation = std::make_unique<ExplosionAnimation>(position, animRadius, ExplosionAnimationType::TELEPORT);
-    if (animation->Load(m_renderer)) {
-        m_explosions.push_back(std::move(animation));
-    }
-}
-
-void Physics::CreateHealAnimation(const Vector2& position, float radius) {
-    if (!m_renderer) return;
-
-    float animRadius = std::max(radius, 50.0f);
-    auto animation = std::make_unique<ExplosionAnimation>(position, animRadius, ExplosionAnimationType::HEAL);
-    if (animation->Load(m_renderer)) {
-        m_explosions.push_back(std::move(animation));
+void Physics::CollectOrb(SkillOrb& orb, Player& player) {
+    orb.OnCollected(&player);
+    if (m_events && orb.IsCollected()) {
+        GameEvent event(GameEventType::ORB_COLLECTED, player.GetId());
+        event.kind = static_cast<Uint8>(orb.GetSkillType());
+        event.position = orb.GetPosition();
+        m_events->Publish(event);
     }
 }
 
@@ -2,12 +2,15 @@
 #include <vector>
 #include <memory>
 #include "Vector2.h"
+#include "Terrain.h"
+#include "CharacterController.h"
+#include "FrameArena.h"
+#include "SkillOrb.h"
 
 class Player;
 class Projectile;
-class SkillOrb;
-class Terrain;
-class ExplosionAnimation;
+class EventBus;
+enum class ExplosionAnimationType;
 
 struct CollisionInfo {
     bool hasCollision;
@@ -49,9 +52,31 @@ public:
     bool HasHeal() const { return m_hasHeal; }
     bool DamagesTerrain() const;
 
-    void SetActive(bool active) { m_active = active; }
-    void SetPosition(const Vector2& position) { m_position = position; }
-    void SetVelocity(const Vector2& velocity) { m_velocity = velocity; }
+    void SetActive(bool active) { m_active = active; m_hashDirty = true; }
+    void SetPosition(const Vector2& position) { m_position = position; m_hashDirty = true; }
+    void SetVelocity(const Vector2& velocity) { m_velocity = velocity; m_hashDirty = true; }
+
+    // Simulation state (keyframes, rollback and snapshots rebuild projectiles from this)
+    struct SavedState {
+        Vector2 position;
+        Vector2 velocity;
+        Vector2 acceleration;
+        float radius;
+        float mass;
+        ProjectileType type;
+        int ownerId;
+        bool active;
+        float lifetime;
+        float maxLifetime;
+        bool hasSplit;
+        bool hasPowerBall;
+        bool hasExplosiveBall;
+        bool hasTeleportBall;
+        bool hasHeal;
+    };
+    SavedState SaveState() const;
+    void LoadState(const SavedState& state);
+    Uint64 ComputeStateHash() const; // Cached until the projectile changes
 
 private:
     Vector2 m_position;
@@ -72,6 +97,9 @@ private:
     bool m_hasTeleportBall;
     bool m_hasHeal;
 
+    mutable Uint64 m_stateHash;
+    mutable bool m_hashDirty;
+
     // Physics constants
     static constexpr float GRAVITY = 980.0f;
     static constexpr float AIR_RESISTANCE = 0.98f;
@@ -87,14 +115,16 @@ public:
 
     void Update(float deltaTime);
     void Draw(class Renderer* renderer);
-    void AddProjectile(std::unique_ptr<Projectile> projectile);
+    Projectile& AddProjectile(const Projectile& projectile); // Copied into a spare one when there is one
     void AddProjectileWithSkills(const Vector2& position, const Vector2& velocity, const std::vector<int>& skills, int ownerId);
     void RemoveProjectile(Projectile* projectile);
+    void Clear(); // Remove all projectiles and debug data
+    void ClearProjectiles(); // Same, restoring a saved state
     bool HasActiveProjectiles() const { return !m_projectiles.empty(); }
     const std::vector<std::unique_ptr<Projectile>>& GetProjectiles() const { return m_projectiles; }
 
     void CheckCollisions(std::vector<std::unique_ptr<Player>>& players,
-        std::vector<std::unique_ptr<SkillOrb>>& skillOrbs);
+        SkillOrbPool& skillOrbs);
 
     bool IsPointInBounds(const Vector2& point, const Vector2& boundsMin, const Vector2& boundsMax) const;
     Vector2 GetPlatformBounds() const { return Vector2(m_platformWidth, m_platformHeight); }
@@ -106,14 +136,31 @@ public:
 
     void ApplyExplosion(const Vector2& center, float radius, float force,
         std::vector<std::unique_ptr<Player>>& players);
+
+    // Area damage of one explosion (batched per step by ApplyExplosions)
+    struct AreaDamage {
+        Vector2 center;
+        float radius;
+        float force;
+        int ownerId;
+    };
+    void ApplyExplosions(const std::vector<AreaDamage>& explosions,
+        std::vector<std::unique_ptr<Player>>& players);
     void ApplyHealing(const Vector2& center, float radius, int ownerId,
         std::vector<std::unique_ptr<Player>>& players);
 
     // Set the terrain for collision detection
     void SetTerrain(Terrain* terrain) { m_terrain = terrain; }
 
-    // Set renderer for explosion animations (needed to load sprites)
-    void SetRenderer(class Renderer* renderer) { m_renderer = renderer; }
+    // Damage, healing, explosions and orb pickups are published here (nullptr = nowhere)
+    void SetEventBus(EventBus* events) { m_events = events; }
+
+    // Set job system for running per-entity work on worker threads (optional)
+    void SetJobSystem(class JobSystem* jobSystem) { m_jobSystem = jobSystem; }
+
+    // Scratch memory for the debug view's points, drawn up to a frame after they were built
+    // (nullptr = general heap)
+    void SetFrameArena(DoubleBufferedArena* arena) { m_frameArena = arena; }
 
     // Debug visualization
     void SetDebugDrawContours(bool enable) { m_debugDrawContours = enable; }
@@ -121,41 +168,110 @@ public:
 
 private:
     std::vector<std::unique_ptr<Projectile>> m_projectiles;
-    std::vector<std::unique_ptr<ExplosionAnimation>> m_explosions;
+    std::vector<std::unique_ptr<Projectile>> m_spareProjectiles; // Gone from play, reused by later shots
     Terrain* m_terrain; // Reference to terrain for collision detection
-    class Renderer* m_renderer; // Reference to renderer for explosion sprite loading
+    EventBus* m_events;
+    class JobSystem* m_jobSystem; // Worker threads (nullptr = run everything on the calling thread)
+    DoubleBufferedArena* m_frameArena;
+
+    void RetireProjectiles(Projectile* only); // Inactive ones, or just the given one; order of the rest kept
+    void CollectOrb(SkillOrb& orb, Player& player);
+
+    // Alive players packed into flat arrays before each pass that tests every player, so
+    // those loops stream through a few cache lines instead of one heap object per player
+    struct PlayerBodies {
+        std::vector<Vector2> position;
+        std::vector<float> radius;
+        std::vector<int> id;
+        std::vector<Player*> player;
 
-    // Create explosion animation at position
-    void CreateExplosion(const Vector2& position, float radius, bool isBigExplosion);
-    void CreateTeleportAnimation(const Vector2& position, float radius);
-    void CreateHealAnimation(const Vector2& position, float radius);
+        void Gather(const std::vector<std::unique_ptr<Player>>& players);
+        int Count() const { return static_cast<int>(id.size()); }
+    };
+    PlayerBodies m_bodies;
 
     // Debug visualization
     bool m_debugDrawContours;
     struct DebugContourData {
+        explicit DebugContourData(FrameArena* arena) : samplePoints(arena), groundPoints(arena) {}
+
         Vector2 playerPos;
         float playerRadius;
-        std::vector<Vector2> samplePoints;
-        std::vector<Vector2> groundPoints;
+        ArenaVector<Vector2> samplePoints;
+        ArenaVector<Vector2> groundPoints;
         int groundY;
     };
     std::vector<DebugContourData> m_debugContourData;
+    Uint64 m_debugContourFrame; // Arena frame the points were built in
+    std::vector<std::vector<DebugContourData>> m_debugBatchBuffers; // One per player batch, merged in order
+
+    // Moves players against the terrain (stateless, shared by all collision workers)
+    CharacterController m_characterController;
+
+    // Last controller move of each player slot. A player resting on unchanged terrain makes
+    // the exact same move every step, so the result is reused instead of recomputed.
+    struct ControllerMemo {
+        Uint64 terrainRevision; // 0 = nothing stored
+        Vector2 start;
+        Vector2 displacement;
+        Vector2 velocity;
+        float radius;
+        bool wasGrounded;
+        Vector2 resultPosition;
+        Vector2 resultVelocity;
+        bool resultGrounded;
+    };
+    std::vector<ControllerMemo> m_controllerMemos;
 
     // World bounds
     float m_platformWidth;
     float m_platformHeight;
     Vector2 m_platformPosition;
 
+    // Projectile impacts are collected during a read-only sweep, then resolved together
+    struct OrbPickupEvent {
+        int projectile; // Index into m_projectiles
+        PoolHandle orb;
+    };
+    struct ImpactEvent {
+        int projectile; // Index into m_projectiles
+        Player* hitPlayer; // nullptr = terrain hit
+        Vector2 position;
+    };
+    struct SweepBuffer {
+        std::vector<OrbPickupEvent> orbPickups;
+        std::vector<ImpactEvent> impacts;
+    };
+    struct PendingAnimation {
+        Vector2 position;
+        float radius;
+        ExplosionAnimationType type;
+    };
+    std::vector<SweepBuffer> m_sweepBatchBuffers; // One per projectile batch, merged in order
+    std::vector<OrbPickupEvent> m_orbPickups;
+    std::vector<ImpactEvent> m_impacts;
+    std::vector<AreaDamage> m_areaDamage;
+    std::vector<TerrainCrater> m_pendingCraters;
+    std::vector<PendingAnimation> m_pendingAnimations;
+
     // Collision detection
     void CheckProjectileCollisions(std::vector<std::unique_ptr<Player>>& players,
-        std::vector<std::unique_ptr<SkillOrb>>& skillOrbs);
+        SkillOrbPool& skillOrbs);
+    void SweepProjectile(int index,
+        const SkillOrbPool& skillOrbs, SweepBuffer& out) const;
+    void ResolveImpacts(std::vector<std::unique_ptr<Player>>& players, SkillOrbPool& skillOrbs);
+    void QueueAnimation(const Vector2& position, float radius, ExplosionAnimationType type);
+    void TeleportPlayer(Player& player, Vector2 teleportPos);
+    static Player* FindPlayerById(const std::vector<std::unique_ptr<Player>>& players, int id);
     void CheckPlayerTerrainCollisions(std::vector<std::unique_ptr<Player>>& players);
-    void CheckSkillOrbCollisions(std::vector<std::unique_ptr<Player>>& players,
-        std::vector<std::unique_ptr<SkillOrb>>& skillOrbs);
+    void ResolvePlayerTerrainCollision(Player& player, ControllerMemo& memo, std::vector<DebugContourData>& debugOut);
+    void CheckSkillOrbCollisions(SkillOrbPool& skillOrbs);
 
     // Constants
     static constexpr float PLATFORM_WIDTH = 800.0f;
     static constexpr float PLATFORM_HEIGHT = 50.0f;
     static constexpr float WORLD_WIDTH = 1200.0f;
     static constexpr float WORLD_HEIGHT = 800.0f;
+    static constexpr int PLAYER_COLLISION_BATCH_SIZE = 2; // Players per worker batch
+    static constexpr int PROJECTILE_SWEEP_BATCH_SIZE = 8; // Projectiles per worker batch
 };
@@ -1,5 +1,6 @@
 #include "Player.h"
 #include "InputManager.h"
+#include "StateHash.h"
 #include <cmath>
 #include <algorithm>
 
@@ -13,11 +14,16 @@ Player::Player(int id, const Vector2& position, const Color& color, const std::s
     : m_id(id), m_position(position), m_velocity(Vector2::Zero()), m_angle(-45.0f), m_power(0.0f),
     m_state(PlayerState::IDLE), m_health(DEFAULT_HEALTH), m_maxHealth(DEFAULT_HEALTH),
     m_mass(DEFAULT_MASS), m_radius(DEFAULT_RADIUS), m_acceleration(Vector2::Zero()),
+    m_sweepOrigin(position), m_grounded(false),
     m_color(color), m_facingRight(true), m_characterName(characterName),
     m_hurtAnimationTimer(0.0f), m_lastHealth(DEFAULT_HEALTH),
     m_leftPressed(false), m_rightPressed(false),
     m_upPressed(false), m_downPressed(false), m_spacePressed(false), m_powerIncreasing(true),
-    m_team(0) {
+    m_team(0), m_hashedMovement(), m_stateHash(0), m_hashDirty(true) {
+
+    // Full size up front, so picking up and spending skills never allocates
+    m_inventory.reserve(MAX_INVENTORY_SIZE);
+    m_selectedSkills.reserve(MAX_INVENTORY_SIZE);
 
     // Create character animation if character name is provided
     if (!m_characterName.empty()) {
@@ -30,7 +36,10 @@ void Player::Update(float deltaTime) {
     if (m_health < m_lastHealth && m_health > 0) {
         m_hurtAnimationTimer = 0.4f; // Play hurt animation for 0.4 seconds (4 frames at 0.1s each)
     }
-    m_lastHealth = m_health;
+    if (m_lastHealth != m_health) {
+        m_lastHealth = m_health;
+        m_hashDirty = true;
+    }
 
     // Handle death
     if (m_state == PlayerState::DEAD) {
@@ -46,6 +55,7 @@ void Player::Update(float deltaTime) {
     // Update hurt animation timer
     if (m_hurtAnimationTimer > 0.0f) {
         m_hurtAnimationTimer -= deltaTime;
+        m_hashDirty = true;
     }
 
     // Update character animation
@@ -87,6 +97,7 @@ void Player::Update(float deltaTime) {
     if (m_state == PlayerState::AIMING) {
         // Handle power adjustment (while space is held)
         if (m_spacePressed) {
+            m_hashDirty = true;
             if (m_powerIncreasing) {
                 m_power += POWER_SPEED * deltaTime;
                 if (m_power >= MAX_POWER) {
@@ -107,6 +118,11 @@ void Player::Update(float deltaTime) {
 void Player::HandleInput(int input, bool pressed) {
     if (m_state == PlayerState::DEAD) return;
 
+    // Match feeds every button every step; only an actual change dirties the hash
+    const Uint8 inputFlagsBefore = GetInputFlags();
+    const float angleBefore = m_angle;
+    const bool facingRightBefore = m_facingRight;
+
     InputManager::PlayerInput playerInput = static_cast<InputManager::PlayerInput>(input);
     switch (playerInput) {
     case InputManager::PlayerInput::MOVE_LEFT:
@@ -159,6 +175,10 @@ void Player::HandleInput(int input, bool pressed) {
             m_angle = std::min(m_angle, MAX_ANGLE);
         }
     }
+
+    if (GetInputFlags() != inputFlagsBefore || m_angle != angleBefore || m_facingRight != facingRightBefore) {
+        m_hashDirty = true;
+    }
 }
 
 void Player::TakeDamage(float damage) {
@@ -168,11 +188,13 @@ void Player::TakeDamage(float damage) {
     if (m_health <= 0.0f) {
         m_state = PlayerState::DEAD;
     }
+    m_hashDirty = true;
 }
 
 void Player::Heal(float amount) {
     m_health += amount;
     m_health = std::min(m_health, m_maxHealth);
+    m_hashDirty = true;
 }
 
 void Player::ApplyForce(const Vector2& force) {
@@ -203,11 +225,13 @@ void Player::StartTurn() {
     m_power = 0.0f;
     m_angle = -45.0f; // Reset angle
     m_selectedSkills.clear(); // Clear selected skills for new turn
+    m_hashDirty = true;
 }
 
 void Player::EndTurn() {
     m_state = PlayerState::IDLE;
     m_power = 0.0f;
+    m_hashDirty = true;
 }
 
 bool Player::ShouldBeRemoved() const {
@@ -228,12 +252,18 @@ void Player::ResetForNewGame() {
     m_acceleration = Vector2::Zero();
     m_power = 0.0f;
     m_angle = -45.0f;
+    m_facingRight = true;
+    m_powerIncreasing = true;
+    m_hurtAnimationTimer = 0.0f;
+    m_lastHealth = m_health;
 
     // Reset position based on player ID
     float platformWidth = 800.0f;
     float spacing = platformWidth / 4;
     m_position.x = 200.0f + spacing * (m_id + 1);
     m_position.y = 600.0f;
+    m_sweepOrigin = m_position;
+    m_grounded = false;
 
     // Clear input states
     m_leftPressed = m_rightPressed = m_upPressed = m_downPressed = m_spacePressed = false;
@@ -241,6 +271,101 @@ void Player::ResetForNewGame() {
     // Clear skills and inventory
     m_availableSkills.clear();
     m_inventory.clear();
+    m_selectedSkills.clear();
+    m_hashDirty = true;
+}
+
+Player::SavedState Player::SaveState() const {
+    SavedState state;
+    state.position = m_position;
+    state.velocity = m_velocity;
+    state.acceleration = m_acceleration;
+    state.sweepOrigin = m_sweepOrigin;
+    state.angle = m_angle;
+    state.power = m_power;
+    state.state = m_state;
+    state.health = m_health;
+    state.maxHealth = m_maxHealth;
+    state.grounded = m_grounded;
+    state.facingRight = m_facingRight;
+    state.hurtAnimationTimer = m_hurtAnimationTimer;
+    state.lastHealth = m_lastHealth;
+    state.team = m_team;
+    state.availableSkills = m_availableSkills;
+    state.inventory = m_inventory;
+    state.selectedSkills = m_selectedSkills;
+    state.inputFlags = GetInputFlags();
+    return state;
+}
+
+Uint8 Player::GetInputFlags() const {
+    return (m_leftPressed ? 1 : 0) | (m_rightPressed ? 2 : 0) | (m_upPressed ? 4 : 0) |
+        (m_downPressed ? 8 : 0) | (m_spacePressed ? 16 : 0) | (m_powerIncreasing ? 32 : 0);
+}
+
+Uint64 Player::ComputeStateHash() const {
+    if (!m_hashDirty && SameBits(m_position, m_hashedMovement.position) &&
+        SameBits(m_velocity, m_hashedMovement.velocity) &&
+        SameBits(m_acceleration, m_hashedMovement.acceleration) &&
+        SameBits(m_sweepOrigin, m_hashedMovement.sweepOrigin) && m_grounded == m_hashedMovement.grounded) {
+        return m_stateHash;
+    }
+
+    StateHasher hasher;
+    hasher.Add(m_position);
+    hasher.Add(m_velocity);
+    hasher.Add(m_acceleration);
+    hasher.Add(m_sweepOrigin);
+    hasher.Add(m_angle);
+    hasher.Add(m_power);
+    hasher.Add(static_cast<int>(m_state));
+    hasher.Add(m_health);
+    hasher.Add(m_maxHealth);
+    hasher.Add(m_grounded);
+    hasher.Add(m_facingRight);
+    hasher.Add(m_hurtAnimationTimer);
+    hasher.Add(m_lastHealth);
+    hasher.Add(m_team);
+    hasher.Add(m_availableSkills);
+    hasher.Add(m_inventory);
+    hasher.Add(m_selectedSkills);
+    hasher.Add(static_cast<int>(GetInputFlags()));
+
+    m_hashedMovement.position = m_position;
+    m_hashedMovement.velocity = m_velocity;
+    m_hashedMovement.acceleration = m_acceleration;
+    m_hashedMovement.sweepOrigin = m_sweepOrigin;
+    m_hashedMovement.grounded = m_grounded;
+    m_stateHash = hasher.Get();
+    m_hashDirty = false;
+    return m_stateHash;
+}
+
+void Player::LoadState(const SavedState& state) {
+    m_position = state.position;
+    m_velocity = state.velocity;
+    m_acceleration = state.acceleration;
+    m_sweepOrigin = state.sweepOrigin;
+    m_angle = state.angle;
+    m_power = state.power;
+    m_state = state.state;
+    m_health = state.health;
+    m_maxHealth = state.maxHealth;
+    m_grounded = state.grounded;
+    m_facingRight = state.facingRight;
+    m_hurtAnimationTimer = state.hurtAnimationTimer;
+    m_lastHealth = state.lastHealth;
+    m_team = state.team;
+    m_availableSkills = state.availableSkills;
+    m_inventory = state.inventory;
+    m_selectedSkills = state.selectedSkills;
+    m_leftPressed = (state.inputFlags & 1) != 0;
+    m_rightPressed = (state.inputFlags & 2) != 0;
+    m_upPressed = (state.inputFlags & 4) != 0;
+    m_downPressed = (state.inputFlags & 8) != 0;
+    m_spacePressed = (state.inputFlags & 16) != 0;
+    m_powerIncreasing = (state.inputFlags & 32) != 0;
+    m_hashDirty = true;
 }
 
 bool Player::HasSkill(int skillType) const {
@@ -251,6 +376,7 @@ void Player::UseSkill(int skillType) {
     auto it = std::find(m_availableSkills.begin(), m_availableSkills.end(), skillType);
     if (it != m_availableSkills.end()) {
         m_availableSkills.erase(it);
+        m_hashDirty = true;
     }
 }
 
@@ -258,6 +384,7 @@ void Player::AddSkill(int skillType) {
     // Check if player already has this skill
     if (!HasSkill(skillType)) {
         m_availableSkills.push_back(skillType);
+        m_hashDirty = true;
     }
 }
 
@@ -269,6 +396,7 @@ bool Player::AddSkillToInventory(int skillType) {
 
     // Add skill to inventory (can have duplicates)
     m_inventory.push_back(skillType);
+    m_hashDirty = true;
     return true;
 }
 
@@ -280,6 +408,7 @@ bool Player::UseInventorySlot(int slot) {
 
     // Remove skill from that slot
     m_inventory.erase(m_inventory.begin() + slot);
+    m_hashDirty = true;
     return true;
 }
 
@@ -297,6 +426,7 @@ void Player::ToggleSkillSelection(int slot) {
     }
 
     int skillType = m_inventory[slot];
+    m_hashDirty = true;
 
     // Check if skill is already selected
     auto it = std::find(m_selectedSkills.begin(), m_selectedSkills.end(), skillType);
@@ -38,15 +38,20 @@ public:
     CharacterAnimation* GetAnimation() { return m_animation.get(); }
     bool ShouldBeRemoved() const; // Returns true if dead and death animation finished
     int GetTeam() const { return m_team; }
+    bool IsGrounded() const { return m_grounded; }
+    // Position of the last placement; movement since then is swept by the character controller
+    const Vector2& GetSweepOrigin() const { return m_sweepOrigin; }
 
     // Setters
-    void SetPosition(const Vector2& position) { m_position = position; }
+    // Place the player directly (spawn, teleport, controller result) without sweeping
+    void SetPosition(const Vector2& position) { m_position = position; m_sweepOrigin = position; }
+    void SetGrounded(bool grounded) { m_grounded = grounded; }
     void SetVelocity(const Vector2& velocity) { m_velocity = velocity; }
-    void SetState(PlayerState state) { m_state = state; }
-    void SetAngle(float angle) { m_angle = angle; }
-    void SetPower(float power) { m_power = power; }
-    void SetFacingRight(bool facingRight) { m_facingRight = facingRight; }
-    void SetTeam(int team) { m_team = team; }
+    void SetState(PlayerState state) { m_state = state; m_hashDirty = true; }
+    void SetAngle(float angle) { m_angle = angle; m_hashDirty = true; }
+    void SetPower(float power) { m_power = power; m_hashDirty = true; }
+    void SetFacingRight(bool facingRight) { m_facingRight = facingRight; m_hashDirty = true; }
+    void SetTeam(int team) { m_team = team; m_hashDirty = true; }
 
     // Physics
     void ApplyForce(const Vector2& force);
@@ -57,6 +62,31 @@ public:
     void EndTurn();
     void ResetForNewGame();
 
+    // Simulation state without visuals (keyframes restore players from this)
+    struct SavedState {
+        Vector2 position;
+        Vector2 velocity;
+        Vector2 acceleration;
+        Vector2 sweepOrigin;
+        float angle;
+        float power;
+        PlayerState state;
+        float health;
+        float maxHealth;
+        bool grounded;
+        bool facingRight;
+        float hurtAnimationTimer;
+        float lastHealth;
+        int team;
+        std::vector<int> availableSkills;
+        std::vector<int> inventory;
+        std::vector<int> selectedSkills;
+        Uint8 inputFlags; // left, right, up, down, space, power increasing
+    };
+    SavedState SaveState() const;
+    void LoadState(const SavedState& state);
+    Uint64 ComputeStateHash() const; // Same fields as SavedState; cached until they change
+
     // Skills and Inventory
     bool HasSkill(int skillType) const;
     void UseSkill(int skillType);
@@ -64,12 +94,12 @@ public:
     bool AddSkillToInventory(int skillType); // Returns false if inventory is full
     bool UseInventorySlot(int slot); // slot 0-3, returns false if empty
     const std::vector<int>& GetInventory() const { return m_inventory; }
-    std::vector<int>& GetInventory() { return m_inventory; }
+    std::vector<int>& GetInventory() { m_hashDirty = true; return m_inventory; }
     int GetInventorySlot(int slot) const; // Returns -1 if slot is empty or invalid
     bool IsInventoryFull() const { return m_inventory.size() >= MAX_INVENTORY_SIZE; }
     void ToggleSkillSelection(int slot); // Toggle skill selection for next shot
     const std::vector<int>& GetSelectedSkills() const { return m_selectedSkills; }
-    void ClearSelectedSkills() { m_selectedSkills.clear(); }
+    void ClearSelectedSkills() { m_selectedSkills.clear(); m_hashDirty = true; }
 
 private:
     int m_id;
@@ -87,6 +117,8 @@ private:
     float m_mass;
     float m_radius;
     Vector2 m_acceleration;
+    Vector2 m_sweepOrigin;
+    bool m_grounded;
 
     // Visual
     Color m_color;
@@ -114,6 +146,20 @@ private:
     bool m_downPressed;
     bool m_spacePressed;
     bool m_powerIncreasing;  // Track if power is increasing or decreasing
+    Uint8 GetInputFlags() const; // left, right, up, down, space, power increasing
+
+    // State hash cache. Mutators mark it dirty; the movement is rewritten by physics and the
+    // controller every step even at rest, so it's compared with the copy from the last hash
+    struct HashedMovement {
+        Vector2 position;
+        Vector2 velocity;
+        Vector2 acceleration;
+        Vector2 sweepOrigin;
+        bool grounded;
+    };
+    mutable HashedMovement m_hashedMovement;
+    mutable Uint64 m_stateHash;
+    mutable bool m_hashDirty;
 
     // Constants
     static constexpr float MOVE_SPEED = 5.0f;
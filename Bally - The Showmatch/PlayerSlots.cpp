@@ -0,0 +1,64 @@
+#include "PlayerSlots.h"
+#include <cmath>
+
+namespace {
+
+const Color CLASSIC_COLORS[] = {
+    Color(255, 100, 100, 255), // Red
+    Color(100, 100, 255, 255), // Blue
+    Color(100, 255, 100, 255), // Green
+    Color(255, 255, 100, 255)  // Yellow
+};
+constexpr int CLASSIC_COLOR_COUNT = 4;
+
+// Characters with animations, handed out in rotation
+const char* const CHARACTER_NAMES[] = { "Meep", "Yetty", "Turt" };
+constexpr int CHARACTER_COUNT = 3;
+
+Color FromHsv(float hue, float saturation, float value) {
+    float sector = hue * 6.0f;
+    int index = static_cast<int>(sector) % 6;
+    float fraction = sector - std::floor(sector);
+    float p = value * (1.0f - saturation);
+    float q = value * (1.0f - saturation * fraction);
+    float t = value * (1.0f - saturation * (1.0f - fraction));
+
+    float r = value, g = t, b = p;
+    switch (index) {
+    case 1: r = q; g = value; b = p; break;
+    case 2: r = p; g = value; b = t; break;
+    case 3: r = p; g = q; b = value; break;
+    case 4: r = t; g = p; b = value; break;
+    case 5: r = value; g = p; b = q; break;
+    default: break;
+    }
+    return Color(static_cast<Uint8>(r * 255.0f), static_cast<Uint8>(g * 255.0f), static_cast<Uint8>(b * 255.0f), 255);
+}
+
+}
+
+namespace PlayerSlots {
+
+Color GetColor(int index) {
+    if (index >= 0 && index < CLASSIC_COLOR_COUNT) {
+        return CLASSIC_COLORS[index];
+    }
+
+    // Golden-ratio hue steps keep neighbouring slots far apart on the color wheel;
+    // alternating brightness separates the slots that still land close together
+    float hue = std::fmod(0.08f + index * 0.618034f, 1.0f);
+    float value = (index % 2 == 0) ? 1.0f : 0.8f;
+    return FromHsv(hue, 0.6f, value);
+}
+
+const char* GetCharacterName(int index) {
+    return CHARACTER_NAMES[(index < 0 ? 0 : index) % CHARACTER_COUNT];
+}
+
+int GetTeam(int index, GameMode gameMode) {
+    if (gameMode != GameMode::TEAM_2V2) return 0;
+    // Players 1, 3, 5... = Team 1 (green), players 2, 4, 6... = Team 2 (red)
+    return (index % 2 == 0) ? 1 : 2;
+}
+
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Renderer.h"
+#include "Menu.h"
+
+// Look of each player slot and the team it plays for. The first four slots keep their
+// classic colors; the rest get generated ones, so lobbies are not tied to a fixed count.
+namespace PlayerSlots {
+
+Color GetColor(int index);
+const char* GetCharacterName(int index);
+
+// 0 = no team (free for all), otherwise 1 or 2 alternating by slot
+int GetTeam(int index, GameMode gameMode);
+
+}
@@ -0,0 +1,101 @@
+#include "PoissonDiskSampler.h"
+#include "Terrain.h"
+#include <algorithm>
+#include <cmath>
+
+PoissonDiskSampler::PoissonDiskSampler() : PoissonDiskSampler(1.0f, Vector2(), Vector2()) {
+}
+
+PoissonDiskSampler::PoissonDiskSampler(float minDistance, const Vector2& boundsMin, const Vector2& boundsMax)
+    : m_gridUsed(0) {
+    Reset(minDistance, boundsMin, boundsMax);
+}
+
+void PoissonDiskSampler::Reset(float minDistance, const Vector2& boundsMin, const Vector2& boundsMax) {
+    m_minDistance = minDistance;
+    m_cellSize = minDistance / std::sqrt(2.0f);
+    m_boundsMin = boundsMin;
+    m_boundsMax = boundsMax;
+    m_points.clear();
+    if (m_gridUsed > 0) {
+        std::fill(m_grid.begin(), m_grid.end(), GridSlot{ 0, -1 });
+        m_gridUsed = 0;
+    }
+}
+
+size_t PoissonDiskSampler::FindSlot(long long key) const {
+    // Linear probing; the table is never more than half full, so this ends quickly
+    size_t mask = m_grid.size() - 1;
+    size_t index = static_cast<size_t>((unsigned long long)key * 0x9E3779B97F4A7C15ull >> 32) & mask;
+    while (m_grid[index].point >= 0 && m_grid[index].key != key) {
+        index = (index + 1) & mask;
+    }
+    return index;
+}
+
+void PoissonDiskSampler::GrowGrid() {
+    std::vector<GridSlot> old;
+    old.swap(m_grid);
+    m_grid.assign(std::max(MIN_GRID_SLOTS, old.size() * 2), GridSlot{ 0, -1 });
+    for (const GridSlot& slot : old) {
+        if (slot.point >= 0) {
+            m_grid[FindSlot(slot.key)] = slot;
+        }
+    }
+}
+
+void PoissonDiskSampler::AddPoint(const Vector2& point) {
+    if ((m_gridUsed + 1) * 2 > m_grid.size()) {
+        GrowGrid();
+    }
+
+    int cellX = (int)std::floor(point.x / m_cellSize);
+    int cellY = (int)std::floor(point.y / m_cellSize);
+    long long key = CellKey(cellX, cellY);
+    GridSlot& slot = m_grid[FindSlot(key)];
+    if (slot.point < 0) m_gridUsed++;
+    slot.key = key;
+    slot.point = static_cast<int>(m_points.size());
+    m_points.push_back(point);
+}
+
+bool PoissonDiskSampler::IsFarEnough(const Vector2& point) const {
+    int cellX = (int)std::floor(point.x / m_cellSize);
+    int cellY = (int)std::floor(point.y / m_cellSize);
+    float minDistanceSq = m_minDistance * m_minDistance;
+
+    for (int y = cellY - 2; y <= cellY + 2; ++y) {
+        for (int x = cellX - 2; x <= cellX + 2; ++x) {
+            int index = m_grid.empty() ? -1 : m_grid[FindSlot(CellKey(x, y))].point;
+            if (index >= 0 && (m_points[index] - point).LengthSquared() < minDistanceSq) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool PoissonDiskSampler::Sample(const Terrain& terrain, RandomStream& random, Vector2& outPoint) {
+    int freeCells = terrain.GetFreeCellCount();
+    if (freeCells == 0) return false;
+
+    for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
+        // Uniform over free space: random free cell, random point inside it
+        Vector2 cellMin, cellMax;
+        terrain.GetFreeCellBounds(random.RangeInt(0, freeCells - 1), cellMin, cellMax);
+        Vector2 candidate(random.Range(cellMin.x, cellMax.x), random.Range(cellMin.y, cellMax.y));
+
+        if (candidate.x < m_boundsMin.x || candidate.x > m_boundsMax.x ||
+            candidate.y < m_boundsMin.y || candidate.y > m_boundsMax.y) {
+            continue;
+        }
+
+        if (IsFarEnough(candidate)) {
+            AddPoint(candidate);
+            outPoint = candidate;
+            return true;
+        }
+    }
+
+    return false;
+}
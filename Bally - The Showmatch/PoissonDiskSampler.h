@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+#include "Vector2.h"
+#include "Random.h"
+
+class Terrain;
+
+// Places points at least minDistance apart inside the terrain's free-space mask.
+// Accepted points go into a sparse grid with cells of minDistance / sqrt(2), so each cell
+// holds at most one point and a distance test only looks at the 5x5 cells around it.
+// Cost per point is bounded by the attempt count, independent of map size.
+// The grid is a flat open-addressed table, so a sampler that is Reset and reused only
+// allocates when it holds more points than it ever did before.
+class PoissonDiskSampler {
+public:
+    PoissonDiskSampler();
+    PoissonDiskSampler(float minDistance, const Vector2& boundsMin, const Vector2& boundsMax);
+
+    // Forget every point and start over with new settings, keeping the memory
+    void Reset(float minDistance, const Vector2& boundsMin, const Vector2& boundsMax);
+
+    // Register an existing point (e.g. an orb that is already in the world)
+    void AddPoint(const Vector2& point);
+
+    // Pick a free position far enough from every point so far. Returns false if none was found.
+    bool Sample(const Terrain& terrain, RandomStream& random, Vector2& outPoint);
+
+    const std::vector<Vector2>& GetPoints() const { return m_points; }
+
+private:
+    struct GridSlot {
+        long long key;
+        int point; // Index into m_points, -1 = empty
+    };
+
+    bool IsFarEnough(const Vector2& point) const;
+    long long CellKey(int cellX, int cellY) const { return ((long long)cellY << 32) ^ (unsigned int)cellX; }
+    size_t FindSlot(long long key) const; // The key's slot, or the empty slot where it would go
+    void GrowGrid();
+
+    float m_minDistance;
+    float m_cellSize;
+    Vector2 m_boundsMin;
+    Vector2 m_boundsMax;
+    std::vector<Vector2> m_points;
+    std::vector<GridSlot> m_grid; // Power of two, at most half full
+    size_t m_gridUsed;
+
+    static constexpr int MAX_ATTEMPTS = 30;
+    static constexpr size_t MIN_GRID_SLOTS = 64;
+};
@@ -0,0 +1,586 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+std::atomic<bool> Profiler::s_recording(false);
+
+namespace {
+
+struct ZoneEvent {
+    int zone;
+    Uint32 allocations;
+    Uint64 start;
+    Uint64 end;
+};
+
+// Single producer (the owning thread), single consumer (whoever holds s_drainMutex)
+struct ThreadBuffer {
+    ZoneEvent events[Profiler::THREAD_BUFFER_SIZE];
+    std::atomic<Uint32> written;
+    std::atomic<Uint32> read;
+    std::atomic<Uint64> dropped;
+    std::atomic<bool> inUse; // Owned by a live thread; freed buffers are reused by new threads
+    int index;
+    char name[32];           // Guarded by s_registryMutex
+};
+
+std::atomic<ThreadBuffer*> s_threads[Profiler::MAX_THREADS];
+std::atomic<int> s_threadCount(0);
+std::atomic<Uint64> s_unbuffered(0); // Zones of threads beyond MAX_THREADS
+
+ThreadBuffer* AcquireBuffer() {
+    int count = std::min(s_threadCount.load(std::memory_order_acquire), Profiler::MAX_THREADS);
+    for (int i = 0; i < count; ++i) {
+        ThreadBuffer* buffer = s_threads[i].load(std::memory_order_acquire);
+        bool expected = false;
+        if (buffer && buffer->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return buffer;
+        }
+    }
+
+    int index = s_threadCount.fetch_add(1, std::memory_order_acq_rel);
+    if (index >= Profiler::MAX_THREADS) return nullptr;
+
+    ThreadBuffer* buffer = new ThreadBuffer();
+    buffer->written.store(0, std::memory_order_relaxed);
+    buffer->read.store(0, std::memory_order_relaxed);
+    buffer->dropped.store(0, std::memory_order_relaxed);
+    buffer->inUse.store(true, std::memory_order_relaxed);
+    buffer->index = index;
+    std::snprintf(buffer->name, sizeof(buffer->name), "Thread %d", index);
+    s_threads[index].store(buffer, std::memory_order_release); // Never freed: threads come and go
+    return buffer;
+}
+
+struct LocalBuffer {
+    ThreadBuffer* buffer = nullptr;
+    bool acquired = false;
+
+    ThreadBuffer* Get() {
+        if (!acquired) {
+            buffer = AcquireBuffer();
+            acquired = true;
+        }
+        return buffer;
+    }
+    ~LocalBuffer() {
+        if (buffer) buffer->inUse.store(false, std::memory_order_release);
+    }
+};
+thread_local LocalBuffer t_buffer;
+
+std::mutex s_registryMutex;
+const char* s_zoneNames[Profiler::MAX_ZONES];
+std::atomic<int> s_zoneCount(0);
+const char* s_counterNames[Profiler::MAX_COUNTERS];
+std::atomic<int> s_counterCount(0);
+Sint64 s_counterValues[Profiler::MAX_COUNTERS]; // Main thread
+
+// Filled by DrainBuffers, moved into the history by EndFrame
+std::mutex s_drainMutex;
+int s_pendingCalls[Profiler::MAX_ZONES];
+Uint64 s_pendingTicks[Profiler::MAX_ZONES];
+int s_pendingAllocations[Profiler::MAX_ZONES];
+
+// History, main thread only
+float s_frameMs[Profiler::HISTORY_FRAMES];
+float s_intervalMs[Profiler::HISTORY_FRAMES];
+float s_zoneMs[Profiler::MAX_ZONES][Profiler::HISTORY_FRAMES];
+int s_zoneCalls[Profiler::MAX_ZONES];
+int s_zoneAllocations[Profiler::MAX_ZONES];
+int s_frameAllocations[Profiler::HISTORY_FRAMES];
+Uint64 s_frameStartAllocations = 0;
+int s_newest = 0;
+int s_length = 0;
+Uint64 s_frameStart = 0;
+Uint64 s_previousFrameStart = 0;
+bool s_historyOn = false;
+
+// Trace capture. Drained zones go to s_traceEvents (under s_drainMutex); the trace thread
+// swaps them out and writes them so formatting and disk I/O stay off the timed threads.
+struct TraceEvent {
+    int zone; // -1 = frame
+    int thread;
+    Uint64 start;
+    Uint64 end;
+    Uint32 allocations;
+};
+
+struct CounterSample {
+    int counter;
+    Uint64 time;
+    Sint64 value;
+};
+
+std::atomic<bool> s_tracing(false);
+std::vector<TraceEvent> s_traceEvents;
+std::vector<CounterSample> s_traceCounters;
+Uint64 s_traceStart = 0;
+std::thread s_traceThread;
+std::mutex s_traceMutex;
+std::condition_variable s_traceCondition;
+bool s_traceStopping = false;
+std::ofstream s_traceFile;
+std::string s_tracePath;
+
+// Flight recorder. Zones go into a ring (under s_drainMutex), frames into another (main thread).
+struct FlightFrame {
+    Uint64 start;
+    Uint64 end;
+    int thread;
+    Sint64 counters[Profiler::MAX_COUNTERS];
+};
+
+std::atomic<bool> s_flightOn(false);
+std::vector<TraceEvent> s_flightEvents;
+Uint64 s_flightEventsWritten = 0;
+std::vector<FlightFrame> s_flightFrames;
+Uint64 s_flightFramesWritten = 0;
+std::string s_flightFolder;
+float s_hitchMs = 0.0f;
+float s_pendingHitchMs = 0.0f;
+int s_dumpCountdown = -1; // Frames left to record after a hitch
+std::thread s_dumpThread;
+std::atomic<bool> s_dumpBusy(false);
+
+int HistoryIndex(int framesAgo) {
+    return (s_newest - framesAgo + Profiler::HISTORY_FRAMES) % Profiler::HISTORY_FRAMES;
+}
+
+bool WantsRecording() {
+    return s_historyOn || s_tracing.load(std::memory_order_relaxed) || s_flightOn.load(std::memory_order_relaxed);
+}
+
+// Collect everything the threads recorded since the last drain. Caller holds s_drainMutex.
+void DrainBuffers(bool keep) {
+    bool tracing = keep && s_tracing.load(std::memory_order_relaxed);
+    bool flight = keep && s_flightOn.load(std::memory_order_relaxed);
+    int count = std::min(s_threadCount.load(std::memory_order_acquire), Profiler::MAX_THREADS);
+    for (int i = 0; i < count; ++i) {
+        ThreadBuffer* buffer = s_threads[i].load(std::memory_order_acquire);
+        if (!buffer) continue;
+
+        Uint32 read = buffer->read.load(std::memory_order_relaxed);
+        Uint32 written = buffer->written.load(std::memory_order_acquire);
+        for (; keep && read != written; ++read) {
+            const ZoneEvent& event = buffer->events[read & (Profiler::THREAD_BUFFER_SIZE - 1)];
+            if (event.zone < 0 || event.zone >= Profiler::MAX_ZONES) continue;
+
+            s_pendingTicks[event.zone] += event.end - event.start;
+            s_pendingCalls[event.zone]++;
+            s_pendingAllocations[event.zone] += event.allocations;
+            if (tracing && event.start >= s_traceStart) {
+                s_traceEvents.push_back({ event.zone, buffer->index, event.start, event.end, event.allocations });
+            }
+            if (flight) {
+                s_flightEvents[s_flightEventsWritten++ & (Profiler::FLIGHT_EVENT_CAPACITY - 1)] =
+                    { event.zone, buffer->index, event.start, event.end, event.allocations };
+            }
+        }
+        buffer->read.store(written, std::memory_order_release);
+    }
+}
+
+void WriteEscaped(std::ostream& file, const char* text) {
+    for (; *text; ++text) {
+        if (*text == '"' || *text == '\\') file << '\\';
+        if (static_cast<unsigned char>(*text) >= 0x20) file << *text;
+    }
+}
+
+void WriteTraceHeader(std::ostream& file) {
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+         << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Bally\"}}";
+}
+
+void WriteTraceEvents(std::ostream& file, const std::vector<TraceEvent>& events, Uint64 base,
+                      std::vector<bool>& namedThreads) {
+    char number[32];
+    for (const TraceEvent& event : events) {
+        // Name each thread the first time it shows up
+        if (event.thread >= static_cast<int>(namedThreads.size())) namedThreads.resize(event.thread + 1, false);
+        if (!namedThreads[event.thread]) {
+            namedThreads[event.thread] = true;
+            std::string name;
+            {
+                std::lock_guard<std::mutex> lock(s_registryMutex);
+                name = s_threads[event.thread].load(std::memory_order_acquire)->name;
+            }
+            file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << event.thread
+                 << ",\"args\":{\"name\":\"";
+            WriteEscaped(file, name.c_str());
+            file << "\"}}";
+        }
+
+        file << ",\n{\"name\":\"";
+        WriteEscaped(file, event.zone < 0 ? "Frame" : Profiler::GetZoneName(event.zone));
+        std::snprintf(number, sizeof(number), "%.3f", (event.start - base) / 1000.0);
+        file << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread << ",\"ts\":" << number;
+        std::snprintf(number, sizeof(number), "%.3f", (event.end - event.start) / 1000.0);
+        file << ",\"dur\":" << number;
+        if (event.allocations > 0) file << ",\"args\":{\"allocations\":" << event.allocations << "}";
+        file << "}";
+    }
+}
+
+void WriteCounterSamples(std::ostream& file, const std::vector<CounterSample>& samples, Uint64 base) {
+    char number[32];
+    for (const CounterSample& sample : samples) {
+        file << ",\n{\"name\":\"";
+        WriteEscaped(file, s_counterNames[sample.counter]);
+        std::snprintf(number, sizeof(number), "%.3f", (sample.time - base) / 1000.0);
+        file << "\",\"ph\":\"C\",\"pid\":1,\"ts\":" << number << ",\"args\":{\"value\":" << sample.value << "}}";
+    }
+}
+
+void TraceLoop() {
+    std::vector<TraceEvent> events;
+    std::vector<CounterSample> counters;
+    std::vector<bool> namedThreads;
+    for (;;) {
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(s_traceMutex);
+            s_traceCondition.wait_for(lock, std::chrono::milliseconds(Profiler::TRACE_FLUSH_MS),
+                [] { return s_traceStopping; });
+            stopping = s_traceStopping;
+        }
+        {
+            std::lock_guard<std::mutex> lock(s_drainMutex);
+            DrainBuffers(true);
+            events.swap(s_traceEvents);
+            counters.swap(s_traceCounters);
+        }
+        WriteTraceEvents(s_traceFile, events, s_traceStart, namedThreads);
+        WriteCounterSamples(s_traceFile, counters, s_traceStart);
+        events.clear();
+        counters.clear();
+        if (stopping) return;
+    }
+}
+
+
+// Copy the recorded window (main thread, under s_drainMutex) and write it on a thread of its own
+void DumpFlightRecorder(float hitchMs) {
+    int frameCount = static_cast<int>(std::min<Uint64>(s_flightFramesWritten, Profiler::FLIGHT_FRAMES));
+    if (frameCount == 0) return;
+
+    std::vector<TraceEvent> events;
+    std::vector<CounterSample> counters;
+    Uint64 firstFrame = s_flightFramesWritten - frameCount;
+    Uint64 base = s_flightFrames[firstFrame % Profiler::FLIGHT_FRAMES].start;
+    int counterCount = s_counterCount.load(std::memory_order_acquire);
+    for (Uint64 i = firstFrame; i < s_flightFramesWritten; ++i) {
+        const FlightFrame& frame = s_flightFrames[i % Profiler::FLIGHT_FRAMES];
+        events.push_back({ -1, frame.thread, frame.start, frame.end, 0 });
+        for (int counter = 0; counter < counterCount; ++counter) {
+            counters.push_back({ counter, frame.end, frame.counters[counter] });
+        }
+    }
+
+    Uint64 oldest = s_flightEventsWritten > Profiler::FLIGHT_EVENT_CAPACITY
+        ? s_flightEventsWritten - Profiler::FLIGHT_EVENT_CAPACITY : 0;
+    for (Uint64 i = oldest; i < s_flightEventsWritten; ++i) {
+        const TraceEvent& event = s_flightEvents[i & (Profiler::FLIGHT_EVENT_CAPACITY - 1)];
+        if (event.start >= base) events.push_back(event);
+    }
+
+    std::string path = s_flightFolder + "/hitch_" + std::to_string(static_cast<long long>(std::time(nullptr))) +
+        "_" + std::to_string(s_flightFramesWritten) + ".json";
+    if (s_dumpThread.joinable()) s_dumpThread.join();
+    s_dumpBusy.store(true, std::memory_order_relaxed);
+    s_dumpThread = std::thread([path, base, hitchMs, events = std::move(events), counters = std::move(counters)]() {
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+
+        std::ofstream file(path, std::ios::out | std::ios::trunc);
+        std::vector<bool> namedThreads;
+        WriteTraceHeader(file);
+        WriteTraceEvents(file, events, base, namedThreads);
+        WriteCounterSamples(file, counters, base);
+        file << "\n]}\n";
+        file.close();
+        if (file.fail()) {
+            std::cerr << "Failed to write hitch trace: " << path << std::endl;
+        } else {
+            std::cout << "Hitch of " << hitchMs << " ms, frames around it saved: " << path << std::endl;
+        }
+        s_dumpBusy.store(false, std::memory_order_relaxed);
+    });
+}
+}
+
+int Profiler::RegisterZone(const char* name) {
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+    int count = s_zoneCount.load(std::memory_order_relaxed);
+    for (int i = 0; i < count; ++i) {
+        if (std::strcmp(s_zoneNames[i], name) == 0) return i;
+    }
+    if (count >= MAX_ZONES) return -1;
+
+    s_zoneNames[count] = name;
+    s_zoneCount.store(count + 1, std::memory_order_release);
+    return count;
+}
+
+int Profiler::RegisterCounter(const char* name) {
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+    int count = s_counterCount.load(std::memory_order_relaxed);
+    for (int i = 0; i < count; ++i) {
+        if (std::strcmp(s_counterNames[i], name) == 0) return i;
+    }
+    if (count >= MAX_COUNTERS) return -1;
+
+    s_counterNames[count] = name;
+    s_counterValues[count] = 0;
+    s_counterCount.store(count + 1, std::memory_order_release);
+    return count;
+}
+
+void Profiler::SetCounter(int counter, Sint64 value) {
+    if (counter >= 0 && counter < MAX_COUNTERS) s_counterValues[counter] = value;
+}
+
+void Profiler::SetRecording(bool recording) {
+    if (recording && !s_historyOn) {
+        // Throw away whatever piled up while nobody was looking
+        std::lock_guard<std::mutex> lock(s_drainMutex);
+        DrainBuffers(IsRecording());
+        std::fill(std::begin(s_pendingTicks), std::end(s_pendingTicks), 0);
+        std::fill(std::begin(s_pendingCalls), std::end(s_pendingCalls), 0);
+        std::fill(std::begin(s_pendingAllocations), std::end(s_pendingAllocations), 0);
+        s_length = 0;
+        s_frameStart = 0;
+        s_previousFrameStart = 0;
+    }
+    s_historyOn = recording;
+    s_recording.store(WantsRecording(), std::memory_order_relaxed);
+}
+
+bool Profiler::StartTrace(const std::string& path) {
+    if (IsTracing()) return false;
+
+    s_traceFile.open(path, std::ios::out | std::ios::trunc);
+    if (!s_traceFile) {
+        std::cerr << "Failed to open trace file: " << path << std::endl;
+        return false;
+    }
+    WriteTraceHeader(s_traceFile);
+    s_tracePath = path;
+
+    {
+        std::lock_guard<std::mutex> lock(s_drainMutex);
+        if (!IsRecording()) DrainBuffers(false); // Stale zones from before the capture
+        s_traceEvents.clear();
+        s_traceCounters.clear();
+        s_traceStart = Now();
+        s_tracing.store(true, std::memory_order_relaxed);
+    }
+    s_recording.store(WantsRecording(), std::memory_order_relaxed);
+
+    s_traceStopping = false;
+    s_traceThread = std::thread(TraceLoop);
+    std::cout << "Trace capture started: " << path << std::endl;
+    return true;
+}
+
+void Profiler::StopTrace() {
+    if (!IsTracing()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(s_traceMutex);
+        s_traceStopping = true;
+    }
+    s_traceCondition.notify_one();
+    s_traceThread.join(); // Writes out what is left
+
+    s_tracing.store(false, std::memory_order_relaxed);
+    s_recording.store(WantsRecording(), std::memory_order_relaxed);
+
+    s_traceFile << "\n]}\n";
+    s_traceFile.close();
+    if (s_traceFile.fail()) {
+        std::cerr << "Failed to write trace file: " << s_tracePath << std::endl;
+    } else {
+        std::cout << "Trace saved: " << s_tracePath << std::endl;
+        if (GetDroppedCount() > 0) {
+            std::cout << GetDroppedCount() << " zones were lost to full thread buffers" << std::endl;
+        }
+    }
+    s_traceFile.clear();
+}
+
+void Profiler::StartFlightRecorder(const std::string& folder, float hitchMs) {
+    {
+        std::lock_guard<std::mutex> lock(s_drainMutex);
+        if (!s_flightOn.load(std::memory_order_relaxed)) {
+            if (!IsRecording()) DrainBuffers(false);
+            s_flightEvents.assign(FLIGHT_EVENT_CAPACITY, TraceEvent());
+            s_flightFrames.assign(FLIGHT_FRAMES, FlightFrame());
+            s_flightEventsWritten = 0;
+            s_flightFramesWritten = 0;
+        }
+        s_flightFolder = folder;
+        s_hitchMs = hitchMs;
+        s_dumpCountdown = -1;
+        s_flightOn.store(true, std::memory_order_relaxed);
+    }
+    s_recording.store(WantsRecording(), std::memory_order_relaxed);
+}
+
+void Profiler::Shutdown() {
+    StopTrace();
+
+    s_flightOn.store(false, std::memory_order_relaxed);
+    s_recording.store(WantsRecording(), std::memory_order_relaxed);
+    if (s_dumpThread.joinable()) s_dumpThread.join();
+}
+
+bool Profiler::IsTracing() {
+    return s_tracing.load(std::memory_order_relaxed);
+}
+
+void Profiler::SetThreadName(const char* name) {
+    ThreadBuffer* buffer = t_buffer.Get();
+    if (!buffer) return;
+
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+    std::snprintf(buffer->name, sizeof(buffer->name), "%s", name);
+}
+
+Uint64 Profiler::Now() {
+    return static_cast<Uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void Profiler::Record(int zone, Uint64 start, Uint64 end, Uint32 allocations) {
+    ThreadBuffer* buffer = t_buffer.Get();
+    if (!buffer) {
+        s_unbuffered.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Uint32 written = buffer->written.load(std::memory_order_relaxed);
+    if (written - buffer->read.load(std::memory_order_acquire) >= THREAD_BUFFER_SIZE) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer->events[written & (THREAD_BUFFER_SIZE - 1)] = { zone, allocations, start, end };
+    buffer->written.store(written + 1, std::memory_order_release);
+}
+
+void Profiler::BeginFrame() {
+    if (!IsRecording()) return;
+    s_previousFrameStart = s_frameStart;
+    s_frameStart = Now();
+    s_frameStartAllocations = AllocationTracker::GetTotalAllocations();
+}
+
+void Profiler::EndFrame() {
+    if (!IsRecording() || s_frameStart == 0) return;
+
+    Uint64 end = Now();
+    Uint64 allocations = AllocationTracker::GetTotalAllocations() - s_frameStartAllocations; // Not the bookkeeping below
+    std::lock_guard<std::mutex> lock(s_drainMutex);
+    DrainBuffers(true);
+
+    ThreadBuffer* buffer = t_buffer.Get();
+    int thread = buffer ? buffer->index : 0;
+    int counterCount = s_counterCount.load(std::memory_order_acquire);
+    if (IsTracing() && s_frameStart >= s_traceStart) {
+        s_traceEvents.push_back({ -1, thread, s_frameStart, end, static_cast<Uint32>(allocations) });
+        for (int counter = 0; counter < counterCount; ++counter) {
+            s_traceCounters.push_back({ counter, end, s_counterValues[counter] });
+        }
+    }
+
+    s_newest = (s_newest + 1) % HISTORY_FRAMES;
+    s_length = std::min(s_length + 1, static_cast<int>(HISTORY_FRAMES));
+    s_frameMs[s_newest] = (end - s_frameStart) / 1000000.0f;
+    s_intervalMs[s_newest] = s_previousFrameStart != 0 ? (s_frameStart - s_previousFrameStart) / 1000000.0f : 0.0f;
+    s_frameAllocations[s_newest] = static_cast<int>(allocations);
+    for (int zone = 0; zone < MAX_ZONES; ++zone) {
+        s_zoneMs[zone][s_newest] = s_pendingTicks[zone] / 1000000.0f;
+        s_zoneCalls[zone] = s_pendingCalls[zone];
+        s_zoneAllocations[zone] = s_pendingAllocations[zone];
+        s_pendingTicks[zone] = 0;
+        s_pendingCalls[zone] = 0;
+        s_pendingAllocations[zone] = 0;
+    }
+
+    if (s_flightOn.load(std::memory_order_relaxed)) {
+        FlightFrame& frame = s_flightFrames[s_flightFramesWritten++ % FLIGHT_FRAMES];
+        frame.start = s_frameStart;
+        frame.end = end;
+        frame.thread = thread;
+        std::copy(s_counterValues, s_counterValues + MAX_COUNTERS, frame.counters);
+
+        // Wait for the frames after a hitch, then write the lot; one dump at a time
+        if (s_dumpCountdown > 0) {
+            if (--s_dumpCountdown == 0) {
+                s_dumpCountdown = -1;
+                DumpFlightRecorder(s_pendingHitchMs);
+            }
+        } else if (s_hitchMs > 0.0f && s_frameMs[s_newest] > s_hitchMs && !s_dumpBusy.load(std::memory_order_relaxed)) {
+            s_pendingHitchMs = s_frameMs[s_newest];
+            s_dumpCountdown = FLIGHT_FRAMES_AFTER;
+        }
+    }
+}
+
+int Profiler::GetZoneCount() {
+    return s_zoneCount.load(std::memory_order_acquire);
+}
+
+const char* Profiler::GetZoneName(int zone) {
+    return (zone >= 0 && zone < GetZoneCount()) ? s_zoneNames[zone] : "";
+}
+
+int Profiler::GetHistoryLength() {
+    return s_length;
+}
+
+float Profiler::GetFrameMs(int framesAgo) {
+    return (framesAgo >= 0 && framesAgo < s_length) ? s_frameMs[HistoryIndex(framesAgo)] : 0.0f;
+}
+
+float Profiler::GetFrameIntervalMs(int framesAgo) {
+    return (framesAgo >= 0 && framesAgo < s_length) ? s_intervalMs[HistoryIndex(framesAgo)] : 0.0f;
+}
+
+float Profiler::GetZoneMs(int zone, int framesAgo) {
+    if (zone < 0 || zone >= MAX_ZONES || framesAgo < 0 || framesAgo >= s_length) return 0.0f;
+    return s_zoneMs[zone][HistoryIndex(framesAgo)];
+}
+
+int Profiler::GetZoneCalls(int zone) {
+    return (zone >= 0 && zone < MAX_ZONES && s_length > 0) ? s_zoneCalls[zone] : 0;
+}
+
+int Profiler::GetZoneAllocations(int zone) {
+    return (zone >= 0 && zone < MAX_ZONES && s_length > 0) ? s_zoneAllocations[zone] : 0;
+}
+
+int Profiler::GetFrameAllocations(int framesAgo) {
+    return (framesAgo >= 0 && framesAgo < s_length) ? s_frameAllocations[HistoryIndex(framesAgo)] : 0;
+}
+
+Uint64 Profiler::GetDroppedCount() {
+    Uint64 dropped = s_unbuffered.load(std::memory_order_relaxed);
+    int count = std::min(s_threadCount.load(std::memory_order_acquire), MAX_THREADS);
+    for (int i = 0; i < count; ++i) {
+        ThreadBuffer* buffer = s_threads[i].load(std::memory_order_acquire);
+        if (buffer) dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <SDL3/SDL.h>
+#include "AllocationTracker.h"
+
+// Build with BALLY_PROFILER=0 to compile every PROFILE_ZONE out
+#ifndef BALLY_PROFILER
+#define BALLY_PROFILER 1
+#endif
+
+// Frame profiler. PROFILE_ZONE("name") times the rest of the enclosing scope. Zones are
+// written to a per-thread ring buffer without locking (job system workers included) and
+// collected once per frame by EndFrame on the main thread, which keeps a rolling history
+// for the overlay. Zones also count the heap allocations their thread made inside them.
+// Nothing is recorded unless the overlay history, a trace capture or the flight recorder
+// is on.
+class Profiler {
+public:
+    // Zone ids are handed out once per name; PROFILE_ZONE keeps its id in a static
+    static int RegisterZone(const char* name);
+
+    static bool IsRecording() { return s_recording.load(std::memory_order_relaxed); }
+    static void SetRecording(bool recording); // Overlay history; turning it on starts a fresh one
+
+    // Chrome trace capture (chrome://tracing or ui.perfetto.dev). A background thread collects
+    // the zones and streams them to the file while the capture runs. Main thread only.
+    static bool StartTrace(const std::string& path);
+    static void StopTrace();
+    static bool IsTracing();
+    static void SetThreadName(const char* name); // Label of the calling thread in traces
+
+    // Per-frame counters, main thread. The last value set before EndFrame is recorded.
+    static int RegisterCounter(const char* name);
+    static void SetCounter(int counter, Sint64 value);
+
+    // Flight recorder: keeps the last FLIGHT_FRAMES frames of zones and counters at all times.
+    // When the work of a frame takes longer than hitchMs, the frames around it are written to
+    // folder as a Chrome trace once FLIGHT_FRAMES_AFTER more frames have been recorded.
+    static void StartFlightRecorder(const std::string& folder, float hitchMs);
+
+    // Ends the trace capture and the flight recorder, waiting for their files to be written
+    static void Shutdown();
+
+    static Uint64 Now(); // Nanoseconds, monotonic
+    static void Record(int zone, Uint64 start, Uint64 end, Uint32 allocations = 0);
+
+    // Main thread, around the work of one frame (not the frame delay)
+    static void BeginFrame();
+    static void EndFrame();
+
+    // History, newest frame first (framesAgo = 0)
+    static int GetZoneCount();
+    static const char* GetZoneName(int zone);
+    static int GetHistoryLength();
+    static float GetFrameMs(int framesAgo);           // Work time of the frame
+    static float GetFrameIntervalMs(int framesAgo);   // Start to start, frame delay included
+    static float GetZoneMs(int zone, int framesAgo);  // Summed over every thread
+    static int GetZoneCalls(int zone);                // In the newest frame
+    static int GetZoneAllocations(int zone);          // In the newest frame, every thread
+    static int GetFrameAllocations(int framesAgo);    // Every thread, frame work only
+    static Uint64 GetDroppedCount();                  // Lost to full thread buffers
+
+    static constexpr int MAX_ZONES = 64;
+    static constexpr int HISTORY_FRAMES = 240;
+    static constexpr int THREAD_BUFFER_SIZE = 4096; // Zones per thread per frame, power of two
+    static constexpr int MAX_THREADS = 64;
+    static constexpr int TRACE_FLUSH_MS = 10;       // How often the trace thread collects zones
+    static constexpr int MAX_COUNTERS = 16;
+    static constexpr int FLIGHT_FRAMES = 300;
+    static constexpr int FLIGHT_FRAMES_AFTER = 30;  // Part of FLIGHT_FRAMES, after the hitch
+    static constexpr int FLIGHT_EVENT_CAPACITY = 1 << 17; // Zones kept, power of two
+    static constexpr float DEFAULT_HITCH_MS = 50.0f;
+
+private:
+    static std::atomic<bool> s_recording;
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(int zone)
+        : m_zone(zone), m_start(Profiler::IsRecording() ? Profiler::Now() : 0),
+          m_allocations(m_start != 0 ? AllocationTracker::GetThreadAllocations() : 0) {}
+    ~ProfileScope() {
+        if (m_start != 0) {
+            Profiler::Record(m_zone, m_start, Profiler::Now(),
+                static_cast<Uint32>(AllocationTracker::GetThreadAllocations() - m_allocations));
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    int m_zone;
+    Uint64 m_start;
+    Uint64 m_allocations;
+};
+
+#if BALLY_PROFILER
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) \
+    static const int PROFILE_CONCAT(s_profileZone, __LINE__) = Profiler::RegisterZone(name); \
+    ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(PROFILE_CONCAT(s_profileZone, __LINE__))
+#define PROFILE_COUNTER(name, value) \
+    do { \
+        static const int s_profileCounter = Profiler::RegisterCounter(name); \
+        Profiler::SetCounter(s_profileCounter, static_cast<Sint64>(value)); \
+    } while (0)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_COUNTER(name, value) ((void)0)
+#endif
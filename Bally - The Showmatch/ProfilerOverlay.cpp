@@ -0,0 +1,163 @@
+#include "ProfilerOverlay.h"
+#include "Profiler.h"
+#include "Renderer.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+struct ZoneRow {
+    int zone;
+    float averageMs;
+    float maxMs;
+};
+
+}
+
+ProfilerOverlay::ProfilerOverlay(Renderer* renderer) : m_renderer(renderer), m_visible(false) {
+}
+
+void ProfilerOverlay::Toggle() {
+    m_visible = !m_visible;
+    Profiler::SetRecording(m_visible);
+}
+
+void ProfilerOverlay::Render() {
+    if (!m_visible) return;
+
+    int frames = std::min(Profiler::GetHistoryLength(), AVERAGE_FRAMES);
+
+    // Average and worst over the window, heaviest zones first (fixed array: the panel is
+    // drawn inside the frame it measures, so it must not allocate)
+    ZoneRow rows[Profiler::MAX_ZONES];
+    int zoneCount = std::min(Profiler::GetZoneCount(), Profiler::MAX_ZONES);
+    for (int zone = 0; zone < zoneCount; ++zone) {
+        ZoneRow row = { zone, 0.0f, 0.0f };
+        for (int i = 0; i < frames; ++i) {
+            float ms = Profiler::GetZoneMs(zone, i);
+            row.averageMs += ms;
+            row.maxMs = std::max(row.maxMs, ms);
+        }
+        row.averageMs = frames > 0 ? row.averageMs / frames : 0.0f;
+        rows[zone] = row;
+    }
+    std::sort(rows, rows + zoneCount, [](const ZoneRow& a, const ZoneRow& b) {
+        return a.averageMs > b.averageMs;
+    });
+    int rowCount = std::min(zoneCount, MAX_ROWS);
+
+    float frameAverage = 0.0f, frameMax = 0.0f, intervalAverage = 0.0f;
+    for (int i = 0; i < frames; ++i) {
+        frameAverage += Profiler::GetFrameMs(i);
+        frameMax = std::max(frameMax, Profiler::GetFrameMs(i));
+        intervalAverage += Profiler::GetFrameIntervalMs(i);
+    }
+    if (frames > 0) {
+        frameAverage /= frames;
+        intervalAverage /= frames;
+    }
+
+    Vector2 position(10, 110);
+    float panelHeight = LINE_HEIGHT * 6 + GRAPH_HEIGHT + 10 + LINE_HEIGHT * (rowCount + 1) + 10;
+    m_renderer->DrawRect(position, PANEL_WIDTH, panelHeight, Color(0, 0, 0, 190));
+    m_renderer->DrawRect(position, PANEL_WIDTH, panelHeight, Color(255, 255, 255, 120), false);
+
+    Vector2 cursor = position + Vector2(8, 5);
+    char text[192];
+    std::snprintf(text, sizeof(text), "Frame %.2f ms  avg %.2f  max %.2f", Profiler::GetFrameMs(0), frameAverage, frameMax);
+    m_renderer->DrawText(cursor, text, Color(255, 255, 255, 255));
+    cursor.y += LINE_HEIGHT;
+
+    int written = std::snprintf(text, sizeof(text), "%.1f fps",
+        intervalAverage > 0.0f ? 1000.0f / intervalAverage : 0.0f);
+    Uint64 dropped = Profiler::GetDroppedCount();
+    if (dropped > 0) {
+        std::snprintf(text + written, sizeof(text) - written, "  (%llu zones dropped)",
+            static_cast<unsigned long long>(dropped));
+    }
+    m_renderer->DrawText(cursor, text, Color(200, 200, 200, 255));
+    cursor.y += LINE_HEIGHT;
+
+    // Heap allocations of the last frame; a match in progress should show 0
+    if (AllocationTracker::IsEnabled()) {
+        std::snprintf(text, sizeof(text), "Heap allocations: %d this frame", Profiler::GetFrameAllocations(0));
+    } else {
+        std::snprintf(text, sizeof(text), "Heap allocations: not tracked in this build");
+    }
+    m_renderer->DrawText(cursor, text, Color(200, 200, 200, 255));
+    cursor.y += LINE_HEIGHT;
+
+    // Copied: drawing the panel adds to the stats of the frame being built
+    RenderStats stats = Renderer::GetFrameStats();
+    std::snprintf(text, sizeof(text), "Draws: %d circles, %d lines, %d rects, %d textures, %d texts, %d points",
+        stats.circles, stats.lines, stats.rects, stats.textureDraws, stats.texts, stats.points);
+    m_renderer->DrawText(cursor, text, Color(200, 200, 200, 255));
+    cursor.y += LINE_HEIGHT;
+
+    std::snprintf(text, sizeof(text), "Textures: +%d -%d (%d live), %llu KB uploaded, %d text rasterized",
+        stats.texturesCreated, stats.texturesDestroyed, stats.liveTextures,
+        static_cast<unsigned long long>(stats.bytesUploaded / 1024), stats.textRasterizations);
+    m_renderer->DrawText(cursor, text, Color(200, 200, 200, 255));
+    cursor.y += LINE_HEIGHT + 5;
+
+    DrawFrameGraph(cursor);
+    cursor.y += GRAPH_HEIGHT + 10;
+
+    // Proportional font: every column starts at a fixed offset
+    const char* headers[] = { "Zone (all threads)", "ms", "avg", "max", "calls", "allocs" };
+    for (int column = 0; column < 6; ++column) {
+        m_renderer->DrawText(cursor + Vector2(COLUMN_OFFSETS[column], 0), headers[column], Color(200, 200, 200, 255));
+    }
+    cursor.y += LINE_HEIGHT;
+
+    for (int i = 0; i < rowCount; ++i) {
+        const ZoneRow& row = rows[i];
+        float values[] = { Profiler::GetZoneMs(row.zone, 0), row.averageMs, row.maxMs };
+        m_renderer->DrawText(cursor, Profiler::GetZoneName(row.zone), Color(255, 255, 255, 255));
+        for (int column = 0; column < 3; ++column) {
+            std::snprintf(text, sizeof(text), "%.2f", values[column]);
+            m_renderer->DrawText(cursor + Vector2(COLUMN_OFFSETS[column + 1], 0), text, Color(255, 255, 255, 255));
+        }
+        std::snprintf(text, sizeof(text), "%d", Profiler::GetZoneCalls(row.zone));
+        m_renderer->DrawText(cursor + Vector2(COLUMN_OFFSETS[4], 0), text, Color(255, 255, 255, 255));
+        int allocations = Profiler::GetZoneAllocations(row.zone);
+        std::snprintf(text, sizeof(text), "%d", allocations);
+        m_renderer->DrawText(cursor + Vector2(COLUMN_OFFSETS[5], 0), text,
+            allocations > 0 ? Color(240, 200, 60, 255) : Color(255, 255, 255, 255));
+        DrawZoneGraph(Vector2(position.x + PANEL_WIDTH - ZONE_GRAPH_FRAMES - 8, cursor.y + 2), row.zone, row.maxMs);
+        cursor.y += LINE_HEIGHT;
+    }
+}
+
+void ProfilerOverlay::DrawFrameGraph(const Vector2& position) {
+    float width = PANEL_WIDTH - 16;
+    float barWidth = width / Profiler::HISTORY_FRAMES;
+    m_renderer->DrawRect(position, width, GRAPH_HEIGHT, Color(30, 30, 30, 255));
+
+    // Newest frame on the right
+    for (int i = 0; i < Profiler::GetHistoryLength(); ++i) {
+        float ms = Profiler::GetFrameMs(i);
+        float height = std::min(ms / GRAPH_MAX_MS, 1.0f) * GRAPH_HEIGHT;
+        Color color = ms <= TARGET_FRAME_MS ? Color(80, 220, 80, 255)
+            : (ms <= GRAPH_MAX_MS ? Color(240, 200, 60, 255) : Color(240, 70, 70, 255));
+        float x = position.x + width - (i + 1) * barWidth;
+        m_renderer->DrawRect(Vector2(x, position.y + GRAPH_HEIGHT - height), std::max(barWidth, 1.0f), height, color);
+    }
+
+    // Budget line for 60 fps
+    float targetY = position.y + GRAPH_HEIGHT - (TARGET_FRAME_MS / GRAPH_MAX_MS) * GRAPH_HEIGHT;
+    m_renderer->DrawLine(Vector2(position.x, targetY), Vector2(position.x + width, targetY), Color(255, 255, 255, 140));
+}
+
+void ProfilerOverlay::DrawZoneGraph(const Vector2& position, int zone, float maxMs) {
+    float height = LINE_HEIGHT - 4;
+    m_renderer->DrawRect(position, static_cast<float>(ZONE_GRAPH_FRAMES), height, Color(30, 30, 30, 255));
+    if (maxMs <= 0.0f) return;
+
+    int frames = std::min(Profiler::GetHistoryLength(), ZONE_GRAPH_FRAMES);
+    for (int i = 0; i < frames; ++i) {
+        float barHeight = Profiler::GetZoneMs(zone, i) / maxMs * height;
+        float x = position.x + ZONE_GRAPH_FRAMES - (i + 1);
+        m_renderer->DrawRect(Vector2(x, position.y + height - barHeight), 1.0f, barHeight, Color(100, 180, 255, 255));
+    }
+}
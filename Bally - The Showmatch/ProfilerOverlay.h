@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Vector2.h"
+
+class Renderer;
+
+// On-screen view of the Profiler: rolling frame-time graph, the renderer's stats and heap
+// allocations of the last frame and a per-zone breakdown with one small graph per zone.
+class ProfilerOverlay {
+public:
+    explicit ProfilerOverlay(Renderer* renderer);
+
+    void Toggle();
+    bool IsVisible() const { return m_visible; }
+
+    // Screen space (camera offset 0)
+    void Render();
+
+private:
+    Renderer* m_renderer;
+    bool m_visible;
+
+    void DrawFrameGraph(const Vector2& position);
+    void DrawZoneGraph(const Vector2& position, int zone, float maxMs);
+
+    static constexpr float PANEL_WIDTH = 530.0f;
+    static constexpr float LINE_HEIGHT = 15.0f;
+    static constexpr float GRAPH_HEIGHT = 60.0f;
+    static constexpr float GRAPH_MAX_MS = 33.3f;  // Top of the frame graph
+    static constexpr float TARGET_FRAME_MS = 16.7f;
+    static constexpr int AVERAGE_FRAMES = 60;     // Window for the per-zone numbers
+    static constexpr int ZONE_GRAPH_FRAMES = 60;
+    static constexpr int MAX_ROWS = 16;
+    static constexpr float COLUMN_OFFSETS[6] = { 0.0f, 200.0f, 250.0f, 300.0f, 350.0f, 400.0f }; // Name, ms, avg, max, calls, allocs
+};
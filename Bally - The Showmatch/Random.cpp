@@ -0,0 +1,35 @@
+#include "Random.h"
+
+Uint64 RandomStream::Hash(Uint64 value) {
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+int RandomStream::RangeInt(int min, int max) {
+    if (max <= min) return min;
+    // Multiply-shift maps 32 random bits onto the range without a division
+    Uint64 range = static_cast<Uint64>(static_cast<Sint64>(max) - min + 1);
+    return min + static_cast<int>((static_cast<Uint64>(NextUInt32()) * range) >> 32);
+}
+
+void RandomService::Seed(Uint64 seed) {
+    RandomStream root(seed);
+    for (int i = 0; i < static_cast<int>(RandomStreamId::COUNT); ++i) {
+        m_streams[i] = root.Split(static_cast<Uint64>(i));
+    }
+}
+
+RandomService::State RandomService::GetState() const {
+    State state;
+    for (int i = 0; i < static_cast<int>(RandomStreamId::COUNT); ++i) {
+        state.streams[i] = m_streams[i];
+    }
+    return state;
+}
+
+void RandomService::SetState(const State& state) {
+    for (int i = 0; i < static_cast<int>(RandomStreamId::COUNT); ++i) {
+        m_streams[i] = state.streams[i];
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+// Counter-based random stream: the n-th number is a hash of (key, n), so the whole
+// state is the key and a counter. Copying a stream is a snapshot, and results are
+// the same on every compiler (unlike std::mt19937 + std distributions).
+class RandomStream {
+public:
+    RandomStream() : m_key(0), m_counter(0) {}
+    explicit RandomStream(Uint64 key) : m_key(key), m_counter(0) {}
+
+    Uint64 NextUInt64() { return Hash(m_key + (m_counter++) * GOLDEN_GAMMA); }
+    Uint32 NextUInt32() { return static_cast<Uint32>(NextUInt64() >> 32); }
+
+    // Uniform float in [0, 1)
+    float NextFloat() { return static_cast<float>(NextUInt64() >> 40) * (1.0f / 16777216.0f); }
+    // Uniform float in [min, max)
+    float Range(float min, float max) { return min + (max - min) * NextFloat(); }
+    // Uniform int in [min, max]
+    int RangeInt(int min, int max);
+
+    // Independent child stream (same id -> same child, whatever this stream's position)
+    RandomStream Split(Uint64 streamId) const { return RandomStream(Hash(m_key ^ Hash(streamId + 1))); }
+
+    Uint64 GetKey() const { return m_key; }
+    Uint64 GetCounter() const { return m_counter; }
+
+    static Uint64 Hash(Uint64 value); // SplitMix64 finalizer
+
+private:
+    Uint64 m_key;
+    Uint64 m_counter;
+
+    static constexpr Uint64 GOLDEN_GAMMA = 0x9E3779B97F4A7C15ull;
+};
+
+// Gameplay randomness of one match, one stream per purpose so that drawing more
+// numbers for one thing never shifts another. New streams go at the end of the enum.
+enum class RandomStreamId {
+    ORB_POSITIONS,
+    ORB_TYPES,
+    COUNT
+};
+
+class RandomService {
+public:
+    RandomService() { Seed(0); }
+
+    void Seed(Uint64 seed);
+    RandomStream& Get(RandomStreamId id) { return m_streams[static_cast<int>(id)]; }
+
+    // Snapshot/restore is a plain copy (a few bytes per stream)
+    struct State {
+        RandomStream streams[static_cast<int>(RandomStreamId::COUNT)];
+    };
+    State GetState() const;
+    void SetState(const State& state);
+
+private:
+    RandomStream m_streams[static_cast<int>(RandomStreamId::COUNT)];
+};
@@ -1,4 +1,6 @@
 #include "Renderer.h"
+#include "Profiler.h"
+#include "FrameArena.h"
 #include <SDL3/SDL.h>
 #include <SDL3_ttf/SDL_ttf.h>
 #include <cmath>
@@ -15,6 +17,17 @@ constexpr const T& clamp(const T& v, const T& lo, const T& hi) {
     return (v < lo) ? lo : (hi < v) ? hi : v;
 }
 
+namespace {
+    // Static so textures can be destroyed without a renderer at hand (destructors)
+    RenderStats s_stats;
+    RenderStats s_frameStats;
+
+    // Pixel positions, as SDL_RenderPoint got them
+    SDL_FPoint ToPoint(int x, int y) {
+        return { static_cast<float>(x), static_cast<float>(y) };
+    }
+}
+
 Renderer::Renderer(SDL_Window* window) : m_renderer(nullptr), m_window(window), m_windowWidth(1200), m_windowHeight(800), m_cameraOffset(0, 0) {
     SDL_GetWindowSize(window, &m_windowWidth, &m_windowHeight);
 }
@@ -77,7 +90,53 @@ void Renderer::BeginFrame() {
 }
 
 void Renderer::EndFrame() {
+    PROFILE_ZONE("Renderer::EndFrame");
+
     SDL_RenderPresent(m_renderer);
+
+    s_frameStats = s_stats;
+    s_stats = RenderStats();
+    s_stats.liveTextures = s_frameStats.liveTextures;
+
+    PROFILE_COUNTER("Render points", s_frameStats.points);
+    PROFILE_COUNTER("Render draw calls", s_frameStats.circles + s_frameStats.lines + s_frameStats.rects +
+                                         s_frameStats.textureDraws + s_frameStats.texts);
+    PROFILE_COUNTER("Text rasterizations", s_frameStats.textRasterizations);
+    PROFILE_COUNTER("Textures created", s_frameStats.texturesCreated);
+    PROFILE_COUNTER("Texture KB uploaded", s_frameStats.bytesUploaded / 1024);
+    PROFILE_COUNTER("Live textures", s_frameStats.liveTextures);
+}
+
+const RenderStats& Renderer::GetFrameStats() {
+    return s_frameStats;
+}
+
+SDL_Texture* Renderer::CreateTextureFromSurface(SDL_Surface* surface) {
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(m_renderer, surface);
+    if (texture) {
+        s_stats.texturesCreated++;
+        s_stats.liveTextures++;
+        s_stats.bytesUploaded += static_cast<Uint64>(surface->pitch) * surface->h;
+    }
+    return texture;
+}
+
+void Renderer::DestroyTexture(SDL_Texture* texture) {
+    if (!texture) return;
+    s_stats.texturesDestroyed++;
+    s_stats.liveTextures--;
+    SDL_DestroyTexture(texture);
+}
+
+void Renderer::DrawTexture(SDL_Texture* texture, const SDL_FRect* source, const SDL_FRect* destination) {
+    s_stats.textureDraws++;
+    SDL_RenderTexture(m_renderer, texture, source, destination);
+}
+
+void Renderer::DrawTextureRotated(SDL_Texture* texture, const SDL_FRect* source, const SDL_FRect* destination,
+                                  double angle, const SDL_FPoint* center, SDL_FlipMode flip) {
+    s_stats.textureDraws++;
+    SDL_RenderTextureRotated(m_renderer, texture, source, destination, angle, center, flip);
 }
 
 void Renderer::SetDrawColor(const Color& color) {
@@ -91,19 +150,29 @@ void Renderer::Clear(const Color& color) {
 
 void Renderer::DrawCircle(const Vector2& center, float radius, const Color& color) {
     SetDrawColor(color);
+    s_stats.circles++;
 
     // Apply camera offset
     int centerX = static_cast<int>(center.x - m_cameraOffset.x);
     int centerY = static_cast<int>(center.y - m_cameraOffset.y);
     int r = static_cast<int>(radius);
 
+    // Points are collected in frame scratch memory and sent in one batch per color
+    ArenaVector<SDL_FPoint> batch{ ArenaAllocator<SDL_FPoint>(m_frameArena) };
+    int side = 2 * std::max(r, 0) + 1;
+    batch.reserve(std::max(side * side, 8 * (std::max(r, 0) + 1)));
+
+    int points = 0;
     for (int y = -r; y <= r; ++y) {
         for (int x = -r; x <= r; ++x) {
             if (x * x + y * y <= r * r) {
-                SDL_RenderPoint(m_renderer, centerX + x, centerY + y);
+                batch.push_back(ToPoint(centerX + x, centerY + y));
             }
         }
     }
+    SDL_RenderPoints(m_renderer, batch.data(), static_cast<int>(batch.size()));
+    points += static_cast<int>(batch.size());
+    batch.clear();
 
     // Draw outline
     Color outlineColor(color.r * 0.7f, color.g * 0.7f, color.b * 0.7f, color.a);
@@ -115,14 +184,14 @@ void Renderer::DrawCircle(const Vector2& center, float radius, const Color& colo
     int err = 0;
 
     while (x >= y) {
-        SDL_RenderPoint(m_renderer, centerX + x, centerY + y);
-        SDL_RenderPoint(m_renderer, centerX + y, centerY + x);
-        SDL_RenderPoint(m_renderer, centerX - y, centerY + x);
-        SDL_RenderPoint(m_renderer, centerX - x, centerY + y);
-        SDL_RenderPoint(m_renderer, centerX - x, centerY - y);
-        SDL_RenderPoint(m_renderer, centerX - y, centerY - x);
-        SDL_RenderPoint(m_renderer, centerX + y, centerY - x);
-        SDL_RenderPoint(m_renderer, centerX + x, centerY - y);
+        batch.push_back(ToPoint(centerX + x, centerY + y));
+        batch.push_back(ToPoint(centerX + y, centerY + x));
+        batch.push_back(ToPoint(centerX - y, centerY + x));
+        batch.push_back(ToPoint(centerX - x, centerY + y));
+        batch.push_back(ToPoint(centerX - x, centerY - y));
+        batch.push_back(ToPoint(centerX - y, centerY - x));
+        batch.push_back(ToPoint(centerX + y, centerY - x));
+        batch.push_back(ToPoint(centerX + x, centerY - y));
 
         if (err <= 0) {
             y += 1;
@@ -133,10 +202,14 @@ void Renderer::DrawCircle(const Vector2& center, float radius, const Color& colo
             err -= 2 * x + 1;
         }
     }
+    SDL_RenderPoints(m_renderer, batch.data(), static_cast<int>(batch.size()));
+    points += static_cast<int>(batch.size());
+    s_stats.points += points;
 }
 
 void Renderer::DrawLine(const Vector2& start, const Vector2& end, const Color& color, float thickness) {
     SetDrawColor(color);
+    s_stats.lines++;
 
     // Apply camera offset
     Vector2 adjustedStart = start - m_cameraOffset;
@@ -150,19 +223,25 @@ void Renderer::DrawLine(const Vector2& start, const Vector2& end, const Color& c
     direction = direction * (1.0f / length);
     Vector2 perpendicular(-direction.y, direction.x);
 
+    ArenaVector<SDL_FPoint> batch{ ArenaAllocator<SDL_FPoint>(m_frameArena) };
+    batch.reserve(static_cast<size_t>((length / 0.5f + 1) * (std::max(thickness, 0.0f) / 0.5f + 1)) + 1);
+
     for (float t = 0; t <= length; t += 0.5f) {
         Vector2 point = adjustedStart + direction * t;
 
         // Draw thickness
         for (float offset = -thickness / 2; offset <= thickness / 2; offset += 0.5f) {
             Vector2 thickPoint = point + perpendicular * offset;
-            SDL_RenderPoint(m_renderer, static_cast<int>(thickPoint.x), static_cast<int>(thickPoint.y));
+            batch.push_back(ToPoint(static_cast<int>(thickPoint.x), static_cast<int>(thickPoint.y)));
         }
     }
+    SDL_RenderPoints(m_renderer, batch.data(), static_cast<int>(batch.size()));
+    s_stats.points += static_cast<int>(batch.size());
 }
 
 void Renderer::DrawRect(const Vector2& position, float width, float height, const Color& color, bool filled) {
     SetDrawColor(color);
+    s_stats.rects++;
 
     // Apply camera offset
     SDL_FRect rect = {
@@ -241,6 +320,8 @@ void Renderer::DrawHealthBar(const Vector2& position, float health, float maxHea
 }
 
 void Renderer::DrawText(const Vector2& position, const char* text, const Color& color) {
+    PROFILE_ZONE("Renderer::DrawText");
+
     if (!text || !*text) return;
     if (!m_font) return; // font must be loaded via LoadFont
 
@@ -252,9 +333,11 @@ void Renderer::DrawText(const Vector2& position, const char* text, const Color&
         sdlColor,
         0
     );
+    s_stats.texts++;
+    s_stats.textRasterizations++;
     if (!surface) return;
 
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(m_renderer, surface);
+    SDL_Texture* texture = CreateTextureFromSurface(surface);
     if (!texture) {
         SDL_DestroySurface(surface);
         return;
@@ -265,7 +348,7 @@ void Renderer::DrawText(const Vector2& position, const char* text, const Color&
                    static_cast<float>(surface->w), static_cast<float>(surface->h) };
     SDL_RenderTexture(m_renderer, texture, nullptr, &dst);
 
-    SDL_DestroyTexture(texture);
+    DestroyTexture(texture);
     SDL_DestroySurface(surface);
 }
 
@@ -285,6 +368,7 @@ void Renderer::GetTextSize(const char* text, int* width, int* height) const {
         sdlColor,
         0
     );
+    s_stats.textRasterizations++;
     if (surface) {
         if (width) *width = surface->w;
         if (height) *height = surface->h;
@@ -296,6 +380,8 @@ void Renderer::GetTextSize(const char* text, int* width, int* height) const {
 }
 
 bool Renderer::LoadFont(const char* fontPath, int pointSize) {
+    PROFILE_ZONE("Renderer::LoadFont");
+
     if (!TTF_WasInit()) {
         if (TTF_Init() == -1) {
             std::cerr << "TTF_Init failed: " << SDL_GetError() << std::endl;
@@ -5,11 +5,30 @@
 #include "Vector2.h"
 #include <SDL3_ttf/SDL_ttf.h>
 
+class FrameArena;
+
 struct Color {
     Uint8 r, g, b, a;
     Color(Uint8 r = 255, Uint8 g = 255, Uint8 b = 255, Uint8 a = 255) : r(r), g(g), b(b), a(a) {}
 };
 
+// What one frame sent to SDL. Textures created outside a frame (loading) count toward the next one.
+struct RenderStats {
+    // Draw calls by primitive
+    int circles = 0;
+    int lines = 0;
+    int rects = 0;
+    int textureDraws = 0;
+    int texts = 0;
+
+    int points = 0;              // Points drawn by circles and lines (one SDL_RenderPoints batch per color)
+    int textRasterizations = 0;  // Text rendered to a surface, measuring included
+    int texturesCreated = 0;
+    int texturesDestroyed = 0;
+    Uint64 bytesUploaded = 0;    // Pixels sent to created textures
+    int liveTextures = 0;        // Created and not yet destroyed, since startup
+};
+
 class Renderer {
 public:
     Renderer(SDL_Window* window);
@@ -34,6 +53,15 @@ public:
 
     bool LoadFont(const char* fontPath, int pointSize);
 
+    // Textures: create, destroy and draw them through these so they show up in the stats
+    SDL_Texture* CreateTextureFromSurface(SDL_Surface* surface);
+    static void DestroyTexture(SDL_Texture* texture);
+    void DrawTexture(SDL_Texture* texture, const SDL_FRect* source, const SDL_FRect* destination);
+    void DrawTextureRotated(SDL_Texture* texture, const SDL_FRect* source, const SDL_FRect* destination,
+                            double angle, const SDL_FPoint* center, SDL_FlipMode flip);
+
+    static const RenderStats& GetFrameStats(); // Last presented frame
+
     // Game specific
     void DrawPlatform(const Vector2& position, float width, float height);
 
@@ -44,6 +72,9 @@ public:
     TTF_Font* GetFont() const { return m_font; }
     Vector2 GetWindowSize() const { return Vector2(static_cast<float>(m_windowWidth), static_cast<float>(m_windowHeight)); }
 
+    // Scratch memory for point batches, valid until the end of the frame (nullptr = general heap)
+    void SetFrameArena(FrameArena* arena) { m_frameArena = arena; }
+
     // Camera offset
     void SetCameraOffset(const Vector2& offset) { m_cameraOffset = offset; }
     Vector2 GetCameraOffset() const { return m_cameraOffset; }
@@ -55,5 +86,6 @@ private:
     int m_windowHeight;
     TTF_Font* m_font = nullptr;
     Vector2 m_cameraOffset; // Camera offset for scrolling
+    FrameArena* m_frameArena = nullptr;
 };
 
@@ -0,0 +1,198 @@
+#include "Replay.h"
+#include "ByteStream.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace {
+
+const Uint8 MAGIC[4] = { 'B', 'R', 'P', 'L' };
+
+}
+
+void ReplayData::Encode(std::vector<Uint8>& out) const {
+    out.clear();
+    for (Uint8 byte : MAGIC) {
+        out.push_back(byte);
+    }
+    out.push_back(VERSION);
+    WriteVarint(out, seed);
+    out.push_back(static_cast<Uint8>(config.gameMode));
+    out.push_back(static_cast<Uint8>(config.numPlayers));
+    out.push_back(config.skipImpactDelay ? 1 : 0);
+    WriteVarint(out, static_cast<Uint32>(mapFolder.size()));
+    out.insert(out.end(), mapFolder.begin(), mapFolder.end());
+    WriteVarint(out, ZigZag(winnerId));
+
+    WriteVarint(out, static_cast<Uint32>(initialCraters.size()));
+    for (const TerrainCrater& crater : initialCraters) {
+        WriteFloat(out, crater.center.x);
+        WriteFloat(out, crater.center.y);
+        WriteFloat(out, crater.radius);
+    }
+
+    // Run-length encode the buttons, each run stored as a delta to the previous one
+    std::vector<Uint8> runs;
+    Uint32 runCount = 0;
+    Uint16 previous = 0;
+    size_t i = 0;
+    while (i < inputs.size()) {
+        size_t end = i;
+        while (end < inputs.size() && inputs[end] == inputs[i]) {
+            ++end;
+        }
+        WriteVarint(runs, static_cast<Uint32>(end - i));
+        WriteVarint(runs, static_cast<Uint32>(inputs[i] ^ previous));
+        previous = inputs[i];
+        runCount++;
+        i = end;
+    }
+
+    WriteVarint(out, static_cast<Uint32>(inputs.size()));
+    WriteVarint(out, runCount);
+    out.insert(out.end(), runs.begin(), runs.end());
+
+    WriteVarint(out, static_cast<Uint32>(hashInterval));
+    WriteVarint(out, static_cast<Uint32>(stateHashes.size()));
+    for (Uint32 hash : stateHashes) {
+        for (int i = 0; i < 4; ++i) {
+            out.push_back(static_cast<Uint8>(hash >> (i * 8)));
+        }
+    }
+}
+
+bool ReplayData::Decode(const std::vector<Uint8>& data) {
+    ByteReader reader(data);
+    if (data.size() < 5 || std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        std::cerr << "Not a replay file" << std::endl;
+        return false;
+    }
+    reader.offset = 4;
+    Uint8 version = reader.ReadByte();
+    if (version != VERSION) {
+        std::cerr << "Unsupported replay version " << (int)version << std::endl;
+        return false;
+    }
+
+    seed = reader.ReadVarint();
+    config.gameMode = static_cast<GameMode>(reader.ReadByte());
+    config.numPlayers = reader.ReadByte();
+    config.skipImpactDelay = (reader.ReadByte() & 1) != 0;
+    Uint32 nameLength = reader.ReadVarint();
+    if (reader.offset + nameLength > data.size()) {
+        std::cerr << "Replay file is truncated" << std::endl;
+        return false;
+    }
+    mapFolder.assign(data.begin() + reader.offset, data.begin() + reader.offset + nameLength);
+    reader.offset += nameLength;
+    winnerId = UnZigZag(reader.ReadVarint());
+
+    Uint32 craterCount = reader.ReadVarint();
+    initialCraters.clear();
+    for (Uint32 i = 0; i < craterCount && !reader.failed; ++i) {
+        TerrainCrater crater;
+        crater.center.x = reader.ReadFloat();
+        crater.center.y = reader.ReadFloat();
+        crater.radius = reader.ReadFloat();
+        initialCraters.push_back(crater);
+    }
+
+    Uint32 stepCount = reader.ReadVarint();
+    Uint32 runCount = reader.ReadVarint();
+    inputs.clear();
+    inputs.reserve(stepCount);
+    Uint16 previous = 0;
+    for (Uint32 run = 0; run < runCount && !reader.failed; ++run) {
+        Uint32 length = reader.ReadVarint();
+        Uint16 buttons = static_cast<Uint16>(reader.ReadVarint() ^ previous);
+        if (inputs.size() + length > stepCount) {
+            reader.failed = true;
+            break;
+        }
+        inputs.insert(inputs.end(), length, buttons);
+        previous = buttons;
+    }
+
+    hashInterval = static_cast<int>(reader.ReadVarint());
+    Uint32 hashCount = reader.ReadVarint();
+    stateHashes.clear();
+    if (hashInterval <= 0 || hashCount > stepCount / static_cast<Uint32>(hashInterval)) {
+        reader.failed = true;
+    }
+    for (Uint32 i = 0; i < hashCount && !reader.failed; ++i) {
+        Uint32 hash = 0;
+        for (int b = 0; b < 4; ++b) {
+            hash |= static_cast<Uint32>(reader.ReadByte()) << (b * 8);
+        }
+        stateHashes.push_back(hash);
+    }
+
+    if (reader.failed || inputs.size() != stepCount) {
+        std::cerr << "Replay file is corrupt or truncated" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool ReplayData::SaveToFile(const std::string& path) const {
+    std::vector<Uint8> bytes;
+    Encode(bytes);
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to write replay: " << path << std::endl;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    return file.good();
+}
+
+bool ReplayData::LoadFromFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to open replay: " << path << std::endl;
+        return false;
+    }
+    std::vector<Uint8> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return Decode(bytes);
+}
+
+ReplayRecorder::ReplayRecorder() : m_recording(false) {
+}
+
+void ReplayRecorder::Begin(const Match& match, const std::string& mapFolder) {
+    m_data = ReplayData();
+    m_data.seed = match.GetSeed();
+    m_data.config = match.GetConfig();
+    m_data.mapFolder = mapFolder;
+    m_data.initialCraters = match.GetTerrain()->GetCraterLog();
+    m_recording = true;
+}
+
+void ReplayRecorder::RecordStep(const MatchInput& input) {
+    if (m_recording) {
+        m_data.inputs.push_back(input.buttons);
+    }
+}
+
+void ReplayRecorder::RecordStateHash(const Match& match) {
+    if (m_recording && !m_data.inputs.empty() && static_cast<int>(m_data.inputs.size()) % m_data.hashInterval == 0) {
+        RecordStateHash(match.ComputeStateHash());
+    }
+}
+
+void ReplayRecorder::RecordStateHash(Uint64 stateHash) {
+    int steps = static_cast<int>(m_data.inputs.size());
+    if (!m_recording || steps == 0 || steps % m_data.hashInterval != 0) return;
+
+    // One checkpoint per interval, even if called more than once for a step
+    if (static_cast<int>(m_data.stateHashes.size()) == steps / m_data.hashInterval - 1) {
+        m_data.stateHashes.push_back(static_cast<Uint32>(stateHash));
+    }
+}
+
+void ReplayRecorder::End(int winnerId) {
+    m_data.winnerId = winnerId;
+    m_recording = false;
+}
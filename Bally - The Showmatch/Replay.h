@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <SDL3/SDL.h>
+#include "Match.h"
+
+// A recorded match: the seed, the terrain it started on and the active player's buttons
+// for every step. The simulation is deterministic, so this is enough to play it back.
+//
+// File layout (little endian, varints are LEB128):
+//   "BRPL" version:u8 seed:varint mode:u8 players:u8 flags:u8 map:string winner:zigzag varint
+//   craters:varint { x:f32 y:f32 radius:f32 }
+//   steps:varint runs:varint { length:varint buttons xor previous:varint }
+//   hashInterval:varint hashes:varint { state hash:u32 }
+// Buttons change a few times per turn, so a full match is a few KB. The state hash
+// checkpoints (low 32 bits of Match::ComputeStateHash after every hashInterval-th step)
+// let playback on another machine or build find where it diverged.
+struct ReplayData {
+    unsigned int seed;
+    MatchConfig config;
+    std::string mapFolder;                      // Map the match was played on ("" = default terrain)
+    std::vector<TerrainCrater> initialCraters;  // Terrain damage carried over into a rematch
+    std::vector<Uint16> inputs;                 // Buttons per step
+    int winnerId;
+    int hashInterval;
+    std::vector<Uint32> stateHashes;            // After steps hashInterval, 2 * hashInterval, ...
+
+    ReplayData() : seed(0), winnerId(-1), hashInterval(HASH_INTERVAL) {}
+
+    void Encode(std::vector<Uint8>& out) const;
+    bool Decode(const std::vector<Uint8>& data);
+
+    bool SaveToFile(const std::string& path) const;
+    bool LoadFromFile(const std::string& path);
+
+    // 2: counter-based gameplay RNG, 3: free cells in cell order, 4: state hashes, 5: config flags
+    static constexpr Uint8 VERSION = 5;
+    static constexpr int HASH_INTERVAL = 60;
+};
+
+// Records the match the game (or server) is driving
+class ReplayRecorder {
+public:
+    ReplayRecorder();
+
+    // Start recording a match that is about to take its first step
+    void Begin(const Match& match, const std::string& mapFolder);
+    // Call with the input passed to Match::Step, before stepping
+    void RecordStep(const MatchInput& input);
+    // Call after stepping; only every HASH_INTERVAL-th step is hashed and kept
+    void RecordStateHash(const Match& match);
+    // Same with a hash computed elsewhere (netplay hashes every frame anyway)
+    void RecordStateHash(Uint64 stateHash);
+    // Stop recording and keep the result
+    void End(int winnerId);
+
+    bool IsRecording() const { return m_recording; }
+    const ReplayData& GetData() const { return m_data; }
+
+private:
+    ReplayData m_data;
+    bool m_recording;
+};
@@ -0,0 +1,129 @@
+#include "ReplayPlayer.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+ReplayPlayer::ReplayPlayer() : m_keyframedTurn(-1), m_checkedHashes(0), m_mismatchStep(-1), m_hashMs(0.0) {
+}
+
+bool ReplayPlayer::Load(const ReplayData& replay, const Terrain& mapTerrain) {
+    m_replay = replay;
+    m_keyframes.clear();
+    m_keyframedTurn = -1;
+    m_checkedHashes = 0;
+    m_mismatchStep = -1;
+    m_hashMs = 0.0;
+
+    if (!m_match.Initialize(mapTerrain, replay.config)) {
+        std::cerr << "Failed to start replay match" << std::endl;
+        return false;
+    }
+
+    // Same start as a rematch: damaged terrain first, then respawn on it
+    for (const TerrainCrater& crater : replay.initialCraters) {
+        m_match.GetTerrain()->DestroyCircle(crater.center, crater.radius);
+    }
+    m_match.Reset();
+    m_match.SetSeed(replay.seed);
+
+    AddKeyframe();
+    return true;
+}
+
+bool ReplayPlayer::Step() {
+    int step = m_match.GetStepCount();
+    if (step >= GetStepCount()) return false;
+
+    MatchInput input;
+    input.buttons = m_replay.inputs[step];
+    m_match.Step(input);
+
+    // Keyframe at the interval and whenever a new turn starts, unless already known
+    int newStep = m_match.GetStepCount();
+    bool known = !m_keyframes.empty() && m_keyframes.back().stepCount >= newStep;
+    bool newTurn = m_match.IsStarted() && m_match.GetTurnCounter() > m_keyframedTurn;
+    if (!known && (newStep % KEYFRAME_INTERVAL == 0 || newTurn)) {
+        AddKeyframe();
+    }
+    CheckStateHash();
+    return true;
+}
+
+void ReplayPlayer::CheckStateHash() {
+    int step = m_match.GetStepCount();
+    int interval = m_replay.hashInterval;
+    if (step % interval != 0 || step / interval != m_checkedHashes + 1) return;
+    if (m_checkedHashes >= static_cast<int>(m_replay.stateHashes.size())) return;
+
+    Uint32 recorded = m_replay.stateHashes[m_checkedHashes];
+    m_checkedHashes++;
+    auto hashStart = std::chrono::steady_clock::now();
+    Uint32 hash = static_cast<Uint32>(m_match.ComputeStateHash());
+    m_hashMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - hashStart).count();
+    if (m_mismatchStep < 0 && hash != recorded) {
+        m_mismatchStep = step;
+        std::cerr << "Replay diverged from the recording between step " << step - interval << " and " << step << std::endl;
+    }
+}
+
+void ReplayPlayer::RunToEnd() {
+    while (Step()) {
+    }
+}
+
+void ReplayPlayer::AddKeyframe() {
+    m_keyframes.emplace_back();
+    m_match.SaveState(m_keyframes.back());
+    if (m_match.IsStarted()) {
+        m_keyframedTurn = std::max(m_keyframedTurn, m_match.GetTurnCounter());
+    }
+}
+
+const MatchState* ReplayPlayer::FindKeyframe(int step) const {
+    const MatchState* best = nullptr;
+    // Binary search for the last keyframe with stepCount <= step
+    size_t low = 0, high = m_keyframes.size();
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if (m_keyframes[mid].stepCount <= step) {
+            best = &m_keyframes[mid];
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return best;
+}
+
+void ReplayPlayer::SeekToStep(int step) {
+    step = std::max(0, std::min(step, GetStepCount()));
+
+    // Restore unless simulating on from where we are is shorter
+    const MatchState* keyframe = FindKeyframe(step);
+    int current = m_match.GetStepCount();
+    if (keyframe && (current > step || keyframe->stepCount > current)) {
+        m_match.LoadState(*keyframe);
+    }
+
+    while (m_match.GetStepCount() < step && Step()) {
+    }
+}
+
+bool ReplayPlayer::SeekToTurn(int turn) {
+    // Turn starts are keyframed, so a turn that was already reached is a single restore
+    for (const MatchState& keyframe : m_keyframes) {
+        if (keyframe.gameStarted && keyframe.turnCounter == turn) {
+            m_match.LoadState(keyframe);
+            return true;
+        }
+    }
+
+    // Not reached yet: play forward from the last keyframe until it starts
+    if (!m_keyframes.empty() && m_keyframes.back().stepCount > m_match.GetStepCount()) {
+        m_match.LoadState(m_keyframes.back());
+    }
+    while (!(m_match.IsStarted() && m_match.GetTurnCounter() >= turn)) {
+        if (!Step()) return false;
+    }
+    return m_match.GetTurnCounter() == turn;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+#include "Match.h"
+#include "Replay.h"
+
+// Plays a replay back in a headless match as fast as the simulation runs.
+// While stepping forward it keeps state keyframes (every KEYFRAME_INTERVAL steps and at
+// every turn start), so seeking restores the nearest keyframe and re-simulates at most
+// one interval instead of the whole match. The first time each recorded state hash
+// checkpoint is reached it is compared with the simulation.
+class ReplayPlayer {
+public:
+    ReplayPlayer();
+
+    // Start playback on the map the replay was recorded on
+    bool Load(const ReplayData& replay, const Terrain& mapTerrain);
+
+    // Advance one step; returns false once all recorded steps have been played
+    bool Step();
+    void RunToEnd();
+
+    // Jump to a step / to the start of a turn (0 = first turn). Seeking backwards is cheap,
+    // seeking past what was played so far simulates forward and keyframes on the way.
+    void SeekToStep(int step);
+    bool SeekToTurn(int turn);
+
+    int GetStep() const { return m_match.GetStepCount(); }
+    int GetStepCount() const { return static_cast<int>(m_replay.inputs.size()); }
+    bool IsFinished() const { return GetStep() >= GetStepCount(); }
+    int GetKeyframeCount() const { return static_cast<int>(m_keyframes.size()); }
+
+    // First checkpoint step whose state hash differs from the recording (-1 = none so far)
+    int GetMismatchStep() const { return m_mismatchStep; }
+    int GetCheckedHashCount() const { return m_checkedHashes; }
+    double GetHashMs() const { return m_hashMs; } // Time spent hashing for the checks
+
+    Match& GetMatch() { return m_match; }
+    const Match& GetMatch() const { return m_match; }
+    const ReplayData& GetReplay() const { return m_replay; }
+
+    static constexpr int KEYFRAME_INTERVAL = 120; // 2 seconds
+
+private:
+    void AddKeyframe();
+    void CheckStateHash();
+    const MatchState* FindKeyframe(int step) const; // Last keyframe at or before step
+
+    ReplayData m_replay;
+    Match m_match;
+    std::vector<MatchState> m_keyframes; // Ordered by step
+    int m_keyframedTurn;                 // Turn of the last turn-start keyframe
+    int m_checkedHashes;
+    int m_mismatchStep;
+    double m_hashMs;
+};
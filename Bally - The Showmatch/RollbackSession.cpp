@@ -0,0 +1,493 @@
+#include "RollbackSession.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace {
+
+// Packet: 'B' 'N' type:u8, then (little endian)
+//   JOIN       (guest, until the setup arrives)
+//   SETUP      seed:u32 mode:u8 players:u8 flags:u8 hostMask:u32 inputDelay:u8 map:u8 length + bytes
+//   SETUP_ACK  (guest, answer to every SETUP)
+//   INPUT      frame:s32 advantage:s8 ack:s32 start:s32 count:u8 { buttons:u16 }
+//              hashFrame:s32 hash:u64 (newest confirmed hashed frame, -1 = none yet)
+//   DESYNC     frame:s32 StateHashDetail (sender's hashes of the frame that differed)
+enum PacketType : Uint8 { JOIN = 1, SETUP = 2, SETUP_ACK = 3, INPUT = 4, DESYNC = 5 };
+
+void WriteHeader(std::vector<Uint8>& out, PacketType type) {
+    out.clear();
+    out.push_back('B');
+    out.push_back('N');
+    out.push_back(type);
+}
+
+void Write16(std::vector<Uint8>& out, Uint16 value) {
+    out.push_back(static_cast<Uint8>(value));
+    out.push_back(static_cast<Uint8>(value >> 8));
+}
+
+void Write32(std::vector<Uint8>& out, Uint32 value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<Uint8>(value >> (i * 8)));
+    }
+}
+
+void Write64(std::vector<Uint8>& out, Uint64 value) {
+    Write32(out, static_cast<Uint32>(value));
+    Write32(out, static_cast<Uint32>(value >> 32));
+}
+
+struct PacketReader {
+    const std::vector<Uint8>& data;
+    size_t offset;
+    bool failed;
+
+    explicit PacketReader(const std::vector<Uint8>& bytes) : data(bytes), offset(3), failed(bytes.size() < 3) {}
+
+    Uint8 Read8() {
+        if (offset >= data.size()) {
+            failed = true;
+            return 0;
+        }
+        return data[offset++];
+    }
+
+    Uint16 Read16() {
+        Uint16 value = Read8();
+        return static_cast<Uint16>(value | (Read8() << 8));
+    }
+
+    Uint32 Read32() {
+        Uint32 value = 0;
+        for (int i = 0; i < 4; ++i) {
+            value |= static_cast<Uint32>(Read8()) << (i * 8);
+        }
+        return value;
+    }
+
+    Uint64 Read64() {
+        Uint64 low = Read32();
+        return low | (static_cast<Uint64>(Read32()) << 32);
+    }
+};
+
+double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+RollbackSession::RollbackSession(NetTransport& transport, bool isHost)
+    : m_transport(transport), m_isHost(isHost), m_status(Status::SYNCHRONIZING), m_hasSetup(false),
+      m_match(nullptr), m_localPlayerMask(0), m_states(MAX_ROLLBACK + 2), m_hashes(INPUT_WINDOW) {
+    ResetFrames();
+}
+
+void RollbackSession::ResetFrames() {
+    // Frames before the input delay have no buttons on either side
+    int delay = std::max(0, std::min(m_setup.inputDelay, MAX_ROLLBACK));
+    m_setup.inputDelay = delay;
+    m_frame = 0;
+    m_localInputFrame = delay - 1;
+    m_remoteConfirmedFrame = delay - 1;
+    m_remoteAckedFrame = delay - 1;
+    m_remoteFrame = 0;
+    m_remoteAdvantage = 0;
+    m_firstMispredictedFrame = -1;
+    m_lastReportedFrame = -1;
+    m_lastTimeSyncFrame = 0;
+    m_framesWithoutPacket = 0;
+    m_resimulating = false;
+    m_sentSincePoll = false;
+    m_peerHashFrame = -1;
+    m_comparedHashFrame = -1;
+    m_peerHash = 0;
+    m_desyncFrame = -1;
+    m_desyncResends = 0;
+    m_hasPeerDetail = false;
+    m_desyncReported = false;
+
+    std::fill(m_localInputs, m_localInputs + INPUT_WINDOW, 0);
+    std::fill(m_remoteInputs, m_remoteInputs + INPUT_WINDOW, 0);
+    std::fill(m_usedInputs, m_usedInputs + INPUT_WINDOW, 0);
+    std::fill(m_usedRemote, m_usedRemote + INPUT_WINDOW, false);
+}
+
+void RollbackSession::SetSetup(const NetplaySetup& setup) {
+    m_setup = setup;
+    m_hasSetup = true;
+    ResetFrames();
+}
+
+void RollbackSession::Start(Match& match) {
+    m_match = &match;
+
+    Uint32 allPlayers = static_cast<Uint32>((1ull << m_setup.config.numPlayers) - 1);
+    m_localPlayerMask = m_isHost ? (m_setup.hostPlayerMask & allPlayers) : (~m_setup.hostPlayerMask & allPlayers);
+}
+
+int RollbackSession::GetConfirmedFrame() const {
+    return std::min(m_remoteConfirmedFrame, m_frame - 1);
+}
+
+void RollbackSession::Poll() {
+    bool received = false;
+    while (m_transport.Receive(m_receivedPacket)) {
+        m_stats.packetsReceived++;
+        received = true;
+        HandlePacket(m_receivedPacket);
+    }
+
+    if (m_status == Status::SYNCHRONIZING) {
+        if (m_isHost && m_hasSetup) {
+            SendSetup();
+        } else if (!m_isHost) {
+            WriteHeader(m_packet, JOIN);
+            m_transport.Send(m_packet);
+            m_stats.packetsSent++;
+        }
+        return;
+    }
+
+    if (m_status != Status::RUNNING) return;
+
+    // Correct mispredictions right away, even on frames that are not advanced
+    if (m_match) {
+        if (m_firstMispredictedFrame >= 0) {
+            Rollback();
+        }
+        ReportConfirmedFrames();
+    }
+
+    // Keep inputs and acks flowing while no frames are advanced (loading, match over)
+    if (!m_sentSincePoll) {
+        SendInputs();
+    }
+    m_sentSincePoll = false;
+
+    // The desync report is a single datagram; repeat it for a while
+    if (m_desyncResends > 0) {
+        m_desyncResends--;
+        SendDesync();
+    }
+
+    // A peer that stays silent for too long has left
+    m_framesWithoutPacket = received ? 0 : m_framesWithoutPacket + 1;
+    if (m_framesWithoutPacket > DISCONNECT_FRAMES) {
+        std::cout << "Netplay peer disconnected" << std::endl;
+        m_status = Status::DISCONNECTED;
+    }
+}
+
+void RollbackSession::SendSetup() {
+    WriteHeader(m_packet, SETUP);
+    Write32(m_packet, m_setup.seed);
+    m_packet.push_back(static_cast<Uint8>(m_setup.config.gameMode));
+    m_packet.push_back(static_cast<Uint8>(m_setup.config.numPlayers));
+    m_packet.push_back(m_setup.config.skipImpactDelay ? 1 : 0);
+    Write32(m_packet, m_setup.hostPlayerMask);
+    m_packet.push_back(static_cast<Uint8>(m_setup.inputDelay));
+    size_t mapLength = std::min(m_setup.mapFolder.size(), static_cast<size_t>(255));
+    m_packet.push_back(static_cast<Uint8>(mapLength));
+    m_packet.insert(m_packet.end(), m_setup.mapFolder.begin(), m_setup.mapFolder.begin() + mapLength);
+    m_transport.Send(m_packet);
+    m_stats.packetsSent++;
+}
+
+void RollbackSession::SendInputs() {
+    int start = m_remoteAckedFrame + 1;
+    int count = std::max(0, std::min(m_localInputFrame - start + 1, MAX_INPUTS_PER_PACKET));
+    int advantage = std::max(-127, std::min(m_frame - m_remoteFrame, 127));
+
+    WriteHeader(m_packet, INPUT);
+    Write32(m_packet, static_cast<Uint32>(m_frame));
+    m_packet.push_back(static_cast<Uint8>(static_cast<Sint8>(advantage)));
+    Write32(m_packet, static_cast<Uint32>(m_remoteConfirmedFrame));
+    Write32(m_packet, static_cast<Uint32>(start));
+    m_packet.push_back(static_cast<Uint8>(count));
+    for (int i = 0; i < count; ++i) {
+        Write16(m_packet, m_localInputs[(start + i) % INPUT_WINDOW]);
+    }
+    int hashFrame = m_lastReportedFrame - (m_lastReportedFrame + 1) % HASH_INTERVAL;
+    const StateHashDetail* confirmed = GetFrameHashes(hashFrame);
+    Write32(m_packet, static_cast<Uint32>(confirmed ? hashFrame : -1));
+    Write64(m_packet, confirmed ? confirmed->total : 0);
+    m_transport.Send(m_packet);
+    m_stats.packetsSent++;
+    m_sentSincePoll = true;
+}
+
+void RollbackSession::HandlePacket(const std::vector<Uint8>& packet) {
+    if (packet.size() < 3 || packet[0] != 'B' || packet[1] != 'N') return;
+
+    PacketReader reader(packet);
+    switch (packet[2]) {
+    case SETUP: {
+        if (m_isHost) return;
+        NetplaySetup setup;
+        setup.seed = reader.Read32();
+        setup.config.gameMode = static_cast<GameMode>(reader.Read8());
+        setup.config.numPlayers = reader.Read8();
+        setup.config.skipImpactDelay = (reader.Read8() & 1) != 0;
+        setup.hostPlayerMask = reader.Read32();
+        setup.inputDelay = reader.Read8();
+        size_t mapLength = reader.Read8();
+        if (reader.failed || reader.offset + mapLength > packet.size()) return;
+        setup.mapFolder.assign(packet.begin() + reader.offset, packet.begin() + reader.offset + mapLength);
+        if (setup.config.numPlayers < Match::MIN_PLAYERS || setup.config.numPlayers > Match::MAX_PLAYERS) return;
+
+        if (m_status == Status::SYNCHRONIZING) {
+            SetSetup(setup);
+            m_status = Status::RUNNING;
+            std::cout << "Joined netplay match (seed " << setup.seed << ")" << std::endl;
+        }
+        // The host keeps sending the setup until this gets through
+        WriteHeader(m_packet, SETUP_ACK);
+        m_transport.Send(m_packet);
+        m_stats.packetsSent++;
+        break;
+    }
+    case SETUP_ACK:
+        if (m_isHost && m_hasSetup && m_status == Status::SYNCHRONIZING) {
+            m_status = Status::RUNNING;
+            std::cout << "Netplay peer joined" << std::endl;
+        }
+        break;
+    case INPUT: {
+        int frame = static_cast<int>(reader.Read32());
+        int advantage = static_cast<Sint8>(reader.Read8());
+        int ack = static_cast<int>(reader.Read32());
+        int start = static_cast<int>(reader.Read32());
+        int count = reader.Read8();
+        if (reader.failed || reader.offset + count * 2 > packet.size()) return;
+
+        // The guest's first inputs also complete the handshake
+        if (m_isHost && m_hasSetup && m_status == Status::SYNCHRONIZING) {
+            m_status = Status::RUNNING;
+        }
+        if (m_status != Status::RUNNING) return;
+
+        // Packets can arrive out of order: only move forward
+        if (frame >= m_remoteFrame) {
+            m_remoteFrame = frame;
+            m_remoteAdvantage = advantage;
+        }
+        m_remoteAckedFrame = std::max(m_remoteAckedFrame, std::min(ack, m_localInputFrame));
+        for (int i = 0; i < count; ++i) {
+            ReceiveRemoteInput(start + i, reader.Read16());
+        }
+
+        int hashFrame = static_cast<int>(reader.Read32());
+        Uint64 hash = reader.Read64();
+        if (!reader.failed && hashFrame > m_peerHashFrame) {
+            m_peerHashFrame = hashFrame;
+            m_peerHash = hash;
+            CheckPeerHash();
+        }
+        break;
+    }
+    case DESYNC: {
+        int frame = static_cast<int>(reader.Read32());
+        if (reader.failed || m_hasPeerDetail || m_desyncReported) return;
+        if (!m_peerDetail.Decode(packet.data() + reader.offset, packet.size() - reader.offset)) return;
+
+        m_peerDetail.step = frame;
+        m_hasPeerDetail = true;
+        if (m_desyncFrame < 0 || frame < m_desyncFrame) {
+            m_desyncFrame = frame;
+        }
+        CheckPeerHash();
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void RollbackSession::ReceiveRemoteInput(int frame, Uint16 buttons) {
+    // Inputs are taken strictly in order; the peer resends anything that was missed
+    if (frame != m_remoteConfirmedFrame + 1 || frame >= m_frame + INPUT_WINDOW / 2) return;
+
+    int slot = frame % INPUT_WINDOW;
+    if (frame < m_frame && m_usedRemote[slot] && m_remoteInputs[slot] != buttons) {
+        if (m_firstMispredictedFrame < 0 || frame < m_firstMispredictedFrame) {
+            m_firstMispredictedFrame = frame;
+        }
+    }
+    m_remoteInputs[slot] = buttons;
+    m_remoteConfirmedFrame = frame;
+}
+
+bool RollbackSession::ShouldWaitForPeer() {
+    // Every predicted frame has to stay inside the rollback window
+    if (m_frame - m_remoteConfirmedFrame > MAX_ROLLBACK) return true;
+    if (m_frame + m_setup.inputDelay - m_remoteAckedFrame > MAX_INPUTS_PER_PACKET) return true;
+
+    // Time sync: if we are further ahead of the peer than it is of us, let it catch up
+    int localAdvantage = m_frame - m_remoteFrame;
+    if ((localAdvantage - m_remoteAdvantage) / 2 >= 1 && m_frame - m_lastTimeSyncFrame >= TIME_SYNC_INTERVAL) {
+        m_lastTimeSyncFrame = m_frame;
+        return true;
+    }
+    return false;
+}
+
+bool RollbackSession::AdvanceFrame(Uint16 localButtons) {
+    if (m_status != Status::RUNNING || !m_match) return false;
+
+    if (m_firstMispredictedFrame >= 0) {
+        Rollback();
+    }
+
+    if (ShouldWaitForPeer()) {
+        m_stats.stallFrames++;
+        SendInputs();
+        return false;
+    }
+
+    int inputFrame = m_frame + m_setup.inputDelay;
+    m_localInputs[inputFrame % INPUT_WINDOW] = localButtons;
+    m_localInputFrame = inputFrame;
+
+    m_match->SaveState(m_states[m_frame % m_states.size()]);
+    StepFrame(m_frame);
+    m_frame++;
+    m_stats.framesSimulated++;
+
+    SendInputs();
+    ReportConfirmedFrames();
+    return true;
+}
+
+void RollbackSession::StepFrame(int frame) {
+    int slot = frame % INPUT_WINDOW;
+    int active = m_match->GetCurrentPlayerIndex();
+    bool remote = active >= 0 && active < Match::MAX_PLAYERS && !IsLocalPlayer(active);
+
+    MatchInput input;
+    if (remote) {
+        // Predict that the peer is still holding the same buttons
+        if (frame > m_remoteConfirmedFrame) {
+            m_remoteInputs[slot] = m_remoteConfirmedFrame >= 0 ? m_remoteInputs[m_remoteConfirmedFrame % INPUT_WINDOW] : 0;
+        }
+        input.buttons = m_remoteInputs[slot];
+    } else {
+        input.buttons = m_localInputs[slot];
+    }
+
+    m_usedRemote[slot] = remote;
+    m_usedInputs[slot] = input.buttons;
+    m_match->Step(input);
+    if (IsHashedFrame(frame)) {
+        m_match->ComputeStateHash(m_hashes[slot]);
+    }
+}
+
+void RollbackSession::Rollback() {
+    int target = m_firstMispredictedFrame;
+    m_firstMispredictedFrame = -1;
+    if (target >= m_frame) return;
+
+    auto startTime = std::chrono::steady_clock::now();
+    m_resimulating = true;
+
+    // Events of these frames were published when they were first predicted
+    EventBus* events = m_match->GetEventBus();
+    m_match->SetEventBus(nullptr);
+
+    m_match->LoadState(m_states[target % m_states.size()]);
+    for (int frame = target; frame < m_frame; ++frame) {
+        if (frame != target) {
+            m_match->SaveState(m_states[frame % m_states.size()]);
+        }
+        StepFrame(frame);
+    }
+
+    m_match->SetEventBus(events);
+    m_resimulating = false;
+    double ms = MillisecondsSince(startTime);
+    int depth = m_frame - target;
+    m_stats.rollbacks++;
+    m_stats.resimulatedFrames += depth;
+    m_stats.maxRollbackDepth = std::max(m_stats.maxRollbackDepth, depth);
+    m_stats.resimulationMs += ms;
+    m_stats.maxResimulationMs = std::max(m_stats.maxResimulationMs, ms);
+}
+
+void RollbackSession::ReportConfirmedFrames() {
+    if (m_firstMispredictedFrame >= 0) return;
+
+    int confirmed = GetConfirmedFrame();
+    while (m_lastReportedFrame < confirmed) {
+        m_lastReportedFrame++;
+        if (m_onFrameConfirmed) {
+            int slot = m_lastReportedFrame % INPUT_WINDOW;
+            MatchInput input;
+            input.buttons = m_usedInputs[slot];
+            m_onFrameConfirmed(input, IsHashedFrame(m_lastReportedFrame) ? m_hashes[slot].total : 0);
+        }
+    }
+    CheckPeerHash();
+}
+
+const StateHashDetail* RollbackSession::GetFrameHashes(int frame) const {
+    // Final once confirmed, and still in the ring until INPUT_WINDOW frames later
+    if (frame < 0 || frame > m_lastReportedFrame || m_frame - 1 - frame >= INPUT_WINDOW || !IsHashedFrame(frame)) {
+        return nullptr;
+    }
+    return &m_hashes[frame % INPUT_WINDOW];
+}
+
+void RollbackSession::CheckPeerHash() {
+    // The peer's newest confirmed hash, once this frame is confirmed here as well (packets
+    // repeat it until the next hashed frame; one compare is enough)
+    if (m_peerHashFrame > m_comparedHashFrame && m_peerHashFrame <= m_lastReportedFrame) {
+        const StateHashDetail* local = GetFrameHashes(m_peerHashFrame);
+        if (local) {
+            m_stats.hashesCompared++;
+            if (local->total != m_peerHash && m_desyncFrame < 0) {
+                m_desyncFrame = m_peerHashFrame;
+                std::cerr << "Netplay desync at frame " << m_desyncFrame << std::endl;
+                m_desyncResends = DESYNC_RESENDS;
+                SendDesync();
+            }
+        }
+        m_comparedHashFrame = m_peerHashFrame;
+    }
+
+    // The peer's hashes of the frame that differed name the part that diverged
+    if (!m_hasPeerDetail || m_desyncReported || m_peerDetail.step > m_lastReportedFrame) return;
+
+    const StateHashDetail* local = GetFrameHashes(m_peerDetail.step);
+    if (m_desyncResends == 0 && local) {
+        // Detected by the peer first: answer with the local side
+        m_desyncResends = DESYNC_RESENDS;
+        SendDesync();
+    }
+
+    std::string difference = local ? StateHashDetail::FirstDifference(*local, m_peerDetail) : "";
+    if (!local) {
+        difference = "unknown (frame no longer kept)";
+    } else if (difference.empty()) {
+        // Same state here; the peer must have compared against a stale frame
+        m_hasPeerDetail = false;
+        return;
+    }
+
+    m_desyncReported = true;
+    std::cerr << "Netplay desync at frame " << m_peerDetail.step << ": " << difference << " differs" << std::endl;
+    if (m_onDesync) {
+        m_onDesync(m_peerDetail.step, difference, local ? *local : m_peerDetail);
+    }
+}
+
+void RollbackSession::SendDesync() {
+    const StateHashDetail* local = GetFrameHashes(m_desyncFrame);
+    if (!local) return;
+
+    WriteHeader(m_packet, DESYNC);
+    Write32(m_packet, static_cast<Uint32>(m_desyncFrame));
+    local->Encode(m_packet);
+    m_transport.Send(m_packet);
+    m_stats.packetsSent++;
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "Match.h"
+#include "NetTransport.h"
+#include "Replay.h"
+#include "StateHash.h"
+
+// What both peers need to start the same match (sent by the host)
+struct NetplaySetup {
+    unsigned int seed;
+    MatchConfig config;
+    std::string mapFolder;  // "" = default terrain
+    Uint32 hostPlayerMask;  // Bit per player index controlled by the host, the rest belong to the guest
+    int inputDelay;         // Frames between sampling a local input and simulating it
+
+    NetplaySetup() : seed(0), hostPlayerMask(0x55555555), inputDelay(DEFAULT_INPUT_DELAY) {} // Host plays players 1, 3, 5... (team 1)
+
+    static constexpr int DEFAULT_INPUT_DELAY = 2; // Hides up to ~66 ms of RTT before rollback kicks in
+};
+
+struct RollbackStats {
+    int framesSimulated;   // Frames advanced (not counting re-simulation)
+    int stallFrames;       // Frames skipped waiting for the peer (rollback window full or time sync)
+    int rollbacks;
+    int resimulatedFrames;
+    int maxRollbackDepth;
+    double resimulationMs; // Wall time spent restoring and re-stepping
+    double maxResimulationMs;
+    int packetsSent;
+    int packetsReceived;
+    int hashesCompared;    // Confirmed frames checked against the peer's state hash
+
+    RollbackStats() : framesSimulated(0), stallFrames(0), rollbacks(0), resimulatedFrames(0), maxRollbackDepth(0),
+        resimulationMs(0.0), maxResimulationMs(0.0), packetsSent(0), packetsReceived(0), hashesCompared(0) {}
+};
+
+// Two-player netplay with input delay and rollback.
+//
+// Peers only exchange buttons. A local input sampled on frame F is scheduled for frame
+// F + inputDelay and sent (with every input the peer has not acknowledged yet) in each
+// packet. When the remote input for a frame is missing the last confirmed one is
+// repeated. When the real input arrives and differs on a frame that consumed it (the
+// match only reads the active player's buttons), the match is restored to the state
+// saved before that frame and re-stepped up to the present.
+//
+// Every HASH_INTERVAL-th frame is hashed (see StateHash), the same frames replays keep as
+// checkpoints. Each packet carries the hash of the newest confirmed hashed frame; when it
+// differs from the local one, both peers exchange the per-entity hashes of that frame to
+// name what diverged first.
+//
+// The session owns the frame count and steps the match itself: call AdvanceFrame once
+// per fixed step instead of Match::Step.
+class RollbackSession {
+public:
+    enum class Status { SYNCHRONIZING, RUNNING, DISCONNECTED };
+
+    RollbackSession(NetTransport& transport, bool isHost);
+
+    // Host: the match both peers will play (sent until the guest acknowledges it)
+    void SetSetup(const NetplaySetup& setup);
+    // Guest: valid once the status is RUNNING
+    const NetplaySetup& GetSetup() const { return m_setup; }
+
+    // Receive packets and run the handshake; call every frame
+    void Poll();
+
+    // Start driving a match initialized from the setup (seed set before Initialize)
+    void Start(Match& match);
+    // Schedule the local buttons and step one frame. Returns false if the frame was skipped
+    // to wait for the peer.
+    bool AdvanceFrame(Uint16 localButtons);
+
+    Status GetStatus() const { return m_status; }
+    bool IsHost() const { return m_isHost; }
+    bool IsLocalPlayer(int playerIndex) const { return (m_localPlayerMask >> playerIndex & 1u) != 0; }
+    int GetFrame() const { return m_frame; }
+    int GetConfirmedFrame() const; // Last frame simulated with final inputs from both peers
+    bool IsConfirmed() const { return GetConfirmedFrame() >= m_frame - 1; }
+    bool IsResimulating() const { return m_resimulating; }
+    const RollbackStats& GetStats() const { return m_stats; }
+
+    // Each frame once its inputs are final, in order, with the input the match used and the
+    // hash of the state it led to (replays; 0 on frames that aren't hashed)
+    void SetOnFrameConfirmed(std::function<void(const MatchInput&, Uint64 stateHash)> callback) {
+        m_onFrameConfirmed = callback;
+    }
+
+    // Called once if the peers' states diverge, with the first part that differs
+    // ("player 2", "terrain", ...) and the local hashes of that frame
+    void SetOnDesync(std::function<void(int frame, const std::string& difference, const StateHashDetail& local)> callback) {
+        m_onDesync = callback;
+    }
+    int GetDesyncFrame() const { return m_desyncFrame; } // -1 = in sync so far
+
+    static constexpr int MAX_ROLLBACK = 12;        // Frames simulated ahead of the last confirmed remote input
+    static constexpr int INPUT_WINDOW = 128;       // Ring size for inputs (frames)
+    static constexpr int MAX_INPUTS_PER_PACKET = 64;
+    static constexpr int DISCONNECT_FRAMES = 300;  // 5 seconds without a packet
+    static constexpr int TIME_SYNC_INTERVAL = 10;  // At most one time sync stall per this many frames
+    static constexpr int DESYNC_RESENDS = 30;      // Polls the local hash detail is resent after a desync
+    static constexpr int HASH_INTERVAL = ReplayData::HASH_INTERVAL; // Frames per hashed frame
+
+private:
+    void SendSetup();
+    void SendInputs();
+    void HandlePacket(const std::vector<Uint8>& packet);
+    void ReceiveRemoteInput(int frame, Uint16 buttons);
+    void CheckPeerHash();
+    void SendDesync();
+    const StateHashDetail* GetFrameHashes(int frame) const; // Final hashes of a confirmed frame
+    static bool IsHashedFrame(int frame) { return (frame + 1) % HASH_INTERVAL == 0; } // Step count multiple
+
+    void Rollback();
+    void StepFrame(int frame);
+    void ReportConfirmedFrames();
+    void ResetFrames();
+    bool ShouldWaitForPeer();
+
+    NetTransport& m_transport;
+    bool m_isHost;
+    Status m_status;
+    NetplaySetup m_setup;
+    bool m_hasSetup;
+    Match* m_match;
+    Uint32 m_localPlayerMask;
+
+    int m_frame;                // Next frame to simulate
+    int m_localInputFrame;      // Last frame with a scheduled local input
+    int m_remoteConfirmedFrame; // Last frame up to which every remote input has arrived
+    int m_remoteAckedFrame;     // Last local input frame the peer has received
+    int m_remoteFrame;          // Peer's frame as of its last packet
+    int m_remoteAdvantage;      // How far the peer thinks it is ahead of us
+    int m_firstMispredictedFrame; // -1 = none
+    int m_lastReportedFrame;
+    int m_lastTimeSyncFrame;
+    int m_framesWithoutPacket;
+    bool m_resimulating;
+    bool m_sentSincePoll;
+    int m_peerHashFrame;        // Peer's newest confirmed frame hash (-1 = none)
+    int m_comparedHashFrame;    // Newest frame already compared with the peer's hash (-1 = none)
+    Uint64 m_peerHash;
+    int m_desyncFrame;
+    int m_desyncResends;
+    bool m_hasPeerDetail;       // Peer's hashes for the desync frame, not compared yet
+    bool m_desyncReported;
+    StateHashDetail m_peerDetail;
+
+    Uint16 m_localInputs[INPUT_WINDOW];
+    Uint16 m_remoteInputs[INPUT_WINDOW];  // Confirmed, or the prediction used for the frame
+    Uint16 m_usedInputs[INPUT_WINDOW];    // Buttons the match stepped with
+    bool m_usedRemote[INPUT_WINDOW];      // The frame's active player belonged to the peer
+    std::vector<MatchState> m_states;     // State before each frame in the rollback window
+    std::vector<StateHashDetail> m_hashes; // State after each frame, by input slot
+
+    std::vector<Uint8> m_packet; // Outgoing
+    std::vector<Uint8> m_receivedPacket;
+    RollbackStats m_stats;
+    std::function<void(const MatchInput&, Uint64)> m_onFrameConfirmed;
+    std::function<void(int, const std::string&, const StateHashDetail&)> m_onDesync;
+};
@@ -1,18 +1,36 @@
 #include "SkillOrb.h"
 #include "Player.h"
+#include "Profiler.h"
 #include "Renderer.h"
+#include "StateHash.h"
 #include <cmath>
 #include <iostream>
 
+SkillOrb::SkillOrb() : SkillOrb(Vector2(), SkillType::SPLIT_THROW, 0) {
+}
+
 SkillOrb::SkillOrb(const Vector2& position, SkillType skillType, int spawnTurn)
     : m_position(position), m_radius(DEFAULT_RADIUS), m_skillType(skillType),
     m_collected(false), m_spawnTurn(spawnTurn), m_animTime(0.0f),
-    m_bobOffset(0.0f), m_bobSpeed(BOB_SPEED), m_texture(nullptr) {
+    m_bobOffset(0.0f), m_bobSpeed(BOB_SPEED), m_texture(nullptr), m_textureSkill(skillType),
+    m_stateHash(0), m_hashDirty(true) {
+}
+
+void SkillOrb::Respawn(const Vector2& position, SkillType skillType, int spawnTurn) {
+    m_position = position;
+    m_radius = DEFAULT_RADIUS;
+    m_skillType = skillType;
+    m_collected = false;
+    m_spawnTurn = spawnTurn;
+    m_animTime = 0.0f;
+    m_bobOffset = 0.0f;
+    m_bobSpeed = BOB_SPEED;
+    m_hashDirty = true;
 }
 
 SkillOrb::~SkillOrb() {
     if (m_texture) {
-        SDL_DestroyTexture(m_texture);
+        Renderer::DestroyTexture(m_texture);
         m_texture = nullptr;
     }
 }
@@ -24,9 +42,53 @@ void SkillOrb::Update(float deltaTime) {
     UpdateAnimation(deltaTime);
 }
 
+SkillOrb::SavedState SkillOrb::SaveState() const {
+    SavedState state;
+    state.position = m_position;
+    state.skillType = m_skillType;
+    state.collected = m_collected;
+    state.spawnTurn = m_spawnTurn;
+    state.animTime = m_animTime;
+    state.bobOffset = m_bobOffset;
+    return state;
+}
+
+Uint64 SkillOrb::ComputeStateHash() const {
+    // The animation timers only move the sprite, and would dirty every orb every step
+    if (!m_hashDirty) return m_stateHash;
+
+    StateHasher hasher;
+    hasher.Add(m_position);
+    hasher.Add(static_cast<int>(m_skillType));
+    hasher.Add(m_collected);
+    hasher.Add(m_spawnTurn);
+    m_stateHash = hasher.Get();
+    m_hashDirty = false;
+    return m_stateHash;
+}
+
+void SkillOrb::LoadState(const SavedState& state) {
+    m_position = state.position;
+    m_skillType = state.skillType;
+    m_collected = state.collected;
+    m_spawnTurn = state.spawnTurn;
+    m_animTime = state.animTime;
+    m_bobOffset = state.bobOffset;
+    m_hashDirty = true;
+}
+
 bool SkillOrb::LoadTexture(Renderer* renderer) {
+    PROFILE_ZONE("SkillOrb::LoadTexture");
+
     if (!renderer) return false;
 
+    // Pool slots are reused; only a different skill needs a different texture
+    if (m_texture && m_textureSkill == m_skillType) return true;
+    if (m_texture) {
+        Renderer::DestroyTexture(m_texture);
+        m_texture = nullptr;
+    }
+
     std::string texturePath = GetTexturePath();
     SDL_Surface* surface = IMG_Load(texturePath.c_str());
     if (!surface) {
@@ -34,13 +96,14 @@ bool SkillOrb::LoadTexture(Renderer* renderer) {
         return false;
     }
 
-    m_texture = SDL_CreateTextureFromSurface(renderer->GetSDLRenderer(), surface);
+    m_texture = renderer->CreateTextureFromSurface(surface);
     SDL_DestroySurface(surface);
 
     if (!m_texture) {
         std::cerr << "Failed to create skill orb texture: " << SDL_GetError() << std::endl;
         return false;
     }
+    m_textureSkill = m_skillType;
 
     return true;
 }
@@ -66,7 +129,7 @@ void SkillOrb::Draw(Renderer* renderer) const {
             textureSize,
             textureSize
         };
-        SDL_RenderTexture(renderer->GetSDLRenderer(), m_texture, nullptr, &destRect);
+        renderer->DrawTexture(m_texture, nullptr, &destRect);
     }
 }
 
@@ -76,6 +139,7 @@ void SkillOrb::OnCollected(Player* player) {
     // Try to add to inventory - only collect if there's space
     if (player->AddSkillToInventory(static_cast<int>(m_skillType))) {
         m_collected = true;
+        m_hashDirty = true;
         // No immediate effect - skills are used from inventory with keybinds
     }
 }
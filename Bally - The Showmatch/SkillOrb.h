@@ -2,6 +2,7 @@
 
 #include "Vector2.h"
 #include "UI.h"
+#include "ObjectPool.h"
 #include <SDL3/SDL.h>
 #include <SDL3_image/SDL_image.h>
 
@@ -10,24 +11,42 @@ class Renderer;
 
 class SkillOrb {
 public:
+    SkillOrb(); // Empty pool slot, Respawn before use
     SkillOrb(const Vector2& position, SkillType skillType, int spawnTurn);
     ~SkillOrb();
 
+    // Start over as a new orb; the texture stays if the skill is the same
+    void Respawn(const Vector2& position, SkillType skillType, int spawnTurn);
+
     void Update(float deltaTime);
     void Draw(Renderer* renderer) const;
     void OnCollected(Player* player);
-    bool IsExpired(int currentTurn, int playerCount) const { return currentTurn >= m_spawnTurn + (playerCount - 1); }
+    bool IsExpired(int currentTurn, int lifetimeTurns) const { return currentTurn >= m_spawnTurn + lifetimeTurns; }
 
     const Vector2& GetPosition() const { return m_position; }
     float GetRadius() const { return m_radius; }
     SkillType GetSkillType() const { return m_skillType; }
+    int GetSpawnTurn() const { return m_spawnTurn; }
     bool IsCollected() const { return m_collected; }
     bool IsActive() const { return !m_collected; }
 
-    void SetPosition(const Vector2& position) { m_position = position; }
-    void SetCollected(bool collected) { m_collected = collected; }
+    void SetPosition(const Vector2& position) { m_position = position; m_hashDirty = true; }
+    void SetCollected(bool collected) { m_collected = collected; m_hashDirty = true; }
+
+    // Simulation state without the texture (keyframes rebuild orbs from this)
+    struct SavedState {
+        Vector2 position;
+        SkillType skillType;
+        bool collected;
+        int spawnTurn;
+        float animTime;
+        float bobOffset;
+    };
+    SavedState SaveState() const;
+    void LoadState(const SavedState& state);
+    Uint64 ComputeStateHash() const; // Cached until the orb changes; the bobbing isn't hashed
 
-    // Texture loading
+    // Texture loading (kept while the orb keeps its skill type)
     bool LoadTexture(Renderer* renderer);
 
     // Skill effects
@@ -36,6 +55,9 @@ public:
     static void ApplyEnhancedExplosiveSkill(Player* player);
     static void ApplyTeleportSkill(Player* player);
 
+    static constexpr float DEFAULT_RADIUS = 15.0f;
+    static constexpr int MAX_LIVE = 32; // A match never holds more than two spawn waves
+
 private:
     Vector2 m_position;
     float m_radius;
@@ -46,14 +68,18 @@ private:
     float m_bobOffset;
     float m_bobSpeed;
     SDL_Texture* m_texture; // Texture for the skill orb
+    SkillType m_textureSkill; // Skill the texture was loaded for
+    mutable Uint64 m_stateHash;
+    mutable bool m_hashDirty;
 
     // Animation
     void UpdateAnimation(float deltaTime);
     std::string GetTexturePath() const;
 
     // Constants
-    static constexpr float DEFAULT_RADIUS = 15.0f;
     static constexpr float MAX_LIFETIME = 30.0f;
     static constexpr float BOB_SPEED = 3.0f;
     static constexpr float BOB_AMPLITUDE = 5.0f;
 };
+
+using SkillOrbPool = ObjectPool<SkillOrb, SkillOrb::MAX_LIVE>;
@@ -0,0 +1,63 @@
+#pragma once
+
+// Thin portability layer over Winsock and BSD sockets (include from .cpp files only).
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+
+typedef SOCKET SocketHandle;
+typedef int SocketLength;
+static const SocketHandle NO_SOCKET = INVALID_SOCKET;
+
+inline bool StartSockets() {
+    WSADATA wsaData;
+    return WSAStartup(MAKEWORD(2, 2), &wsaData) == 0;
+}
+inline void StopSockets() { WSACleanup(); }
+inline void CloseSocket(SocketHandle socket) { closesocket(socket); }
+inline void SetNonBlocking(SocketHandle socket) {
+    u_long nonBlocking = 1;
+    ioctlsocket(socket, FIONBIO, &nonBlocking);
+}
+inline int PollSockets(pollfd* sockets, size_t count, int timeoutMs) {
+    return WSAPoll(sockets, static_cast<ULONG>(count), timeoutMs);
+}
+inline bool SocketWouldBlock() { return WSAGetLastError() == WSAEWOULDBLOCK; }
+#else
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+typedef int SocketHandle;
+typedef socklen_t SocketLength;
+static const SocketHandle NO_SOCKET = -1;
+
+inline bool StartSockets() { return true; }
+inline void StopSockets() {}
+inline void CloseSocket(SocketHandle socket) { close(socket); }
+inline void SetNonBlocking(SocketHandle socket) { fcntl(socket, F_SETFL, fcntl(socket, F_GETFL, 0) | O_NONBLOCK); }
+inline int PollSockets(pollfd* sockets, size_t count, int timeoutMs) {
+    return poll(sockets, static_cast<nfds_t>(count), timeoutMs);
+}
+inline bool SocketWouldBlock() { return errno == EWOULDBLOCK || errno == EAGAIN; }
+#endif
+
+// A peer that went away must fail the send, not raise SIGPIPE
+#ifdef MSG_NOSIGNAL
+static const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+static const int SEND_FLAGS = 0;
+#endif
+
+// Socket handles are stored as long long in headers that must not include this file
+inline SocketHandle ToSocket(long long handle) { return static_cast<SocketHandle>(handle); }
@@ -0,0 +1,464 @@
+#include "SpectatorStream.h"
+#include "ByteStream.h"
+#include "MatchSnapshot.h"
+#include <cmath>
+
+namespace {
+
+enum TurnField : Uint8 {
+    TURN_PLAYER = 1 << 0,
+    TURN_COUNTER = 1 << 1,
+    TURN_TIMER = 1 << 2,
+    TURN_FLAGS = 1 << 3,
+    TURN_WINNER = 1 << 4,
+    TURN_IMPACT_DELAY = 1 << 5
+};
+
+enum PlayerField : Uint32 {
+    PLAYER_POSITION = 1 << 0,
+    PLAYER_AIM = 1 << 1,    // Angle, power
+    PLAYER_HEALTH = 1 << 2, // Health, max health, last health
+    PLAYER_STATE = 1 << 3,  // State, grounded, facing, input flags
+    PLAYER_HURT = 1 << 4,
+    PLAYER_TEAM = 1 << 5,
+    PLAYER_SKILLS = 1 << 6
+};
+
+// Projectile kind byte: a full record, or the residuals that are non-zero (x, y, vx, vy)
+constexpr Uint8 PROJECTILE_FULL = 0x80;
+
+// Longer gaps send projectiles in full rather than simulating the flight that far
+constexpr int MAX_PREDICTED_STEPS = 60;
+
+int Quantize(float value, float scale) { return static_cast<int>(std::lround(value * scale)); }
+float Dequantize(int value, float scale) { return static_cast<float>(value) / scale; }
+
+void BeginFrame(std::vector<Uint8>& frame, SpectatorFrameType type) {
+    frame.clear();
+    frame.resize(SpectatorDecoder::HEADER_SIZE, 0);
+    frame[4] = static_cast<Uint8>(type);
+}
+
+void EndFrame(std::vector<Uint8>& frame) {
+    Uint32 length = static_cast<Uint32>(frame.size() - 4);
+    for (int i = 0; i < 4; ++i) {
+        frame[i] = static_cast<Uint8>(length >> (i * 8));
+    }
+}
+
+Uint8 TurnFlags(const MatchState& state) {
+    return (state.gameStarted ? 1 : 0) | (state.gameEnded ? 2 : 0) |
+        (state.waitingForProjectiles ? 4 : 0) | (state.impactDelayActive ? 8 : 0);
+}
+
+Uint8 PlayerFlags(const Player::SavedState& player) {
+    return (player.grounded ? 1 : 0) | (player.facingRight ? 2 : 0);
+}
+
+Uint8 ProjectileFlags(const Projectile::SavedState& projectile) {
+    return (projectile.active ? 1 : 0) | (projectile.hasSplit ? 2 : 0) | (projectile.hasPowerBall ? 4 : 0) |
+        (projectile.hasExplosiveBall ? 8 : 0) | (projectile.hasTeleportBall ? 16 : 0) | (projectile.hasHeal ? 32 : 0);
+}
+
+void SetProjectileFlags(Projectile::SavedState& projectile, Uint8 flags) {
+    projectile.active = (flags & 1) != 0;
+    projectile.hasSplit = (flags & 2) != 0;
+    projectile.hasPowerBall = (flags & 4) != 0;
+    projectile.hasExplosiveBall = (flags & 8) != 0;
+    projectile.hasTeleportBall = (flags & 16) != 0;
+    projectile.hasHeal = (flags & 32) != 0;
+}
+
+void WriteList(std::vector<Uint8>& out, const std::vector<int>& values) {
+    WriteVarint(out, static_cast<Uint32>(values.size()));
+    for (int value : values) {
+        WriteVarint(out, ZigZag(value));
+    }
+}
+
+void ReadList(ByteReader& reader, std::vector<int>& values) {
+    Uint32 count = reader.ReadVarint();
+    if (count > reader.size - reader.offset) {
+        reader.failed = true;
+        return;
+    }
+    values.resize(count);
+    for (int& value : values) {
+        value = UnZigZag(reader.ReadVarint());
+    }
+}
+
+bool SameCrater(const TerrainCrater& a, const TerrainCrater& b) {
+    return a.center.x == b.center.x && a.center.y == b.center.y && a.radius == b.radius;
+}
+
+Uint32 ChangedPlayerFields(const Player::SavedState& view, const Player::SavedState& actual) {
+    const float scale = SpectatorEncoder::POSITION_SCALE;
+    Uint32 mask = 0;
+    if (Quantize(actual.position.x, scale) != Quantize(view.position.x, scale) ||
+        Quantize(actual.position.y, scale) != Quantize(view.position.y, scale)) {
+        mask |= PLAYER_POSITION;
+    }
+    if (actual.angle != view.angle || actual.power != view.power) mask |= PLAYER_AIM;
+    if (actual.health != view.health || actual.maxHealth != view.maxHealth || actual.lastHealth != view.lastHealth) {
+        mask |= PLAYER_HEALTH;
+    }
+    if (actual.state != view.state || PlayerFlags(actual) != PlayerFlags(view) || actual.inputFlags != view.inputFlags) {
+        mask |= PLAYER_STATE;
+    }
+    if (actual.hurtAnimationTimer != view.hurtAnimationTimer) mask |= PLAYER_HURT;
+    if (actual.team != view.team) mask |= PLAYER_TEAM;
+    if (actual.availableSkills != view.availableSkills || actual.inventory != view.inventory ||
+        actual.selectedSkills != view.selectedSkills) {
+        mask |= PLAYER_SKILLS;
+    }
+    return mask;
+}
+
+bool SkillOrbsChanged(const std::vector<SkillOrb::SavedState>& view, const std::vector<SkillOrb::SavedState>& actual) {
+    if (view.size() != actual.size()) return true;
+    for (size_t i = 0; i < view.size(); ++i) {
+        // Animation phase is left to the spectator
+        if (view[i].position.x != actual[i].position.x || view[i].position.y != actual[i].position.y ||
+            view[i].skillType != actual[i].skillType || view[i].collected != actual[i].collected ||
+            view[i].spawnTurn != actual[i].spawnTurn) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Where the spectator expects a projectile after some steps of free flight
+Projectile::SavedState PredictFlight(const Projectile::SavedState& state, int steps) {
+    Projectile projectile(state.position, state.velocity, state.type, state.ownerId);
+    projectile.LoadState(state);
+    for (int i = 0; i < steps; ++i) {
+        projectile.Update(Match::STEP_DURATION);
+    }
+    return projectile.SaveState();
+}
+
+void WriteProjectile(std::vector<Uint8>& out, const Projectile::SavedState& projectile) {
+    out.push_back(PROJECTILE_FULL);
+    WriteFloat(out, projectile.position.x);
+    WriteFloat(out, projectile.position.y);
+    WriteFloat(out, projectile.velocity.x);
+    WriteFloat(out, projectile.velocity.y);
+    WriteFloat(out, projectile.radius);
+    WriteFloat(out, projectile.mass);
+    out.push_back(static_cast<Uint8>(projectile.type));
+    WriteVarint(out, ZigZag(projectile.ownerId));
+    out.push_back(ProjectileFlags(projectile));
+    WriteFloat(out, projectile.lifetime);
+    WriteFloat(out, projectile.maxLifetime);
+}
+
+void ReadProjectile(ByteReader& reader, Projectile::SavedState& projectile) {
+    projectile.position.x = reader.ReadFloat();
+    projectile.position.y = reader.ReadFloat();
+    projectile.velocity.x = reader.ReadFloat();
+    projectile.velocity.y = reader.ReadFloat();
+    projectile.acceleration = Vector2::Zero();
+    projectile.radius = reader.ReadFloat();
+    projectile.mass = reader.ReadFloat();
+    projectile.type = static_cast<ProjectileType>(reader.ReadByte());
+    projectile.ownerId = UnZigZag(reader.ReadVarint());
+    SetProjectileFlags(projectile, reader.ReadByte());
+    projectile.lifetime = reader.ReadFloat();
+    projectile.maxLifetime = reader.ReadFloat();
+}
+
+}
+
+SpectatorDecoder::SpectatorDecoder() : m_view(), m_hasKeyframe(false) {
+}
+
+bool SpectatorDecoder::PeekFrameSize(const Uint8* data, size_t available, size_t& frameSize) {
+    if (available < 4) return false;
+    Uint32 length = static_cast<Uint32>(data[0]) | (static_cast<Uint32>(data[1]) << 8) |
+        (static_cast<Uint32>(data[2]) << 16) | (static_cast<Uint32>(data[3]) << 24);
+    frameSize = static_cast<size_t>(length) + 4;
+    return true;
+}
+
+bool SpectatorDecoder::ApplyFrame(const Uint8* frame, size_t size) {
+    size_t frameSize = 0;
+    if (size < HEADER_SIZE || !PeekFrameSize(frame, size, frameSize) || frameSize != size) {
+        return false;
+    }
+
+    const Uint8* payload = frame + HEADER_SIZE;
+    size_t payloadSize = size - HEADER_SIZE;
+    switch (static_cast<SpectatorFrameType>(frame[4])) {
+    case SpectatorFrameType::KEYFRAME:
+        m_hasKeyframe = MatchSnapshot::Read(payload, payloadSize, m_view);
+        return m_hasKeyframe;
+    case SpectatorFrameType::DELTA:
+        if (!m_hasKeyframe) return false;
+        // A bad delta leaves the view half updated; only a keyframe can recover it
+        m_hasKeyframe = ApplyDelta(payload, payloadSize);
+        return m_hasKeyframe;
+    default:
+        return false;
+    }
+}
+
+bool SpectatorDecoder::ApplyDelta(const Uint8* data, size_t size) {
+    ByteReader reader(data, size);
+    MatchState& view = m_view;
+    const float scale = SpectatorEncoder::POSITION_SCALE;
+    const float timerScale = SpectatorEncoder::TIMER_SCALE;
+
+    int steps = static_cast<int>(reader.ReadVarint());
+    view.stepCount += steps;
+
+    Uint8 turnMask = reader.ReadByte();
+    if (turnMask & TURN_PLAYER) view.currentPlayerIndex = UnZigZag(reader.ReadVarint());
+    if (turnMask & TURN_COUNTER) view.turnCounter = UnZigZag(reader.ReadVarint());
+    if (turnMask & TURN_TIMER) {
+        view.turnTimer = Dequantize(Quantize(view.turnTimer, timerScale) + UnZigZag(reader.ReadVarint()), timerScale);
+    }
+    if (turnMask & TURN_FLAGS) {
+        Uint8 flags = reader.ReadByte();
+        view.gameStarted = (flags & 1) != 0;
+        view.gameEnded = (flags & 2) != 0;
+        view.waitingForProjectiles = (flags & 4) != 0;
+        view.impactDelayActive = (flags & 8) != 0;
+    }
+    if (turnMask & TURN_WINNER) view.winnerId = UnZigZag(reader.ReadVarint());
+    if (turnMask & TURN_IMPACT_DELAY) {
+        view.impactDelayTimer = Dequantize(Quantize(view.impactDelayTimer, timerScale) + UnZigZag(reader.ReadVarint()),
+            timerScale);
+    }
+
+    for (Player::SavedState& player : view.players) {
+        Uint32 mask = reader.ReadVarint();
+        if (mask & PLAYER_POSITION) {
+            player.position.x = Dequantize(Quantize(player.position.x, scale) + UnZigZag(reader.ReadVarint()), scale);
+            player.position.y = Dequantize(Quantize(player.position.y, scale) + UnZigZag(reader.ReadVarint()), scale);
+        }
+        if (mask & PLAYER_AIM) {
+            player.angle = reader.ReadFloat();
+            player.power = reader.ReadFloat();
+        }
+        if (mask & PLAYER_HEALTH) {
+            player.health = reader.ReadFloat();
+            player.maxHealth = reader.ReadFloat();
+            player.lastHealth = reader.ReadFloat();
+        }
+        if (mask & PLAYER_STATE) {
+            player.state = static_cast<PlayerState>(reader.ReadByte());
+            Uint8 flags = reader.ReadByte();
+            player.grounded = (flags & 1) != 0;
+            player.facingRight = (flags & 2) != 0;
+            player.inputFlags = reader.ReadByte();
+        }
+        if (mask & PLAYER_HURT) player.hurtAnimationTimer = reader.ReadFloat();
+        if (mask & PLAYER_TEAM) player.team = UnZigZag(reader.ReadVarint());
+        if (mask & PLAYER_SKILLS) {
+            ReadList(reader, player.availableSkills);
+            ReadList(reader, player.inventory);
+            ReadList(reader, player.selectedSkills);
+        }
+        if (reader.failed) return false;
+    }
+
+    Uint32 projectileCount = reader.ReadVarint();
+    if (projectileCount > size) return false;
+    std::vector<Projectile::SavedState> projectiles(projectileCount);
+    for (Uint32 i = 0; i < projectileCount; ++i) {
+        Uint8 kind = reader.ReadByte();
+        if (kind & PROJECTILE_FULL) {
+            ReadProjectile(reader, projectiles[i]);
+            continue;
+        }
+        if (i >= view.projectiles.size() || steps > MAX_PREDICTED_STEPS) return false;
+
+        Projectile::SavedState& projectile = projectiles[i];
+        projectile = PredictFlight(view.projectiles[i], steps);
+        int residuals[4] = { 0, 0, 0, 0 };
+        for (int r = 0; r < 4; ++r) {
+            if (kind & (1 << r)) residuals[r] = UnZigZag(reader.ReadVarint());
+        }
+        projectile.position.x = Dequantize(Quantize(projectile.position.x, scale) + residuals[0], scale);
+        projectile.position.y = Dequantize(Quantize(projectile.position.y, scale) + residuals[1], scale);
+        projectile.velocity.x = Dequantize(Quantize(projectile.velocity.x, scale) + residuals[2], scale);
+        projectile.velocity.y = Dequantize(Quantize(projectile.velocity.y, scale) + residuals[3], scale);
+    }
+    view.projectiles.swap(projectiles);
+
+    if (reader.ReadByte()) {
+        Uint32 orbCount = reader.ReadVarint();
+        if (orbCount > size) return false;
+        std::vector<SkillOrb::SavedState> orbs(orbCount);
+        for (Uint32 i = 0; i < orbCount; ++i) {
+            SkillOrb::SavedState& orb = orbs[i];
+            orb.position.x = reader.ReadFloat();
+            orb.position.y = reader.ReadFloat();
+            orb.skillType = static_cast<SkillType>(reader.ReadByte());
+            orb.collected = reader.ReadByte() != 0;
+            orb.spawnTurn = UnZigZag(reader.ReadVarint());
+            orb.animTime = i < view.skillOrbs.size() ? view.skillOrbs[i].animTime : 0.0f;
+            orb.bobOffset = i < view.skillOrbs.size() ? view.skillOrbs[i].bobOffset : 0.0f;
+        }
+        view.skillOrbs.swap(orbs);
+    }
+
+    Uint32 craterCount = reader.ReadVarint();
+    if (craterCount > size) return false;
+    for (Uint32 i = 0; i < craterCount; ++i) {
+        TerrainCrater crater;
+        crater.center.x = reader.ReadFloat();
+        crater.center.y = reader.ReadFloat();
+        crater.radius = reader.ReadFloat();
+        view.craters.push_back(crater);
+    }
+
+    return !reader.failed && reader.AtEnd();
+}
+
+bool SpectatorEncoder::EncodeDelta(const MatchState& state, std::vector<Uint8>& frame) {
+    if (!m_view.HasKeyframe()) return false;
+
+    const MatchState& view = m_view.GetView();
+    int steps = state.stepCount - view.stepCount;
+    if (steps < 0 || state.players.size() != view.players.size() || state.craters.size() < view.craters.size()) {
+        return false;
+    }
+    // Craters are only ever appended; anything else means the terrain was rebuilt
+    if (!view.craters.empty() && !SameCrater(view.craters.back(), state.craters[view.craters.size() - 1])) {
+        return false;
+    }
+
+    BeginFrame(frame, SpectatorFrameType::DELTA);
+    WriteVarint(frame, static_cast<Uint32>(steps));
+
+    // Turn state
+    int timerStep = Quantize(state.turnTimer, TIMER_SCALE) - Quantize(view.turnTimer, TIMER_SCALE);
+    int impactStep = Quantize(state.impactDelayTimer, TIMER_SCALE) - Quantize(view.impactDelayTimer, TIMER_SCALE);
+    Uint8 turnMask = 0;
+    if (state.currentPlayerIndex != view.currentPlayerIndex) turnMask |= TURN_PLAYER;
+    if (state.turnCounter != view.turnCounter) turnMask |= TURN_COUNTER;
+    if (timerStep != 0) turnMask |= TURN_TIMER;
+    if (TurnFlags(state) != TurnFlags(view)) turnMask |= TURN_FLAGS;
+    if (state.winnerId != view.winnerId) turnMask |= TURN_WINNER;
+    if (impactStep != 0) turnMask |= TURN_IMPACT_DELAY;
+    frame.push_back(turnMask);
+    if (turnMask & TURN_PLAYER) WriteVarint(frame, ZigZag(state.currentPlayerIndex));
+    if (turnMask & TURN_COUNTER) WriteVarint(frame, ZigZag(state.turnCounter));
+    if (turnMask & TURN_TIMER) WriteVarint(frame, ZigZag(timerStep));
+    if (turnMask & TURN_FLAGS) frame.push_back(TurnFlags(state));
+    if (turnMask & TURN_WINNER) WriteVarint(frame, ZigZag(state.winnerId));
+    if (turnMask & TURN_IMPACT_DELAY) WriteVarint(frame, ZigZag(impactStep));
+
+    // Players: only the fields that changed
+    for (size_t i = 0; i < state.players.size(); ++i) {
+        const Player::SavedState& actual = state.players[i];
+        const Player::SavedState& seen = view.players[i];
+        Uint32 mask = ChangedPlayerFields(seen, actual);
+        WriteVarint(frame, mask);
+        if (mask & PLAYER_POSITION) {
+            WriteVarint(frame, ZigZag(Quantize(actual.position.x, POSITION_SCALE) - Quantize(seen.position.x, POSITION_SCALE)));
+            WriteVarint(frame, ZigZag(Quantize(actual.position.y, POSITION_SCALE) - Quantize(seen.position.y, POSITION_SCALE)));
+        }
+        if (mask & PLAYER_AIM) {
+            WriteFloat(frame, actual.angle);
+            WriteFloat(frame, actual.power);
+        }
+        if (mask & PLAYER_HEALTH) {
+            WriteFloat(frame, actual.health);
+            WriteFloat(frame, actual.maxHealth);
+            WriteFloat(frame, actual.lastHealth);
+        }
+        if (mask & PLAYER_STATE) {
+            frame.push_back(static_cast<Uint8>(actual.state));
+            frame.push_back(PlayerFlags(actual));
+            frame.push_back(actual.inputFlags);
+        }
+        if (mask & PLAYER_HURT) WriteFloat(frame, actual.hurtAnimationTimer);
+        if (mask & PLAYER_TEAM) WriteVarint(frame, ZigZag(actual.team));
+        if (mask & PLAYER_SKILLS) {
+            WriteList(frame, actual.availableSkills);
+            WriteList(frame, actual.inventory);
+            WriteList(frame, actual.selectedSkills);
+        }
+    }
+
+    // Projectiles: what differs from the flight the spectator predicts on its own
+    WriteVarint(frame, static_cast<Uint32>(state.projectiles.size()));
+    for (size_t i = 0; i < state.projectiles.size(); ++i) {
+        const Projectile::SavedState& actual = state.projectiles[i];
+        bool predictable = i < view.projectiles.size() && steps <= MAX_PREDICTED_STEPS &&
+            view.projectiles[i].type == actual.type && view.projectiles[i].ownerId == actual.ownerId &&
+            ProjectileFlags(view.projectiles[i]) == ProjectileFlags(actual);
+        if (!predictable) {
+            WriteProjectile(frame, actual);
+            continue;
+        }
+
+        Projectile::SavedState predicted = PredictFlight(view.projectiles[i], steps);
+        if (predicted.active != actual.active) {
+            WriteProjectile(frame, actual);
+            continue;
+        }
+        int residuals[4] = {
+            Quantize(actual.position.x, POSITION_SCALE) - Quantize(predicted.position.x, POSITION_SCALE),
+            Quantize(actual.position.y, POSITION_SCALE) - Quantize(predicted.position.y, POSITION_SCALE),
+            Quantize(actual.velocity.x, POSITION_SCALE) - Quantize(predicted.velocity.x, POSITION_SCALE),
+            Quantize(actual.velocity.y, POSITION_SCALE) - Quantize(predicted.velocity.y, POSITION_SCALE)
+        };
+        Uint8 kind = 0;
+        for (int r = 0; r < 4; ++r) {
+            if (residuals[r] != 0) kind |= static_cast<Uint8>(1 << r);
+        }
+        frame.push_back(kind);
+        for (int r = 0; r < 4; ++r) {
+            if (residuals[r] != 0) WriteVarint(frame, ZigZag(residuals[r]));
+        }
+    }
+
+    // Skill orbs rarely change; resend the list when they do
+    if (SkillOrbsChanged(view.skillOrbs, state.skillOrbs)) {
+        frame.push_back(1);
+        WriteVarint(frame, static_cast<Uint32>(state.skillOrbs.size()));
+        for (const SkillOrb::SavedState& orb : state.skillOrbs) {
+            WriteFloat(frame, orb.position.x);
+            WriteFloat(frame, orb.position.y);
+            frame.push_back(static_cast<Uint8>(orb.skillType));
+            frame.push_back(orb.collected ? 1 : 0);
+            WriteVarint(frame, ZigZag(orb.spawnTurn));
+        }
+    }
+    else {
+        frame.push_back(0);
+    }
+
+    // Terrain: the craters carved since the last frame
+    WriteVarint(frame, static_cast<Uint32>(state.craters.size() - view.craters.size()));
+    for (size_t i = view.craters.size(); i < state.craters.size(); ++i) {
+        WriteFloat(frame, state.craters[i].center.x);
+        WriteFloat(frame, state.craters[i].center.y);
+        WriteFloat(frame, state.craters[i].radius);
+    }
+
+    EndFrame(frame);
+
+    // Move the view exactly the way every spectator will
+    m_view.ApplyFrame(frame.data(), frame.size());
+    return true;
+}
+
+void SpectatorEncoder::EncodeKeyframe(const MatchState& state, std::vector<Uint8>& frame) {
+    MatchSnapshot::Write(state, frame);
+    frame.insert(frame.begin(), SpectatorDecoder::HEADER_SIZE, 0);
+    frame[4] = static_cast<Uint8>(SpectatorFrameType::KEYFRAME);
+    EndFrame(frame);
+    m_view.ApplyFrame(frame.data(), frame.size());
+}
+
+void SpectatorEncoder::EncodeViewKeyframe(std::vector<Uint8>& frame) const {
+    MatchSnapshot::Write(m_view.GetView(), frame);
+    frame.insert(frame.begin(), SpectatorDecoder::HEADER_SIZE, 0);
+    frame[4] = static_cast<Uint8>(SpectatorFrameType::KEYFRAME);
+    EndFrame(frame);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include <SDL3/SDL.h>
+#include "Match.h"
+
+// Spectator stream: a keyframe, then one delta per broadcast tick.
+//
+// Frame: length:u32 (type + payload), type:u8, payload
+//   KEYFRAME  MatchSnapshot of the spectator view
+//   DELTA     changes since the previous frame:
+//     steps advanced, turn fields that changed, a field mask per player (positions as
+//     1/16 px differences), projectiles as residuals against the flight predicted from
+//     the previous frame, the skill orb list when it changed and the terrain craters
+//     added since (crater ops, never pixels).
+//
+// Physics-only player fields (velocity, acceleration, sweep origin) and the RNG are not
+// streamed; spectators only draw the match.
+enum class SpectatorFrameType : Uint8 {
+    KEYFRAME = 1,
+    DELTA = 2
+};
+
+// What a spectator knows about the match. The encoder keeps one too, so both sides
+// quantize identically and never drift apart.
+class SpectatorDecoder {
+public:
+    SpectatorDecoder();
+
+    // Apply one complete frame (header included). Fails on a corrupt frame or a delta
+    // that arrives before any keyframe.
+    bool ApplyFrame(const Uint8* frame, size_t size);
+
+    bool HasKeyframe() const { return m_hasKeyframe; }
+    const MatchState& GetView() const { return m_view; }
+
+    // Total size of the frame starting at data, once its length field has arrived.
+    // Sizes outside [HEADER_SIZE, MAX_FRAME_SIZE] mean the stream is corrupt.
+    static bool PeekFrameSize(const Uint8* data, size_t available, size_t& frameSize);
+
+    static constexpr size_t HEADER_SIZE = 5;
+    static constexpr size_t MAX_FRAME_SIZE = 4 * 1024 * 1024;
+
+private:
+    bool ApplyDelta(const Uint8* data, size_t size);
+
+    MatchState m_view;
+    bool m_hasKeyframe;
+};
+
+class SpectatorEncoder {
+public:
+    // Delta from the current view to state; the view moves to state. Returns false
+    // (frame untouched) when only a keyframe can express the change: no view yet, a
+    // rematch, a different player count or terrain that was rebuilt.
+    bool EncodeDelta(const MatchState& state, std::vector<Uint8>& frame);
+
+    // Keyframe of state; the view restarts from it
+    void EncodeKeyframe(const MatchState& state, std::vector<Uint8>& frame);
+
+    // Keyframe of the current view, for spectators joining or resynchronizing mid-stream
+    void EncodeViewKeyframe(std::vector<Uint8>& frame) const;
+
+    bool HasView() const { return m_view.HasKeyframe(); }
+    const MatchState& GetView() const { return m_view.GetView(); }
+
+    // Stream resolution
+    static constexpr float POSITION_SCALE = 16.0f; // 1/16 px
+    static constexpr float TIMER_SCALE = 60.0f;    // One simulation step
+
+private:
+    SpectatorDecoder m_view;
+};
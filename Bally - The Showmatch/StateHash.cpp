@@ -0,0 +1,207 @@
+#include "StateHash.h"
+#include "ByteStream.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+void Write64(std::vector<Uint8>& out, Uint64 value) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<Uint8>(value >> (i * 8)));
+    }
+}
+
+Uint64 Read64(ByteReader& reader) {
+    Uint64 value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<Uint64>(reader.ReadByte()) << (i * 8);
+    }
+    return value;
+}
+
+void WriteList(std::vector<Uint8>& out, const std::vector<Uint64>& values) {
+    WriteVarint(out, static_cast<Uint32>(values.size()));
+    for (Uint64 value : values) {
+        Write64(out, value);
+    }
+}
+
+bool ReadList(ByteReader& reader, std::vector<Uint64>& values) {
+    Uint32 count = reader.ReadVarint();
+    if (count > (reader.size - reader.offset) / 8) return false;
+    values.resize(count);
+    for (Uint64& value : values) {
+        value = Read64(reader);
+    }
+    return !reader.failed;
+}
+
+void DumpList(std::ostream& out, const char* name, const std::vector<Uint64>& values) {
+    out << name << " " << std::dec << values.size() << std::hex;
+    for (Uint64 value : values) {
+        out << " " << std::setw(16) << value;
+    }
+    out << "\n";
+}
+
+bool ParseList(std::istringstream& line, std::vector<Uint64>& values) {
+    size_t count = 0;
+    line >> std::dec >> count;
+    values.resize(count);
+    for (Uint64& value : values) {
+        line >> std::hex >> value;
+    }
+    return !line.fail();
+}
+
+// Index of the first differing entry, or -1
+int FirstDifferentIndex(const std::vector<Uint64>& a, const std::vector<Uint64>& b) {
+    size_t count = std::min(a.size(), b.size());
+    for (size_t i = 0; i < count; ++i) {
+        if (a[i] != b[i]) return static_cast<int>(i);
+    }
+    return a.size() == b.size() ? -1 : static_cast<int>(count);
+}
+
+}
+
+void StateHasher::AddBytes(const void* data, size_t size) {
+    const Uint8* bytes = static_cast<const Uint8*>(data);
+    size_t offset = 0;
+
+    // Long inputs (terrain rows, chunk hashes) go through four independent lanes, so each
+    // multiply doesn't wait for the one before it; the lanes are folded back in order
+    if (size >= LANE_BLOCK) {
+        StateHasher lanes[4];
+        for (; offset + LANE_BLOCK <= size; offset += LANE_BLOCK) {
+            for (int lane = 0; lane < 4; ++lane) {
+                Uint64 word;
+                std::memcpy(&word, bytes + offset + lane * 8, sizeof(word));
+                lanes[lane].Add(word);
+            }
+        }
+        for (const StateHasher& lane : lanes) {
+            Add(lane.Get());
+        }
+    }
+
+    for (; offset + 8 <= size; offset += 8) {
+        Uint64 word;
+        std::memcpy(&word, bytes + offset, sizeof(word));
+        Add(word);
+    }
+    Uint64 tail = 0;
+    std::memcpy(&tail, bytes + offset, size - offset);
+    Add(tail ^ static_cast<Uint64>(size));
+}
+
+void StateHashDetail::Encode(std::vector<Uint8>& out) const {
+    WriteVarint(out, ZigZag(step));
+    Write64(out, total);
+    Write64(out, turn);
+    WriteList(out, players);
+    WriteList(out, projectiles);
+    WriteList(out, skillOrbs);
+    Write64(out, terrain);
+}
+
+bool StateHashDetail::Decode(const Uint8* data, size_t size) {
+    ByteReader reader(data, size);
+    step = UnZigZag(reader.ReadVarint());
+    total = Read64(reader);
+    turn = Read64(reader);
+    if (!ReadList(reader, players) || !ReadList(reader, projectiles) || !ReadList(reader, skillOrbs)) {
+        return false;
+    }
+    terrain = Read64(reader);
+    terrainChunks.clear();
+    chunkColumns = 0;
+    chunkSize = 0;
+    return !reader.failed;
+}
+
+bool StateHashDetail::WriteDump(const std::string& path, const std::string& note) const {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Failed to write state dump: " << path << std::endl;
+        return false;
+    }
+
+    file << "# " << note << "\n";
+    file << "step " << step << "\n";
+    file << std::hex << std::setfill('0');
+    file << "total " << std::setw(16) << total << "\n";
+    file << "turn " << std::setw(16) << turn << "\n";
+    DumpList(file, "players", players);
+    DumpList(file, "projectiles", projectiles);
+    DumpList(file, "orbs", skillOrbs);
+    file << "terrain " << std::setw(16) << terrain << "\n";
+    file << std::dec << "chunks " << chunkColumns << " " << chunkSize;
+    DumpList(file, "", terrainChunks);
+    return file.good();
+}
+
+bool StateHashDetail::ReadDump(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Failed to open state dump: " << path << std::endl;
+        return false;
+    }
+
+    *this = StateHashDetail();
+    std::string text;
+    bool valid = true;
+    while (valid && std::getline(file, text)) {
+        std::istringstream line(text);
+        std::string key;
+        line >> key;
+        if (key.empty() || key[0] == '#') continue;
+
+        if (key == "step") line >> std::dec >> step;
+        else if (key == "total") line >> std::hex >> total;
+        else if (key == "turn") line >> std::hex >> turn;
+        else if (key == "players") valid = ParseList(line, players);
+        else if (key == "projectiles") valid = ParseList(line, projectiles);
+        else if (key == "orbs") valid = ParseList(line, skillOrbs);
+        else if (key == "terrain") line >> std::hex >> terrain;
+        else if (key == "chunks") {
+            line >> std::dec >> chunkColumns >> chunkSize;
+            valid = ParseList(line, terrainChunks);
+        }
+        valid = valid && !line.fail();
+    }
+
+    if (!valid) {
+        std::cerr << "State dump is corrupt: " << path << std::endl;
+    }
+    return valid;
+}
+
+std::string StateHashDetail::FirstDifference(const StateHashDetail& a, const StateHashDetail& b) {
+    std::ostringstream out;
+    int index = -1;
+    if (a.turn != b.turn) {
+        out << "turn state";
+    } else if ((index = FirstDifferentIndex(a.players, b.players)) >= 0) {
+        out << "player " << index;
+    } else if ((index = FirstDifferentIndex(a.projectiles, b.projectiles)) >= 0) {
+        out << "projectile " << index;
+    } else if ((index = FirstDifferentIndex(a.skillOrbs, b.skillOrbs)) >= 0) {
+        out << "skill orb " << index;
+    } else if (a.terrain != b.terrain) {
+        out << "terrain";
+        if (a.chunkColumns > 0 && a.chunkColumns == b.chunkColumns && a.chunkSize == b.chunkSize &&
+            (index = FirstDifferentIndex(a.terrainChunks, b.terrainChunks)) >= 0) {
+            int x = (index % a.chunkColumns) * a.chunkSize;
+            int y = (index / a.chunkColumns) * a.chunkSize;
+            out << " chunk " << index << " (x " << x << "-" << x + a.chunkSize - 1 << ", y " << y << "-"
+                << y + a.chunkSize - 1 << ")";
+        }
+    } else if (a.total != b.total) {
+        out << "state";
+    }
+    return out.str();
+}
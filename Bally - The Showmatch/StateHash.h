@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include <SDL3/SDL.h>
+#include "Vector2.h"
+
+// Running 64-bit hash over simulation state. Not cryptographic: it only has to change
+// when any hashed bit changes, and to be cheap enough to run every step.
+class StateHasher {
+public:
+    StateHasher() : m_hash(0x9E3779B97F4A7C15ull) {}
+
+    void Add(Uint64 value) {
+        m_hash = (m_hash ^ value) * 0xBF58476D1CE4E5B9ull;
+        m_hash ^= m_hash >> 31;
+    }
+    void Add(int value) { Add(static_cast<Uint64>(static_cast<Uint32>(value))); }
+    void Add(bool value) { Add(static_cast<Uint64>(value ? 1 : 0)); }
+    void Add(float value) {
+        Uint32 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        Add(static_cast<Uint64>(bits));
+    }
+    void Add(const Vector2& value) {
+        Add(value.x);
+        Add(value.y);
+    }
+    void Add(const std::vector<int>& values) {
+        Add(static_cast<int>(values.size()));
+        for (int value : values) {
+            Add(value);
+        }
+    }
+    void AddBytes(const void* data, size_t size);
+
+    Uint64 Get() const { return m_hash; }
+
+private:
+    static constexpr size_t LANE_BLOCK = 32; // Bytes per round of the four AddBytes lanes
+
+    Uint64 m_hash;
+};
+
+// Bitwise equality, so a cached hash is only reused when every hashed bit is the same
+inline bool SameBits(const Vector2& a, const Vector2& b) {
+    return std::memcmp(&a.x, &b.x, sizeof(float)) == 0 && std::memcmp(&a.y, &b.y, sizeof(float)) == 0;
+}
+
+// Hash of one simulation step, split by part. Peers exchange and replays record only the
+// total; the parts (and, in dumps, the terrain chunks) name what diverged.
+struct StateHashDetail {
+    int step;
+    Uint64 total;
+    Uint64 turn;                       // Turn order, timers, flags and RNG streams
+    std::vector<Uint64> players;
+    std::vector<Uint64> projectiles;
+    std::vector<Uint64> skillOrbs;
+    Uint64 terrain;                    // Root over the chunk hashes
+    std::vector<Uint64> terrainChunks; // Only filled for dumps
+    int chunkColumns;
+    int chunkSize;
+
+    StateHashDetail() : step(0), total(0), turn(0), terrain(0), chunkColumns(0), chunkSize(0) {}
+
+    // Compact binary form without the terrain chunks (netplay desync reports)
+    void Encode(std::vector<Uint8>& out) const;
+    bool Decode(const Uint8* data, size_t size);
+
+    // Text dump; two dumps of the same step can be compared on another machine
+    bool WriteDump(const std::string& path, const std::string& note) const;
+    bool ReadDump(const std::string& path);
+
+    // First part that differs ("player 2", "terrain chunk 17 (x 320-383, y 128-191)"),
+    // or an empty string when both are equal
+    static std::string FirstDifference(const StateHashDetail& a, const StateHashDetail& b);
+};
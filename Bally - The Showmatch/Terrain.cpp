@@ -1,24 +1,37 @@
 #include "Terrain.h"
+#include "Profiler.h"
 #include "Renderer.h"
+#include "StateHash.h"
 #include <iostream>
 #include <cmath>
 #include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace {
+
+std::atomic<Uint64> s_nextRevision(1);
+std::atomic<Uint64> s_cratersCut(0);
+std::atomic<Uint64> s_craterNanoseconds(0);
 
-Terrain::Terrain() : m_surface(nullptr), m_texture(nullptr), m_width(0), m_height(0), m_needsTextureUpdate(false) {
+}
+
+Terrain::Terrain() : m_surface(nullptr), m_texture(nullptr), m_width(0), m_height(0), m_needsTextureUpdate(false),
+    m_freeCellTotal(0), m_cellColumns(0), m_cellRows(0), m_freeSpaceReach(0), m_freeSpaceRadius(0.0f),
+    m_terrainHash(0), m_hashDirty(false), m_hashChunkColumns(0), m_revision(0) {
+    BumpRevision();
 }
 
 Terrain::~Terrain() {
-    if (m_surface) {
-        SDL_DestroySurface(m_surface);
-        m_surface = nullptr;
-    }
     if (m_texture) {
-        SDL_DestroyTexture(m_texture);
+        Renderer::DestroyTexture(m_texture);
         m_texture = nullptr;
     }
 }
 
 bool Terrain::LoadFromImage(const std::string& filepath) {
+    PROFILE_ZONE("Terrain::LoadFromImage");
+
     // Load image using SDL_image
     SDL_Surface* loadedSurface = IMG_Load(filepath.c_str());
     if (!loadedSurface) {
@@ -27,7 +40,7 @@ bool Terrain::LoadFromImage(const std::string& filepath) {
     }
 
     // Convert to RGBA format for easier pixel manipulation
-    m_surface = SDL_ConvertSurface(loadedSurface, SDL_PIXELFORMAT_RGBA32);
+    SetSurface(SDL_ConvertSurface(loadedSurface, SDL_PIXELFORMAT_RGBA32));
     SDL_DestroySurface(loadedSurface);
 
     if (!m_surface) {
@@ -38,6 +51,9 @@ bool Terrain::LoadFromImage(const std::string& filepath) {
     m_width = m_surface->w;
     m_height = m_surface->h;
     m_needsTextureUpdate = true;
+    m_craterLog.clear();
+    ClearFreeSpaceMask();
+    RebuildChunkHashes();
 
     std::cout << "Terrain loaded: " << filepath.c_str() << " (" << m_width << "x" << m_height << ")" << std::endl;
     return true;
@@ -48,14 +64,14 @@ void Terrain::CreateDefaultTerrain(int width, int height) {
     m_width = width;
     m_height = height;
 
-    m_surface = SDL_CreateSurface(width, height, SDL_PIXELFORMAT_RGBA32);
+    SetSurface(SDL_CreateSurface(width, height, SDL_PIXELFORMAT_RGBA32));
     if (!m_surface) {
         std::cerr << "Failed to create default terrain surface" << std::endl;
         return;
     }
 
     // Fill with a simple terrain pattern
-    SDL_LockSurface(m_surface);
+    SDL_LockSurface(m_surface.get());
 
     Uint32* pixels = (Uint32*)m_surface->pixels;
     int pitch = m_surface->pitch / 4; // Convert byte pitch to pixel pitch
@@ -80,13 +96,70 @@ void Terrain::CreateDefaultTerrain(int width, int height) {
         }
     }
 
-    SDL_UnlockSurface(m_surface);
+    SDL_UnlockSurface(m_surface.get());
     m_needsTextureUpdate = true;
+    m_craterLog.clear();
+    ClearFreeSpaceMask();
+    RebuildChunkHashes();
 
     std::cout << "Default terrain created (" << width << "x" << height << ")" << std::endl;
 }
 
+void Terrain::ShareFrom(const Terrain& source) {
+    m_surface = source.m_surface;
+    m_width = source.m_width;
+    m_height = source.m_height;
+    m_needsTextureUpdate = true;
+    m_craterLog = source.m_craterLog;
+
+    // The free-space mask is small, so it's copied rather than shared
+    m_cellSolidCount = source.m_cellSolidCount;
+    m_cellFree = source.m_cellFree;
+    m_freeCellTree = source.m_freeCellTree;
+    m_freeCellTotal = source.m_freeCellTotal;
+    m_cellColumns = source.m_cellColumns;
+    m_cellRows = source.m_cellRows;
+    m_freeSpaceReach = source.m_freeSpaceReach;
+    m_freeSpaceRadius = source.m_freeSpaceRadius;
+
+    source.RefreshChunkHashes();
+    m_chunkHashes = source.m_chunkHashes;
+    m_chunkDirty = source.m_chunkDirty;
+    m_terrainHash = source.m_terrainHash;
+    m_hashDirty = source.m_hashDirty;
+    m_hashChunkColumns = source.m_hashChunkColumns;
+    BumpRevision();
+}
+
+void Terrain::SetSurface(SDL_Surface* surface) {
+    if (surface) {
+        m_surface.reset(surface, SDL_DestroySurface);
+    } else {
+        m_surface.reset();
+    }
+    BumpRevision();
+}
+
+void Terrain::BumpRevision() {
+    m_revision = s_nextRevision.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Terrain::MakeSurfaceUnique() {
+    // Other terrains only ever read a shared surface, so copying it here is safe even while
+    // they run on other threads
+    if (!IsSurfaceShared()) return;
+
+    SDL_Surface* copy = SDL_DuplicateSurface(m_surface.get());
+    if (!copy) {
+        std::cerr << "Failed to copy shared terrain surface: " << SDL_GetError() << std::endl;
+        return;
+    }
+    SetSurface(copy);
+}
+
 void Terrain::Draw(Renderer* renderer) {
+    PROFILE_ZONE("Terrain::Draw");
+
     if (!m_surface) return;
 
     // Update texture if needed (after destruction)
@@ -99,7 +172,7 @@ void Terrain::Draw(Renderer* renderer) {
         // Get camera offset from renderer and apply it
         Vector2 cameraOffset = renderer->GetCameraOffset();
         SDL_FRect destRect = { -cameraOffset.x, -cameraOffset.y, (float)m_width, (float)m_height };
-        SDL_RenderTexture(renderer->GetSDLRenderer(), m_texture, nullptr, &destRect);
+        renderer->DrawTexture(m_texture, nullptr, &destRect);
     }
 }
 
@@ -110,14 +183,12 @@ bool Terrain::IsInBounds(int x, int y) const {
 Uint8 Terrain::GetPixelAlpha(int x, int y) const {
     if (!m_surface || !IsInBounds(x, y)) return 0;
 
-    SDL_LockSurface(m_surface);
-
-    Uint32* pixels = (Uint32*)m_surface->pixels;
+    // Terrain surfaces are plain RGBA32 (never RLE), so pixels are readable without
+    // SDL_LockSurface. Skipping the lock also makes concurrent reads from workers safe.
+    const Uint32* pixels = (const Uint32*)m_surface->pixels;
     int pitch = m_surface->pitch / 4;
     Uint32 pixel = pixels[y * pitch + x];
 
-    SDL_UnlockSurface(m_surface);
-
     // Extract alpha channel (assuming RGBA32 format)
     Uint8 alpha = (pixel >> 24) & 0xFF;
     return alpha;
@@ -126,13 +197,10 @@ Uint8 Terrain::GetPixelAlpha(int x, int y) const {
 void Terrain::SetPixelTransparent(int x, int y) {
     if (!m_surface || !IsInBounds(x, y)) return;
 
-    SDL_LockSurface(m_surface);
-
+    // Same layout guarantee as GetPixelAlpha - no lock needed per pixel
     Uint32* pixels = (Uint32*)m_surface->pixels;
     int pitch = m_surface->pitch / 4;
     pixels[y * pitch + x] = 0x00000000; // Fully transparent
-
-    SDL_UnlockSurface(m_surface);
 }
 
 bool Terrain::IsPixelSolid(int x, int y) const {
@@ -165,9 +233,77 @@ bool Terrain::IsCircleSolid(const Vector2& center, float radius) const {
     return false;
 }
 
+float Terrain::DistanceToSolid(const Vector2& point, float maxDistance) const {
+    int centerY = (int)std::floor(point.y + 0.5f);
+    int reach = (int)std::ceil(maxDistance) + 1;
+    float bestSq = maxDistance * maxDistance;
+
+    // Visit rows outward from the center so the search stops once no row can be closer
+    for (int offset = 0; offset <= reach; ++offset) {
+        for (int side = 0; side < (offset == 0 ? 1 : 2); ++side) {
+            int y = side == 0 ? centerY + offset : centerY - offset;
+            if (y < 0 || y >= m_height) continue;
+
+            float dy = y - point.y;
+            float remainingSq = bestSq - dy * dy;
+            if (remainingSq <= 0.0f) continue;
+
+            float span = std::sqrt(remainingSq);
+            int minX = std::max(0, (int)std::ceil(point.x - span));
+            int maxX = std::min(m_width - 1, (int)std::floor(point.x + span));
+            for (int x = minX; x <= maxX; ++x) {
+                if (!IsPixelSolid(x, y)) continue;
+
+                float dx = x - point.x;
+                float distSq = dx * dx + dy * dy;
+                if (distSq < bestSq) {
+                    bestSq = distSq;
+                }
+            }
+        }
+
+        float nextDy = offset + 1 - std::abs(point.y - centerY);
+        if (nextDy > 0 && nextDy * nextDy >= bestSq) break;
+    }
+
+    return std::sqrt(bestSq);
+}
+
+Vector2 Terrain::GetSurfaceNormal(const Vector2& point, float radius) const {
+    int minX = std::max(0, (int)(point.x - radius));
+    int maxX = std::min(m_width - 1, (int)(point.x + radius));
+    int minY = std::max(0, (int)(point.y - radius));
+    int maxY = std::min(m_height - 1, (int)(point.y + radius));
+
+    float radiusSq = radius * radius;
+    Vector2 sum(0, 0);
+
+    // Solid pixels pull the normal toward themselves; the normal points the other way
+    for (int y = minY; y <= maxY; ++y) {
+        for (int x = minX; x <= maxX; ++x) {
+            float dx = x - point.x;
+            float dy = y - point.y;
+            if (dx * dx + dy * dy <= radiusSq && IsPixelSolid(x, y)) {
+                sum.x -= dx;
+                sum.y -= dy;
+            }
+        }
+    }
+
+    if (sum.LengthSquared() < 0.0001f) {
+        return Vector2::Up();
+    }
+    return sum.Normalized();
+}
+
 void Terrain::DestroyCircle(const Vector2& center, float radius) {
     if (!m_surface) return;
 
+    Uint64 start = Profiler::Now();
+    MakeSurfaceUnique();
+    m_craterLog.push_back(TerrainCrater{ center, radius });
+    s_cratersCut.fetch_add(1, std::memory_order_relaxed);
+
     int minX = std::max(0, (int)(center.x - radius));
     int maxX = std::min(m_width - 1, (int)(center.x + radius));
     int minY = std::max(0, (int)(center.y - radius));
@@ -182,12 +318,148 @@ void Terrain::DestroyCircle(const Vector2& center, float radius) {
             float distSq = dx * dx + dy * dy;
 
             if (distSq <= radiusSq) {
+                if (HasFreeSpaceMask() && IsPixelSolid(x, y)) {
+                    int cell = (y / FREE_SPACE_CELL_SIZE) * m_cellColumns + (x / FREE_SPACE_CELL_SIZE);
+                    m_cellSolidCount[cell]--;
+                }
                 SetPixelTransparent(x, y);
             }
         }
     }
 
+    MarkChunksDirty(minX, minY, maxX, maxY);
+
+    // Only cells within reach of the crater can have become free
+    if (HasFreeSpaceMask() && minX <= maxX && minY <= maxY) {
+        RefreshFreeCells(minX / FREE_SPACE_CELL_SIZE - m_freeSpaceReach, minY / FREE_SPACE_CELL_SIZE - m_freeSpaceReach,
+            maxX / FREE_SPACE_CELL_SIZE + m_freeSpaceReach, maxY / FREE_SPACE_CELL_SIZE + m_freeSpaceReach);
+    }
+
     m_needsTextureUpdate = true;
+    s_craterNanoseconds.fetch_add(Profiler::Now() - start, std::memory_order_relaxed);
+}
+
+Uint64 Terrain::GetCratersCutTotal() {
+    return s_cratersCut.load(std::memory_order_relaxed);
+}
+
+Uint64 Terrain::GetCraterNanosecondsTotal() {
+    return s_craterNanoseconds.load(std::memory_order_relaxed);
+}
+
+void Terrain::DestroyCircles(const std::vector<TerrainCrater>& craters) {
+    for (size_t i = 0; i < craters.size(); ++i) {
+        const TerrainCrater& crater = craters[i];
+
+        // Skip craters fully covered by another one (split shots hitting the same spot)
+        bool covered = false;
+        for (size_t j = 0; j < craters.size() && !covered; ++j) {
+            if (i == j) continue;
+            const TerrainCrater& other = craters[j];
+            float distance = (crater.center - other.center).Length();
+            bool inside = distance + crater.radius <= other.radius;
+            // Identical craters: keep only the first
+            bool duplicate = inside && distance + other.radius <= crater.radius && j > i;
+            covered = inside && !duplicate;
+        }
+
+        if (!covered) {
+            DestroyCircle(crater.center, crater.radius);
+        }
+    }
+}
+
+void Terrain::ClearCirclePixels(const Vector2& center, float radius, int minX, int minY, int maxX, int maxY) {
+    // Same pixel set as DestroyCircle, clipped to the box
+    minX = std::max(minX, std::max(0, (int)(center.x - radius)));
+    maxX = std::min(maxX, std::min(m_width - 1, (int)(center.x + radius)));
+    minY = std::max(minY, std::max(0, (int)(center.y - radius)));
+    maxY = std::min(maxY, std::min(m_height - 1, (int)(center.y + radius)));
+
+    float radiusSq = radius * radius;
+    for (int y = minY; y <= maxY; ++y) {
+        for (int x = minX; x <= maxX; ++x) {
+            float dx = x - center.x;
+            float dy = y - center.y;
+            if (dx * dx + dy * dy <= radiusSq) {
+                SetPixelTransparent(x, y);
+            }
+        }
+    }
+    MarkChunksDirty(minX, minY, maxX, maxY);
+}
+
+void Terrain::RestoreCraters(const Terrain& pristine, const std::vector<TerrainCrater>& craters) {
+    size_t common = 0;
+    while (common < m_craterLog.size() && common < craters.size() &&
+        m_craterLog[common].center.x == craters[common].center.x &&
+        m_craterLog[common].center.y == craters[common].center.y &&
+        m_craterLog[common].radius == craters[common].radius) {
+        common++;
+    }
+
+    if (common < m_craterLog.size()) {
+        if (!pristine.m_surface || pristine.m_width != m_width || pristine.m_height != m_height) {
+            // Not our map - start over from it
+            ShareFrom(pristine);
+            common = 0;
+        } else {
+            // Box around the craters to undo, grown to whole mask cells
+            int minX = m_width, minY = m_height, maxX = -1, maxY = -1;
+            for (size_t i = common; i < m_craterLog.size(); ++i) {
+                const TerrainCrater& crater = m_craterLog[i];
+                minX = std::min(minX, std::max(0, (int)(crater.center.x - crater.radius)));
+                minY = std::min(minY, std::max(0, (int)(crater.center.y - crater.radius)));
+                maxX = std::max(maxX, std::min(m_width - 1, (int)(crater.center.x + crater.radius)));
+                maxY = std::max(maxY, std::min(m_height - 1, (int)(crater.center.y + crater.radius)));
+            }
+
+            if (minX <= maxX && minY <= maxY) {
+                minX = (minX / FREE_SPACE_CELL_SIZE) * FREE_SPACE_CELL_SIZE;
+                minY = (minY / FREE_SPACE_CELL_SIZE) * FREE_SPACE_CELL_SIZE;
+                maxX = std::min(m_width - 1, (maxX / FREE_SPACE_CELL_SIZE + 1) * FREE_SPACE_CELL_SIZE - 1);
+                maxY = std::min(m_height - 1, (maxY / FREE_SPACE_CELL_SIZE + 1) * FREE_SPACE_CELL_SIZE - 1);
+
+                MakeSurfaceUnique();
+                const Uint8* source = (const Uint8*)pristine.m_surface->pixels;
+                Uint8* destination = (Uint8*)m_surface->pixels;
+                for (int y = minY; y <= maxY; ++y) {
+                    std::memcpy(destination + y * m_surface->pitch + minX * 4,
+                        source + y * pristine.m_surface->pitch + minX * 4, (maxX - minX + 1) * 4);
+                }
+                MarkChunksDirty(minX, minY, maxX, maxY);
+
+                // Craters that stay are cut into the box again
+                for (size_t i = 0; i < common; ++i) {
+                    ClearCirclePixels(m_craterLog[i].center, m_craterLog[i].radius, minX, minY, maxX, maxY);
+                }
+
+                if (HasFreeSpaceMask()) {
+                    for (int cellY = minY / FREE_SPACE_CELL_SIZE; cellY <= maxY / FREE_SPACE_CELL_SIZE; ++cellY) {
+                        for (int cellX = minX / FREE_SPACE_CELL_SIZE; cellX <= maxX / FREE_SPACE_CELL_SIZE; ++cellX) {
+                            Uint8 count = 0;
+                            int endY = std::min(m_height, (cellY + 1) * FREE_SPACE_CELL_SIZE);
+                            int endX = std::min(m_width, (cellX + 1) * FREE_SPACE_CELL_SIZE);
+                            for (int y = cellY * FREE_SPACE_CELL_SIZE; y < endY; ++y) {
+                                for (int x = cellX * FREE_SPACE_CELL_SIZE; x < endX; ++x) {
+                                    count += IsPixelSolid(x, y) ? 1 : 0;
+                                }
+                            }
+                            m_cellSolidCount[cellY * m_cellColumns + cellX] = count;
+                        }
+                    }
+                    RefreshFreeCells(minX / FREE_SPACE_CELL_SIZE - m_freeSpaceReach, minY / FREE_SPACE_CELL_SIZE - m_freeSpaceReach,
+                        maxX / FREE_SPACE_CELL_SIZE + m_freeSpaceReach, maxY / FREE_SPACE_CELL_SIZE + m_freeSpaceReach);
+                }
+                m_needsTextureUpdate = true;
+            }
+            m_craterLog.resize(common);
+        }
+    }
+
+    for (size_t i = common; i < craters.size(); ++i) {
+        DestroyCircle(craters[i].center, craters[i].radius);
+    }
 }
 
 int Terrain::FindTopSolidPixel(int x, int startY) const {
@@ -365,17 +637,186 @@ bool Terrain::FindValidSpawnPosition(int targetX, int searchRange, float playerR
 }
 
 void Terrain::UpdateTexture(Renderer* renderer) {
+    PROFILE_ZONE("Terrain::UpdateTexture");
+
     if (!m_surface) return;
 
     // Destroy old texture
     if (m_texture) {
-        SDL_DestroyTexture(m_texture);
+        Renderer::DestroyTexture(m_texture);
         m_texture = nullptr;
     }
 
     // Create new texture from surface
-    m_texture = SDL_CreateTextureFromSurface(renderer->GetSDLRenderer(), m_surface);
+    m_texture = renderer->CreateTextureFromSurface(m_surface.get());
     if (!m_texture) {
         std::cerr << "Failed to create terrain texture from surface" << std::endl;
     }
 }
+
+void Terrain::ClearFreeSpaceMask() {
+    m_cellSolidCount.clear();
+    m_cellFree.clear();
+    m_freeCellTree.clear();
+    m_freeCellTotal = 0;
+    m_cellColumns = 0;
+    m_cellRows = 0;
+    m_freeSpaceReach = 0;
+    m_freeSpaceRadius = 0.0f;
+}
+
+void Terrain::BuildFreeSpaceMask(float clearanceRadius) {
+    ClearFreeSpaceMask();
+    if (!m_surface || clearanceRadius <= 0.0f) return;
+
+    m_freeSpaceRadius = clearanceRadius;
+    m_freeSpaceReach = (int)std::ceil(clearanceRadius / FREE_SPACE_CELL_SIZE);
+    m_cellColumns = (m_width + FREE_SPACE_CELL_SIZE - 1) / FREE_SPACE_CELL_SIZE;
+    m_cellRows = (m_height + FREE_SPACE_CELL_SIZE - 1) / FREE_SPACE_CELL_SIZE;
+    m_cellSolidCount.assign(m_cellColumns * m_cellRows, 0);
+    m_cellFree.assign(m_cellColumns * m_cellRows, 0);
+    m_freeCellTree.assign(m_cellColumns * m_cellRows + 1, 0);
+
+    for (int y = 0; y < m_height; ++y) {
+        Uint8* rowCounts = &m_cellSolidCount[(y / FREE_SPACE_CELL_SIZE) * m_cellColumns];
+        for (int x = 0; x < m_width; ++x) {
+            if (IsPixelSolid(x, y)) {
+                rowCounts[x / FREE_SPACE_CELL_SIZE]++;
+            }
+        }
+    }
+
+    RefreshFreeCells(0, 0, m_cellColumns - 1, m_cellRows - 1);
+}
+
+void Terrain::RefreshFreeCells(int minCellX, int minCellY, int maxCellX, int maxCellY) {
+    minCellX = std::max(0, minCellX);
+    minCellY = std::max(0, minCellY);
+    maxCellX = std::min(m_cellColumns - 1, maxCellX);
+    maxCellY = std::min(m_cellRows - 1, maxCellY);
+
+    for (int cellY = minCellY; cellY <= maxCellY; ++cellY) {
+        for (int cellX = minCellX; cellX <= maxCellX; ++cellX) {
+            // A circle anywhere in this cell only reaches cells within m_freeSpaceReach
+            bool free = true;
+            for (int ny = std::max(0, cellY - m_freeSpaceReach); free && ny <= std::min(m_cellRows - 1, cellY + m_freeSpaceReach); ++ny) {
+                for (int nx = std::max(0, cellX - m_freeSpaceReach); nx <= std::min(m_cellColumns - 1, cellX + m_freeSpaceReach); ++nx) {
+                    if (m_cellSolidCount[ny * m_cellColumns + nx] > 0) {
+                        free = false;
+                        break;
+                    }
+                }
+            }
+
+            SetCellFree(cellY * m_cellColumns + cellX, free);
+        }
+    }
+}
+
+void Terrain::SetCellFree(int cell, bool free) {
+    if ((m_cellFree[cell] != 0) == free) return;
+    m_cellFree[cell] = free ? 1 : 0;
+
+    int delta = free ? 1 : -1;
+    m_freeCellTotal += delta;
+    for (int i = cell + 1; i < static_cast<int>(m_freeCellTree.size()); i += i & -i) {
+        m_freeCellTree[i] += delta;
+    }
+}
+
+int Terrain::FindFreeCell(int n) const {
+    // Descend the Fenwick tree to the cell with exactly n free cells before it
+    int size = static_cast<int>(m_freeCellTree.size()) - 1;
+    int step = 1;
+    while (step * 2 <= size) {
+        step *= 2;
+    }
+
+    int position = 0;
+    for (; step > 0; step /= 2) {
+        if (position + step <= size && m_freeCellTree[position + step] <= n) {
+            position += step;
+            n -= m_freeCellTree[position];
+        }
+    }
+    return position; // Tree index position + 1 -> cell position
+}
+
+void Terrain::GetFreeCellBounds(int n, Vector2& outMin, Vector2& outMax) const {
+    int cell = FindFreeCell(n);
+    float x = (float)((cell % m_cellColumns) * FREE_SPACE_CELL_SIZE);
+    float y = (float)((cell / m_cellColumns) * FREE_SPACE_CELL_SIZE);
+    outMin = Vector2(x, y);
+    outMax = Vector2(std::min(x + FREE_SPACE_CELL_SIZE, (float)m_width), std::min(y + FREE_SPACE_CELL_SIZE, (float)m_height));
+}
+
+bool Terrain::IsFreeSpace(const Vector2& point) const {
+    if (!HasFreeSpaceMask() || !IsInBounds((int)point.x, (int)point.y)) return false;
+
+    int cell = ((int)point.y / FREE_SPACE_CELL_SIZE) * m_cellColumns + ((int)point.x / FREE_SPACE_CELL_SIZE);
+    return m_cellFree[cell] != 0;
+}
+
+void Terrain::RebuildChunkHashes() {
+    BumpRevision();
+    int size = HASH_CHUNK_SIZE;
+    m_hashChunkColumns = m_surface ? (m_width + size - 1) / size : 0;
+    int rows = m_surface ? (m_height + size - 1) / size : 0;
+    m_chunkHashes.assign(m_hashChunkColumns * rows, 0);
+    m_chunkDirty.assign(m_chunkHashes.size(), 1);
+    m_hashDirty = true;
+    RefreshChunkHashes();
+}
+
+void Terrain::MarkChunksDirty(int minX, int minY, int maxX, int maxY) {
+    BumpRevision();
+    if (m_hashChunkColumns == 0 || minX > maxX || minY > maxY) return;
+
+    int rows = static_cast<int>(m_chunkDirty.size()) / m_hashChunkColumns;
+    int minColumn = std::max(0, minX / HASH_CHUNK_SIZE);
+    int maxColumn = std::min(m_hashChunkColumns - 1, maxX / HASH_CHUNK_SIZE);
+    int minRow = std::max(0, minY / HASH_CHUNK_SIZE);
+    int maxRow = std::min(rows - 1, maxY / HASH_CHUNK_SIZE);
+    for (int row = minRow; row <= maxRow; ++row) {
+        for (int column = minColumn; column <= maxColumn; ++column) {
+            m_chunkDirty[row * m_hashChunkColumns + column] = 1;
+        }
+    }
+    m_hashDirty = true;
+}
+
+void Terrain::RefreshChunkHashes() const {
+    if (!m_hashDirty) return;
+
+    for (size_t chunk = 0; chunk < m_chunkHashes.size(); ++chunk) {
+        if (!m_chunkDirty[chunk]) continue;
+
+        int x = static_cast<int>(chunk % m_hashChunkColumns) * HASH_CHUNK_SIZE;
+        int y = static_cast<int>(chunk / m_hashChunkColumns) * HASH_CHUNK_SIZE;
+        int width = std::min(HASH_CHUNK_SIZE, m_width - x);
+        int height = std::min(HASH_CHUNK_SIZE, m_height - y);
+
+        StateHasher hasher;
+        const Uint8* pixels = (const Uint8*)m_surface->pixels;
+        for (int row = y; row < y + height; ++row) {
+            hasher.AddBytes(pixels + row * m_surface->pitch + x * 4, width * 4);
+        }
+        m_chunkHashes[chunk] = hasher.Get();
+        m_chunkDirty[chunk] = 0;
+    }
+
+    StateHasher root;
+    root.AddBytes(m_chunkHashes.data(), m_chunkHashes.size() * sizeof(Uint64));
+    m_terrainHash = root.Get();
+    m_hashDirty = false;
+}
+
+Uint64 Terrain::GetStateHash() const {
+    RefreshChunkHashes();
+    return m_terrainHash;
+}
+
+Uint64 Terrain::GetChunkHash(int chunk) const {
+    if (chunk < 0 || chunk >= static_cast<int>(m_chunkHashes.size())) return 0;
+    return m_chunkHashes[chunk];
+}
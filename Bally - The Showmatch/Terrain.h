@@ -2,12 +2,19 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 #include <SDL3/SDL.h>
 #include <SDL3_image/SDL_image.h>
 #include "Vector2.h"
 
 class Renderer;
 
+// Circular hole cut into the terrain (explosion crater)
+struct TerrainCrater {
+    Vector2 center;
+    float radius;
+};
+
 class Terrain {
 public:
     Terrain();
@@ -19,6 +26,11 @@ public:
     // Create a simple default terrain (for testing)
     void CreateDefaultTerrain(int width, int height);
 
+    // Share another terrain's pixels (copy-on-write). Loaded maps are shared this way between
+    // matches; the first DestroyCircle makes a private copy of the surface.
+    void ShareFrom(const Terrain& source);
+    bool IsSurfaceShared() const { return m_surface && m_surface.use_count() > 1; }
+
     // Render the terrain
     void Draw(Renderer* renderer);
 
@@ -26,15 +38,34 @@ public:
     bool IsPixelSolid(int x, int y) const;
     bool IsCircleSolid(const Vector2& center, float radius) const;
 
+    // Distance from point to the nearest solid pixel (maxDistance if nothing is closer)
+    float DistanceToSolid(const Vector2& point, float maxDistance) const;
+
+    // Outward surface normal at point, averaged over the solid pixels within radius
+    // Returns Vector2::Up() when there is no solid pixel nearby
+    Vector2 GetSurfaceNormal(const Vector2& point, float radius) const;
+
     // Terrain destruction - remove pixels in a circular area
     void DestroyCircle(const Vector2& center, float radius);
 
+    // Apply all craters of one step as a single edit (craters inside another one are skipped)
+    void DestroyCircles(const std::vector<TerrainCrater>& craters);
+
+    // Every crater cut since the map was loaded, in order (replays and keyframes rebuild
+    // the terrain from the map plus this log)
+    const std::vector<TerrainCrater>& GetCraterLog() const { return m_craterLog; }
+
+    // Bring the terrain to pristine + craters. Craters past the common prefix with the
+    // current log are undone locally (pixels copied back from the pristine map, older
+    // craters in that box re-cut), then the missing ones are cut.
+    void RestoreCraters(const Terrain& pristine, const std::vector<TerrainCrater>& craters);
+
     // Get terrain dimensions
     int GetWidth() const { return m_width; }
     int GetHeight() const { return m_height; }
 
     // Get the terrain surface for rendering
-    SDL_Surface* GetSurface() const { return m_surface; }
+    SDL_Surface* GetSurface() const { return m_surface.get(); }
 
     // Find the highest solid pixel at a given x position (for standing on terrain)
     int FindTopSolidPixel(int x, int startY) const;
@@ -59,12 +90,42 @@ public:
     // Returns true if valid position found, with spawnX and spawnY set
     bool FindValidSpawnPosition(int targetX, int searchRange, float playerRadius, int& outSpawnX, int& outSpawnY) const;
 
+    // Free-space mask: coarse cells where a circle of clearanceRadius fits anywhere inside
+    // the cell without touching solid terrain (terrain eroded by the radius).
+    // Built once per map, then kept up to date by DestroyCircle.
+    void BuildFreeSpaceMask(float clearanceRadius);
+    bool HasFreeSpaceMask() const { return m_freeSpaceRadius > 0.0f; }
+    int GetFreeCellCount() const { return m_freeCellTotal; }
+    // Bounds of the n-th free cell in cell order (0 <= n < GetFreeCellCount()).
+    // The order only depends on the pixels, not on the order craters were cut in.
+    void GetFreeCellBounds(int n, Vector2& outMin, Vector2& outMax) const;
+    bool IsFreeSpace(const Vector2& point) const;
+
+    // State hash, Merkle style: one hash per HASH_CHUNK_SIZE square of pixels, combined into
+    // a root. Edits only mark the chunks they touch; those are re-hashed on the next call.
+    Uint64 GetStateHash() const;
+    int GetHashChunkColumns() const { return m_hashChunkColumns; }
+    int GetHashChunkCount() const { return static_cast<int>(m_chunkHashes.size()); }
+    Uint64 GetChunkHash(int chunk) const; // Call GetStateHash first
+
+    static constexpr int HASH_CHUNK_SIZE = 64;
+
+    // Changes whenever the pixels do; unique across all terrains, so an unchanged revision
+    // means collision queries against this terrain still give the same answers
+    Uint64 GetRevision() const { return m_revision; }
+
+    // Craters cut by every terrain in the process so far, and the time spent cutting them
+    // (live metrics, scenario runs)
+    static Uint64 GetCratersCutTotal();
+    static Uint64 GetCraterNanosecondsTotal();
+
 private:
-    SDL_Surface* m_surface;
+    std::shared_ptr<SDL_Surface> m_surface; // Shared between terrains until the first edit
     SDL_Texture* m_texture;
     int m_width;
     int m_height;
     bool m_needsTextureUpdate;
+    std::vector<TerrainCrater> m_craterLog;
 
     // Helper to check if coordinates are in bounds
     bool IsInBounds(int x, int y) const;
@@ -75,6 +136,44 @@ private:
     // Set pixel to transparent
     void SetPixelTransparent(int x, int y);
 
+    // Take ownership of a surface / make a private copy before editing a shared one
+    void SetSurface(SDL_Surface* surface);
+    void MakeSurfaceUnique();
+
     // Update texture from surface after destruction
     void UpdateTexture(Renderer* renderer);
+
+    // Free-space mask state
+    std::vector<Uint8> m_cellSolidCount;  // Solid pixels per cell
+    std::vector<Uint8> m_cellFree;        // 1 if a circle fits anywhere in the cell
+    std::vector<int> m_freeCellTree;      // Fenwick tree over m_cellFree, for n-th free cell lookups
+    int m_freeCellTotal;
+    int m_cellColumns;
+    int m_cellRows;
+    int m_freeSpaceReach;                 // Cells around a cell that must be empty
+    float m_freeSpaceRadius;
+    static constexpr int FREE_SPACE_CELL_SIZE = 8;
+
+    void ClearFreeSpaceMask();
+    void RefreshFreeCells(int minCellX, int minCellY, int maxCellX, int maxCellY);
+    void SetCellFree(int cell, bool free);
+    int FindFreeCell(int n) const;
+
+    // Chunk hashes (mutable: refreshed lazily by the const getters). A loaded map hashes
+    // all chunks up front, so terrains sharing it only copy the hashes.
+    mutable std::vector<Uint64> m_chunkHashes;
+    mutable std::vector<Uint8> m_chunkDirty;
+    mutable Uint64 m_terrainHash;
+    mutable bool m_hashDirty;
+    int m_hashChunkColumns;
+    Uint64 m_revision;
+
+    void BumpRevision();
+
+    void RebuildChunkHashes();
+    void MarkChunksDirty(int minX, int minY, int maxX, int maxY);
+    void RefreshChunkHashes() const;
+
+    // Clear the pixels of a circle inside a box, without touching the crater log or the mask
+    void ClearCirclePixels(const Vector2& center, float radius, int minX, int minY, int maxX, int maxY);
 };
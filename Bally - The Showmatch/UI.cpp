@@ -1,12 +1,15 @@
 #include "UI.h"
+#include "Profiler.h"
 #include "SkillOrb.h"
 #include "Player.h"
+#include "Match.h"
+#include "PlayerSlots.h"
+#include "Camera.h"
 #include <SDL3/SDL.h>
 #include <SDL3_image/SDL_image.h>
 #include <cmath>
 #include <algorithm>
-#include <sstream>
-#include <iomanip>
+#include <cstdio>
 #include <iostream>
 
 // Define M_PI if not defined
@@ -24,6 +27,7 @@ UI::UI(Renderer* renderer) : m_renderer(renderer), m_turnTimer(20.0f), m_current
     m_inventorySlotTexture(nullptr), m_selectedInventorySlotTexture(nullptr), m_inventorySlotWidth(0), m_inventorySlotHeight(0),
     m_gameMode(GameMode::FREE_FOR_ALL), m_gameOverActive(false), m_winnerId(-1),
     m_colorCycleTime(0.0f), m_currentColorIndex(0) {
+    m_messages.reserve(MAX_MESSAGES);
     // Initialize skill orb textures to nullptr
     for (int i = 0; i < static_cast<int>(SkillType::COUNT); ++i) {
         m_skillOrbTextures[i] = nullptr;
@@ -41,24 +45,24 @@ UI::UI(Renderer* renderer) : m_renderer(renderer), m_turnTimer(20.0f), m_current
 
 UI::~UI() {
     if (m_inventorySlotTexture) {
-        SDL_DestroyTexture(m_inventorySlotTexture);
+        Renderer::DestroyTexture(m_inventorySlotTexture);
         m_inventorySlotTexture = nullptr;
     }
     if (m_selectedInventorySlotTexture) {
-        SDL_DestroyTexture(m_selectedInventorySlotTexture);
+        Renderer::DestroyTexture(m_selectedInventorySlotTexture);
         m_selectedInventorySlotTexture = nullptr;
     }
     // Clean up skill orb textures
     for (int i = 0; i < static_cast<int>(SkillType::COUNT); ++i) {
         if (m_skillOrbTextures[i]) {
-            SDL_DestroyTexture(m_skillOrbTextures[i]);
+            Renderer::DestroyTexture(m_skillOrbTextures[i]);
             m_skillOrbTextures[i] = nullptr;
         }
     }
     // Clean up button textures
     for (int i = 0; i < 4; ++i) {
         if (m_buttonTextures[i]) {
-            SDL_DestroyTexture(m_buttonTextures[i]);
+            Renderer::DestroyTexture(m_buttonTextures[i]);
             m_buttonTextures[i] = nullptr;
         }
     }
@@ -107,12 +111,14 @@ void UI::Render(const std::vector<std::unique_ptr<Player>>& players,
 }
 
 void UI::RenderWorldSpace(const std::vector<std::unique_ptr<Player>>& players,
-    int currentPlayerIndex, const Vector2& mousePosition) {
+    int currentPlayerIndex, const Vector2& mousePosition, const Camera* camera) {
+    PROFILE_ZONE("UI::RenderWorldSpace");
+
     // Draw health bars and player names above players (world-space)
     for (size_t i = 0; i < players.size(); ++i) {
-        if (players[i]->IsAlive()) {
-            DrawPlayerHealthBar(*players[i], static_cast<int>(i));
-        }
+        if (!players[i]->IsAlive()) continue;
+        if (camera && !camera->IsVisible(players[i]->GetPosition(), NAME_TAG_CULL_MARGIN)) continue;
+        DrawPlayerHealthBar(*players[i], static_cast<int>(i));
     }
 
     // Draw aiming UI for current player (world-space: angle, power, trajectory)
@@ -127,6 +133,8 @@ void UI::RenderWorldSpace(const std::vector<std::unique_ptr<Player>>& players,
 void UI::RenderScreenSpace(const std::vector<std::unique_ptr<Player>>& players,
     int currentPlayerIndex, float turnTimer,
     const Vector2& cameraPos, float mapWidth, float mapHeight) {
+    PROFILE_ZONE("UI::RenderScreenSpace");
+
     m_currentPlayerIndex = currentPlayerIndex;
     m_turnTimer = turnTimer;
 
@@ -163,9 +171,10 @@ void UI::DrawPlayerHealthBar(const Player& player, int index) {
     const float nameOffset = 60.0f;
 
     // Get player name and text size
-    std::string playerName = "Player " + std::to_string(index + 1);
+    char playerName[32];
+    std::snprintf(playerName, sizeof(playerName), "Player %d", index + 1);
     int textWidth = 0, textHeight = 0;
-    m_renderer->GetTextSize(playerName.c_str(), &textWidth, &textHeight);
+    m_renderer->GetTextSize(playerName, &textWidth, &textHeight);
     
     // Player name position (manual offset from player)
     float nameX = playerPos.x - textWidth / 2.0f;
@@ -175,7 +184,7 @@ void UI::DrawPlayerHealthBar(const Player& player, int index) {
     // Health bar position (centered above player)
     Vector2 healthBarPos = playerPos + Vector2(-healthBarWidth / 2.0f, -healthBarOffset);
     
-    m_renderer->DrawText(namePos, playerName.c_str(), Color(255, 255, 255, 255));
+    m_renderer->DrawText(namePos, playerName, Color(255, 255, 255, 255));
 
     // Determine health bar color based on team mode
     Color teamColor = Color(255, 255, 255, 255); // Default (invalid, will use percentage-based color)
@@ -218,14 +227,15 @@ void UI::DrawTurnTimer(float timer) {
     m_renderer->DrawRect(timerPos, TURN_TIMER_WIDTH, TURN_TIMER_HEIGHT, Color(255, 255, 255, 255), false);
 
     // Timer text
-    std::stringstream ss;
-    ss << "Turn: " << std::fixed << std::setprecision(1) << timer << "s";
-    m_renderer->DrawText(timerPos + Vector2(0, 25), ss.str().c_str(), Color(255, 255, 255, 255));
+    char text[32];
+    std::snprintf(text, sizeof(text), "Turn: %.1fs", timer);
+    m_renderer->DrawText(timerPos + Vector2(0, 25), text, Color(255, 255, 255, 255));
 }
 
 void UI::DrawCurrentPlayerIndicator(int playerIndex) {
-    std::string text = "Current Player: " + std::to_string(playerIndex + 1);
-    m_renderer->DrawText(Vector2(500, 50), text.c_str(), Color(255, 255, 0, 255));
+    char text[32];
+    std::snprintf(text, sizeof(text), "Current Player: %d", playerIndex + 1);
+    m_renderer->DrawText(Vector2(500, 50), text, Color(255, 255, 0, 255));
 }
 
 void UI::DrawAimingUI(const Player& player, const Vector2& mousePosition) {
@@ -281,7 +291,7 @@ void UI::DrawInventory(const Player& player, const Vector2& position) {
         if (textureToUse && m_inventorySlotWidth > 0 && m_inventorySlotHeight > 0) {
             // Draw slot texture at fixed size (50x50)
             SDL_FRect destRect = { slotPos.x, slotPos.y, 50.0f, 50.0f };
-            SDL_RenderTexture(m_renderer->GetSDLRenderer(), textureToUse, nullptr, &destRect);
+            m_renderer->DrawTexture(textureToUse, nullptr, &destRect);
         } else {
             // Fallback: Draw slot background if texture not loaded
             Color slotColor = Color(50, 50, 50, 255);
@@ -296,12 +306,13 @@ void UI::DrawInventory(const Player& player, const Vector2& position) {
         }
 
         // Draw key number (bottom left of slot)
-        std::string keyText = std::to_string(i + 1);
+        char keyText[16];
+        std::snprintf(keyText, sizeof(keyText), "%d", i + 1);
         int textWidth = 0, textHeight = 0;
-        m_renderer->GetTextSize(keyText.c_str(), &textWidth, &textHeight);
+        m_renderer->GetTextSize(keyText, &textWidth, &textHeight);
         float offset = 5.0f; // Padding from edge
         Vector2 textPos = slotPos + Vector2(offset, 53.0f - textHeight - offset);
-        m_renderer->DrawText(textPos, keyText.c_str(), Color(255, 255, 255, 255));
+        m_renderer->DrawText(textPos, keyText, Color(255, 255, 255, 255));
 
         // Draw skill orb texture if slot is occupied (centered in slot)
         if (i < inventory.size()) {
@@ -316,7 +327,7 @@ void UI::DrawInventory(const Player& player, const Vector2& position) {
                 float centerY = slotPos.y + slotSize / 2.0f - textureSize / 2.0f;
                 
                 SDL_FRect destRect = { centerX, centerY, textureSize, textureSize };
-                SDL_RenderTexture(m_renderer->GetSDLRenderer(), skillTexture, nullptr, &destRect);
+                m_renderer->DrawTexture(skillTexture, nullptr, &destRect);
             }
         }
     }
@@ -388,11 +399,12 @@ void UI::DrawPowerBarRuler(const Player& player) {
         m_renderer->DrawLine(Vector2(x, tickStartY), Vector2(x, tickEndY), tickColor, 2.0f);
         
         // Draw number label above the ruler
-        std::string label = std::to_string(value);
+        char label[16];
+        std::snprintf(label, sizeof(label), "%d", value);
         int textWidth = 0, textHeight = 0;
-        m_renderer->GetTextSize(label.c_str(), &textWidth, &textHeight);
+        m_renderer->GetTextSize(label, &textWidth, &textHeight);
         Vector2 textPos(x - textWidth / 2.0f, barY - textHeight - 5.0f);
-        m_renderer->DrawText(textPos, label.c_str(), textColor);
+        m_renderer->DrawText(textPos, label, textColor);
     }
     
     // Draw current power value indicator (vertical line)
@@ -415,7 +427,7 @@ void UI::DrawMessages() {
     Vector2 messagePos(500, 100);
 
     for (const auto& message : m_messages) {
-        m_renderer->DrawText(messagePos, message.text.c_str(), message.color);
+        m_renderer->DrawText(messagePos, message.text, message.color);
         messagePos.y += 20;
     }
 }
@@ -426,16 +438,9 @@ void UI::DrawGameOverScreen(int winnerId) {
     // Semi-transparent overlay
     m_renderer->DrawRect(Vector2::Zero(), 1200, 800, Color(0, 0, 0, 200));
 
-    // Get player colors for cycling
-    std::vector<Color> playerColors = {
-        Color(255, 100, 100, 255), // Red (Player 1)
-        Color(100, 100, 255, 255), // Blue (Player 2)
-        Color(100, 255, 100, 255), // Green (Player 3)
-        Color(255, 255, 100, 255)  // Yellow (Player 4)
-    };
-    
     // Determine winner text
-    std::string winnerText;
+    const char* winnerText = "";
+    char playerWins[32];
     if (m_gameMode == GameMode::TEAM_2V2) {
         if (winnerId == -1) {
             winnerText = "TEAM 1 WINS!";
@@ -443,19 +448,20 @@ void UI::DrawGameOverScreen(int winnerId) {
             winnerText = "TEAM 2 WINS!";
         }
     } else {
-        if (winnerId >= 0 && winnerId < 4) {
-            winnerText = "PLAYER " + std::to_string(winnerId + 1) + " WINS!";
+        if (winnerId >= 0 && winnerId < Match::MAX_PLAYERS) {
+            std::snprintf(playerWins, sizeof(playerWins), "PLAYER %d WINS!", winnerId + 1);
+            winnerText = playerWins;
         } else {
             winnerText = "GAME OVER";
         }
     }
     
-    // Get current color for cycling
-    Color currentColor = playerColors[m_currentColorIndex];
+    // Get current color for cycling (the first four player colors)
+    Color currentColor = PlayerSlots::GetColor(m_currentColorIndex);
     
     // Draw big, bold winner text (centered, with color cycling)
     int textWidth = 0, textHeight = 0;
-    m_renderer->GetTextSize(winnerText.c_str(), &textWidth, &textHeight);
+    m_renderer->GetTextSize(winnerText, &textWidth, &textHeight);
     Vector2 winnerTextPos(600.0f - textWidth / 2.0f, 250.0f);
     
     // Draw text with current color (bold effect by drawing multiple times with slight offset)
@@ -463,11 +469,11 @@ void UI::DrawGameOverScreen(int winnerId) {
         for (int j = -1; j <= 1; ++j) {
             if (i != 0 || j != 0) {
                 m_renderer->DrawText(winnerTextPos + Vector2(static_cast<float>(i), static_cast<float>(j)), 
-                                    winnerText.c_str(), Color(0, 0, 0, 200));
+                                    winnerText, Color(0, 0, 0, 200));
             }
         }
     }
-    m_renderer->DrawText(winnerTextPos, winnerText.c_str(), currentColor);
+    m_renderer->DrawText(winnerTextPos, winnerText, currentColor);
     
     // Draw buttons (Back to Menu - pink, Rematch - aqua)
     const float buttonWidth = 200.0f;
@@ -497,7 +503,7 @@ void UI::DrawGameOverScreen(int winnerId) {
             scaledWidth, 
             scaledHeight 
         };
-        SDL_RenderTexture(m_renderer->GetSDLRenderer(), m_buttonTextures[2], nullptr, &destRect);
+        m_renderer->DrawTexture(m_buttonTextures[2], nullptr, &destRect);
     } else {
         // Fallback to colored rectangle
         m_renderer->DrawRect(backButtonPos, buttonWidth, buttonHeight, Color(255, 192, 203, 255));
@@ -531,7 +537,7 @@ void UI::DrawGameOverScreen(int winnerId) {
             scaledWidth, 
             scaledHeight 
         };
-        SDL_RenderTexture(m_renderer->GetSDLRenderer(), m_buttonTextures[0], nullptr, &destRect);
+        m_renderer->DrawTexture(m_buttonTextures[0], nullptr, &destRect);
     } else {
         // Fallback to colored rectangle
         m_renderer->DrawRect(rematchButtonPos, buttonWidth, buttonHeight, Color(0, 255, 255, 255));
@@ -618,9 +624,13 @@ Color UI::GetSkillColor(SkillType skillType) const {
     }
 }
 
-void UI::ShowMessage(const std::string& message, float duration) {
+void UI::ShowMessage(const char* message, float duration) {
+    if (m_messages.size() >= MAX_MESSAGES) {
+        m_messages.erase(m_messages.begin());
+    }
+
     Message msg;
-    msg.text = message;
+    std::snprintf(msg.text, sizeof(msg.text), "%s", message);
     msg.remainingTime = duration;
     msg.color = Color(255, 255, 255, 255);
     m_messages.push_back(msg);
@@ -628,9 +638,9 @@ void UI::ShowMessage(const std::string& message, float duration) {
 
 void UI::ShowGameOver(int winnerId, GameMode gameMode) {
     // Only activate if there's a valid winner
-    // Valid IDs: -2 (Team 2), -1 (Team 1), 0-3 (Players 1-4)
+    // Valid IDs: -2 (Team 2), -1 (Team 1), 0 to MAX_PLAYERS - 1 (Players)
     // Use -999 or any value < -2 to clear/deactivate
-    if (winnerId >= -2 && winnerId < 4) {
+    if (winnerId >= -2 && winnerId < Match::MAX_PLAYERS) {
         m_gameOverActive = true;
         m_winnerId = winnerId;
         m_gameMode = gameMode;
@@ -725,6 +735,8 @@ bool UI::HandleMinimapClick(const Vector2& mousePos, float mapWidth, float mapHe
 }
 
 void UI::LoadInventorySlotTexture() {
+    PROFILE_ZONE("UI::LoadInventorySlotTexture");
+
     // Load regular inventory slot texture
     std::string texturePath = "../assets/inventory_slot.png";
     SDL_Surface* surface = IMG_Load(texturePath.c_str());
@@ -733,7 +745,7 @@ void UI::LoadInventorySlotTexture() {
     } else {
         m_inventorySlotWidth = surface->w;
         m_inventorySlotHeight = surface->h;
-        m_inventorySlotTexture = SDL_CreateTextureFromSurface(m_renderer->GetSDLRenderer(), surface);
+        m_inventorySlotTexture = m_renderer->CreateTextureFromSurface(surface);
         SDL_DestroySurface(surface);
 
         if (!m_inventorySlotTexture) {
@@ -763,7 +775,7 @@ void UI::LoadInventorySlotTexture() {
             m_inventorySlotHeight = selectedSurface->h;
         }
 
-        m_selectedInventorySlotTexture = SDL_CreateTextureFromSurface(m_renderer->GetSDLRenderer(), selectedSurface);
+        m_selectedInventorySlotTexture = m_renderer->CreateTextureFromSurface(selectedSurface);
         SDL_DestroySurface(selectedSurface);
 
         if (!m_selectedInventorySlotTexture) {
@@ -775,6 +787,8 @@ void UI::LoadInventorySlotTexture() {
 }
 
 void UI::LoadSkillOrbTextures() {
+    PROFILE_ZONE("UI::LoadSkillOrbTextures");
+
     for (int i = 0; i < static_cast<int>(SkillType::COUNT); ++i) {
         SkillType skillType = static_cast<SkillType>(i);
         std::string texturePath = GetSkillOrbTexturePath(skillType);
@@ -789,7 +803,7 @@ void UI::LoadSkillOrbTextures() {
             continue;
         }
         
-        m_skillOrbTextures[i] = SDL_CreateTextureFromSurface(m_renderer->GetSDLRenderer(), surface);
+        m_skillOrbTextures[i] = m_renderer->CreateTextureFromSurface(surface);
         SDL_DestroySurface(surface);
         
         if (!m_skillOrbTextures[i]) {
@@ -818,6 +832,8 @@ std::string UI::GetSkillOrbTexturePath(SkillType skillType) const {
 }
 
 void UI::LoadButtonTextures() {
+    PROFILE_ZONE("UI::LoadButtonTextures");
+
     // Button texture paths - order: aqua, orange, pink, purple
     const char* buttonPaths[] = {
         "../assets/buttons/aqua_button.png",
@@ -832,7 +848,7 @@ void UI::LoadButtonTextures() {
         if (surface) {
             m_buttonTextureWidths[i] = surface->w;
             m_buttonTextureHeights[i] = surface->h;
-            m_buttonTextures[i] = SDL_CreateTextureFromSurface(m_renderer->GetSDLRenderer(), surface);
+            m_buttonTextures[i] = m_renderer->CreateTextureFromSurface(surface);
             SDL_DestroySurface(surface);
             if (!m_buttonTextures[i]) {
                 std::cerr << "Failed to create button texture " << i << ": " << SDL_GetError() << std::endl;
@@ -10,6 +10,7 @@
 
 class Player;
 class Renderer;
+class Camera;
 
 enum class SkillType {
     SPLIT_THROW = 0,
@@ -30,9 +31,10 @@ public:
         int currentPlayerIndex, float turnTimer,
         const Vector2& mousePosition);
 
-    // Render world-space UI (call with camera offset active)
+    // Render world-space UI (call with camera offset active); with a camera, name tags of
+    // players outside its view are skipped
     void RenderWorldSpace(const std::vector<std::unique_ptr<Player>>& players,
-        int currentPlayerIndex, const Vector2& mousePosition);
+        int currentPlayerIndex, const Vector2& mousePosition, const Camera* camera = nullptr);
 
     // Render screen-space UI (call with camera offset reset to 0)
     void RenderScreenSpace(const std::vector<std::unique_ptr<Player>>& players,
@@ -48,7 +50,7 @@ public:
     // Check if mouse is over minimap (for dragging)
     bool IsMouseOverMinimap(const Vector2& mousePos) const;
 
-    void ShowMessage(const std::string& message, float duration = 3.0f);
+    void ShowMessage(const char* message, float duration = 3.0f); // Copied, cut at MESSAGE_LENGTH
     void ShowGameOver(int winnerId, GameMode gameMode);
     void ClearMessages();
     void SetGameMode(GameMode gameMode) { m_gameMode = gameMode; }
@@ -76,9 +78,11 @@ private:
     int m_buttonTextureWidths[4];
     int m_buttonTextureHeights[4];
 
-    // Message system
+    // Message system (fixed-size text and a reserved list, so showing one never allocates)
+    static constexpr int MESSAGE_LENGTH = 96;
+    static constexpr int MAX_MESSAGES = 8; // The oldest one goes first
     struct Message {
-        std::string text;
+        char text[MESSAGE_LENGTH];
         float remainingTime;
         Color color;
     };
@@ -127,4 +131,5 @@ private:
     static constexpr float TURN_TIMER_HEIGHT = 20.0f;
     static constexpr float MINIMAP_WIDTH = 200.0f;
     static constexpr float MINIMAP_HEIGHT = 150.0f;
+    static constexpr float NAME_TAG_CULL_MARGIN = 80.0f; // Name and health bar reach past the player
 };
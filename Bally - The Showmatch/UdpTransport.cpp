@@ -0,0 +1,133 @@
+#include "UdpTransport.h"
+#include "SocketPlatform.h"
+#include <cstring>
+#include <iostream>
+
+UdpTransport::UdpTransport() : m_socket(-1), m_peerAddressLength(0), m_hasPeer(false) {
+    std::memset(m_peerAddress, 0, sizeof(m_peerAddress));
+    static_assert(sizeof(m_peerAddress) >= sizeof(sockaddr_storage), "peer address buffer too small");
+}
+
+UdpTransport::~UdpTransport() {
+    Close();
+}
+
+bool UdpTransport::OpenSocket(Uint16 port) {
+    Close();
+
+    if (!StartSockets()) {
+        std::cerr << "Failed to start Winsock" << std::endl;
+        return false;
+    }
+
+    SocketHandle handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (handle == NO_SOCKET) {
+        std::cerr << "Failed to create UDP socket" << std::endl;
+        StopSockets();
+        return false;
+    }
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (bind(handle, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        std::cerr << "Failed to bind UDP port " << port << std::endl;
+        CloseSocket(handle);
+        StopSockets();
+        return false;
+    }
+
+    // Never block the game loop
+    SetNonBlocking(handle);
+
+    m_socket = static_cast<long long>(handle);
+    return true;
+}
+
+bool UdpTransport::Listen(Uint16 port) {
+    if (!OpenSocket(port)) return false;
+    std::cout << "Waiting for a netplay peer on UDP port " << port << std::endl;
+    return true;
+}
+
+bool UdpTransport::Connect(const std::string& host, Uint16 port) {
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+
+    // Open first: resolving needs Winsock started
+    if (!OpenSocket(0)) return false;
+
+    addrinfo* result = nullptr;
+    std::string service = std::to_string(port);
+    if (getaddrinfo(host.c_str(), service.c_str(), &hints, &result) != 0 || !result) {
+        std::cerr << "Failed to resolve " << host << std::endl;
+        Close();
+        return false;
+    }
+
+    std::memcpy(m_peerAddress, result->ai_addr, result->ai_addrlen);
+    m_peerAddressLength = static_cast<int>(result->ai_addrlen);
+    m_hasPeer = true;
+    freeaddrinfo(result);
+
+    std::cout << "Connecting to " << host << ":" << port << std::endl;
+    return true;
+}
+
+void UdpTransport::Close() {
+    if (m_socket == -1) return;
+
+    CloseSocket(ToSocket(m_socket));
+    m_socket = -1;
+    m_hasPeer = false;
+    StopSockets();
+}
+
+bool UdpTransport::IsPeer(const sockaddr_storage& from) const {
+    const sockaddr_in* peer = reinterpret_cast<const sockaddr_in*>(m_peerAddress);
+    const sockaddr_in* sender = reinterpret_cast<const sockaddr_in*>(&from);
+    return sender->sin_family == peer->sin_family && sender->sin_port == peer->sin_port &&
+        sender->sin_addr.s_addr == peer->sin_addr.s_addr;
+}
+
+void UdpTransport::Send(const std::vector<Uint8>& packet) {
+    if (m_socket == -1 || !m_hasPeer || packet.empty()) return;
+
+    // Lost sends are like lost packets: the session resends
+    sendto(ToSocket(m_socket), reinterpret_cast<const char*>(packet.data()),
+        static_cast<int>(packet.size()), 0, reinterpret_cast<const sockaddr*>(m_peerAddress),
+        static_cast<SocketLength>(m_peerAddressLength));
+}
+
+bool UdpTransport::Receive(std::vector<Uint8>& packet) {
+    if (m_socket == -1) return false;
+
+    packet.resize(MAX_PACKET_SIZE);
+    while (true) {
+        sockaddr_storage from;
+        SocketLength fromLength = sizeof(from);
+        int received = static_cast<int>(recvfrom(ToSocket(m_socket),
+            reinterpret_cast<char*>(packet.data()), static_cast<int>(packet.size()), 0,
+            reinterpret_cast<sockaddr*>(&from), &fromLength));
+        if (received <= 0) {
+            packet.clear();
+            return false;
+        }
+
+        // The first sender becomes the peer; everyone else is ignored
+        if (!m_hasPeer) {
+            std::memcpy(m_peerAddress, &from, fromLength);
+            m_peerAddressLength = static_cast<int>(fromLength);
+            m_hasPeer = true;
+        } else if (!IsPeer(from)) {
+            continue;
+        }
+
+        packet.resize(received);
+        return true;
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include "NetTransport.h"
+
+struct sockaddr_storage;
+
+// Non-blocking UDP socket talking to one peer.
+// The host listens on a port and answers whoever sends to it first; the guest
+// connects to the host's address.
+class UdpTransport : public NetTransport {
+public:
+    UdpTransport();
+    ~UdpTransport();
+
+    bool Listen(Uint16 port);
+    bool Connect(const std::string& host, Uint16 port);
+    void Close();
+
+    bool HasPeer() const { return m_hasPeer; }
+
+    void Send(const std::vector<Uint8>& packet) override;
+    bool Receive(std::vector<Uint8>& packet) override;
+
+    static constexpr size_t MAX_PACKET_SIZE = 1400; // Stay under the usual MTU
+
+private:
+    bool OpenSocket(Uint16 port);
+    bool IsPeer(const sockaddr_storage& from) const;
+
+    long long m_socket;          // SOCKET on Windows, file descriptor elsewhere (-1 = closed)
+    Uint8 m_peerAddress[128];    // sockaddr_storage of the peer
+    int m_peerAddressLength;
+    bool m_hasPeer;
+};
@@ -1,14 +1,66 @@
 #include "Game.h"
+#include "Profiler.h"
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <string>
 
 int main(int argc, char* argv[]) {
     Game game;
 
+    // --trace file records a Chrome trace from startup (asset loads included) until exit.
+    // Frames slower than --hitch-ms (0 = never) get the frames around them saved to hitches/.
+    float hitchMs = Profiler::DEFAULT_HITCH_MS;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--trace") == 0) {
+            Profiler::StartTrace(argv[i + 1]);
+        } else if (std::strcmp(argv[i], "--hitch-ms") == 0) {
+            hitchMs = static_cast<float>(std::atof(argv[i + 1]));
+        }
+    }
+    Profiler::StartFlightRecorder("hitches", hitchMs);
+
     if (!game.Initialize()) {
         std::cerr << "Failed to initialize game!" << std::endl;
         return -1;
     }
 
+    // --metrics [name] publishes live metrics to shared memory for BallyMetrics
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--metrics") == 0) {
+            bool hasName = i + 1 < argc && argv[i + 1][0] != '-';
+            game.PublishMetrics(hasName ? argv[i + 1] : LiveMetricsPublisher::DEFAULT_NAME);
+        }
+    }
+
+    // --alloc-check reports gameplay frames that allocate on the heap
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--alloc-check") == 0) {
+            game.EnableAllocationCheck();
+        }
+    }
+
+    // Online play: --host port [--delay frames] or --join address:port
+    int inputDelay = NetplaySetup::DEFAULT_INPUT_DELAY;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--delay") == 0) {
+            inputDelay = std::atoi(argv[i + 1]);
+        }
+    }
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--host") == 0) {
+            game.HostNetplay(static_cast<Uint16>(std::atoi(argv[i + 1])), inputDelay);
+        } else if (std::strcmp(argv[i], "--join") == 0) {
+            std::string address = argv[i + 1];
+            size_t colon = address.rfind(':');
+            if (colon == std::string::npos) {
+                std::cerr << "Use --join address:port" << std::endl;
+                continue;
+            }
+            game.JoinNetplay(address.substr(0, colon), static_cast<Uint16>(std::atoi(address.c_str() + colon + 1)));
+        }
+    }
+
     std::cout << "Bally - The Showdown" << std::endl;
     std::cout << "Starting game..." << std::endl;
 